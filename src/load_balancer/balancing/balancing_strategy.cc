@@ -0,0 +1,48 @@
+#include "balancing_strategy.h"
+
+#include <stdexcept>
+
+#include "maglev_strategy.h"
+#include "peak_ewma_strategy.h"
+#include "power_of_two_choices_strategy.h"
+#include "round_robin_strategy.h"
+#include "weighted_round_robin_strategy.h"
+
+namespace load_balancer::balancing {
+
+void BalancingStrategy::SelectServers(
+    const std::span<const std::size_t> client_hashes, const std::span<std::size_t> server_indexes
+) {
+  for (std::size_t i = 0; i < server_indexes.size(); ++i) {
+    server_indexes[i] = SelectServer(client_hashes[i]);
+  }
+}
+
+std::unique_ptr<BalancingStrategy> CreateBalancingStrategy(
+    const BalancingStrategyType type,
+    const std::vector<ServerInfo> &servers,
+    std::shared_ptr<const ServerLatency> latency
+) {
+  if (servers.empty()) {
+    throw std::invalid_argument("Balancing strategy requires at least one server.");
+  }
+  std::vector<std::size_t> weights;
+  for (const auto &server : servers) {
+    weights.push_back(server.weight);
+  }
+  switch (type) {
+    case BalancingStrategyType::kRoundRobin:
+      return std::make_unique<RoundRobinStrategy>(weights.size());
+    case BalancingStrategyType::kWeightedRoundRobin:
+      return std::make_unique<WeightedRoundRobinStrategy>(weights);
+    case BalancingStrategyType::kPowerOfTwoChoices:
+      return std::make_unique<PowerOfTwoChoicesStrategy>(weights);
+    case BalancingStrategyType::kMaglev:
+      return std::make_unique<MaglevStrategy>(servers);
+    case BalancingStrategyType::kPeakEwma:
+      return std::make_unique<PeakEwmaStrategy>(weights, std::move(latency));
+  }
+  throw std::invalid_argument("Unknown balancing strategy type.");
+}
+
+}  // namespace load_balancer::balancing
@@ -0,0 +1,73 @@
+#ifndef BALANCING_STRATEGY_H
+#define BALANCING_STRATEGY_H
+
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "server_latency.h"
+
+namespace load_balancer::balancing {
+
+/**
+ * \brief Алгоритм выбора сервера.
+ */
+enum class BalancingStrategyType {
+  kRoundRobin,          ///< Серверы выбираются по кругу, веса не учитываются.
+  kWeightedRoundRobin,  ///< Плавный взвешенный Round-robin.
+  kPowerOfTwoChoices,   ///< Менее нагруженный из двух случайных серверов.
+  kMaglev,              ///< Согласованное хеширование Maglev по адресу клиента.
+  kPeakEwma,            ///< Из двух случайных серверов с меньшей задержкой ответов (peak-EWMA).
+};
+
+/**
+ * \brief Сведения о сервере, необходимые стратегии выбора.
+ */
+struct ServerInfo {
+  /// Хеш конечной точки, идентифицирующий сервер независимо от его позиции в списке.
+  std::size_t key;
+  /// Вес сервера, все стратегии считают нулевой вес единичным.
+  std::size_t weight;
+};
+
+/**
+ * \brief Стратегия выбора сервера, на который перенаправляется очередной запрос.
+ *
+ * Реализации допускают одновременный вызов методов выбора из нескольких потоков без блокировок.
+ */
+class BalancingStrategy {
+ public:
+  virtual ~BalancingStrategy() = default;
+
+  /**
+   * \brief Выбрать сервер для очередного запроса.
+   * \param client_hash хеш конечной точки клиента, отправившего запрос.
+   * \return индекс сервера.
+   */
+  virtual std::size_t SelectServer(std::size_t client_hash) = 0;
+  /**
+   * \brief Выбрать серверы для нескольких очередных запросов.
+   * \param client_hashes хеши конечных точек клиентов, по одному на каждый запрос;
+   * \param server_indexes индексы выбранных серверов, по одному на каждый запрос.
+   */
+  virtual void SelectServers(
+      std::span<const std::size_t> client_hashes, std::span<std::size_t> server_indexes
+  );
+};
+
+/**
+ * \brief Создать стратегию выбора сервера указанного типа.
+ * \param servers сведения о серверах в порядке их индексов;
+ * \param latency задержки ответов серверов, обязательны для
+ * @link BalancingStrategyType::kPeakEwma @endlink.
+ */
+std::unique_ptr<BalancingStrategy> CreateBalancingStrategy(
+    BalancingStrategyType type,
+    const std::vector<ServerInfo> &servers,
+    std::shared_ptr<const ServerLatency> latency = nullptr
+);
+
+}  // namespace load_balancer::balancing
+
+#endif  // BALANCING_STRATEGY_H
@@ -0,0 +1,90 @@
+#include "maglev_strategy.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace load_balancer::balancing {
+
+namespace {
+
+/**
+ * \brief Перемешивание splitmix64, дающее из ключа сервера независимые псевдослучайные числа.
+ */
+std::uint64_t Mix(std::uint64_t value) {
+  value += 0x9e3779b97f4a7c15;
+  value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9;
+  value = (value ^ (value >> 27)) * 0x94d049bb133111eb;
+  return value ^ (value >> 31);
+}
+
+/**
+ * \brief Перестановка позиций таблицы, в порядке которой сервер занимает свободные записи.
+ */
+struct Permutation {
+  std::uint64_t offset;
+  std::uint64_t skip;
+  std::uint64_t next = 0;
+
+  explicit Permutation(const std::size_t key)
+      : offset(Mix(key) % MaglevStrategy::kTableSize),
+        skip(Mix(Mix(key)) % (MaglevStrategy::kTableSize - 1) + 1) {
+  }
+
+  std::uint64_t Next() {
+    return (offset + skip * next++) % MaglevStrategy::kTableSize;
+  }
+};
+
+}  // namespace
+
+MaglevStrategy::MaglevStrategy(const std::vector<ServerInfo> &servers)
+    : table_(BuildTable(servers)) {
+}
+
+std::size_t MaglevStrategy::SelectServer(const std::size_t client_hash) {
+  return table_[client_hash % kTableSize];
+}
+
+void MaglevStrategy::SelectServers(
+    const std::span<const std::size_t> client_hashes, const std::span<std::size_t> server_indexes
+) {
+  for (std::size_t i = 0; i < server_indexes.size(); ++i) {
+    server_indexes[i] = table_[client_hashes[i] % kTableSize];
+  }
+}
+
+MaglevStrategy::LookupTable MaglevStrategy::BuildTable(const std::vector<ServerInfo> &servers) {
+  if (servers.size() > kMaxServerCount) {
+    throw std::invalid_argument("Too many servers for Maglev lookup table.");
+  }
+  if (servers.empty()) {
+    throw std::invalid_argument("Maglev lookup table requires at least one server.");
+  }
+  std::vector<Permutation> permutations;
+  for (const auto &server : servers) {
+    permutations.emplace_back(server.key);
+  }
+
+  // Серверы по очереди занимают очередную свободную запись своей перестановки, каждый - столько
+  // записей за круг, каков его вес, пока таблица не заполнится.
+  constexpr auto kEmpty = UINT16_MAX;
+  LookupTable table(kTableSize, kEmpty);
+  std::size_t filled = 0;
+  while (filled < kTableSize) {
+    for (std::size_t server = 0; server < servers.size() && filled < kTableSize; ++server) {
+      // Нулевой вес, как и в остальных стратегиях, равнозначен единичному.
+      const auto weight = std::max<std::size_t>(servers[server].weight, 1);
+      for (std::size_t turn = 0; turn < weight && filled < kTableSize; ++turn) {
+        auto position = permutations[server].Next();
+        while (table[position] != kEmpty) {
+          position = permutations[server].Next();
+        }
+        table[position] = static_cast<std::uint16_t>(server);
+        ++filled;
+      }
+    }
+  }
+  return table;
+}
+
+}  // namespace load_balancer::balancing
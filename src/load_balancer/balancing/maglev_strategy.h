@@ -0,0 +1,48 @@
+#ifndef MAGLEV_STRATEGY_H
+#define MAGLEV_STRATEGY_H
+
+#include <cstdint>
+
+#include "balancing_strategy.h"
+
+namespace load_balancer::balancing {
+
+/**
+ * \brief Согласованное хеширование Maglev: запросы одного клиента направляются на один сервер.
+ *
+ * Сервер выбирается по хешу конечной точки клиента из таблицы поиска размером
+ * @link kTableSize @endlink записей, поэтому выбор - одно обращение к таблице, целиком
+ * умещающейся в кэше L2. Каждый сервер заполняет таблицу в порядке собственной перестановки,
+ * зависящей только от его ключа, поэтому при добавлении или исключении сервера меняется
+ * лишь малая доля записей. Таблица строится при создании стратегии и больше не изменяется,
+ * поэтому выбор читает ее без синхронизации; при перезагрузке конфигурации стратегия создается
+ * заново и подменяется вместе со снимком параметров.
+ */
+class MaglevStrategy : public BalancingStrategy {
+ public:
+  /// Размер таблицы поиска, простое число, много большее количества серверов.
+  static constexpr std::size_t kTableSize = 65537;
+  /// Максимальное количество серверов, индекс сервера хранится в 16 битах.
+  static constexpr std::size_t kMaxServerCount = UINT16_MAX;
+
+  /**
+   * \throws std::invalid_argument серверов нет либо их больше @link kMaxServerCount @endlink.
+   */
+  explicit MaglevStrategy(const std::vector<ServerInfo> &servers);
+
+  std::size_t SelectServer(std::size_t client_hash) override;
+  void SelectServers(
+      std::span<const std::size_t> client_hashes, std::span<std::size_t> server_indexes
+  ) override;
+
+ private:
+  using LookupTable = std::vector<std::uint16_t>;
+
+  const LookupTable table_;
+
+  static LookupTable BuildTable(const std::vector<ServerInfo> &servers);
+};
+
+}  // namespace load_balancer::balancing
+
+#endif  // MAGLEV_STRATEGY_H
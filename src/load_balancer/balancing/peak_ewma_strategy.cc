@@ -0,0 +1,43 @@
+#include "peak_ewma_strategy.h"
+
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+
+namespace load_balancer::balancing {
+
+PeakEwmaStrategy::PeakEwmaStrategy(
+    const std::vector<std::size_t> &weights, std::shared_ptr<const ServerLatency> latency
+)
+    : weights_(weights), latency_(std::move(latency)) {
+  if (!latency_ || latency_->GetServerCount() != weights_.size()) {
+    throw std::invalid_argument("Peak-EWMA strategy requires latency of every server.");
+  }
+}
+
+std::size_t PeakEwmaStrategy::SelectServer([[maybe_unused]] const std::size_t client_hash) {
+  const auto server_count = weights_.size();
+  if (server_count == 1) {
+    return 0;
+  }
+  const auto random = NextRandom();
+  const auto first = random % server_count;
+  const auto second = (first + 1 + (random >> 32) % (server_count - 1)) % server_count;
+
+  const auto now = ServerLatency::Clock::now();
+  const auto first_cost = latency_->GetCost(first, now) /
+                          static_cast<double>(std::max<std::size_t>(weights_[first], 1));
+  const auto second_cost = latency_->GetCost(second, now) /
+                           static_cast<double>(std::max<std::size_t>(weights_[second], 1));
+  return first_cost <= second_cost ? first : second;
+}
+
+std::uint64_t PeakEwmaStrategy::NextRandom() {
+  thread_local std::uint64_t state = std::random_device()() | 1;
+  state ^= state << 13;
+  state ^= state >> 7;
+  state ^= state << 17;
+  return state;
+}
+
+}  // namespace load_balancer::balancing
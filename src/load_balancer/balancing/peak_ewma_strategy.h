@@ -0,0 +1,40 @@
+#ifndef PEAK_EWMA_STRATEGY_H
+#define PEAK_EWMA_STRATEGY_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "balancing_strategy.h"
+#include "server_latency.h"
+
+namespace load_balancer::balancing {
+
+/**
+ * \brief Выбор из двух случайных серверов сервера с меньшей стоимостью peak-EWMA: задержкой
+ * ответов, умноженной на количество ожидающих ответа запросов, деленной на вес сервера.
+ *
+ * Стратегия только читает @link ServerLatency задержки серверов@endlink, которые обновляют
+ * потоки отправки запросов и приема ответов, поэтому выбор не изменяет общих данных.
+ */
+class PeakEwmaStrategy : public BalancingStrategy {
+ public:
+  PeakEwmaStrategy(
+      const std::vector<std::size_t> &weights, std::shared_ptr<const ServerLatency> latency
+  );
+
+  std::size_t SelectServer(std::size_t client_hash) override;
+
+ private:
+  const std::vector<std::size_t> weights_;
+  const std::shared_ptr<const ServerLatency> latency_;
+
+  /**
+   * \brief Случайное число из потоко-локального генератора xorshift.
+   */
+  static std::uint64_t NextRandom();
+};
+
+}  // namespace load_balancer::balancing
+
+#endif  // PEAK_EWMA_STRATEGY_H
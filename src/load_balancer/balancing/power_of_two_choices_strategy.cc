@@ -0,0 +1,80 @@
+#include "power_of_two_choices_strategy.h"
+
+#include <algorithm>
+#include <random>
+
+namespace load_balancer::balancing {
+
+namespace {
+
+std::vector<std::size_t> NormalizeWeights(std::vector<std::size_t> weights) {
+  for (auto &weight : weights) {
+    weight = std::max<std::size_t>(weight, 1);
+  }
+  return weights;
+}
+
+}  // namespace
+
+PowerOfTwoChoicesStrategy::PowerOfTwoChoicesStrategy(const std::vector<std::size_t> &weights)
+    : weights_(NormalizeWeights(weights)), recent_sends_(weights.size()) {
+}
+
+std::size_t PowerOfTwoChoicesStrategy::SelectServer(
+    [[maybe_unused]] const std::size_t client_hash
+) {
+  const auto server_count = weights_.size();
+  if (server_count == 1) {
+    return 0;
+  }
+  const auto random = NextRandom();
+  const auto first = random % server_count;
+  const auto second = (first + 1 + (random >> 32) % (server_count - 1)) % server_count;
+
+  const auto epoch = CurrentEpoch();
+  const auto first_state = recent_sends_[first].state.load(std::memory_order_relaxed);
+  const auto second_state = recent_sends_[second].state.load(std::memory_order_relaxed);
+  const auto first_load =
+      static_cast<double>(Decay(first_state, epoch)) / static_cast<double>(weights_[first]);
+  const auto second_load =
+      static_cast<double>(Decay(second_state, epoch)) / static_cast<double>(weights_[second]);
+  const auto selected = first_load <= second_load ? first : second;
+
+  auto &state = recent_sends_[selected].state;
+  auto current = selected == first ? first_state : second_state;
+  while (!state.compare_exchange_weak(
+      current,
+      (epoch << kCountBits) | std::min(Decay(current, epoch) + 1, kCountMask),
+      std::memory_order_relaxed
+  )) {
+  }
+  return selected;
+}
+
+std::uint64_t PowerOfTwoChoicesStrategy::GetRecentSends(const std::size_t server_index) const {
+  return Decay(recent_sends_[server_index].state.load(std::memory_order_relaxed), CurrentEpoch());
+}
+
+std::uint64_t PowerOfTwoChoicesStrategy::CurrentEpoch() {
+  return static_cast<std::uint64_t>(Clock::now().time_since_epoch() / kDecayPeriod) & kEpochMask;
+}
+
+std::uint64_t PowerOfTwoChoicesStrategy::Decay(
+    const std::uint64_t state, const std::uint64_t epoch
+) {
+  const auto elapsed = (epoch - (state >> kCountBits)) & kEpochMask;
+  if (elapsed >= kCountBits) {
+    return 0;
+  }
+  return (state & kCountMask) >> elapsed;
+}
+
+std::uint64_t PowerOfTwoChoicesStrategy::NextRandom() {
+  thread_local std::uint64_t state = std::random_device()() | 1;
+  state ^= state << 13;
+  state ^= state >> 7;
+  state ^= state << 17;
+  return state;
+}
+
+}  // namespace load_balancer::balancing
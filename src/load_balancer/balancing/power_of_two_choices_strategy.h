@@ -0,0 +1,61 @@
+#ifndef POWER_OF_TWO_CHOICES_STRATEGY_H
+#define POWER_OF_TWO_CHOICES_STRATEGY_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "balancing_strategy.h"
+#include "cache_line.h"
+
+namespace load_balancer::balancing {
+
+/**
+ * \brief Выбор менее нагруженного из двух случайных серверов (power of two choices).
+ *
+ * Нагрузкой сервера считается количество недавно отправленных ему запросов, деленное на вес
+ * сервера. Счетчик каждого сервера экспоненциально затухает, уменьшаясь вдвое за каждый
+ * @link kDecayPeriod @endlink, и лежит в отдельной кэш-линии.
+ */
+class PowerOfTwoChoicesStrategy : public BalancingStrategy {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  /// Период, за который счетчик недавних отправок уменьшается вдвое.
+  static constexpr auto kDecayPeriod = std::chrono::milliseconds(100);
+
+  explicit PowerOfTwoChoicesStrategy(const std::vector<std::size_t> &weights);
+
+  std::size_t SelectServer(std::size_t client_hash) override;
+
+  /**
+   * \brief Количество недавних отправок серверу с учетом затухания.
+   */
+  [[nodiscard]] std::uint64_t GetRecentSends(std::size_t server_index) const;
+
+ private:
+  static constexpr std::uint64_t kCountBits = 48;
+  static constexpr std::uint64_t kCountMask = (std::uint64_t{1} << kCountBits) - 1;
+  static constexpr std::uint64_t kEpochMask = (std::uint64_t{1} << (64 - kCountBits)) - 1;
+
+  /**
+   * \brief Затухающий счетчик отправок: номер периода затухания и значение на его начало.
+   */
+  struct alignas(kCacheLineSize) RecentSends {
+    std::atomic<std::uint64_t> state = 0;
+  };
+
+  const std::vector<std::size_t> weights_;
+  std::vector<RecentSends> recent_sends_;
+
+  static std::uint64_t CurrentEpoch();
+  static std::uint64_t Decay(std::uint64_t state, std::uint64_t epoch);
+  /**
+   * \brief Случайное число из потоко-локального генератора xorshift.
+   */
+  static std::uint64_t NextRandom();
+};
+
+}  // namespace load_balancer::balancing
+
+#endif  // POWER_OF_TWO_CHOICES_STRATEGY_H
@@ -0,0 +1,24 @@
+#include "round_robin_strategy.h"
+
+namespace load_balancer::balancing {
+
+RoundRobinStrategy::RoundRobinStrategy(const std::size_t server_count)
+    : server_count_(server_count) {
+}
+
+std::size_t RoundRobinStrategy::SelectServer([[maybe_unused]] const std::size_t client_hash) {
+  return next_server_.fetch_add(1, std::memory_order_relaxed) % server_count_;
+}
+
+void RoundRobinStrategy::SelectServers(
+    [[maybe_unused]] const std::span<const std::size_t> client_hashes,
+    const std::span<std::size_t> server_indexes
+) {
+  const auto first =
+      next_server_.fetch_add(server_indexes.size(), std::memory_order_relaxed) % server_count_;
+  for (std::size_t i = 0; i < server_indexes.size(); ++i) {
+    server_indexes[i] = (first + i) % server_count_;
+  }
+}
+
+}  // namespace load_balancer::balancing
@@ -0,0 +1,31 @@
+#ifndef ROUND_ROBIN_STRATEGY_H
+#define ROUND_ROBIN_STRATEGY_H
+
+#include <atomic>
+
+#include "balancing_strategy.h"
+
+namespace load_balancer::balancing {
+
+/**
+ * \brief Простейший Round-robin: серверы выбираются последовательно друг за другом.
+ *
+ * Курсор продвигается атомарным fetch_add, для пачки запросов - одним вызовом.
+ */
+class RoundRobinStrategy : public BalancingStrategy {
+ public:
+  explicit RoundRobinStrategy(std::size_t server_count);
+
+  std::size_t SelectServer(std::size_t client_hash) override;
+  void SelectServers(
+      std::span<const std::size_t> client_hashes, std::span<std::size_t> server_indexes
+  ) override;
+
+ private:
+  const std::size_t server_count_;
+  std::atomic_size_t next_server_ = 0;
+};
+
+}  // namespace load_balancer::balancing
+
+#endif  // ROUND_ROBIN_STRATEGY_H
@@ -0,0 +1,114 @@
+#include "server_latency.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace load_balancer::balancing {
+
+ServerLatency::ServerLatency(
+    const std::size_t server_count, const std::chrono::milliseconds decay_time
+)
+    : decay_time_(static_cast<double>(std::chrono::nanoseconds(decay_time).count())),
+      stats_(server_count) {
+}
+
+std::size_t ServerLatency::GetServerCount() const {
+  return stats_.size();
+}
+
+void ServerLatency::OnSent(const std::size_t server_index, const Clock::time_point now) {
+  if (server_index >= stats_.size()) {
+    return;
+  }
+  auto &stats = stats_[server_index];
+  const auto sequence = stats.sent.fetch_add(1, std::memory_order_relaxed);
+  stats.sent_at[sequence % kMaxOutstanding].store(ToNanoseconds(now), std::memory_order_release);
+}
+
+void ServerLatency::OnReply(const std::size_t server_index, const Clock::time_point now) {
+  if (server_index >= stats_.size()) {
+    return;
+  }
+  auto &stats = stats_[server_index];
+  const auto now_ns = ToNanoseconds(now);
+  const auto timeout_ns = std::chrono::nanoseconds(kReplyTimeout).count();
+  auto completed = stats.completed.load(std::memory_order_relaxed);
+  while (true) {
+    const auto sent = stats.sent.load(std::memory_order_acquire);
+    // Запросы, время отправки которых перезаписано, и запросы без ответа дольше таймаута
+    // потеряны.
+    auto oldest = std::max(completed, sent > kMaxOutstanding ? sent - kMaxOutstanding : 0);
+    std::int64_t sent_at = 0;
+    while (oldest < sent) {
+      sent_at = stats.sent_at[oldest % kMaxOutstanding].load(std::memory_order_acquire);
+      if (now_ns - sent_at <= timeout_ns) {
+        break;
+      }
+      ++oldest;
+    }
+    // Ответ без ожидающего запроса только завершает потерянные запросы.
+    const auto next = oldest < sent ? oldest + 1 : oldest;
+    if (!stats.completed.compare_exchange_weak(completed, next, std::memory_order_relaxed)) {
+      continue;
+    }
+    if (oldest < sent) {
+      Observe(stats, static_cast<double>(std::max<std::int64_t>(now_ns - sent_at, 0)), now_ns);
+    }
+    return;
+  }
+}
+
+double ServerLatency::GetCost(const std::size_t server_index, const Clock::time_point now) const {
+  const auto &stats = stats_[server_index];
+  const auto latency = Decay(
+      stats.latency.load(std::memory_order_relaxed),
+      stats.updated.load(std::memory_order_relaxed),
+      ToNanoseconds(now)
+  );
+  const auto outstanding = static_cast<double>(GetOutstanding(server_index));
+  if (latency == 0 && outstanding > 0) {
+    return kUnmeasuredPenalty + outstanding;
+  }
+  return latency * (outstanding + 1);
+}
+
+std::chrono::nanoseconds ServerLatency::GetLatency(const std::size_t server_index) const {
+  return std::chrono::nanoseconds(
+      std::llround(stats_[server_index].latency.load(std::memory_order_relaxed))
+  );
+}
+
+std::uint64_t ServerLatency::GetOutstanding(const std::size_t server_index) const {
+  const auto &stats = stats_[server_index];
+  const auto completed = stats.completed.load(std::memory_order_relaxed);
+  const auto sent = stats.sent.load(std::memory_order_relaxed);
+  return sent > completed ? std::min<std::uint64_t>(sent - completed, kMaxOutstanding) : 0;
+}
+
+double ServerLatency::Decay(
+    const double latency, const std::int64_t updated, const std::int64_t now
+) const {
+  const auto elapsed = static_cast<double>(std::max<std::int64_t>(now - updated, 0));
+  return latency * std::exp(-elapsed / decay_time_);
+}
+
+void ServerLatency::Observe(Stats &stats, const double sample, const std::int64_t now) const {
+  // Одновременные ответы сервера на разных сокетах редки, потерянное при гонке обновление
+  // равносильно пропуску одного измерения.
+  const auto latency = stats.latency.load(std::memory_order_relaxed);
+  const auto updated = stats.updated.load(std::memory_order_relaxed);
+  double next = sample;
+  if (sample < latency) {
+    const auto weight =
+        std::exp(-static_cast<double>(std::max<std::int64_t>(now - updated, 0)) / decay_time_);
+    next = latency * weight + sample * (1 - weight);
+  }
+  stats.latency.store(next, std::memory_order_relaxed);
+  stats.updated.store(now, std::memory_order_relaxed);
+}
+
+std::int64_t ServerLatency::ToNanoseconds(const Clock::time_point time) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+}  // namespace load_balancer::balancing
@@ -0,0 +1,99 @@
+#ifndef SERVER_LATENCY_H
+#define SERVER_LATENCY_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "cache_line.h"
+
+namespace load_balancer::balancing {
+
+/**
+ * \brief Задержки ответов серверов и количество ожидающих ответа запросов, разделяемые
+ * потоками отправки запросов и приема ответов.
+ *
+ * UDP-ответ не содержит идентификатора запроса, поэтому ответы сервера сопоставляются с его
+ * запросами по порядку отправки: ответ завершает самый старый запрос, ожидающий ответа не
+ * дольше @link kReplyTimeout @endlink. Более старые запросы считаются потерянными.
+ *
+ * Задержка сглаживается по алгоритму peak-EWMA: задержка выше текущей оценки принимается
+ * сразу, ниже - усредняется с весом, затухающим со временем decay_time, поэтому замедление
+ * сервера учитывается немедленно, а восстановление - постепенно.
+ *
+ * Счетчики сервера изменяются атомарными операциями без блокировок. Поля, изменяемые потоками
+ * отправки и потоками приема ответов, лежат в разных кэш-линиях, а сведения разных серверов
+ * не разделяют кэш-линий.
+ */
+class ServerLatency {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  /// Максимальное количество запросов сервера, ожидающих ответа; при переполнении самые
+  /// старые запросы считаются потерянными.
+  static constexpr std::size_t kMaxOutstanding = 256;
+  /// Время, после которого запрос без ответа считается потерянным.
+  static constexpr auto kReplyTimeout = std::chrono::seconds(1);
+
+  ServerLatency(std::size_t server_count, std::chrono::milliseconds decay_time);
+
+  [[nodiscard]] std::size_t GetServerCount() const;
+  /**
+   * \brief Учесть отправку запроса серверу.
+   */
+  void OnSent(std::size_t server_index, Clock::time_point now);
+  /**
+   * \brief Учесть ответ сервера и измерить задержку ответа на самый старый ожидающий запрос.
+   */
+  void OnReply(std::size_t server_index, Clock::time_point now);
+  /**
+   * \brief Стоимость выбора сервера: оценка задержки, затухающая со времени последнего
+   * ответа, умноженная на количество ожидающих ответа запросов с учетом нового.
+   *
+   * Сервер без измерений с ожидающими ответа запросами получает наибольшую стоимость, а сервер
+   * без измерений и запросов - нулевую, чтобы его задержка была измерена.
+   */
+  [[nodiscard]] double GetCost(std::size_t server_index, Clock::time_point now) const;
+  /**
+   * \brief Текущая оценка задержки ответа сервера без затухания.
+   */
+  [[nodiscard]] std::chrono::nanoseconds GetLatency(std::size_t server_index) const;
+  /**
+   * \brief Количество запросов сервера, ожидающих ответа.
+   */
+  [[nodiscard]] std::uint64_t GetOutstanding(std::size_t server_index) const;
+
+ private:
+  /// Стоимость сервера без измерений с ожидающими ответа запросами.
+  static constexpr double kUnmeasuredPenalty = 1e15;
+
+  struct alignas(kCacheLineSize) Stats {
+    /// Количество отправленных запросов, изменяется потоками отправки.
+    std::atomic<std::uint64_t> sent = 0;
+    /// Количество завершенных ответом или потерянных запросов.
+    alignas(kCacheLineSize) std::atomic<std::uint64_t> completed = 0;
+    /// Оценка задержки в наносекундах.
+    std::atomic<double> latency = 0;
+    /// Время последнего изменения оценки в наносекундах от начала отсчета Clock.
+    std::atomic<std::int64_t> updated = 0;
+    /// Время отправки запросов по номеру запроса по модулю kMaxOutstanding.
+    alignas(kCacheLineSize) std::array<std::atomic<std::int64_t>, kMaxOutstanding> sent_at{};
+  };
+
+  const double decay_time_;
+  std::vector<Stats> stats_;
+
+  /**
+   * \brief Оценка задержки, затухшая к указанному моменту без новых измерений.
+   */
+  [[nodiscard]] double Decay(double latency, std::int64_t updated, std::int64_t now) const;
+  void Observe(Stats &stats, double sample, std::int64_t now) const;
+  static std::int64_t ToNanoseconds(Clock::time_point time);
+};
+
+}  // namespace load_balancer::balancing
+
+#endif  // SERVER_LATENCY_H
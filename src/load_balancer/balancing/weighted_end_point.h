@@ -0,0 +1,26 @@
+#ifndef WEIGHTED_END_POINT_H
+#define WEIGHTED_END_POINT_H
+
+#include <cstddef>
+
+namespace load_balancer::balancing {
+
+/**
+ * \brief Конечная точка сервера вместе с его весом.
+ *
+ * Вес задает долю запросов, приходящуюся на сервер, относительно остальных серверов.
+ */
+template <typename EndPoint>
+struct WeightedEndPoint {
+  /// Вес сервера по умолчанию.
+  static constexpr std::size_t kDefaultWeight = 1;
+
+  EndPoint end_point;
+  std::size_t weight = kDefaultWeight;
+
+  bool operator==(const WeightedEndPoint &other) const = default;
+};
+
+}  // namespace load_balancer::balancing
+
+#endif  // WEIGHTED_END_POINT_H
@@ -0,0 +1,75 @@
+#include "weighted_round_robin_strategy.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace load_balancer::balancing {
+
+WeightedRoundRobinStrategy::WeightedRoundRobinStrategy(const std::vector<std::size_t> &weights)
+    : period_(BuildPeriod(weights)) {
+}
+
+std::size_t WeightedRoundRobinStrategy::SelectServer(
+    [[maybe_unused]] const std::size_t client_hash
+) {
+  return period_[next_position_.fetch_add(1, std::memory_order_relaxed) % period_.size()];
+}
+
+void WeightedRoundRobinStrategy::SelectServers(
+    [[maybe_unused]] const std::span<const std::size_t> client_hashes,
+    const std::span<std::size_t> server_indexes
+) {
+  const auto first =
+      next_position_.fetch_add(server_indexes.size(), std::memory_order_relaxed) % period_.size();
+  for (std::size_t i = 0; i < server_indexes.size(); ++i) {
+    server_indexes[i] = period_[(first + i) % period_.size()];
+  }
+}
+
+std::vector<std::uint32_t> WeightedRoundRobinStrategy::BuildPeriod(std::vector<std::size_t> weights
+) {
+  for (auto &weight : weights) {
+    weight = std::max<std::size_t>(weight, 1);
+  }
+  const auto gcd = std::reduce(weights.begin(), weights.end(), std::size_t{0}, [](auto a, auto b) {
+    return std::gcd(a, b);
+  });
+  auto total_weight = std::size_t{0};
+  for (auto &weight : weights) {
+    weight /= gcd;
+    total_weight += weight;
+  }
+  if (total_weight > kMaxPeriodLength) {
+    const auto original_total_weight = total_weight;
+    total_weight = 0;
+    for (auto &weight : weights) {
+      weight = std::max<std::size_t>(
+          static_cast<std::size_t>(
+              static_cast<double>(weight) * kMaxPeriodLength / original_total_weight
+          ),
+          1
+      );
+      total_weight += weight;
+    }
+  }
+
+  // Алгоритм nginx: на каждом шаге текущие веса увеличиваются на исходные, выбирается сервер с
+  // наибольшим текущим весом, и его текущий вес уменьшается на сумму весов.
+  std::vector<std::uint32_t> period;
+  period.reserve(total_weight);
+  std::vector<std::int64_t> current_weights(weights.size(), 0);
+  for (std::size_t step = 0; step < total_weight; ++step) {
+    std::size_t selected = 0;
+    for (std::size_t i = 0; i < weights.size(); ++i) {
+      current_weights[i] += static_cast<std::int64_t>(weights[i]);
+      if (current_weights[i] > current_weights[selected]) {
+        selected = i;
+      }
+    }
+    current_weights[selected] -= static_cast<std::int64_t>(total_weight);
+    period.push_back(static_cast<std::uint32_t>(selected));
+  }
+  return period;
+}
+
+}  // namespace load_balancer::balancing
@@ -0,0 +1,40 @@
+#ifndef WEIGHTED_ROUND_ROBIN_STRATEGY_H
+#define WEIGHTED_ROUND_ROBIN_STRATEGY_H
+
+#include <atomic>
+#include <cstdint>
+
+#include "balancing_strategy.h"
+
+namespace load_balancer::balancing {
+
+/**
+ * \brief Плавный взвешенный Round-robin (smooth weighted round-robin).
+ *
+ * Каждый сервер выбирается пропорционально своему весу, причем выборы одного сервера
+ * равномерно перемежаются выборами остальных. Полный период выбора вычисляется при создании
+ * стратегии, после чего выбор сводится к атомарному продвижению курсора по периоду.
+ */
+class WeightedRoundRobinStrategy : public BalancingStrategy {
+ public:
+  /// Максимальная длина периода выбора, при превышении веса пропорционально уменьшаются.
+  static constexpr std::size_t kMaxPeriodLength = std::size_t{1} << 16;
+
+  explicit WeightedRoundRobinStrategy(const std::vector<std::size_t> &weights);
+
+  std::size_t SelectServer(std::size_t client_hash) override;
+  void SelectServers(
+      std::span<const std::size_t> client_hashes, std::span<std::size_t> server_indexes
+  ) override;
+
+ private:
+  /// Последовательность индексов серверов в течение одного периода.
+  const std::vector<std::uint32_t> period_;
+  std::atomic_size_t next_position_ = 0;
+
+  static std::vector<std::uint32_t> BuildPeriod(std::vector<std::size_t> weights);
+};
+
+}  // namespace load_balancer::balancing
+
+#endif  // WEIGHTED_ROUND_ROBIN_STRATEGY_H
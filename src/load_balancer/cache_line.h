@@ -0,0 +1,13 @@
+#ifndef CACHE_LINE_H
+#define CACHE_LINE_H
+
+#include <cstddef>
+
+namespace load_balancer {
+
+/// Размер кэш-линии, по которому выравниваются данные, изменяемые разными потоками.
+inline constexpr std::size_t kCacheLineSize = 64;
+
+}  // namespace load_balancer
+
+#endif  // CACHE_LINE_H
@@ -0,0 +1,305 @@
+#include "pcap_file.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <format>
+#include <stdexcept>
+
+namespace load_balancer::capture {
+
+namespace {
+
+/// Сигнатура файла pcap с микросекундными метками времени.
+constexpr std::uint32_t kMicrosecondMagic = 0xA1B2C3D4;
+/// Сигнатура файла pcap с наносекундными метками времени.
+constexpr std::uint32_t kNanosecondMagic = 0xA1B23C4D;
+constexpr std::uint16_t kVersionMajor = 2;
+constexpr std::uint16_t kVersionMinor = 4;
+constexpr std::size_t kFileHeaderSize = 24;
+constexpr std::size_t kRecordHeaderSize = 16;
+
+constexpr std::uint32_t kLinkTypeEthernet = 1;
+constexpr std::uint32_t kLinkTypeRaw = 101;
+constexpr std::uint32_t kLinkTypeLinuxSll = 113;
+constexpr std::uint32_t kLinkTypeIpV4 = 228;
+
+constexpr std::size_t kEthernetHeaderSize = 14;
+constexpr std::size_t kVlanTagSize = 4;
+constexpr std::size_t kLinuxSllHeaderSize = 16;
+constexpr std::uint16_t kEtherTypeIpV4 = 0x0800;
+constexpr std::uint16_t kEtherTypeVlan = 0x8100;
+
+constexpr std::size_t kIpV4HeaderSize = 20;
+constexpr std::size_t kUdpHeaderSize = 8;
+constexpr std::uint8_t kIpV4VersionIhl = 0x45;
+constexpr std::uint8_t kTtl = 64;
+constexpr std::uint8_t kProtocolUdp = 17;
+/// Маска флага MF и смещения фрагмента в заголовке IPv4.
+constexpr std::uint16_t kFragmentMask = 0x3FFF;
+
+void PutUint16(char *dest, const std::uint16_t value) {
+  std::memcpy(dest, &value, sizeof(value));
+}
+
+void PutUint32(char *dest, const std::uint32_t value) {
+  std::memcpy(dest, &value, sizeof(value));
+}
+
+/**
+ * \brief Записать число в сетевом порядке байтов.
+ */
+void PutNetUint16(char *dest, const std::uint16_t value) {
+  dest[0] = static_cast<char>(value >> 8);
+  dest[1] = static_cast<char>(value & 0xFF);
+}
+
+void PutNetUint32(char *dest, const std::uint32_t value) {
+  PutNetUint16(dest, static_cast<std::uint16_t>(value >> 16));
+  PutNetUint16(dest + 2, static_cast<std::uint16_t>(value & 0xFFFF));
+}
+
+std::uint16_t GetNetUint16(const char *src) {
+  return static_cast<std::uint16_t>(
+      (static_cast<std::uint8_t>(src[0]) << 8) | static_cast<std::uint8_t>(src[1])
+  );
+}
+
+std::uint32_t GetNetUint32(const char *src) {
+  return (static_cast<std::uint32_t>(GetNetUint16(src)) << 16) | GetNetUint16(src + 2);
+}
+
+/**
+ * \brief Изменить порядок байтов числа (std::byteswap доступен только с C++23).
+ */
+std::uint32_t ByteSwap(const std::uint32_t value) {
+  return __builtin_bswap32(value);
+}
+
+/**
+ * \brief Контрольная сумма заголовка IPv4 (RFC 1071).
+ */
+std::uint16_t IpChecksum(const std::span<const char> header) {
+  std::uint32_t sum = 0;
+  for (std::size_t i = 0; i + 1 < header.size(); i += 2) {
+    sum += GetNetUint16(header.data() + i);
+  }
+  while (sum >> 16 != 0) {
+    sum = (sum & 0xFFFF) + (sum >> 16);
+  }
+  return static_cast<std::uint16_t>(~sum);
+}
+
+}  // namespace
+
+PcapWriter::PcapWriter(const std::string &file_name, const std::size_t snap_length)
+    : file_(file_name, std::ios::binary | std::ios::trunc),
+      snap_length_(snap_length),
+      record_(kRecordHeaderSize + kIpV4HeaderSize + kUdpHeaderSize + snap_length) {
+  if (!file_) {
+    throw std::runtime_error(
+        std::format("Can't open capture file '{}': {}", file_name, std::strerror(errno))
+    );
+  }
+  std::array<char, kFileHeaderSize> header{};
+  PutUint32(header.data(), kNanosecondMagic);
+  PutUint16(header.data() + 4, kVersionMajor);
+  PutUint16(header.data() + 6, kVersionMinor);
+  PutUint32(
+      header.data() + 16,
+      static_cast<std::uint32_t>(kIpV4HeaderSize + kUdpHeaderSize + snap_length)
+  );
+  PutUint32(header.data() + 20, kLinkTypeRaw);
+  file_.write(header.data(), header.size());
+}
+
+void PcapWriter::Write(
+    const std::chrono::nanoseconds timestamp,
+    const PacketAddress &source,
+    const PacketAddress &destination,
+    std::span<const char> payload,
+    const std::size_t original_size
+) {
+  payload = payload.first(std::min(payload.size(), snap_length_));
+  constexpr auto kHeadersSize = kIpV4HeaderSize + kUdpHeaderSize;
+  const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(timestamp);
+  char *const record = record_.data();
+  PutUint32(record, static_cast<std::uint32_t>(seconds.count()));
+  PutUint32(record + 4, static_cast<std::uint32_t>((timestamp - seconds).count()));
+  PutUint32(record + 8, static_cast<std::uint32_t>(kHeadersSize + payload.size()));
+  PutUint32(record + 12, static_cast<std::uint32_t>(kHeadersSize + original_size));
+
+  char *const ip = record + kRecordHeaderSize;
+  std::memset(ip, 0, kHeadersSize);
+  ip[0] = static_cast<char>(kIpV4VersionIhl);
+  PutNetUint16(ip + 2, static_cast<std::uint16_t>(kHeadersSize + original_size));
+  ip[8] = static_cast<char>(kTtl);
+  ip[9] = static_cast<char>(kProtocolUdp);
+  PutNetUint32(ip + 12, source.address);
+  PutNetUint32(ip + 16, destination.address);
+  PutNetUint16(ip + 10, IpChecksum({ip, kIpV4HeaderSize}));
+
+  // Контрольная сумма UDP не вычисляется: нулевое значение допустимо для IPv4.
+  char *const udp = ip + kIpV4HeaderSize;
+  PutNetUint16(udp, source.port);
+  PutNetUint16(udp + 2, destination.port);
+  PutNetUint16(udp + 4, static_cast<std::uint16_t>(kUdpHeaderSize + original_size));
+
+  std::memcpy(udp + kUdpHeaderSize, payload.data(), payload.size());
+  const auto record_size = kRecordHeaderSize + kHeadersSize + payload.size();
+  file_.write(record, static_cast<std::streamsize>(record_size));
+}
+
+void PcapWriter::Flush() {
+  file_.flush();
+}
+
+PcapReader::PcapReader(const std::string &file_name) {
+  const int fd = open(file_name.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    throw std::runtime_error(
+        std::format("Can't open capture file '{}': {}", file_name, std::strerror(errno))
+    );
+  }
+  struct stat file_stat {};
+  if (fstat(fd, &file_stat) != 0 || file_stat.st_size < static_cast<off_t>(kFileHeaderSize)) {
+    close(fd);
+    throw std::runtime_error(std::format("'{}' is not a pcap file", file_name));
+  }
+  size_ = static_cast<std::size_t>(file_stat.st_size);
+  void *data = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    throw std::runtime_error(
+        std::format("Can't map capture file '{}': {}", file_name, std::strerror(errno))
+    );
+  }
+  data_ = static_cast<char *>(data);
+  madvise(data_, size_, MADV_SEQUENTIAL);
+
+  std::uint32_t magic = 0;
+  std::memcpy(&magic, data_, sizeof(magic));
+  if (magic == kMicrosecondMagic || magic == kNanosecondMagic) {
+    swapped_ = false;
+  } else if (ByteSwap(magic) == kMicrosecondMagic || ByteSwap(magic) == kNanosecondMagic) {
+    swapped_ = true;
+    magic = ByteSwap(magic);
+  } else {
+    munmap(data_, size_);
+    throw std::runtime_error(std::format("'{}' is not a pcap file", file_name));
+  }
+  nanoseconds_ = magic == kNanosecondMagic;
+  link_type_ = ReadHeaderField(20) & 0xFFFF;
+  if (link_type_ != kLinkTypeEthernet && link_type_ != kLinkTypeRaw &&
+      link_type_ != kLinkTypeLinuxSll && link_type_ != kLinkTypeIpV4) {
+    munmap(data_, size_);
+    throw std::runtime_error(
+        std::format("Unsupported link type {} of capture file '{}'", link_type_, file_name)
+    );
+  }
+  Rewind();
+}
+
+PcapReader::~PcapReader() {
+  munmap(data_, size_);
+}
+
+std::optional<PcapPacket> PcapReader::Next() {
+  while (offset_ + kRecordHeaderSize <= size_) {
+    const auto seconds = ReadHeaderField(offset_);
+    const auto fraction = ReadHeaderField(offset_ + 4);
+    const auto captured = ReadHeaderField(offset_ + 8);
+    const auto frame_offset = offset_ + kRecordHeaderSize;
+    if (captured > size_ - frame_offset) {
+      return std::nullopt;
+    }
+    offset_ = frame_offset + captured;
+    PcapPacket packet;
+    packet.timestamp = std::chrono::seconds(seconds) +
+                       (nanoseconds_ ? std::chrono::nanoseconds(fraction)
+                                     : std::chrono::microseconds(fraction));
+    if (ParseFrame({data_ + frame_offset, captured}, packet)) {
+      return packet;
+    }
+    ++skipped_;
+  }
+  return std::nullopt;
+}
+
+void PcapReader::Rewind() {
+  offset_ = kFileHeaderSize;
+  skipped_ = 0;
+}
+
+std::size_t PcapReader::GetSkipped() const {
+  return skipped_;
+}
+
+std::uint32_t PcapReader::ReadHeaderField(const std::size_t offset) const {
+  std::uint32_t value = 0;
+  std::memcpy(&value, data_ + offset, sizeof(value));
+  return swapped_ ? ByteSwap(value) : value;
+}
+
+std::optional<std::size_t> PcapReader::GetNetworkOffset(const std::span<const char> frame) const {
+  switch (link_type_) {
+    case kLinkTypeEthernet: {
+      if (frame.size() < kEthernetHeaderSize) {
+        return std::nullopt;
+      }
+      auto ether_type = GetNetUint16(frame.data() + 12);
+      std::size_t offset = kEthernetHeaderSize;
+      if (ether_type == kEtherTypeVlan && frame.size() >= kEthernetHeaderSize + kVlanTagSize) {
+        ether_type = GetNetUint16(frame.data() + 16);
+        offset += kVlanTagSize;
+      }
+      return ether_type == kEtherTypeIpV4 ? std::optional(offset) : std::nullopt;
+    }
+    case kLinkTypeLinuxSll:
+      if (frame.size() < kLinuxSllHeaderSize ||
+          GetNetUint16(frame.data() + 14) != kEtherTypeIpV4) {
+        return std::nullopt;
+      }
+      return kLinuxSllHeaderSize;
+    default:
+      return 0;
+  }
+}
+
+bool PcapReader::ParseFrame(const std::span<char> frame, PcapPacket &packet) const {
+  const auto network_offset = GetNetworkOffset(frame);
+  if (!network_offset) {
+    return false;
+  }
+  const auto ip = frame.subspan(*network_offset);
+  if (ip.size() < kIpV4HeaderSize || (static_cast<std::uint8_t>(ip[0]) >> 4) != 4) {
+    return false;
+  }
+  const auto header_size = static_cast<std::size_t>(ip[0] & 0x0F) * 4;
+  if (header_size < kIpV4HeaderSize || ip.size() < header_size + kUdpHeaderSize ||
+      static_cast<std::uint8_t>(ip[9]) != kProtocolUdp ||
+      (GetNetUint16(ip.data() + 6) & kFragmentMask) != 0) {
+    return false;
+  }
+  const auto udp = ip.subspan(header_size);
+  const std::size_t udp_length = GetNetUint16(udp.data() + 4);
+  if (udp_length < kUdpHeaderSize) {
+    return false;
+  }
+  packet.source = {.address = GetNetUint32(ip.data() + 12), .port = GetNetUint16(udp.data())};
+  packet.destination = {
+      .address = GetNetUint32(ip.data() + 16), .port = GetNetUint16(udp.data() + 2)
+  };
+  packet.original_size = udp_length - kUdpHeaderSize;
+  packet.payload =
+      udp.subspan(kUdpHeaderSize, std::min(udp.size() - kUdpHeaderSize, packet.original_size));
+  return true;
+}
+
+}  // namespace load_balancer::capture
@@ -0,0 +1,145 @@
+#ifndef PCAP_FILE_H
+#define PCAP_FILE_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace load_balancer::capture {
+
+/**
+ * \brief IPv4-адрес и порт UDP в порядке байтов узла.
+ */
+struct PacketAddress {
+  std::uint32_t address = 0;
+  std::uint16_t port = 0;
+
+  bool operator==(const PacketAddress &other) const = default;
+};
+
+/**
+ * \brief UDP-датаграмма, прочитанная из файла pcap.
+ */
+struct PcapPacket {
+  /// Время захвата от начала эпохи Unix.
+  std::chrono::nanoseconds timestamp{0};
+  PacketAddress source;
+  PacketAddress destination;
+  /// Сохраненная часть датаграммы в отображении файла.
+  std::span<char> payload;
+  /// Размер датаграммы до обрезки при захвате.
+  std::size_t original_size = 0;
+};
+
+/**
+ * \brief Запись UDP-датаграмм в файл pcap.
+ *
+ * Пишется формат pcap с наносекундными метками времени и типом канального уровня
+ * LINKTYPE_RAW: перед каждой датаграммой формируются заголовки IPv4 и UDP, поэтому файл
+ * открывается tcpdump и Wireshark. Записи буферизуются и сбрасываются на диск @link Flush
+ * @endlink.
+ */
+class PcapWriter {
+ public:
+  /**
+   * \param file_name путь к файлу, существующий файл перезаписывается;
+   * \param snap_length максимальный сохраняемый размер датаграммы.
+   * \throws std::runtime_error не удалось открыть файл.
+   */
+  PcapWriter(const std::string &file_name, std::size_t snap_length);
+
+  PcapWriter(const PcapWriter &other) = delete;
+  PcapWriter &operator=(const PcapWriter &other) = delete;
+
+  /**
+   * \brief Записать датаграмму.
+   * \param timestamp время захвата от начала эпохи Unix;
+   * \param payload сохраняемая часть датаграммы, не длиннее @link snap_length @endlink;
+   * \param original_size размер датаграммы до обрезки.
+   */
+  void Write(
+      std::chrono::nanoseconds timestamp,
+      const PacketAddress &source,
+      const PacketAddress &destination,
+      std::span<const char> payload,
+      std::size_t original_size
+  );
+  /**
+   * \brief Сбросить буферизованные записи на диск.
+   */
+  void Flush();
+
+ private:
+  std::ofstream file_;
+  const std::size_t snap_length_;
+  std::vector<char> record_;
+};
+
+/**
+ * \brief Чтение UDP-датаграмм из файла pcap, отображенного в память.
+ *
+ * Поддерживаются микро- и наносекундные метки времени в любом порядке байтов и типы
+ * канального уровня Ethernet (в том числе с одной меткой VLAN), Linux cooked capture,
+ * LINKTYPE_RAW и LINKTYPE_IPV4, то есть файлы этого балансировщика и tcpdump. Пакеты, не
+ * являющиеся UDP-датаграммами IPv4, а также фрагменты пропускаются.
+ *
+ * Отображение закрытое и доступно для записи, поэтому датаграммы передаются отправке без
+ * копирования, а файл не изменяется.
+ */
+class PcapReader {
+ public:
+  /**
+   * \throws std::runtime_error не удалось отобразить файл, файл не является файлом pcap или
+   * тип канального уровня не поддерживается.
+   */
+  explicit PcapReader(const std::string &file_name);
+
+  PcapReader(const PcapReader &other) = delete;
+  PcapReader &operator=(const PcapReader &other) = delete;
+
+  ~PcapReader();
+
+  /**
+   * \brief Следующая UDP-датаграмма файла.
+   * \return std::nullopt - файл прочитан до конца либо последняя запись обрезана.
+   */
+  std::optional<PcapPacket> Next();
+  /**
+   * \brief Прочитать файл сначала.
+   */
+  void Rewind();
+  /**
+   * \brief Количество пропущенных пакетов, не являющихся UDP-датаграммами IPv4.
+   */
+  [[nodiscard]] std::size_t GetSkipped() const;
+
+ private:
+  char *data_ = nullptr;
+  std::size_t size_ = 0;
+  std::size_t offset_ = 0;
+  bool swapped_ = false;
+  bool nanoseconds_ = false;
+  std::uint32_t link_type_ = 0;
+  std::size_t skipped_ = 0;
+
+  [[nodiscard]] std::uint32_t ReadHeaderField(std::size_t offset) const;
+  /**
+   * \brief Смещение заголовка IPv4 в кадре канального уровня.
+   * \return std::nullopt - кадр не содержит IPv4.
+   */
+  [[nodiscard]] std::optional<std::size_t> GetNetworkOffset(std::span<const char> frame) const;
+  /**
+   * \brief Разобрать заголовки IPv4 и UDP кадра.
+   * \return false - кадр не является UDP-датаграммой IPv4 или является фрагментом.
+   */
+  bool ParseFrame(std::span<char> frame, PcapPacket &packet) const;
+};
+
+}  // namespace load_balancer::capture
+
+#endif  // PCAP_FILE_H
@@ -0,0 +1,115 @@
+#include "traffic_capture.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+namespace load_balancer::capture {
+
+TrafficCapture::TrafficCapture(
+    const std::string &file_name, const std::size_t capacity, const std::size_t snap_length
+)
+    : snap_length_(snap_length),
+      mask_(std::bit_ceil(std::max<std::size_t>(capacity, 1)) - 1),
+      slots_(mask_ + 1),
+      data_((mask_ + 1) * snap_length),
+      writer_(file_name, snap_length) {
+  for (std::size_t i = 0; i < slots_.size(); ++i) {
+    slots_[i].sequence.store(i, std::memory_order_relaxed);
+  }
+}
+
+TrafficCapture::~TrafficCapture() {
+  Stop();
+}
+
+void TrafficCapture::Start() {
+  thread_ = std::jthread([this](const std::stop_token &stop_token) {
+    Writer(stop_token);
+  });
+}
+
+void TrafficCapture::Stop() {
+  thread_ = {};
+}
+
+bool TrafficCapture::Capture(
+    const std::span<const char> datagram,
+    const PacketAddress &source,
+    const PacketAddress &destination
+) {
+  auto position = head_.load(std::memory_order_relaxed);
+  Slot *slot = nullptr;
+  while (true) {
+    slot = &slots_[position & mask_];
+    const auto sequence = slot->sequence.load(std::memory_order_acquire);
+    const auto difference =
+        static_cast<std::int64_t>(sequence) - static_cast<std::int64_t>(position);
+    if (difference == 0) {
+      if (head_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (difference < 0) {
+      // Слот еще не записан в файл: буфер заполнен.
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    } else {
+      position = head_.load(std::memory_order_relaxed);
+    }
+  }
+  const auto size = std::min(datagram.size(), snap_length_);
+  std::memcpy(data_.data() + (position & mask_) * snap_length_, datagram.data(), size);
+  slot->timestamp = Clock::now().time_since_epoch();
+  slot->source = source;
+  slot->destination = destination;
+  slot->size = static_cast<std::uint32_t>(datagram.size());
+  slot->sequence.store(position + 1, std::memory_order_release);
+  return true;
+}
+
+std::uint64_t TrafficCapture::GetWritten() const {
+  return written_.load(std::memory_order_relaxed);
+}
+
+std::uint64_t TrafficCapture::GetDropped() const {
+  return dropped_.load(std::memory_order_relaxed);
+}
+
+void TrafficCapture::Writer(const std::stop_token &stop_token) {
+  while (!stop_token.stop_requested()) {
+    if (Drain() > 0) {
+      continue;
+    }
+    writer_.Flush();
+    std::unique_lock lock(flush_mutex_);
+    flush_elapsed_.wait_for(lock, stop_token, kFlushPeriod, [] { return false; });
+  }
+  // Датаграммы, захваченные до остановки потоков обработки, записываются полностью.
+  Drain();
+  writer_.Flush();
+}
+
+std::size_t TrafficCapture::Drain() {
+  std::size_t count = 0;
+  while (true) {
+    auto &slot = slots_[tail_ & mask_];
+    if (slot.sequence.load(std::memory_order_acquire) != tail_ + 1) {
+      break;
+    }
+    const auto size = std::min<std::size_t>(slot.size, snap_length_);
+    writer_.Write(
+        slot.timestamp,
+        slot.source,
+        slot.destination,
+        {data_.data() + (tail_ & mask_) * snap_length_, size},
+        slot.size
+    );
+    slot.sequence.store(tail_ + mask_ + 1, std::memory_order_release);
+    ++tail_;
+    ++count;
+  }
+  written_.fetch_add(count, std::memory_order_relaxed);
+  return count;
+}
+
+}  // namespace load_balancer::capture
@@ -0,0 +1,146 @@
+#ifndef TRAFFIC_CAPTURE_H
+#define TRAFFIC_CAPTURE_H
+
+#include <netinet/in.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cache_line.h"
+#include "pcap_file.h"
+
+namespace load_balancer::capture {
+
+/**
+ * \brief Захват принятых датаграмм в файл pcap без блокировки потоков обработки.
+ *
+ * Потоки обработки копируют датаграмму в свободный слот кольцевого буфера фиксированного
+ * размера (очередь Вьюкова: один CAS позиции записи и сохранение номера слота), а отдельный
+ * поток записывает заполненные слоты в файл. Если буфер заполнен, датаграмма не
+ * захватывается, поэтому медленный диск не задерживает обработку запросов.
+ */
+class TrafficCapture {
+ public:
+  using Clock = std::chrono::system_clock;
+
+  /// Период сброса записанных датаграмм на диск, пока буфер пуст.
+  static constexpr auto kFlushPeriod = std::chrono::milliseconds(10);
+
+  /**
+   * \param file_name путь к файлу pcap, существующий файл перезаписывается;
+   * \param capacity количество слотов буфера, округляется вверх до степени двойки;
+   * \param snap_length максимальный сохраняемый размер датаграммы.
+   * \throws std::runtime_error не удалось открыть файл.
+   */
+  TrafficCapture(const std::string &file_name, std::size_t capacity, std::size_t snap_length);
+
+  TrafficCapture(const TrafficCapture &other) = delete;
+  TrafficCapture &operator=(const TrafficCapture &other) = delete;
+
+  ~TrafficCapture();
+
+  /**
+   * \brief Запустить поток записи.
+   */
+  void Start();
+  /**
+   * \brief Записать захваченные датаграммы, сбросить файл на диск и остановить поток записи.
+   */
+  void Stop();
+
+  /**
+   * \brief Захватить принятую датаграмму.
+   * \return false - буфер заполнен, датаграмма не захвачена.
+   */
+  bool Capture(
+      std::span<const char> datagram, const PacketAddress &source, const PacketAddress &destination
+  );
+  /**
+   * \brief Захватить принятую датаграмму с адресами конечных точек сокетов.
+   * \return false - буфер заполнен, датаграмма не захвачена.
+   */
+  template <typename EndPoint>
+  bool Capture(
+      std::span<const char> datagram, const EndPoint &source, const EndPoint &destination
+  );
+
+  /**
+   * \brief Количество датаграмм, записанных в файл.
+   */
+  [[nodiscard]] std::uint64_t GetWritten() const;
+  /**
+   * \brief Количество датаграмм, не захваченных из-за заполненного буфера.
+   */
+  [[nodiscard]] std::uint64_t GetDropped() const;
+
+  /**
+   * \brief IPv4-адрес и порт конечной точки, для других семейств адресов - нулевой адрес.
+   */
+  template <typename EndPoint>
+  [[nodiscard]] static PacketAddress ToPacketAddress(const EndPoint &end_point);
+
+ private:
+  /**
+   * \brief Заголовок слота; датаграмма слота хранится в @link data_ @endlink.
+   */
+  struct alignas(kCacheLineSize) Slot {
+    /// Позиция, которую слот ожидает: равна позиции записи, если слот свободен, и позиции
+    /// записи + 1, если заполнен.
+    std::atomic<std::uint64_t> sequence = 0;
+    std::chrono::nanoseconds timestamp{0};
+    PacketAddress source;
+    PacketAddress destination;
+    std::uint32_t size = 0;
+  };
+
+  const std::size_t snap_length_;
+  const std::uint64_t mask_;
+  std::vector<Slot> slots_;
+  std::vector<char> data_;
+  alignas(kCacheLineSize) std::atomic<std::uint64_t> head_ = 0;
+  alignas(kCacheLineSize) std::atomic<std::uint64_t> dropped_ = 0;
+  /// Позиция чтения, изменяется только потоком записи.
+  std::uint64_t tail_ = 0;
+  std::atomic<std::uint64_t> written_ = 0;
+  PcapWriter writer_;
+  std::mutex flush_mutex_;
+  std::condition_variable_any flush_elapsed_;
+  std::jthread thread_;
+
+  void Writer(const std::stop_token &stop_token);
+  /**
+   * \brief Записать в файл все заполненные слоты.
+   * \return количество записанных датаграмм.
+   */
+  std::size_t Drain();
+};
+
+template <typename EndPoint>
+bool TrafficCapture::Capture(
+    const std::span<const char> datagram, const EndPoint &source, const EndPoint &destination
+) {
+  return Capture(datagram, ToPacketAddress(source), ToPacketAddress(destination));
+}
+
+template <typename EndPoint>
+PacketAddress TrafficCapture::ToPacketAddress(const EndPoint &end_point) {
+  const auto *address = end_point.GetAddressImpl();
+  if (address->sa_family != AF_INET) {
+    return {.address = 0, .port = end_point.GetPort()};
+  }
+  return {
+      .address = ntohl(reinterpret_cast<const sockaddr_in *>(address)->sin_addr.s_addr),
+      .port = end_point.GetPort(),
+  };
+}
+
+}  // namespace load_balancer::capture
+
+#endif  // TRAFFIC_CAPTURE_H
@@ -0,0 +1,158 @@
+#include "rate_share_gossip.h"
+
+#include <poll.h>
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <format>
+#include <numeric>
+
+#include "invalid_socket_exception.h"
+
+namespace load_balancer::cluster {
+
+namespace {
+
+/// Максимальный размер сообщения обмена.
+constexpr std::size_t kMaxMessageSize = 128;
+
+/**
+ * \brief Прочитать число до пробела или конца строки и пропустить пробел.
+ */
+bool ParseNumber(std::string_view &str, std::uint64_t &value) {
+  const auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), value);
+  if (ec != std::errc() || ptr == str.data()) {
+    return false;
+  }
+  str.remove_prefix(ptr - str.data());
+  if (!str.empty() && str.front() == ' ') {
+    str.remove_prefix(1);
+  }
+  return true;
+}
+
+}  // namespace
+
+RateShareGossip::RateShareGossip(
+    const std::uint16_t port,
+    std::vector<EndPointType> peers,
+    const std::chrono::milliseconds period,
+    LoadCounter load,
+    ShareHandler on_share
+)
+    : period_(period), load_(std::move(load)), on_share_(std::move(on_share)), socket_(port) {
+  for (auto &peer : peers) {
+    peers_.push_back({.end_point = std::move(peer), .rate = 0, .last_seen = {}});
+  }
+}
+
+RateShareGossip::~RateShareGossip() {
+  Stop();
+}
+
+void RateShareGossip::Start() {
+  last_load_ = load_();
+  last_period_ = Clock::now();
+  // До первых сообщений узлы считаются доступными и не нагруженными.
+  for (auto &peer : peers_) {
+    peer.last_seen = last_period_;
+  }
+  thread_ = std::jthread([this](const std::stop_token &stop_token) {
+    Worker(stop_token);
+  });
+}
+
+void RateShareGossip::Stop() {
+  thread_ = {};
+}
+
+RateShareGossip::EndPointType RateShareGossip::GetEndPoint() const {
+  return socket_.GetEndPoint();
+}
+
+double RateShareGossip::ComputeShare(
+    const double local_rate, const std::span<const double> peer_rates
+) {
+  const auto node_count = static_cast<double>(peer_rates.size() + 1);
+  const auto total_rate = std::accumulate(peer_rates.begin(), peer_rates.end(), local_rate);
+  if (total_rate <= 0) {
+    return 1 / node_count;
+  }
+  return (1 - kEvenShare) * local_rate / total_rate + kEvenShare / node_count;
+}
+
+void RateShareGossip::Worker(const std::stop_token &stop_token) {
+  while (!stop_token.stop_requested()) {
+    try {
+      const auto now = Clock::now();
+      const auto next_period = last_period_ + period_;
+      if (now >= next_period) {
+        Exchange(now);
+        continue;
+      }
+      pollfd fd = {.fd = socket_.GetNativeHandle(), .events = POLLIN, .revents = 0};
+      const auto timeout = std::chrono::ceil<std::chrono::milliseconds>(next_period - now);
+      if (poll(&fd, 1, static_cast<int>(timeout.count())) > 0) {
+        ReceiveMessage(Clock::now());
+      }
+    } catch ([[maybe_unused]] const socket_wrapper::InvalidSocketException &ex) {
+      return;
+    } catch ([[maybe_unused]] const std::exception &ex) {
+      // Недоступность остановленного узла (ICMP port unreachable) возвращается следующей
+      // операцией с сокетом и не является ошибкой обмена.
+    }
+  }
+}
+
+void RateShareGossip::Exchange(const Clock::time_point now) {
+  const auto load = load_();
+  const auto delta = load - last_load_;
+  const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - last_period_);
+  last_load_ = load;
+  last_period_ = now;
+  if (elapsed.count() > 0) {
+    const auto rate = static_cast<double>(delta) * 1000 / static_cast<double>(elapsed.count());
+    local_rate_ = kSmoothing * rate + (1 - kSmoothing) * local_rate_;
+  }
+
+  const auto message = std::format("{} {} {}", kMessagePrefix, delta, elapsed.count());
+  std::vector<double> peer_rates;
+  for (const auto &peer : peers_) {
+    try {
+      socket_.SendTo(message, peer.end_point);
+    } catch ([[maybe_unused]] const std::exception &ex) {
+      // Сообщение недоступному узлу теряется так же, как потерянная датаграмма.
+    }
+    if (now - peer.last_seen <= kPeerTimeoutPeriods * period_) {
+      peer_rates.push_back(peer.rate);
+    }
+  }
+  on_share_(ComputeShare(local_rate_, peer_rates));
+}
+
+void RateShareGossip::ReceiveMessage(const Clock::time_point now) {
+  std::array<char, kMaxMessageSize> buffer{};
+  const auto [size, sender] = socket_.ReceiveFrom(buffer);
+  const auto peer = std::ranges::find(peers_, sender, &Peer::end_point);
+  if (peer == peers_.end()) {
+    return;
+  }
+  std::string_view message(buffer.data(), size);
+  if (!message.starts_with(kMessagePrefix) || message.size() == kMessagePrefix.size() ||
+      message[kMessagePrefix.size()] != ' ') {
+    return;
+  }
+  message.remove_prefix(kMessagePrefix.size() + 1);
+  std::uint64_t delta = 0;
+  std::uint64_t elapsed_ms = 0;
+  if (!ParseNumber(message, delta) || !ParseNumber(message, elapsed_ms) || !message.empty() ||
+      elapsed_ms == 0) {
+    return;
+  }
+  const auto rate = static_cast<double>(delta) * 1000 / static_cast<double>(elapsed_ms);
+  peer->rate = kSmoothing * rate + (1 - kSmoothing) * peer->rate;
+  peer->last_seen = now;
+}
+
+}  // namespace load_balancer::cluster
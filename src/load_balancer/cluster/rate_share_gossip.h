@@ -0,0 +1,117 @@
+#ifndef RATE_SHARE_GOSSIP_H
+#define RATE_SHARE_GOSSIP_H
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "udp_socket.h"
+
+namespace load_balancer::cluster {
+
+/**
+ * \brief Обмен нагрузкой между экземплярами балансировщика для общего ограничения нагрузки
+ * кластера.
+ *
+ * Каждый узел периодически отправляет всем остальным узлам по UDP прирост своей нагрузки
+ * (количества принятых запросов) с момента предыдущего сообщения и по сообщениям остальных
+ * узлов оценивает их частоту запросов. По частотам вычисляется доля общего ограничения,
+ * приходящаяся на узел: большая часть бюджета распределяется пропорционально нагрузке,
+ * остальное - поровну, чтобы узел без нагрузки мог принять первые запросы. Центральный узел
+ * отсутствует; узел, не приславший сообщений за несколько периодов, считается недоступным, и
+ * его доля распределяется между остальными.
+ */
+class RateShareGossip {
+ public:
+  static constexpr auto ProtoFamily = socket_wrapper::ProtocolFamily::kIpV4;
+  using SocketType = socket_wrapper::udp::UdpSocket<ProtoFamily>;
+  using EndPointType = SocketType::EndPointType;
+  using Clock = std::chrono::steady_clock;
+  /// Текущее значение монотонного счетчика нагрузки узла.
+  using LoadCounter = std::function<std::uint64_t()>;
+  /// Обработчик новой доли общего ограничения, от 0 до 1.
+  using ShareHandler = std::function<void(double share)>;
+
+  /// Доля общего ограничения, распределяемая между доступными узлами поровну.
+  static constexpr double kEvenShare = 0.1;
+  /// Вес нового измерения при сглаживании частоты запросов узла.
+  static constexpr double kSmoothing = 0.5;
+  /// Количество периодов без сообщений, после которого узел считается недоступным.
+  static constexpr std::size_t kPeerTimeoutPeriods = 3;
+  /// Префикс сообщения, отличающий его от посторонних датаграмм.
+  static constexpr std::string_view kMessagePrefix = "lb-rate-share";
+
+  /**
+   * \param port локальный порт обмена;
+   * \param peers конечные точки обмена остальных узлов;
+   * \param period период отправки сообщений и пересчета доли;
+   * \param load счетчик нагрузки узла, вызывается из потока обмена;
+   * \param on_share обработчик доли, вызывается из потока обмена после каждого периода.
+   */
+  RateShareGossip(
+      std::uint16_t port,
+      std::vector<EndPointType> peers,
+      std::chrono::milliseconds period,
+      LoadCounter load,
+      ShareHandler on_share
+  );
+
+  RateShareGossip(const RateShareGossip &other) = delete;
+  RateShareGossip &operator=(const RateShareGossip &other) = delete;
+
+  ~RateShareGossip();
+
+  /**
+   * \brief Запустить обмен.
+   */
+  void Start();
+  /**
+   * \brief Остановить обмен и дождаться завершения его потока.
+   */
+  void Stop();
+  [[nodiscard]] EndPointType GetEndPoint() const;
+
+  /**
+   * \brief Доля общего ограничения, приходящаяся на узел.
+   * \param local_rate частота запросов узла;
+   * \param peer_rates частоты запросов доступных остальных узлов.
+   */
+  [[nodiscard]] static double ComputeShare(double local_rate, std::span<const double> peer_rates);
+
+ private:
+  struct Peer {
+    EndPointType end_point;
+    /// Сглаженная частота запросов в секунду.
+    double rate = 0;
+    Clock::time_point last_seen;
+  };
+
+  const std::chrono::milliseconds period_;
+  const LoadCounter load_;
+  const ShareHandler on_share_;
+  SocketType socket_;
+  std::vector<Peer> peers_;
+  /// Сглаженная частота запросов узла в секунду.
+  double local_rate_ = 0;
+  std::uint64_t last_load_ = 0;
+  Clock::time_point last_period_;
+  std::jthread thread_;
+
+  void Worker(const std::stop_token &stop_token);
+  /**
+   * \brief Отправить прирост нагрузки остальным узлам и пересчитать долю.
+   */
+  void Exchange(Clock::time_point now);
+  /**
+   * \brief Принять сообщение узла и обновить его частоту запросов.
+   */
+  void ReceiveMessage(Clock::time_point now);
+};
+
+}  // namespace load_balancer::cluster
+
+#endif  // RATE_SHARE_GOSSIP_H
@@ -16,6 +16,15 @@ void Configuration::UpdateConfiguration() {
   ReadParamsFromFile();
 }
 
+Configuration::Params Configuration::GetParams() const {
+  std::shared_lock lock(mutex_);
+  return params_;
+}
+
+const std::string &Configuration::GetFileName() const {
+  return file_name_;
+}
+
 void Configuration::ReadParamsFromFile() {
   std::lock_guard lock(mutex_);
   params_.clear();
@@ -38,13 +47,4 @@ void Configuration::ReadParamsFromFile() {
   }
 }
 
-std::optional<std::any> Configuration::FindParam(const std::string &key) {
-  std::shared_lock lock(mutex_);
-  const auto value = params_.find(key);
-  if (value != params_.end()) {
-    return value->second;
-  }
-  return std::nullopt;
-}
-
 }  // namespace load_balancer::config
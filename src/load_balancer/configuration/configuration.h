@@ -2,8 +2,6 @@
 #define CONFIGURATION_H
 
 #include <any>
-#include <functional>
-#include <optional>
 #include <shared_mutex>
 #include <string>
 #include <unordered_map>
@@ -12,9 +10,15 @@ namespace load_balancer::config {
 
 /**
  * \brief Класс, выполняющий чтение конфигурации из файла.
+ *
+ * Значения хранятся без преобразования, типы и проверки значений задаются схемой
+ * (см. @link Schema @endlink).
  */
 class Configuration {
  public:
+  /// Значения свойств по ключам: строки, прочитанные из файла, либо значения типов свойств.
+  using Params = std::unordered_map<std::string, std::any>;
+
   /// Имя файла с конфигурацией по умолчанию.
   static constexpr auto kDefaultFileName = "config.properties";
 
@@ -24,64 +28,30 @@ class Configuration {
   virtual ~Configuration() = default;
 
   /**
-   * \brief Получить значение свойства по ключу.
+   * \brief Получить значения всех свойств.
    */
-  template <typename T>
-  T GetParam(const std::string &key, const T &default_value);
+  [[nodiscard]] Params GetParams() const;
   /**
    * \brief Повторно прочитать значения свойств из файла.
    */
   void UpdateConfiguration();
+  /**
+   * \brief Получить имя файла с конфигурацией.
+   */
+  [[nodiscard]] const std::string &GetFileName() const;
 
  protected:
-  std::shared_mutex mutex_;
+  mutable std::shared_mutex mutex_;
   std::string file_name_;
-  std::unordered_map<std::string, std::any> params_;
+  Params params_;
 
  private:
   /**
    * \brief Прочитать значения параметров из файла.
    */
   void ReadParamsFromFile();
-  /**
-   * \brief Поиск значения параметра.
-   * \return std::nullopt - если параметр с таким ключом не найден.
-   */
-  std::optional<std::any> FindParam(const std::string &key);
 };
 
-/**
- * \brief Преобразователь строки в указанный тип данных.
- * \tparam T целевой тип.
- */
-template <typename T>
-struct StringConverter {
-  using ParsingType = T;
-  std::optional<T> operator()(const std::string &str_value) const;
-};
-
-template <typename T>
-T Configuration::GetParam(const std::string &key, const T &default_value) {
-  auto value = FindParam(key);
-  if (!value) {
-    return default_value;
-  }
-  if (value->type() != typeid(std::string) && value->type() != typeid(T)) {
-    return default_value;
-  }
-  if (value->type() == typeid(T)) {
-    return any_cast<T>(*value);
-  }
-  const auto str_value = any_cast<std::string &>(*value);
-  const auto parsed_value = StringConverter<T>()(str_value);
-  if (parsed_value) {
-    std::lock_guard lock(mutex_);
-    params_[key] = *parsed_value;
-    return std::any_cast<T &>(params_[key]);
-  }
-  return default_value;
-}
-
 }  // namespace load_balancer::config
 
 #endif  // CONFIGURATION_H
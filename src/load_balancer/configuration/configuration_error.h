@@ -0,0 +1,41 @@
+#ifndef CONFIGURATION_ERROR_H
+#define CONFIGURATION_ERROR_H
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace load_balancer::config {
+
+/**
+ * \brief Исключение, перечисляющее все ошибки конфигурации: неизвестные ключи, значения, не
+ * преобразуемые к типу свойства, и значения, не прошедшие проверку.
+ */
+class ConfigurationError : public std::runtime_error {
+ public:
+  explicit ConfigurationError(std::vector<std::string> errors)
+      : std::runtime_error(MakeMessage(errors)), errors_(std::move(errors)) {
+  }
+
+  /**
+   * \brief Ошибки конфигурации, по одной на свойство.
+   */
+  [[nodiscard]] const std::vector<std::string> &GetErrors() const {
+    return errors_;
+  }
+
+ private:
+  std::vector<std::string> errors_;
+
+  static std::string MakeMessage(const std::vector<std::string> &errors) {
+    std::string message = "Invalid configuration";
+    for (std::size_t i = 0; i < errors.size(); ++i) {
+      message += (i == 0 ? ": " : "; ") + errors[i];
+    }
+    return message + ".";
+  }
+};
+
+}  // namespace load_balancer::config
+
+#endif  // CONFIGURATION_ERROR_H
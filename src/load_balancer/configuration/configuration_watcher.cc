@@ -0,0 +1,89 @@
+#include "configuration_watcher.h"
+
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+#include <filesystem>
+#include <iostream>
+#include <system_error>
+
+namespace load_balancer::config {
+
+ConfigurationWatcher::ConfigurationWatcher(
+    const std::string &file_name, std::function<void()> on_change
+)
+    : on_change_(std::move(on_change)) {
+  const std::filesystem::path path(file_name);
+  file_name_ = path.filename().string();
+  const auto directory = path.has_parent_path() ? path.parent_path() : ".";
+  inotify_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (inotify_ < 0) {
+    throw std::system_error(errno, std::generic_category(), "Can't init inotify");
+  }
+  if (inotify_add_watch(inotify_, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE) <
+      0) {
+    const auto error = errno;
+    close(inotify_);
+    throw std::system_error(error, std::generic_category(), "Can't watch " + directory.string());
+  }
+}
+
+ConfigurationWatcher::~ConfigurationWatcher() {
+  Stop();
+  close(inotify_);
+}
+
+void ConfigurationWatcher::Start() {
+  thread_ = std::jthread([this](const std::stop_token &stop_token) {
+    Worker(stop_token);
+  });
+}
+
+void ConfigurationWatcher::Stop() {
+  thread_ = {};
+}
+
+void ConfigurationWatcher::Worker(const std::stop_token &stop_token) {
+  while (!stop_token.stop_requested()) {
+    if (!WaitForEvents(kPollTimeout) || !ReadEvents()) {
+      continue;
+    }
+    // Запись файла может порождать несколько событий подряд.
+    while (WaitForEvents(kSettleTime)) {
+      static_cast<void>(ReadEvents());
+    }
+    try {
+      on_change_();
+    } catch (const std::exception &ex) {
+      std::cerr << "Error while applying configuration: " << ex.what() << ".\n";
+    }
+  }
+}
+
+bool ConfigurationWatcher::ReadEvents() const {
+  alignas(inotify_event) std::array<char, 4096> buffer{};
+  bool changed = false;
+  while (true) {
+    const auto size = read(inotify_, buffer.data(), buffer.size());
+    if (size <= 0) {
+      return changed;
+    }
+    for (auto offset = 0L; offset < size;) {
+      const auto *const event = reinterpret_cast<const inotify_event *>(buffer.data() + offset);
+      if (event->len > 0 && file_name_ == event->name) {
+        changed = true;
+      }
+      offset += static_cast<long>(sizeof(inotify_event) + event->len);
+    }
+  }
+}
+
+bool ConfigurationWatcher::WaitForEvents(const std::chrono::milliseconds timeout) const {
+  pollfd fd = {.fd = inotify_, .events = POLLIN, .revents = 0};
+  return poll(&fd, 1, static_cast<int>(timeout.count())) > 0;
+}
+
+}  // namespace load_balancer::config
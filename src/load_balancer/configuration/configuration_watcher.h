@@ -0,0 +1,67 @@
+#ifndef CONFIGURATION_WATCHER_H
+#define CONFIGURATION_WATCHER_H
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <thread>
+
+namespace load_balancer::config {
+
+/**
+ * \brief Отслеживание изменений файла конфигурации через inotify.
+ *
+ * Отслеживается каталог файла, а не сам файл, поэтому учитывается и запись в файл, и его
+ * замена переименованием, как это делают текстовые редакторы. События, пришедшие в течение
+ * @link kSettleTime @endlink после первого, объединяются в одно изменение.
+ */
+class ConfigurationWatcher {
+ public:
+  /// Максимальное время ожидания событий, после которого проверяется запрос остановки.
+  static constexpr auto kPollTimeout = std::chrono::milliseconds(100);
+  /// Время ожидания завершения записи файла перед сообщением об изменении.
+  static constexpr auto kSettleTime = std::chrono::milliseconds(50);
+
+  /**
+   * \param file_name отслеживаемый файл;
+   * \param on_change функция, вызываемая в потоке отслеживания после изменения файла.
+   * \throws std::system_error не удалось начать отслеживание.
+   */
+  ConfigurationWatcher(const std::string &file_name, std::function<void()> on_change);
+
+  ConfigurationWatcher(const ConfigurationWatcher &other) = delete;
+  ConfigurationWatcher &operator=(const ConfigurationWatcher &other) = delete;
+
+  ~ConfigurationWatcher();
+
+  /**
+   * \brief Запустить отслеживание.
+   */
+  void Start();
+  /**
+   * \brief Остановить отслеживание и дождаться завершения его потока.
+   */
+  void Stop();
+
+ private:
+  const std::function<void()> on_change_;
+  std::string file_name_;
+  int inotify_ = -1;
+  std::jthread thread_;
+
+  void Worker(const std::stop_token &stop_token);
+  /**
+   * \brief Прочитать накопленные события.
+   * \return true - если среди них есть изменение отслеживаемого файла.
+   */
+  [[nodiscard]] bool ReadEvents() const;
+  /**
+   * \brief Дождаться событий не дольше указанного времени.
+   * \return true - если события есть.
+   */
+  [[nodiscard]] bool WaitForEvents(std::chrono::milliseconds timeout) const;
+};
+
+}  // namespace load_balancer::config
+
+#endif  // CONFIGURATION_WATCHER_H
@@ -2,16 +2,31 @@
 #define CONVERTERS_H
 
 #include <charconv>
+#include <chrono>
 #include <optional>
+#include <ranges>
 #include <string>
 #include <type_traits>
 #include <vector>
 
-#include "configuration.h"
+#include "balancing/balancing_strategy.h"
+#include "balancing/weighted_end_point.h"
 #include "end_point.h"
+#include "rate_limiter/rate_limiter.h"
+#include "transport_type.h"
 
 namespace load_balancer::config {
 
+/**
+ * \brief Преобразователь строки в указанный тип данных.
+ * \tparam T целевой тип.
+ */
+template <typename T>
+struct StringConverter {
+  using ParsingType = T;
+  std::optional<T> operator()(const std::string &str_value) const;
+};
+
 /**
  * \brief Преобразователь строки в список значений заданного типа.
  */
@@ -25,10 +40,36 @@ struct StringConverter<std::vector<T>> {
  * \brief Преобразователь строки в указанный числовой тип.
  */
 template <typename Number>
-requires(std::is_arithmetic_v<Number>) struct StringConverter<Number> {
+requires(std::is_arithmetic_v<Number> && !std::is_same_v<Number, bool>)
+struct StringConverter<Number> {
   std::optional<Number> operator()(const std::string &str_value) const;
 };
 
+/**
+ * \brief Преобразователь строки с целым числом в длительность.
+ */
+template <typename Rep, typename Period>
+struct StringConverter<std::chrono::duration<Rep, Period>> {
+  using ParsingType = std::chrono::duration<Rep, Period>;
+  std::optional<ParsingType> operator()(const std::string &str_value) const;
+};
+
+/**
+ * \brief Строковое значение, используемое без преобразования.
+ */
+template <>
+struct StringConverter<std::string> {
+  std::optional<std::string> operator()(const std::string &str_value) const;
+};
+
+/**
+ * \brief Преобразователь строки в логическое значение (true/false, 1/0).
+ */
+template <>
+struct StringConverter<bool> {
+  std::optional<bool> operator()(const std::string &str_value) const;
+};
+
 /**
  * \brief Преобразователь строки в конечную точку.
  */
@@ -38,6 +79,43 @@ struct StringConverter<socket_wrapper::EndPoint<Proto>> {
   std::optional<ParsingType> operator()(const std::string &str_value) const;
 };
 
+/**
+ * \brief Преобразователь строки в конечную точку сервера с необязательным весом.
+ *
+ * Формат: адрес:порт[@вес], например 10.0.0.1:1001@3. Вес должен быть положительным.
+ */
+template <typename EndPoint>
+struct StringConverter<balancing::WeightedEndPoint<EndPoint>> {
+  using ParsingType = balancing::WeightedEndPoint<EndPoint>;
+  std::optional<ParsingType> operator()(const std::string &str_value) const;
+};
+
+/**
+ * \brief Преобразователь строки в тип стратегии выбора сервера (round_robin,
+ * weighted_round_robin, power_of_two_choices, maglev, peak_ewma).
+ */
+template <>
+struct StringConverter<balancing::BalancingStrategyType> {
+  std::optional<balancing::BalancingStrategyType> operator()(const std::string &str_value) const;
+};
+
+/**
+ * \brief Преобразователь строки в тип ограничителя нагрузки (token_bucket, sliding_window).
+ */
+template <>
+struct StringConverter<rate_limiter::RateLimiterType> {
+  std::optional<rate_limiter::RateLimiterType> operator()(const std::string &str_value) const;
+};
+
+/**
+ * \brief Преобразователь строки в способ приема и перенаправления датаграмм (socket, io_uring,
+ * epoll).
+ */
+template <>
+struct StringConverter<TransportType> {
+  std::optional<TransportType> operator()(const std::string &str_value) const;
+};
+
 template <typename T>
 std::optional<typename StringConverter<std::vector<T>>::ParsingType>
 StringConverter<std::vector<T>>::operator()(const std::string &str_value) const {
@@ -54,17 +132,109 @@ StringConverter<std::vector<T>>::operator()(const std::string &str_value) const
 }
 
 template <typename Number>
-requires(std::is_arithmetic_v<Number>)
-    std::optional<Number> StringConverter<Number>::operator()(const std::string &str_value) const {
+requires(std::is_arithmetic_v<Number> && !std::is_same_v<Number, bool>)
+std::optional<Number> StringConverter<Number>::operator()(const std::string &str_value) const {
   Number value;
-  const auto [_, ec] =
-      std::from_chars(str_value.data(), str_value.data() + str_value.size(), value);
-  if (ec == std::errc()) {
+  const auto end = str_value.data() + str_value.size();
+  const auto [ptr, ec] = std::from_chars(str_value.data(), end, value);
+  if (ec == std::errc() && ptr == end) {
     return value;
   }
   return std::nullopt;
 }
 
+template <typename Rep, typename Period>
+std::optional<typename StringConverter<std::chrono::duration<Rep, Period>>::ParsingType>
+StringConverter<std::chrono::duration<Rep, Period>>::operator()(const std::string &str_value
+) const {
+  const auto count = StringConverter<Rep>()(str_value);
+  if (!count) {
+    return std::nullopt;
+  }
+  return ParsingType(*count);
+}
+
+inline std::optional<std::string> StringConverter<std::string>::operator()(
+    const std::string &str_value
+) const {
+  return str_value;
+}
+
+inline std::optional<bool> StringConverter<bool>::operator()(const std::string &str_value) const {
+  if (str_value == "true" || str_value == "1") {
+    return true;
+  }
+  if (str_value == "false" || str_value == "0") {
+    return false;
+  }
+  return std::nullopt;
+}
+
+template <typename EndPoint>
+std::optional<typename StringConverter<balancing::WeightedEndPoint<EndPoint>>::ParsingType>
+StringConverter<balancing::WeightedEndPoint<EndPoint>>::operator()(const std::string &str_value
+) const {
+  const auto divider = str_value.rfind('@');
+  const auto end_point = StringConverter<EndPoint>()(str_value.substr(0, divider));
+  if (!end_point) {
+    return std::nullopt;
+  }
+  if (divider == std::string::npos) {
+    return ParsingType{.end_point = *end_point};
+  }
+  const auto weight = StringConverter<std::size_t>()(str_value.substr(divider + 1));
+  if (!weight || *weight == 0) {
+    return std::nullopt;
+  }
+  return ParsingType{.end_point = *end_point, .weight = *weight};
+}
+
+inline std::optional<balancing::BalancingStrategyType>
+StringConverter<balancing::BalancingStrategyType>::operator()(const std::string &str_value) const {
+  if (str_value == "round_robin") {
+    return balancing::BalancingStrategyType::kRoundRobin;
+  }
+  if (str_value == "weighted_round_robin") {
+    return balancing::BalancingStrategyType::kWeightedRoundRobin;
+  }
+  if (str_value == "power_of_two_choices") {
+    return balancing::BalancingStrategyType::kPowerOfTwoChoices;
+  }
+  if (str_value == "maglev") {
+    return balancing::BalancingStrategyType::kMaglev;
+  }
+  if (str_value == "peak_ewma") {
+    return balancing::BalancingStrategyType::kPeakEwma;
+  }
+  return std::nullopt;
+}
+
+inline std::optional<rate_limiter::RateLimiterType>
+StringConverter<rate_limiter::RateLimiterType>::operator()(const std::string &str_value) const {
+  if (str_value == "token_bucket") {
+    return rate_limiter::RateLimiterType::kTokenBucket;
+  }
+  if (str_value == "sliding_window") {
+    return rate_limiter::RateLimiterType::kSlidingWindow;
+  }
+  return std::nullopt;
+}
+
+inline std::optional<TransportType> StringConverter<TransportType>::operator()(
+    const std::string &str_value
+) const {
+  if (str_value == "socket") {
+    return TransportType::kSocket;
+  }
+  if (str_value == "io_uring") {
+    return TransportType::kIoUring;
+  }
+  if (str_value == "epoll") {
+    return TransportType::kEpoll;
+  }
+  return std::nullopt;
+}
+
 template <typename Proto>
 std::optional<typename StringConverter<socket_wrapper::EndPoint<Proto>>::ParsingType>
 StringConverter<socket_wrapper::EndPoint<Proto>>::operator()(const std::string &str_value) const {
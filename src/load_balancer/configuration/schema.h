@@ -0,0 +1,178 @@
+#ifndef SCHEMA_H
+#define SCHEMA_H
+
+#include <algorithm>
+#include <any>
+#include <format>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include "configuration.h"
+#include "configuration_error.h"
+#include "converters.h"
+
+namespace load_balancer::config {
+
+/**
+ * \brief Описание свойства конфигурации: ключ, поле структуры параметров, в которое
+ * записывается значение, и необязательная проверка значения.
+ *
+ * Тип свойства определяется типом поля, значение по умолчанию - инициализатором поля.
+ *
+ * \tparam Settings структура параметров;
+ * \tparam T тип свойства.
+ */
+template <typename Settings, typename T>
+struct Field {
+  using Validator = bool (*)(const T &value);
+
+  const char *key;
+  T Settings::*member;
+  /// Проверка значения, отсутствует, если допустимо любое значение типа.
+  Validator validator;
+  /// Требование к значению для сообщения об ошибке проверки.
+  const char *requirement;
+
+  constexpr Field(
+      const char *key,
+      T Settings::*member,
+      std::type_identity_t<Validator> validator = nullptr,
+      const char *requirement = nullptr
+  )
+      : key(key), member(member), validator(validator), requirement(requirement) {
+  }
+};
+
+/**
+ * \brief Проверка, что значение не меньше kMin и не больше kMax.
+ */
+template <auto kMin, decltype(kMin) kMax = std::numeric_limits<decltype(kMin)>::max()>
+constexpr bool InRange(const decltype(kMin) &value) {
+  return kMin <= value && value <= kMax;
+}
+
+/**
+ * \brief Проверка, что значение больше значения по умолчанию его типа (нуля).
+ */
+template <typename T>
+constexpr bool IsPositive(const T &value) {
+  return value > T{};
+}
+
+/**
+ * \brief Проверка, что контейнер не пуст.
+ */
+template <typename T>
+bool IsNotEmpty(const T &value) {
+  return !value.empty();
+}
+
+/**
+ * \brief Схема конфигурации, по которой все свойства один раз читаются и проверяются в
+ * структуру параметров.
+ *
+ * После чтения параметры используются как обычные поля структуры, без поиска по ключу,
+ * преобразования типов и блокировок.
+ *
+ * \tparam Settings структура параметров;
+ * \tparam Ts типы свойств.
+ */
+template <typename Settings, typename... Ts>
+class Schema {
+ public:
+  constexpr explicit Schema(Field<Settings, Ts>... fields) : fields_(fields...) {
+  }
+
+  /**
+   * \brief Прочитать и проверить все свойства конфигурации.
+   * \return параметры, отсутствующие свойства имеют значения по умолчанию.
+   * \throws ConfigurationError ошибки всех неизвестных ключей и некорректных значений.
+   */
+  [[nodiscard]] Settings Parse(const Configuration &configuration) const {
+    const auto params = configuration.GetParams();
+    std::vector<std::string> errors;
+    for (const auto &[key, _] : params) {
+      if (!HasKey(key)) {
+        errors.push_back(std::format("unknown key '{}'", key));
+      }
+    }
+    // Порядок ключей в файле не сохраняется, поэтому ошибки упорядочиваются для повторяемости.
+    std::ranges::sort(errors);
+    Settings settings;
+    std::apply(
+        [&params, &settings, &errors](const auto &...field) {
+          (ParseField(field, params, settings, errors), ...);
+        },
+        fields_
+    );
+    if (!errors.empty()) {
+      throw ConfigurationError(std::move(errors));
+    }
+    return settings;
+  }
+
+  /**
+   * \brief Проверить, описано ли свойство с ключом в схеме.
+   */
+  [[nodiscard]] constexpr bool HasKey(const std::string_view key) const {
+    return std::apply(
+        [key](const auto &...field) {
+          return ((key == field.key) || ...);
+        },
+        fields_
+    );
+  }
+
+ private:
+  std::tuple<Field<Settings, Ts>...> fields_;
+
+  /**
+   * \brief Записать значение свойства в параметры, если оно задано и корректно, иначе
+   * добавить ошибку.
+   */
+  template <typename T>
+  static void ParseField(
+      const Field<Settings, T> &field,
+      const Configuration::Params &params,
+      Settings &settings,
+      std::vector<std::string> &errors
+  ) {
+    const auto param = params.find(field.key);
+    if (param == params.end()) {
+      // Значение по умолчанию, не прошедшее проверку, делает свойство обязательным.
+      if (field.validator && !field.validator(settings.*field.member)) {
+        errors.push_back(
+            std::format("key '{}' is missing: value {}", field.key, field.requirement)
+        );
+      }
+      return;
+    }
+    std::optional<T> value;
+    if (const auto *typed_value = std::any_cast<T>(&param->second)) {
+      value = *typed_value;
+    } else if (const auto *str_value = std::any_cast<std::string>(&param->second)) {
+      value = StringConverter<T>()(*str_value);
+      if (!value) {
+        errors.push_back(std::format("key '{}': cannot parse '{}'", field.key, *str_value));
+        return;
+      }
+    } else {
+      errors.push_back(std::format("key '{}': unexpected value type", field.key));
+      return;
+    }
+    if (field.validator && !field.validator(*value)) {
+      errors.push_back(std::format("key '{}': value {}", field.key, field.requirement));
+      return;
+    }
+    settings.*field.member = std::move(*value);
+  }
+};
+
+}  // namespace load_balancer::config
+
+#endif  // SCHEMA_H
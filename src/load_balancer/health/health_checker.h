@@ -0,0 +1,322 @@
+#ifndef HEALTH_CHECKER_H
+#define HEALTH_CHECKER_H
+
+#include <poll.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "invalid_socket_exception.h"
+#include "server_health.h"
+#include "udp_socket.h"
+
+namespace load_balancer::health {
+
+/**
+ * \brief Параметры проверки здоровья серверов.
+ */
+struct HealthCheckOptions {
+  /// Период активных проверок, нулевой период отключает их.
+  std::chrono::milliseconds interval{0};
+  /// Время ожидания результата активной проверки.
+  std::chrono::milliseconds timeout{1000};
+  /// Датаграмма, отправляемая серверу при активной проверке.
+  std::string payload = "ping";
+  /// Считать проверку успешной только при получении ответа, иначе - при отсутствии
+  /// ICMP-ошибки.
+  bool expect_reply = false;
+  /// Количество неудачных проверок подряд, после которого сервер исключается из выбора.
+  std::size_t unhealthy_threshold = 3;
+  /// Количество успешных проверок подряд, после которого сервер возвращается к выбору.
+  std::size_t healthy_threshold = 2;
+  /// Время исключения сервера после ошибки доставки перенаправленного ему запроса, нулевое
+  /// время отключает пассивную проверку.
+  std::chrono::milliseconds ejection_time{10000};
+};
+
+/**
+ * \brief Активная и пассивная проверка здоровья серверов в отдельном потоке.
+ *
+ * Активная проверка периодически отправляет серверам датаграмму через собственный сокет и
+ * учитывает ответ на нее либо ICMP-ошибку. Пассивная проверка читает ICMP-ошибки доставки
+ * перенаправленных запросов из очередей ошибок сокетов отправки (IP_RECVERR) и сразу
+ * исключает сервер на @link HealthCheckOptions::ejection_time @endlink. Сервер выбирается,
+ * только если он прошел активную проверку и время его исключения истекло.
+ *
+ * \tparam ProtoFamily семейство протоколов сокетов.
+ */
+template <socket_wrapper::ProtocolFamily ProtoFamily>
+class HealthChecker {
+ public:
+  using EndPointType = socket_wrapper::udp::UdpEndPoint<ProtoFamily>;
+  using SocketType = socket_wrapper::udp::UdpSocket<ProtoFamily>;
+  using Clock = std::chrono::steady_clock;
+
+  /// Максимальное время ожидания событий, после которого проверяется запрос остановки.
+  static constexpr auto kPollTimeout = std::chrono::milliseconds(100);
+
+  /**
+   * \param servers конечные точки серверов в порядке их индексов;
+   * \param health признаки исправности серверов, изменяемые проверкой.
+   */
+  HealthChecker(
+      std::vector<EndPointType> servers, ServerHealth &health, HealthCheckOptions options
+  );
+
+  HealthChecker(const HealthChecker &other) = delete;
+  HealthChecker &operator=(const HealthChecker &other) = delete;
+
+  ~HealthChecker();
+
+  /**
+   * \brief Запустить проверку.
+   * \param senders сокеты, через которые перенаправляются запросы, с включенной очередью
+   * ошибок. Сокеты должны существовать до остановки проверки.
+   */
+  void Start(std::vector<const SocketType *> senders);
+  /**
+   * \brief Остановить проверку и дождаться завершения ее потока.
+   */
+  void Stop();
+
+ private:
+  /**
+   * \brief Состояние проверки одного сервера.
+   */
+  struct ServerState {
+    std::size_t failures = 0;
+    std::size_t successes = 0;
+    /// Результат последних активных проверок.
+    bool probe_healthy = true;
+    /// На текущую активную проверку пришла ICMP-ошибка.
+    bool probe_failed = false;
+    /// На текущую активную проверку пришел ответ.
+    bool probe_replied = false;
+    Clock::time_point ejected_until;
+  };
+
+  const std::vector<EndPointType> servers_;
+  ServerHealth &health_;
+  const HealthCheckOptions options_;
+  std::vector<ServerState> states_;
+
+  SocketType probe_socket_;
+  std::vector<const SocketType *> senders_;
+  /// Опрашиваемые сокеты: сокет активной проверки, за ним - сокеты отправки.
+  std::vector<pollfd> poll_fds_;
+  std::jthread thread_;
+
+  void Worker(const std::stop_token &stop_token);
+  /**
+   * \brief Дождаться событий сокетов не дольше, чем до указанного момента, и обработать их.
+   */
+  void HandleEvents(Clock::time_point deadline);
+  void HandleProbeReply();
+  /**
+   * \brief Отправить активные проверки всем серверам. Сервер, проверку которому не удалось
+   * отправить, считается не прошедшим ее.
+   */
+  void SendProbes();
+  void EvaluateProbes();
+  /**
+   * \brief Исключить серверы, доставка запросов которым завершилась ошибкой.
+   */
+  void EjectUnreachable(const std::vector<EndPointType> &receivers, Clock::time_point now);
+  /**
+   * \brief Вернуть к выбору серверы, время исключения которых истекло.
+   */
+  void AdmitRecovered(Clock::time_point now);
+  void UpdateHealth(std::size_t server_index, Clock::time_point now);
+  /**
+   * \return индекс сервера либо количество серверов, если конечная точка не принадлежит серверу.
+   */
+  [[nodiscard]] std::size_t FindServer(const EndPointType &end_point) const;
+};
+
+template <socket_wrapper::ProtocolFamily ProtoFamily>
+HealthChecker<ProtoFamily>::HealthChecker(
+    std::vector<EndPointType> servers, ServerHealth &health, HealthCheckOptions options
+)
+    : servers_(std::move(servers)),
+      health_(health),
+      options_(std::move(options)),
+      states_(servers_.size()),
+      probe_socket_(0) {
+  probe_socket_.SetRecvErr(true);
+}
+
+template <socket_wrapper::ProtocolFamily ProtoFamily>
+HealthChecker<ProtoFamily>::~HealthChecker() {
+  Stop();
+}
+
+template <socket_wrapper::ProtocolFamily ProtoFamily>
+void HealthChecker<ProtoFamily>::Start(std::vector<const SocketType *> senders) {
+  senders_ = std::move(senders);
+  // Событие POLLERR сообщается без запроса и означает непустую очередь ошибок.
+  poll_fds_.clear();
+  poll_fds_.push_back({.fd = probe_socket_.GetNativeHandle(), .events = POLLIN, .revents = 0});
+  for (const auto *const sender : senders_) {
+    poll_fds_.push_back({.fd = sender->GetNativeHandle(), .events = 0, .revents = 0});
+  }
+  thread_ = std::jthread([this](const std::stop_token &stop_token) {
+    Worker(stop_token);
+  });
+}
+
+template <socket_wrapper::ProtocolFamily ProtoFamily>
+void HealthChecker<ProtoFamily>::Stop() {
+  thread_ = {};
+}
+
+template <socket_wrapper::ProtocolFamily ProtoFamily>
+void HealthChecker<ProtoFamily>::Worker(const std::stop_token &stop_token) {
+  const bool active = options_.interval.count() > 0;
+  const auto timeout = std::min(options_.timeout, options_.interval);
+  // Время следующей активной проверки и время подведения итогов текущей.
+  auto next_probe = active ? Clock::now() : Clock::time_point::max();
+  auto probe_deadline = Clock::time_point::max();
+  while (!stop_token.stop_requested()) {
+    try {
+      const auto now = Clock::now();
+      if (now >= probe_deadline) {
+        EvaluateProbes();
+        probe_deadline = Clock::time_point::max();
+      }
+      if (now >= next_probe) {
+        // Время следующей проверки сдвигается до отправки, чтобы ошибка не повторяла ее сразу.
+        next_probe = now + options_.interval;
+        probe_deadline = now + timeout;
+        SendProbes();
+      }
+      AdmitRecovered(now);
+      HandleEvents(std::min({now + kPollTimeout, next_probe, probe_deadline}));
+    } catch ([[maybe_unused]] const socket_wrapper::InvalidSocketException &ex) {
+      return;
+    } catch (const std::exception &ex) {
+      std::cerr << "Error in health checker: " << ex.what() << ".\n";
+    }
+  }
+}
+
+template <socket_wrapper::ProtocolFamily ProtoFamily>
+void HealthChecker<ProtoFamily>::HandleEvents(const Clock::time_point deadline) {
+  const auto wait_time = std::max<std::int64_t>(
+      std::chrono::ceil<std::chrono::milliseconds>(deadline - Clock::now()).count(), 0
+  );
+  if (poll(poll_fds_.data(), poll_fds_.size(), static_cast<int>(wait_time)) <= 0) {
+    return;
+  }
+  const auto now = Clock::now();
+  if (poll_fds_[0].revents & POLLIN) {
+    HandleProbeReply();
+  }
+  if (poll_fds_[0].revents & POLLERR) {
+    for (const auto &receiver : probe_socket_.ReceiveErrors()) {
+      if (const auto server_index = FindServer(receiver); server_index < servers_.size()) {
+        states_[server_index].probe_failed = true;
+      }
+    }
+  }
+  for (std::size_t i = 0; i < senders_.size(); ++i) {
+    if (poll_fds_[i + 1].revents & POLLERR) {
+      EjectUnreachable(senders_[i]->ReceiveErrors(), now);
+    }
+  }
+}
+
+template <socket_wrapper::ProtocolFamily ProtoFamily>
+void HealthChecker<ProtoFamily>::HandleProbeReply() {
+  std::array<char, 1> buffer{};
+  const auto [size, sender] = probe_socket_.ReceiveFrom(buffer);
+  if (const auto server_index = FindServer(sender); server_index < servers_.size()) {
+    states_[server_index].probe_replied = true;
+  }
+}
+
+template <socket_wrapper::ProtocolFamily ProtoFamily>
+void HealthChecker<ProtoFamily>::SendProbes() {
+  for (std::size_t i = 0; i < servers_.size(); ++i) {
+    states_[i].probe_failed = false;
+    states_[i].probe_replied = false;
+    try {
+      probe_socket_.SendTo(options_.payload, servers_[i]);
+    } catch ([[maybe_unused]] const socket_wrapper::InvalidSocketException &ex) {
+      throw;
+    } catch ([[maybe_unused]] const std::exception &ex) {
+      // Например, ENETUNREACH: маршрута к серверу нет.
+      states_[i].probe_failed = true;
+    }
+  }
+}
+
+template <socket_wrapper::ProtocolFamily ProtoFamily>
+void HealthChecker<ProtoFamily>::EvaluateProbes() {
+  const auto now = Clock::now();
+  for (std::size_t i = 0; i < servers_.size(); ++i) {
+    auto &state = states_[i];
+    if (state.probe_failed || (options_.expect_reply && !state.probe_replied)) {
+      state.successes = 0;
+      if (++state.failures >= options_.unhealthy_threshold) {
+        state.probe_healthy = false;
+      }
+    } else {
+      state.failures = 0;
+      if (++state.successes >= options_.healthy_threshold) {
+        state.probe_healthy = true;
+      }
+    }
+    UpdateHealth(i, now);
+  }
+}
+
+template <socket_wrapper::ProtocolFamily ProtoFamily>
+void HealthChecker<ProtoFamily>::EjectUnreachable(
+    const std::vector<EndPointType> &receivers, const Clock::time_point now
+) {
+  if (options_.ejection_time.count() == 0) {
+    return;
+  }
+  for (const auto &receiver : receivers) {
+    if (const auto server_index = FindServer(receiver); server_index < servers_.size()) {
+      states_[server_index].ejected_until = now + options_.ejection_time;
+      UpdateHealth(server_index, now);
+    }
+  }
+}
+
+template <socket_wrapper::ProtocolFamily ProtoFamily>
+void HealthChecker<ProtoFamily>::AdmitRecovered(const Clock::time_point now) {
+  for (std::size_t i = 0; i < servers_.size(); ++i) {
+    if (!health_.IsHealthy(i)) {
+      UpdateHealth(i, now);
+    }
+  }
+}
+
+template <socket_wrapper::ProtocolFamily ProtoFamily>
+void HealthChecker<ProtoFamily>::UpdateHealth(
+    const std::size_t server_index, const Clock::time_point now
+) {
+  const auto &state = states_[server_index];
+  const auto healthy = state.probe_healthy && now >= state.ejected_until;
+  if (health_.SetHealthy(server_index, healthy)) {
+    std::cout << "Server " << servers_[server_index] << (healthy ? " is healthy" : " is ejected")
+              << ".\n";
+  }
+}
+
+template <socket_wrapper::ProtocolFamily ProtoFamily>
+std::size_t HealthChecker<ProtoFamily>::FindServer(const EndPointType &end_point) const {
+  return std::find(servers_.begin(), servers_.end(), end_point) - servers_.begin();
+}
+
+}  // namespace load_balancer::health
+
+#endif  // HEALTH_CHECKER_H
@@ -0,0 +1,47 @@
+#include "server_health.h"
+
+namespace load_balancer::health {
+
+ServerHealth::ServerHealth(const std::size_t server_count)
+    : server_count_(server_count), healthy_(std::make_unique<std::atomic_bool[]>(server_count)) {
+  for (std::size_t i = 0; i < server_count_; ++i) {
+    healthy_[i].store(true, std::memory_order_relaxed);
+  }
+}
+
+std::size_t ServerHealth::GetServerCount() const {
+  return server_count_;
+}
+
+bool ServerHealth::IsHealthy(const std::size_t server_index) const {
+  return healthy_[server_index].load(std::memory_order_relaxed);
+}
+
+bool ServerHealth::SetHealthy(const std::size_t server_index, const bool healthy) {
+  return healthy_[server_index].exchange(healthy, std::memory_order_relaxed) != healthy;
+}
+
+std::size_t ServerHealth::Redirect(const std::size_t server_index, const std::size_t client_hash)
+    const {
+  if (IsHealthy(server_index)) {
+    return server_index;
+  }
+  const auto start = client_hash % server_count_;
+  for (std::size_t i = 0; i < server_count_; ++i) {
+    const auto candidate = (start + i) % server_count_;
+    if (IsHealthy(candidate)) {
+      return candidate;
+    }
+  }
+  return server_index;
+}
+
+void ServerHealth::Redirect(
+    const std::span<const std::size_t> client_hashes, const std::span<std::size_t> server_indexes
+) const {
+  for (std::size_t i = 0; i < server_indexes.size(); ++i) {
+    server_indexes[i] = Redirect(server_indexes[i], client_hashes[i]);
+  }
+}
+
+}  // namespace load_balancer::health
@@ -0,0 +1,55 @@
+#ifndef SERVER_HEALTH_H
+#define SERVER_HEALTH_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <span>
+
+namespace load_balancer::health {
+
+/**
+ * \brief Признаки исправности серверов, разделяемые потоками обработки запросов.
+ *
+ * Исключение сервера из выбора и его возврат - запись одного атомарного флага, поэтому
+ * проверка здоровья не останавливает и не блокирует обработку запросов. Стратегия выбора
+ * сервера не знает об исправности серверов: выбранный ею неисправный сервер заменяется
+ * исправным методом @link Redirect @endlink.
+ */
+class ServerHealth {
+ public:
+  explicit ServerHealth(std::size_t server_count);
+
+  [[nodiscard]] std::size_t GetServerCount() const;
+  [[nodiscard]] bool IsHealthy(std::size_t server_index) const;
+  /**
+   * \brief Изменить признак исправности сервера.
+   * \return true - если признак изменился.
+   */
+  bool SetHealthy(std::size_t server_index, bool healthy);
+
+  /**
+   * \brief Заменить неисправный сервер исправным.
+   *
+   * Замена зависит от хеша клиента, поэтому запросы одного клиента попадают на один и тот же
+   * сервер, а запросы разных клиентов распределяются по всем исправным серверам.
+   *
+   * \return индекс выбранного сервера, если он исправен или исправных серверов нет, иначе
+   * индекс исправного сервера.
+   */
+  [[nodiscard]] std::size_t Redirect(std::size_t server_index, std::size_t client_hash) const;
+  /**
+   * \brief Заменить неисправные серверы, выбранные для пачки запросов, исправными.
+   */
+  void Redirect(
+      std::span<const std::size_t> client_hashes, std::span<std::size_t> server_indexes
+  ) const;
+
+ private:
+  const std::size_t server_count_;
+  std::unique_ptr<std::atomic_bool[]> healthy_;
+};
+
+}  // namespace load_balancer::health
+
+#endif  // SERVER_HEALTH_H
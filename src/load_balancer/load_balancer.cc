@@ -1,24 +1,299 @@
 #include "load_balancer.h"
 
+#include <poll.h>
+#include <sys/epoll.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <format>
 #include <mutex>
+#include <optional>
 
-#include "configuration/converters.h"
+#include "buffer_pool.h"
+#include "configuration/schema.h"
 #include "invalid_socket_exception.h"
-
-using namespace std::chrono_literals;
+#include "io_uring_udp_transport.h"
+#include "workers/cpu_affinity.h"
 
 namespace load_balancer {
 
+namespace {
+
+using Settings = LoadBalancer::Settings;
+using config::Field;
+using config::InRange;
+using config::IsPositive;
+
+constexpr auto kPositive = "must be positive";
+/// Период проверки разрешений ограничителя нагрузки, пока очередь допуска не пуста.
+constexpr auto kQueuePollPeriod = std::chrono::milliseconds(1);
+/// Период проверки остановки и стратегии выбора сервера при ожидании ответов серверов.
+constexpr auto kReplyPollPeriod = std::chrono::milliseconds(100);
+/// Размер буфера ответа сервера: для измерения задержки содержимое ответа не нужно.
+constexpr std::size_t kReplyBufferSize = 1;
+
+/// Схема конфигурации балансировщика: ключи, типы, значения по умолчанию (инициализаторы полей
+/// @link LoadBalancer::Settings @endlink) и проверки значений.
+constexpr config::Schema kSettingsSchema(
+    Field(
+        LoadBalancer::kServersKey,
+        &Settings::servers,
+        config::IsNotEmpty<std::vector<LoadBalancer::ServerType>>,
+        "must list at least one server"
+    ),
+    Field(LoadBalancer::kMaxRpsKey, &Settings::max_rps),
+    Field(LoadBalancer::kMaxRpsPerSourceKey, &Settings::max_rps_per_source),
+    Field(
+        LoadBalancer::kSourceSketchWidthKey,
+        &Settings::source_sketch_width,
+        InRange<std::size_t{1}>,
+        kPositive
+    ),
+    Field(
+        LoadBalancer::kSourceSketchDepthKey,
+        &Settings::source_sketch_depth,
+        InRange<std::size_t{1}>,
+        kPositive
+    ),
+    Field(LoadBalancer::kHeavyHittersKey, &Settings::heavy_hitters),
+    Field(LoadBalancer::kBalancingStrategyKey, &Settings::balancing_strategy_type),
+    Field(
+        LoadBalancer::kPeakEwmaDecayKey,
+        &Settings::peak_ewma_decay,
+        IsPositive<std::chrono::milliseconds>,
+        kPositive
+    ),
+    Field(LoadBalancer::kRateLimiterKey, &Settings::rate_limiter_type),
+    Field(LoadBalancer::kReceiverPortKey, &Settings::receiver_port),
+    Field(LoadBalancer::kReceiverPortsKey, &Settings::receiver_ports),
+    Field(LoadBalancer::kSenderPortKey, &Settings::sender_port),
+    Field(LoadBalancer::kBatchSizeKey, &Settings::batch_size, InRange<std::size_t{1}>, kPositive),
+    Field(LoadBalancer::kThreadCountKey, &Settings::thread_count),
+    Field(LoadBalancer::kBusyPollKey, &Settings::busy_poll),
+    Field(LoadBalancer::kReceiveSpinKey, &Settings::receive_spin),
+    Field(
+        LoadBalancer::kReceiveBufferKey,
+        &Settings::receive_buffer,
+        InRange<std::size_t{0}, std::size_t{LoadBalancer::SocketType::kMaxBufferSize}>,
+        "must be from 0 to 1073741823"
+    ),
+    Field(
+        LoadBalancer::kSendBufferKey,
+        &Settings::send_buffer,
+        InRange<std::size_t{0}, std::size_t{LoadBalancer::SocketType::kMaxBufferSize}>,
+        "must be from 0 to 1073741823"
+    ),
+    Field(LoadBalancer::kSocketBufferForceKey, &Settings::socket_buffer_force),
+    Field(LoadBalancer::kCpuAffinityKey, &Settings::cpu_affinity),
+    Field(LoadBalancer::kWorkerAutoscaleKey, &Settings::worker_autoscale),
+    Field(
+        LoadBalancer::kWorkerScalePeriodKey,
+        &Settings::worker_scale_period,
+        IsPositive<std::chrono::milliseconds>,
+        kPositive
+    ),
+    Field(LoadBalancer::kShardedKey, &Settings::sharded),
+    Field(LoadBalancer::kTransportKey, &Settings::transport),
+    Field(LoadBalancer::kUdpOffloadKey, &Settings::udp_offload),
+    Field(
+        LoadBalancer::kBufferSizeKey,
+        &Settings::buffer_size,
+        InRange<std::size_t{1}, LoadBalancer::SocketType::kMaxDatagramSize>,
+        "must be from 1 to 65507"
+    ),
+    Field(LoadBalancer::kHugePagesKey, &Settings::huge_pages),
+    Field(LoadBalancer::kHealthCheckIntervalKey, &Settings::health_check_interval),
+    Field(
+        LoadBalancer::kHealthCheckTimeoutKey,
+        &Settings::health_check_timeout,
+        IsPositive<std::chrono::milliseconds>,
+        kPositive
+    ),
+    Field(LoadBalancer::kHealthCheckPayloadKey, &Settings::health_check_payload),
+    Field(LoadBalancer::kHealthCheckExpectReplyKey, &Settings::health_check_expect_reply),
+    Field(
+        LoadBalancer::kUnhealthyThresholdKey,
+        &Settings::unhealthy_threshold,
+        InRange<std::size_t{1}>,
+        kPositive
+    ),
+    Field(
+        LoadBalancer::kHealthyThresholdKey,
+        &Settings::healthy_threshold,
+        InRange<std::size_t{1}>,
+        kPositive
+    ),
+    Field(LoadBalancer::kEjectionTimeKey, &Settings::ejection_time),
+    Field(LoadBalancer::kProxyKey, &Settings::proxy),
+    Field(LoadBalancer::kMaxFlowsKey, &Settings::max_flows, InRange<std::size_t{1}>, kPositive),
+    Field(
+        LoadBalancer::kFlowIdleTimeoutKey,
+        &Settings::flow_idle_timeout,
+        IsPositive<std::chrono::milliseconds>,
+        kPositive
+    ),
+    Field(LoadBalancer::kMetricsPortKey, &Settings::metrics_port),
+    Field(LoadBalancer::kConfigReloadKey, &Settings::config_reload),
+    Field(LoadBalancer::kAdmissionQueueKey, &Settings::admission_queue),
+    Field(
+        LoadBalancer::kCoDelTargetKey,
+        &Settings::codel_target,
+        IsPositive<std::chrono::milliseconds>,
+        kPositive
+    ),
+    Field(
+        LoadBalancer::kCoDelIntervalKey,
+        &Settings::codel_interval,
+        IsPositive<std::chrono::milliseconds>,
+        kPositive
+    ),
+    Field(LoadBalancer::kClusterPortKey, &Settings::cluster_port),
+    Field(LoadBalancer::kClusterPeersKey, &Settings::cluster_peers),
+    Field(
+        LoadBalancer::kClusterSyncPeriodKey,
+        &Settings::cluster_sync_period,
+        IsPositive<std::chrono::milliseconds>,
+        kPositive
+    ),
+    Field(LoadBalancer::kCaptureFileKey, &Settings::capture_file),
+    Field(
+        LoadBalancer::kCaptureBufferKey,
+        &Settings::capture_buffer,
+        InRange<std::size_t{1}>,
+        kPositive
+    ),
+    Field(
+        LoadBalancer::kCaptureSnapLengthKey,
+        &Settings::capture_snap_length,
+        InRange<std::size_t{1}, LoadBalancer::SocketType::kMaxDatagramSize>,
+        "must be from 1 to 65507"
+    )
+);
+
+}  // namespace
+
+LoadBalancer::Shard::Shard(const std::size_t index, SocketType receiver, SocketType sender)
+    : index(index), receiver(std::move(receiver)), sender(std::move(sender)) {
+}
+
 LoadBalancer::LoadBalancer(std::shared_ptr<config::Configuration> configuration)
-    : configuration_(std::move(configuration)) {
-  UpdateConfigParameters();
+    : configuration_(std::move(configuration)),
+      settings_(ParseSettings(*configuration_)),
+      health_check_options_(GetHealthCheckOptions(settings_)),
+      thread_count_(GetThreadCount(settings_)),
+      cpus_(workers::GetAllowedCpus()) {
+  const auto shard_count = settings_.sharded ? thread_count_ : 1;
+  const SocketOptions socket_options = {.reuse_port = settings_.sharded};
+  const SocketOptions receiver_options = {
+      .reuse_port = settings_.sharded, .non_blocking = UsesReactor(settings_)
+  };
+  bool force_socket_buffers = settings_.socket_buffer_force;
+  for (std::size_t i = 0; i < shard_count; ++i) {
+    shards_.emplace_back(std::make_unique<Shard>(
+        i,
+        SocketType(settings_.receiver_port, receiver_options),
+        SocketType(settings_.sender_port, socket_options)
+    ));
+    for (const auto port : settings_.receiver_ports) {
+      shards_.back()->extra_receivers.emplace_back(port, receiver_options);
+    }
+    // Ядро сообщает об отброшенных датаграммах только после потерь, поэтому прием без потерь
+    // не разбирает управляющие сообщения.
+    shards_.back()->receiver.SetRxqOverflow(true);
+    SetSocketBuffers(shards_.back()->receiver, force_socket_buffers);
+    for (auto &receiver : shards_.back()->extra_receivers) {
+      receiver.SetRxqOverflow(true);
+      SetSocketBuffers(receiver, force_socket_buffers);
+    }
+    SetSocketBuffers(shards_.back()->sender, force_socket_buffers);
+    // Объединенные буферы разделяются только при приеме пачками через сокет.
+    if (settings_.udp_offload && settings_.transport == TransportType::kSocket) {
+      shards_.back()->receiver.SetGro(true);
+    }
+    if (health_check_options_.ejection_time.count() > 0) {
+      shards_.back()->sender.SetRecvErr(true);
+    }
+    if (settings_.busy_poll.count() > 0) {
+      try {
+        shards_.back()->receiver.SetBusyPoll(settings_.busy_poll);
+      } catch (const std::exception &ex) {
+        // Без CAP_NET_ADMIN остается повторный прием в пространстве пользователя.
+        std::cerr << "Can't enable busy polling: " << ex.what() << ".\n";
+      }
+    }
+    // Ядро направляет датаграммы в сокет шарда, поток которого выполняется на процессоре,
+    // обработавшем прием, поэтому данные запроса остаются в кеше этого процессора.
+    if (settings_.sharded && settings_.cpu_affinity) {
+      shards_.back()->receiver.SetIncomingCpu(cpus_[i % cpus_.size()]);
+    }
+    if (settings_.admission_queue > 0) {
+      shards_.back()->admission_queue = std::make_unique<AdmissionQueue>(
+          settings_.admission_queue, settings_.codel_target, settings_.codel_interval
+      );
+    }
+  }
 
-  if (server_end_points_.empty()) {
-    throw std::runtime_error("You must specify the address of at least one server!");
+  if (UsesReactor(settings_)) {
+    stop_event_ = std::make_unique<reactor::StopEvent>();
   }
+  worker_scaler_ = std::make_unique<workers::WorkerScaler>(
+      thread_count_,
+      std::min(kDefaultThreadCount, thread_count_),
+      settings_.worker_autoscale ? settings_.worker_scale_period : std::chrono::milliseconds(0)
+  );
 
-  receiver_ = SocketType(receiver_port_);
-  sender_ = SocketType(sender_port_);
+  if (settings_.proxy) {
+    flow_table_ = std::make_unique<proxy::FlowTable<EndPointType>>(
+        settings_.max_flows, settings_.flow_idle_timeout
+    );
+    upstream_sockets_.reserve(flow_table_->GetCapacity());
+    // Поток ответов забирает датаграммы без ожидания: событие сокета может оказаться ошибкой
+    // доставки без данных.
+    const SocketOptions upstream_options = {.non_blocking = true};
+    for (std::size_t i = 0; i < flow_table_->GetCapacity(); ++i) {
+      upstream_sockets_.emplace_back(static_cast<std::uint16_t>(0), upstream_options);
+      if (health_check_options_.ejection_time.count() > 0) {
+        upstream_sockets_.back().SetRecvErr(true);
+      }
+    }
+  }
+
+  metrics_registry_ = std::make_unique<metrics::MetricsRegistry>(
+      std::vector<std::string>(), kMaxMetricsServers
+  );
+  if (settings_.metrics_port != 0) {
+    metrics_server_ =
+        std::make_unique<metrics::MetricsServer>(settings_.metrics_port, *metrics_registry_);
+  }
+  metrics_registry_->SetSocketStatsSource([this] { return GetSocketStats(); });
+
+  if (settings_.cluster_port != 0) {
+    // До первого обмена общее ограничение делится между экземплярами поровну.
+    rate_share_ = 1.0 / static_cast<double>(settings_.cluster_peers.size() + 1);
+    rate_share_gossip_ = std::make_unique<cluster::RateShareGossip>(
+        settings_.cluster_port,
+        settings_.cluster_peers,
+        settings_.cluster_sync_period,
+        [this] { return metrics_registry_->Get(metrics::Counter::kReceived); },
+        [this](const double share) { ApplyRateShare(share); }
+    );
+  }
+  if (!settings_.capture_file.empty()) {
+    capture_ = std::make_unique<capture::TrafficCapture>(
+        settings_.capture_file, settings_.capture_buffer, settings_.capture_snap_length
+    );
+  }
+  snapshot_ =
+      std::make_unique<rcu::RcuPointer<Snapshot>>(BuildSnapshot(settings_, nullptr));
+  health_checker_ = CreateHealthChecker(snapshot_->Get());
+  if (settings_.config_reload && !configuration_->GetFileName().empty()) {
+    config_watcher_ =
+        std::make_unique<config::ConfigurationWatcher>(configuration_->GetFileName(), [this] {
+          Reload();
+        });
+  }
 }
 
 LoadBalancer::~LoadBalancer() {
@@ -30,11 +305,57 @@ void LoadBalancer::Start() {
   if (!stopped_.compare_exchange_strong(was_stopped, false)) {
     return;
   }
+  {
+    const std::lock_guard lock(reload_mutex_);
+    if (health_checker_) {
+      health_checker_->Start(GetHealthCheckSenders());
+    }
+    StartLatencyWorkers();
+  }
+  if (metrics_server_) {
+    metrics_server_->Start();
+  }
+  if (config_watcher_) {
+    config_watcher_->Start();
+  }
+  if (rate_share_gossip_) {
+    rate_share_gossip_->Start();
+  }
+  if (capture_) {
+    capture_->Start();
+  }
   for (std::size_t i = 0; i < thread_count_; ++i) {
+    auto &shard = *shards_[i % shards_.size()];
+    threads_.emplace_back([this, &shard, i] {
+      PinWorker(i);
+      if (settings_.proxy) {
+        ProxyWorker(shard);
+      } else if (settings_.transport == TransportType::kIoUring) {
+        IoUringWorker(shard);
+      } else if (settings_.transport == TransportType::kEpoll) {
+        EpollWorker(shard);
+      } else if (settings_.udp_offload) {
+        OffloadWorker(shard);
+      } else if (settings_.batch_size > 1) {
+        BatchWorker(shard);
+      } else {
+        Worker(shard);
+      }
+    });
+  }
+  if (settings_.proxy) {
     threads_.emplace_back([this] {
-      Worker();
+      ReplyWorker();
     });
   }
+  for (const auto &shard : shards_) {
+    if (shard->admission_queue) {
+      threads_.emplace_back([this, queued_shard = shard.get()](const std::stop_token &stop) {
+        QueueWorker(*queued_shard, stop);
+      });
+    }
+  }
+  worker_scaler_->Start();
 }
 
 void LoadBalancer::Stop() {
@@ -44,9 +365,84 @@ void LoadBalancer::Stop() {
   }
   std::cout << "Stop requests receiving.\n";
   stopped_.notify_all();
-  receiver_.Close();
+  if (config_watcher_) {
+    config_watcher_->Stop();
+  }
+  if (stop_event_) {
+    // Реакторы завершаются по событию, поэтому сокеты закрываются после остановки потоков.
+    stop_event_->Notify();
+    threads_.clear();
+  }
+  for (const auto &shard : shards_) {
+    shard->receiver.Close();
+    for (auto &receiver : shard->extra_receivers) {
+      receiver.Close();
+    }
+  }
+  // Ожидающие активации потоки завершаются на закрытых сокетах.
+  worker_scaler_->Stop();
   threads_.clear();
-  sender_.Close();
+  {
+    const std::lock_guard lock(reload_mutex_);
+    latency_threads_.clear();
+    if (health_checker_) {
+      health_checker_->Stop();
+    }
+  }
+  if (metrics_server_) {
+    metrics_server_->Stop();
+  }
+  if (rate_share_gossip_) {
+    rate_share_gossip_->Stop();
+  }
+  // Потоки обработки остановлены, поэтому захваченные ими датаграммы записываются полностью.
+  if (capture_) {
+    capture_->Stop();
+  }
+  for (const auto &shard : shards_) {
+    shard->sender.Close();
+  }
+}
+
+void LoadBalancer::Reload() {
+  const std::lock_guard lock(reload_mutex_);
+  configuration_->UpdateConfiguration();
+  const auto settings = ParseSettings(*configuration_);
+  const auto &current = snapshot_->Get();
+  if (settings == current.settings) {
+    return;
+  }
+  auto snapshot = BuildSnapshot(settings, &current);
+  if (snapshot->server_health == current.server_health) {
+    snapshot_->Update(std::move(snapshot));
+  } else {
+    // Проверка здоровья изменяет исправность серверов прежнего снимка, поэтому она
+    // останавливается до его удаления.
+    auto health_checker = CreateHealthChecker(*snapshot);
+    if (health_checker_) {
+      health_checker_->Stop();
+    }
+    snapshot_->Update(std::move(snapshot));
+    health_checker_ = std::move(health_checker);
+    if (health_checker_ && !stopped_) {
+      health_checker_->Start(GetHealthCheckSenders());
+    }
+  }
+  StartLatencyWorkers();
+  std::cout << "Configuration reloaded.\n";
+}
+
+void LoadBalancer::StartLatencyWorkers() {
+  // В режиме проксирования ответы принимает поток ответов.
+  if (settings_.proxy || stopped_ || !latency_threads_.empty() ||
+      !snapshot_->Get().server_latency) {
+    return;
+  }
+  for (const auto &shard : shards_) {
+    latency_threads_.emplace_back([this, replied_shard = shard.get()](const std::stop_token &stop) {
+      LatencyWorker(*replied_shard, stop);
+    });
+  }
 }
 
 void LoadBalancer::Join() const {
@@ -54,58 +450,1000 @@ void LoadBalancer::Join() const {
 }
 
 LoadBalancer::EndPointType LoadBalancer::ReceiverEndPoint() const {
-  return receiver_.GetEndPoint();
+  return shards_.front()->receiver.GetEndPoint();
 }
 
 LoadBalancer::EndPointType LoadBalancer::SenderEndPoint() const {
-  return sender_.GetEndPoint();
+  return shards_.front()->sender.GetEndPoint();
+}
+
+const metrics::MetricsRegistry &LoadBalancer::GetMetrics() const {
+  return *metrics_registry_;
+}
+
+void LoadBalancer::Worker(Shard &shard) {
+  auto &metrics = metrics_registry_->RegisterThread();
+  const auto reader = snapshot_->RegisterReader();
+  BufferPool buffer_pool(settings_.buffer_size, 1, settings_.huge_pages);
+  const auto buffer = buffer_pool.Acquire();
+  const auto worker = worker_scaler_->RegisterWorker();
+  while (true) {
+    try {
+      worker.WaitUntilActive();
+      const auto [size, sender] = Receive(shard.receiver, buffer);
+      metrics.Add(metrics::Counter::kReceived);
+      metrics.Add(metrics::Counter::kReceivedBytes, size);
+      Capture(buffer.first(size), sender, shard.receiver, metrics);
+      const auto snapshot = reader.Read();
+      if (!AdmitSource(*snapshot, sender)) {
+        metrics.Add(metrics::Counter::kSourceRateLimited);
+        continue;
+      }
+      const auto admitted = AddRequests(*snapshot, shard, 1, metrics) == 1;
+      if (!admitted && !shard.admission_queue) {
+        continue;
+      }
+      const auto client_hash = sender.Hash();
+      const auto server_idx = snapshot->server_health->Redirect(
+          snapshot->balancing_strategies[shard.index]->SelectServer(client_hash), client_hash
+      );
+      if (!admitted) {
+        QueueRequest(*snapshot, shard, {buffer.data(), size}, server_idx, metrics);
+        continue;
+      }
+      RecordSent(*snapshot, std::span(&server_idx, 1));
+      const auto lock = LockShard(shard.send_msg_mutex);
+      shard.sender.SendTo(buffer.first(size), snapshot->server_end_points[server_idx]);
+      metrics.AddForwarded(snapshot->metric_indexes[server_idx], size);
+    } catch ([[maybe_unused]] const InvalidSocketException &ex) {
+      return;
+    } catch (const std::exception &ex) {
+      metrics.Add(metrics::Counter::kForwardErrors);
+      std::cerr << "Error in load balancer: " << ex.what() << ".\n";
+    } catch (...) {
+      metrics.Add(metrics::Counter::kForwardErrors);
+      std::cerr << "Error in load balancer: uknown exception.\n";
+    }
+  }
+}
+
+void LoadBalancer::BatchWorker(Shard &shard) {
+  auto &metrics = metrics_registry_->RegisterThread();
+  const auto reader = snapshot_->RegisterReader();
+  BufferPool buffer_pool(settings_.buffer_size, settings_.batch_size, settings_.huge_pages);
+  std::vector<SocketType::DatagramView> datagrams(settings_.batch_size);
+  for (auto &datagram : datagrams) {
+    datagram.buffer = buffer_pool.Acquire();
+  }
+  std::vector<std::size_t> client_hashes(settings_.batch_size);
+  std::vector<std::size_t> server_indexes(settings_.batch_size);
+  const auto worker = worker_scaler_->RegisterWorker();
+  while (true) {
+    try {
+      worker.WaitUntilActive();
+      static_cast<void>(ForwardBatch(
+          shard, shard.receiver, datagrams, client_hashes, server_indexes, reader, metrics
+      ));
+    } catch ([[maybe_unused]] const InvalidSocketException &ex) {
+      return;
+    } catch (const std::exception &ex) {
+      metrics.Add(metrics::Counter::kForwardErrors);
+      std::cerr << "Error in load balancer: " << ex.what() << ".\n";
+    } catch (...) {
+      metrics.Add(metrics::Counter::kForwardErrors);
+      std::cerr << "Error in load balancer: uknown exception.\n";
+    }
+  }
+}
+
+void LoadBalancer::EpollWorker(Shard &shard) {
+  auto &metrics = metrics_registry_->RegisterThread();
+  const auto reader = snapshot_->RegisterReader();
+  BufferPool buffer_pool(settings_.buffer_size, settings_.batch_size, settings_.huge_pages);
+  std::vector<SocketType::DatagramView> datagrams(settings_.batch_size);
+  for (auto &datagram : datagrams) {
+    datagram.buffer = buffer_pool.Acquire();
+  }
+  std::vector<std::size_t> client_hashes(settings_.batch_size);
+  std::vector<std::size_t> server_indexes(settings_.batch_size);
+  std::vector<const SocketType *> receivers = {&shard.receiver};
+  for (const auto &receiver : shard.extra_receivers) {
+    receivers.push_back(&receiver);
+  }
+  std::optional<reactor::Reactor> reactor;
+  try {
+    reactor.emplace(*stop_event_);
+    for (std::size_t i = 0; i < receivers.size(); ++i) {
+      reactor->Add(receivers[i]->GetNativeHandle(), i);
+    }
+  } catch (const std::exception &ex) {
+    std::cerr << "Error in load balancer reactor: " << ex.what() << ".\n";
+    return;
+  }
+  std::vector<std::uint64_t> ready;
+  ready.reserve(reactor::Reactor::kMaxEvents);
+  while (true) {
+    try {
+      if (!reactor->Wait(ready)) {
+        return;
+      }
+    } catch (const std::exception &ex) {
+      std::cerr << "Error in load balancer reactor: " << ex.what() << ".\n";
+      return;
+    }
+    for (const auto index : ready) {
+      const auto &receiver = *receivers[index];
+      // Уведомление по фронту приходит только на новые датаграммы, поэтому сокет читается до
+      // тех пор, пока принимать нечего.
+      while (true) {
+        try {
+          const auto received = ForwardBatch(
+              shard, receiver, datagrams, client_hashes, server_indexes, reader, metrics
+          );
+          if (received == 0) {
+            break;
+          }
+        } catch ([[maybe_unused]] const InvalidSocketException &ex) {
+          return;
+        } catch (const std::exception &ex) {
+          metrics.Add(metrics::Counter::kForwardErrors);
+          std::cerr << "Error in load balancer: " << ex.what() << ".\n";
+        } catch (...) {
+          metrics.Add(metrics::Counter::kForwardErrors);
+          std::cerr << "Error in load balancer: uknown exception.\n";
+        }
+      }
+    }
+  }
+}
+
+std::pair<std::size_t, LoadBalancer::EndPointType> LoadBalancer::Receive(
+    const SocketType &receiver, const std::span<char> buffer
+) const {
+  if (settings_.receive_spin.count() > 0) {
+    const auto deadline = std::chrono::steady_clock::now() + settings_.receive_spin;
+    do {
+      if (const auto datagram = receiver.TryReceiveFrom(buffer)) {
+        return *datagram;
+      }
+    } while (std::chrono::steady_clock::now() < deadline);
+  }
+  return receiver.ReceiveFrom(buffer);
+}
+
+std::size_t LoadBalancer::ReceiveBatch(
+    const SocketType &receiver, const std::span<SocketType::DatagramView> datagrams
+) const {
+  if (settings_.receive_spin.count() > 0) {
+    const auto deadline = std::chrono::steady_clock::now() + settings_.receive_spin;
+    do {
+      const auto received = receiver.TryReceiveBatchFrom(datagrams);
+      if (received > 0) {
+        return received;
+      }
+    } while (std::chrono::steady_clock::now() < deadline);
+  }
+  return receiver.ReceiveBatchFrom(datagrams);
+}
+
+std::size_t LoadBalancer::ForwardBatch(
+    Shard &shard,
+    const SocketType &receiver,
+    const std::span<SocketType::DatagramView> datagrams,
+    const std::span<std::size_t> client_hashes,
+    const std::span<std::size_t> server_indexes,
+    const rcu::RcuPointer<Snapshot>::Reader &reader,
+    metrics::ThreadMetrics &metrics
+) const {
+  const auto received = ReceiveBatch(receiver, datagrams);
+  if (received == 0) {
+    return 0;
+  }
+  metrics.Add(metrics::Counter::kReceived, received);
+  for (std::size_t i = 0; i < received; ++i) {
+    const auto &datagram = datagrams[i];
+    metrics.Add(metrics::Counter::kReceivedBytes, datagram.size);
+    Capture(datagram.buffer.first(datagram.size), datagram.end_point, receiver, metrics);
+  }
+  const auto snapshot = reader.Read();
+  const auto admitted_sources = AdmitSources(
+      *snapshot,
+      datagrams.first(received),
+      [](const SocketType::DatagramView &datagram) { return datagram.end_point; },
+      metrics
+  );
+  const auto admitted = AddRequests(*snapshot, shard, admitted_sources, metrics);
+  // Серверы выбираются и для датаграмм, ожидающих в очереди допуска.
+  const auto selected = shard.admission_queue ? admitted_sources : admitted;
+  if (selected == 0) {
+    return received;
+  }
+  for (std::size_t i = 0; i < selected; ++i) {
+    client_hashes[i] = datagrams[i].end_point.Hash();
+  }
+  snapshot->balancing_strategies[shard.index]->SelectServers(
+      client_hashes.first(selected), server_indexes.first(selected)
+  );
+  snapshot->server_health->Redirect(client_hashes.first(selected), server_indexes.first(selected));
+  for (std::size_t i = admitted; i < selected; ++i) {
+    const std::string_view data(datagrams[i].buffer.data(), datagrams[i].size);
+    QueueRequest(*snapshot, shard, data, server_indexes[i], metrics);
+  }
+  if (admitted == 0) {
+    return received;
+  }
+  for (std::size_t i = 0; i < admitted; ++i) {
+    datagrams[i].end_point = snapshot->server_end_points[server_indexes[i]];
+  }
+  RecordSent(*snapshot, server_indexes.first(admitted));
+  const auto lock = LockShard(shard.send_msg_mutex);
+  shard.sender.SendBatchTo(datagrams.first(admitted));
+  for (std::size_t i = 0; i < admitted; ++i) {
+    metrics.AddForwarded(snapshot->metric_indexes[server_indexes[i]], datagrams[i].size);
+  }
+  return received;
+}
+
+void LoadBalancer::QueueWorker(Shard &shard, const std::stop_token stop) {
+  auto &metrics = metrics_registry_->RegisterThread();
+  const auto reader = snapshot_->RegisterReader();
+  auto &queue = *shard.admission_queue;
+  std::vector<std::pair<QueuedDatagram, AdmissionQueue::Duration>> released;
+  Datagrams datagrams;
+  std::vector<std::size_t> server_indexes;
+  while (queue.WaitNotEmpty(stop)) {
+    try {
+      std::shared_ptr<rate_limiter::RateLimiter> rate_limiter;
+      {
+        // Снимок не удерживается во время ожидания разрешений.
+        const auto snapshot = reader.Read();
+        rate_limiter = snapshot->rate_limiters[shard.index];
+      }
+      const auto now = AdmissionQueue::Clock::now();
+      const auto permits = rate_limiter->TryAcquire(queue.Size(), now);
+      if (permits == 0) {
+        std::this_thread::sleep_for(kQueuePollPeriod);
+        continue;
+      }
+      released.clear();
+      const auto dropped = queue.Pop(permits, now, released);
+      // Датаграммы, отброшенные CoDel, освобождают место в очереди, и разрешений может
+      // остаться больше, чем датаграмм. Неизрасходованные разрешения возвращаются ограничителю.
+      if (released.size() < permits) {
+        rate_limiter->Release(permits - released.size(), now);
+      }
+      metrics.Add(metrics::Counter::kQueueDropped, dropped);
+      metrics.Add(metrics::Counter::kQueueReleased, released.size());
+      metrics.Add(metrics::Counter::kAdmitted, released.size());
+      datagrams.clear();
+      server_indexes.clear();
+      const auto snapshot = reader.Read();
+      for (auto &[datagram, delay] : released) {
+        metrics.Add(
+            metrics::Counter::kQueueDelayUs,
+            std::chrono::duration_cast<std::chrono::microseconds>(delay).count()
+        );
+        datagrams.emplace_back(std::move(datagram.data), datagram.server);
+        if (datagram.server_latency && datagram.server_latency == snapshot->server_latency) {
+          server_indexes.push_back(datagram.server_index);
+        }
+      }
+      if (datagrams.empty()) {
+        continue;
+      }
+      RecordSent(*snapshot, server_indexes);
+      {
+        const auto lock = LockShard(shard.send_msg_mutex);
+        shard.sender.SendBatchTo(datagrams);
+      }
+      for (std::size_t i = 0; i < released.size(); ++i) {
+        metrics.AddForwarded(released[i].first.metric_index, datagrams[i].first.size());
+      }
+    } catch ([[maybe_unused]] const InvalidSocketException &ex) {
+      return;
+    } catch (const std::exception &ex) {
+      metrics.Add(metrics::Counter::kForwardErrors);
+      std::cerr << "Error in load balancer queue: " << ex.what() << ".\n";
+    }
+  }
+}
+
+void LoadBalancer::LatencyWorker(const Shard &shard, const std::stop_token stop) const {
+  const auto reader = snapshot_->RegisterReader();
+  std::array<char, kReplyBufferSize> buffer{};
+  while (!stop.stop_requested()) {
+    try {
+      if (!reader.Read()->server_latency) {
+        // Ответы не читаются, пока задержки не измеряются, и отбрасываются ядром.
+        std::this_thread::sleep_for(kReplyPollPeriod);
+        continue;
+      }
+      pollfd fd = {.fd = shard.sender.GetNativeHandle(), .events = POLLIN, .revents = 0};
+      if (poll(&fd, 1, static_cast<int>(kReplyPollPeriod.count())) <= 0) {
+        continue;
+      }
+      if ((fd.revents & POLLIN) == 0) {
+        // Очередь ошибок сокета читает проверка здоровья.
+        std::this_thread::sleep_for(kQueuePollPeriod);
+        continue;
+      }
+      const auto snapshot = reader.Read();
+      const auto &servers = snapshot->server_indexes;
+      while (const auto reply = shard.sender.TryReceiveFrom(buffer)) {
+        const auto server = servers.find(reply->second);
+        if (server != servers.end() && snapshot->server_latency) {
+          snapshot->server_latency->OnReply(server->second, std::chrono::steady_clock::now());
+        }
+      }
+    } catch ([[maybe_unused]] const InvalidSocketException &ex) {
+      return;
+    } catch ([[maybe_unused]] const std::exception &ex) {
+      // Недоступность сервера (ICMP port unreachable) возвращается следующим приемом и
+      // учитывается пассивной проверкой здоровья.
+    }
+  }
+}
+
+void LoadBalancer::RecordSent(
+    const Snapshot &snapshot, const std::span<const std::size_t> server_indexes
+) {
+  if (!snapshot.server_latency) {
+    return;
+  }
+  const auto now = std::chrono::steady_clock::now();
+  for (const auto server_index : server_indexes) {
+    snapshot.server_latency->OnSent(server_index, now);
+  }
+}
+
+void LoadBalancer::Capture(
+    const std::span<const char> datagram,
+    const EndPointType &client,
+    const SocketType &receiver,
+    metrics::ThreadMetrics &metrics
+) const {
+  if (capture_ && !capture_->Capture(datagram, client, receiver.GetEndPoint())) {
+    metrics.Add(metrics::Counter::kCaptureDropped);
+  }
+}
+
+void LoadBalancer::QueueRequest(
+    const Snapshot &snapshot,
+    const Shard &shard,
+    const std::string_view data,
+    const std::size_t server_index,
+    metrics::ThreadMetrics &metrics
+) {
+  QueuedDatagram datagram = {
+      .data = std::string(data),
+      .server = snapshot.server_end_points[server_index],
+      .server_index = server_index,
+      .metric_index = snapshot.metric_indexes[server_index],
+      .server_latency = snapshot.server_latency,
+  };
+  if (shard.admission_queue->Push(std::move(datagram), AdmissionQueue::Clock::now())) {
+    metrics.Add(metrics::Counter::kQueued);
+  } else {
+    metrics.Add(metrics::Counter::kQueueDropped);
+  }
 }
 
-void LoadBalancer::Worker() {
+void LoadBalancer::OffloadWorker(Shard &shard) {
+  auto &metrics = metrics_registry_->RegisterThread();
+  const auto reader = snapshot_->RegisterReader();
+  // Объединенный UDP_GRO буфер может иметь максимальный размер датаграммы, а разделенные
+  // датаграммы ссылаются на его части без копирования.
+  BufferPool buffer_pool(SocketType::kMaxDatagramSize, settings_.batch_size, settings_.huge_pages);
+  std::vector<SocketType::DatagramView> buffers(settings_.batch_size);
+  for (auto &buffer : buffers) {
+    buffer.buffer = buffer_pool.Acquire();
+  }
+  const auto max_datagrams = settings_.batch_size * SocketType::kMaxSegmentCount;
+  std::vector<SocketType::DatagramView> datagrams;
+  datagrams.reserve(max_datagrams);
+  std::vector<SocketType::DatagramView> grouped;
+  grouped.reserve(max_datagrams);
+  std::vector<std::size_t> client_hashes(max_datagrams);
+  std::vector<std::size_t> server_indexes(max_datagrams);
+  std::vector<std::size_t> server_offsets;
+  const auto worker = worker_scaler_->RegisterWorker();
   while (true) {
     try {
-      const auto [datagram, sender] = receiver_.ReceiveFrom();
-      if (!AddRequest()) {
+      worker.WaitUntilActive();
+      shard.receiver.ReceiveSegmentedBatchFrom(buffers, datagrams);
+      metrics.Add(metrics::Counter::kReceived, datagrams.size());
+      for (const auto &datagram : datagrams) {
+        metrics.Add(metrics::Counter::kReceivedBytes, datagram.size);
+        Capture(datagram.buffer.first(datagram.size), datagram.end_point, shard.receiver, metrics);
+      }
+      const auto snapshot = reader.Read();
+      const auto admitted_sources = AdmitSources(
+          *snapshot,
+          std::span(datagrams),
+          [](const SocketType::DatagramView &datagram) { return datagram.end_point; },
+          metrics
+      );
+      const auto admitted = AddRequests(*snapshot, shard, admitted_sources, metrics);
+      if (admitted == 0) {
         continue;
       }
-      const auto server_idx = GetNextServerIndex();
-      std::lock_guard lock(send_msg_mutex_);
-      sender_.SendTo(datagram, server_end_points_[server_idx]);
+      datagrams.resize(admitted);
+      if (server_indexes.size() < admitted) {
+        // Ядро может объединить больше сегментов, чем ожидается.
+        client_hashes.resize(admitted);
+        server_indexes.resize(admitted);
+      }
+      for (std::size_t i = 0; i < admitted; ++i) {
+        client_hashes[i] = datagrams[i].end_point.Hash();
+      }
+      snapshot->balancing_strategies[shard.index]->SelectServers(
+          std::span(client_hashes).first(admitted), std::span(server_indexes).first(admitted)
+      );
+      snapshot->server_health->Redirect(
+          std::span(client_hashes).first(admitted), std::span(server_indexes).first(admitted)
+      );
+      for (std::size_t i = 0; i < admitted; ++i) {
+        datagrams[i].end_point = snapshot->server_end_points[server_indexes[i]];
+      }
+      server_offsets.resize(snapshot->server_end_points.size() + 1);
+      GroupByServer(std::span(server_indexes).first(admitted), datagrams, server_offsets, grouped);
+      RecordSent(*snapshot, std::span(server_indexes).first(admitted));
+      {
+        const auto lock = LockShard(shard.send_msg_mutex);
+        shard.sender.SendSegmentedBatchTo(grouped);
+      }
+      for (std::size_t i = 0; i < admitted; ++i) {
+        metrics.AddForwarded(snapshot->metric_indexes[server_indexes[i]], datagrams[i].size);
+      }
     } catch ([[maybe_unused]] const InvalidSocketException &ex) {
       return;
     } catch (const std::exception &ex) {
+      metrics.Add(metrics::Counter::kForwardErrors);
       std::cerr << "Error in load balancer: " << ex.what() << ".\n";
     } catch (...) {
+      metrics.Add(metrics::Counter::kForwardErrors);
       std::cerr << "Error in load balancer: uknown exception.\n";
     }
   }
 }
 
-void LoadBalancer::UpdateConfigParameters() {
-  server_end_points_ = configuration_->GetParam(kServersKey, server_end_points_);
-  max_rps_ = configuration_->GetParam(kMaxRpsKey, max_rps_);
-  receiver_port_ = configuration_->GetParam(kReceiverPortKey, receiver_port_);
-  sender_port_ = configuration_->GetParam(kSenderPortKey, sender_port_);
+void LoadBalancer::ProxyWorker(Shard &shard) {
+  auto &metrics = metrics_registry_->RegisterThread();
+  const auto reader = snapshot_->RegisterReader();
+  BufferPool buffer_pool(settings_.buffer_size, 1, settings_.huge_pages);
+  const auto buffer = buffer_pool.Acquire();
+  while (true) {
+    try {
+      const auto [size, client] = shard.receiver.ReceiveFrom(buffer);
+      metrics.Add(metrics::Counter::kReceived);
+      metrics.Add(metrics::Counter::kReceivedBytes, size);
+      Capture(buffer.first(size), client, shard.receiver, metrics);
+      const auto snapshot = reader.Read();
+      if (!AddRequest(*snapshot, shard, client, metrics)) {
+        continue;
+      }
+      const auto &servers = snapshot->server_end_points;
+      const auto &server_health = *snapshot->server_health;
+      const auto client_hash = client.Hash();
+      const auto now = std::chrono::steady_clock::now();
+      auto flow = flow_table_->Find(client, client_hash, now);
+      if (!flow) {
+        const auto server_idx = server_health.Redirect(
+            snapshot->balancing_strategies[shard.index]->SelectServer(client_hash), client_hash
+        );
+        flow = flow_table_->Insert(client, client_hash, server_idx, now);
+        if (!flow) {
+          // Таблица потоков заполнена: запрос перенаправляется, но ответ не вернется клиенту.
+          RecordSent(*snapshot, std::span(&server_idx, 1));
+          const auto lock = LockShard(shard.send_msg_mutex);
+          shard.sender.SendTo(buffer.first(size), servers[server_idx]);
+          metrics.AddForwarded(snapshot->metric_indexes[server_idx], size);
+          continue;
+        }
+      }
+      auto server_idx = flow_table_->GetServer(*flow);
+      // Сервер потока мог быть удален из конфигурации после его выбора.
+      if (server_idx >= servers.size()) {
+        server_idx = server_health.Redirect(
+            snapshot->balancing_strategies[shard.index]->SelectServer(client_hash), client_hash
+        );
+        flow_table_->SetServer(*flow, server_idx);
+      } else if (!server_health.IsHealthy(server_idx)) {
+        server_idx = server_health.Redirect(server_idx, client_hash);
+        flow_table_->SetServer(*flow, server_idx);
+      }
+      RecordSent(*snapshot, std::span(&server_idx, 1));
+      upstream_sockets_[*flow].SendTo(buffer.first(size), servers[server_idx]);
+      metrics.AddForwarded(snapshot->metric_indexes[server_idx], size);
+    } catch ([[maybe_unused]] const InvalidSocketException &ex) {
+      return;
+    } catch (const std::exception &ex) {
+      metrics.Add(metrics::Counter::kForwardErrors);
+      std::cerr << "Error in load balancer: " << ex.what() << ".\n";
+    } catch (...) {
+      metrics.Add(metrics::Counter::kForwardErrors);
+      std::cerr << "Error in load balancer: uknown exception.\n";
+    }
+  }
 }
 
-size_t LoadBalancer::GetNextServerIndex() {
-  std::lock_guard lock(next_server_mutex_);
-  const auto server_idx = next_server_;
-  next_server_ = (next_server_ + 1) % server_end_points_.size();
-  return server_idx;
+void LoadBalancer::ReplyWorker() {
+  using Clock = std::chrono::steady_clock;
+  constexpr auto kWaitTimeout = std::chrono::milliseconds(100);
+  const auto expiry_period =
+      std::min<Clock::duration>(settings_.flow_idle_timeout / 2, std::chrono::seconds(1));
+
+  const int epoll = epoll_create1(EPOLL_CLOEXEC);
+  if (epoll < 0) {
+    std::cerr << "Can't start reply worker: " << strerror(errno) << ".\n";
+    return;
+  }
+  for (std::size_t flow = 0; flow < upstream_sockets_.size(); ++flow) {
+    epoll_event event = {.events = EPOLLIN, .data = {.u64 = flow}};
+    if (epoll_ctl(epoll, EPOLL_CTL_ADD, upstream_sockets_[flow].GetNativeHandle(), &event) < 0) {
+      std::cerr << "Can't start reply worker: " << strerror(errno) << ".\n";
+      close(epoll);
+      return;
+    }
+  }
+  const auto reader = snapshot_->RegisterReader();
+  BufferPool buffer_pool(settings_.buffer_size, 1, settings_.huge_pages);
+  const auto buffer = buffer_pool.Acquire();
+  const auto &replier = shards_.front()->receiver;
+  std::array<epoll_event, 64> events{};
+  auto next_expiry = Clock::now() + expiry_period;
+  while (!stopped_) {
+    try {
+      const int ready = epoll_wait(
+          epoll, events.data(), events.size(), static_cast<int>(kWaitTimeout.count())
+      );
+      const auto now = Clock::now();
+      const auto snapshot = reader.Read();
+      const auto &servers = snapshot->server_end_points;
+      for (int i = 0; i < ready; ++i) {
+        // Ошибку доставки без данных (EPOLLERR) забирает из очереди ошибок проверка здоровья.
+        if ((events[i].events & EPOLLIN) == 0) {
+          continue;
+        }
+        const auto flow = static_cast<std::size_t>(events[i].data.u64);
+        try {
+          while (const auto reply = upstream_sockets_[flow].TryReceiveFrom(buffer)) {
+            const auto &[size, server] = *reply;
+            // Ответ удаленного потока либо датаграмма не от сервера потока отбрасываются.
+            const auto client = flow_table_->GetClient(flow, now);
+            const auto server_idx = flow_table_->GetServer(flow);
+            if (!client || server_idx >= servers.size() || server != servers[server_idx]) {
+              continue;
+            }
+            if (snapshot->server_latency) {
+              snapshot->server_latency->OnReply(server_idx, now);
+            }
+            replier.SendTo(buffer.first(size), *client);
+          }
+        } catch ([[maybe_unused]] const InvalidSocketException &ex) {
+          throw;
+        } catch (const std::exception &ex) {
+          // Ошибка сокета одного потока не мешает принять ответы остальных потоков.
+          std::cerr << "Error in load balancer: " << ex.what() << ".\n";
+        }
+      }
+      if (now >= next_expiry) {
+        flow_table_->ExpireIdle(now);
+        next_expiry = now + expiry_period;
+      }
+    } catch ([[maybe_unused]] const InvalidSocketException &ex) {
+      break;
+    } catch (const std::exception &ex) {
+      std::cerr << "Error in load balancer: " << ex.what() << ".\n";
+    }
+  }
+  close(epoll);
+}
+
+void LoadBalancer::GroupByServer(
+    const std::span<const std::size_t> server_indexes,
+    const std::span<const SocketType::DatagramView> datagrams,
+    std::vector<std::size_t> &server_offsets,
+    std::vector<SocketType::DatagramView> &grouped
+) const {
+  // Сортировка подсчетом по индексу сервера устойчива и линейна по размеру пачки.
+  std::fill(server_offsets.begin(), server_offsets.end(), 0);
+  for (const auto server_index : server_indexes) {
+    ++server_offsets[server_index + 1];
+  }
+  for (std::size_t i = 1; i < server_offsets.size(); ++i) {
+    server_offsets[i] += server_offsets[i - 1];
+  }
+  grouped.resize(datagrams.size());
+  for (std::size_t i = 0; i < datagrams.size(); ++i) {
+    grouped[server_offsets[server_indexes[i]]++] = datagrams[i];
+  }
+}
+
+void LoadBalancer::IoUringWorker(Shard &shard) {
+  using Transport = udp::IoUringUdpTransport<ProtoFamily>;
+  // Кольцо io_uring создается в потоке, который будет его использовать.
+  std::unique_ptr<Transport> transport;
+  try {
+    transport = std::make_unique<Transport>(shard.receiver, shard.sender, settings_.buffer_size);
+  } catch (const std::exception &ex) {
+    std::cerr << "Can't start io_uring worker: " << ex.what() << ".\n";
+    return;
+  }
+  auto &metrics = metrics_registry_->RegisterThread();
+  const auto reader = snapshot_->RegisterReader();
+  std::vector<typename Transport::Datagram> datagrams;
+  datagrams.reserve(Transport::kBufferCount);
+  std::vector<std::size_t> client_hashes(Transport::kBufferCount);
+  std::vector<std::size_t> server_indexes(Transport::kBufferCount);
+  while (true) {
+    try {
+      const auto received = transport->Receive();
+      datagrams.assign(received.begin(), received.end());
+      metrics.Add(metrics::Counter::kReceived, datagrams.size());
+      for (const auto &datagram : datagrams) {
+        metrics.Add(metrics::Counter::kReceivedBytes, datagram.payload.size());
+        Capture(datagram.payload, datagram.sender, shard.receiver, metrics);
+      }
+      const auto snapshot = reader.Read();
+      const auto admitted_sources = AdmitSources(
+          *snapshot,
+          std::span(datagrams),
+          [](const auto &datagram) { return datagram.sender; },
+          metrics
+      );
+      const auto admitted = AddRequests(*snapshot, shard, admitted_sources, metrics);
+      for (std::size_t i = 0; i < admitted; ++i) {
+        client_hashes[i] = datagrams[i].sender.Hash();
+      }
+      snapshot->balancing_strategies[shard.index]->SelectServers(
+          std::span(client_hashes).first(admitted), std::span(server_indexes).first(admitted)
+      );
+      snapshot->server_health->Redirect(
+          std::span(client_hashes).first(admitted), std::span(server_indexes).first(admitted)
+      );
+      RecordSent(*snapshot, std::span(server_indexes).first(admitted));
+      for (std::size_t i = 0; i < admitted; ++i) {
+        transport->Forward(datagrams[i], snapshot->server_end_points[server_indexes[i]]);
+        metrics.AddForwarded(
+            snapshot->metric_indexes[server_indexes[i]], datagrams[i].payload.size()
+        );
+      }
+      for (std::size_t i = admitted; i < datagrams.size(); ++i) {
+        transport->Release(datagrams[i]);
+      }
+    } catch ([[maybe_unused]] const InvalidSocketException &ex) {
+      return;
+    } catch (const std::exception &ex) {
+      metrics.Add(metrics::Counter::kForwardErrors);
+      std::cerr << "Error in load balancer: " << ex.what() << ".\n";
+    } catch (...) {
+      metrics.Add(metrics::Counter::kForwardErrors);
+      std::cerr << "Error in load balancer: uknown exception.\n";
+    }
+  }
 }
 
-bool LoadBalancer::AddRequest() {
-  std::lock_guard lock(requests_mutex_);
-  const auto now = Clock::now();
-  while (!request_times_.empty() && now - request_times_.front() >= 1s) {
-    request_times_.pop();
+std::unique_lock<std::mutex> LoadBalancer::LockShard(std::mutex &mutex) const {
+  if (settings_.sharded) {
+    return {};
   }
-  if (request_times_.size() >= max_rps_) {
+  return std::unique_lock(mutex);
+}
+
+LoadBalancer::Settings LoadBalancer::ParseSettings(const config::Configuration &configuration) {
+  auto settings = kSettingsSchema.Parse(configuration);
+  std::vector<std::string> errors;
+  // Дополнительные порты обслуживает только реактор.
+  if (!settings.receiver_ports.empty() && !UsesReactor(settings)) {
+    errors.push_back(
+        std::format("key '{}': requires transport=epoll without proxy", kReceiverPortsKey)
+    );
+  }
+  // Очередь хранит копии датаграмм, принятых в буферы пула, и не поддерживается io_uring,
+  // объединенными буферами и проксированием.
+  if (settings.admission_queue > 0 &&
+      (settings.transport == TransportType::kIoUring || settings.udp_offload || settings.proxy)) {
+    errors.push_back(std::format(
+        "key '{}': requires transport=socket or epoll without udp_offload and proxy",
+        kAdmissionQueueKey
+    ));
+  }
+  // Повторный прием заменяет только блокирующий прием из сокета, а загрузка повторяющих прием
+  // потоков не отражает нагрузку.
+  if (settings.receive_spin.count() > 0 &&
+      (settings.transport != TransportType::kSocket || settings.udp_offload || settings.proxy ||
+       settings.worker_autoscale)) {
+    errors.push_back(std::format(
+        "key '{}': requires transport=socket without udp_offload, proxy and worker_autoscale",
+        kReceiveSpinKey
+    ));
+  }
+  // Количество потоков изменяется только для потоков, разделяющих блокирующий сокет приема.
+  if (settings.worker_autoscale &&
+      (settings.sharded || settings.transport != TransportType::kSocket || settings.proxy)) {
+    errors.push_back(std::format(
+        "key '{}': requires transport=socket without sharded and proxy", kWorkerAutoscaleKey
+    ));
+  }
+  if (!settings.cluster_peers.empty() && settings.cluster_port == 0) {
+    errors.push_back(std::format("key '{}': requires {}", kClusterPeersKey, kClusterPortKey));
+  }
+  if (!errors.empty()) {
+    throw config::ConfigurationError(std::move(errors));
+  }
+  return settings;
+}
+
+std::size_t LoadBalancer::GetShardMaxRps(const std::size_t max_rps, const std::size_t shard) const {
+  const auto share = rate_share_.load();
+  // Полная доля не пересчитывается через double: max_rps может быть SIZE_MAX.
+  const auto local_max_rps =
+      share >= 1 ? max_rps
+                 : static_cast<std::size_t>(std::round(static_cast<double>(max_rps) * share));
+  const auto shard_count = shards_.size();
+  return local_max_rps / shard_count + (shard < local_max_rps % shard_count ? 1 : 0);
+}
+
+void LoadBalancer::ApplyRateShare(const double share) {
+  rate_share_ = share;
+  const std::lock_guard lock(reload_mutex_);
+  const auto &snapshot = snapshot_->Get();
+  for (std::size_t i = 0; i < snapshot.rate_limiters.size(); ++i) {
+    snapshot.rate_limiters[i]->SetMaxRps(GetShardMaxRps(snapshot.settings.max_rps, i));
+  }
+}
+
+void LoadBalancer::PinWorker(const std::size_t worker) const {
+  if (!settings_.cpu_affinity) {
+    return;
+  }
+  try {
+    workers::PinCurrentThread(cpus_[worker % cpus_.size()]);
+  } catch (const std::exception &ex) {
+    std::cerr << "Can't pin load balancer worker: " << ex.what() << ".\n";
+  }
+}
+
+bool LoadBalancer::UsesReactor(const Settings &settings) {
+  return settings.transport == TransportType::kEpoll && !settings.proxy;
+}
+
+health::HealthCheckOptions LoadBalancer::GetHealthCheckOptions(const Settings &settings) {
+  return {
+      .interval = settings.health_check_interval,
+      .timeout = settings.health_check_timeout,
+      .payload = settings.health_check_payload,
+      .expect_reply = settings.health_check_expect_reply,
+      .unhealthy_threshold = settings.unhealthy_threshold,
+      .healthy_threshold = settings.healthy_threshold,
+      .ejection_time = settings.ejection_time,
+  };
+}
+
+std::size_t LoadBalancer::GetThreadCount(const Settings &settings) {
+  if (settings.thread_count != 0) {
+    return settings.thread_count;
+  }
+  return settings.sharded || settings.worker_autoscale ? workers::GetAllowedCpus().size()
+                                                      : kDefaultThreadCount;
+}
+
+std::unique_ptr<LoadBalancer::Snapshot> LoadBalancer::BuildSnapshot(
+    const Settings &settings, const Snapshot *previous
+) const {
+  auto snapshot = std::make_unique<Snapshot>();
+  snapshot->settings = settings;
+  const auto shard_count = shards_.size();
+
+  const bool servers_changed = !previous || previous->settings.servers != settings.servers;
+  std::vector<balancing::ServerInfo> server_infos;
+  for (const auto &server : settings.servers) {
+    snapshot->server_indexes.emplace(server.end_point, snapshot->server_end_points.size());
+    snapshot->server_end_points.push_back(server.end_point);
+    server_infos.push_back({.key = server.end_point.Hash(), .weight = server.weight});
+  }
+  if (servers_changed) {
+    for (const auto &server : snapshot->server_end_points) {
+      snapshot->metric_indexes.push_back(metrics_registry_->AddServer(
+          std::format("{}:{}", server.GetAddress(), server.GetPort())
+      ));
+    }
+    snapshot->server_health =
+        std::make_shared<health::ServerHealth>(snapshot->server_end_points.size());
+  } else {
+    snapshot->metric_indexes = previous->metric_indexes;
+    snapshot->server_health = previous->server_health;
+  }
+
+  bool latency_changed = false;
+  if (settings.balancing_strategy_type == balancing::BalancingStrategyType::kPeakEwma) {
+    if (!servers_changed && previous->server_latency &&
+        previous->settings.peak_ewma_decay == settings.peak_ewma_decay) {
+      snapshot->server_latency = previous->server_latency;
+    } else {
+      snapshot->server_latency = std::make_shared<balancing::ServerLatency>(
+          snapshot->server_end_points.size(), settings.peak_ewma_decay
+      );
+      latency_changed = true;
+    }
+  }
+
+  if (servers_changed || latency_changed ||
+      previous->settings.balancing_strategy_type != settings.balancing_strategy_type) {
+    for (std::size_t i = 0; i < shard_count; ++i) {
+      snapshot->balancing_strategies.push_back(balancing::CreateBalancingStrategy(
+          settings.balancing_strategy_type, server_infos, snapshot->server_latency
+      ));
+    }
+  } else {
+    snapshot->balancing_strategies = previous->balancing_strategies;
+  }
+
+  if (!previous || previous->settings.max_rps != settings.max_rps ||
+      previous->settings.rate_limiter_type != settings.rate_limiter_type) {
+    for (std::size_t i = 0; i < shard_count; ++i) {
+      snapshot->rate_limiters.push_back(rate_limiter::CreateRateLimiter(
+          settings.rate_limiter_type, GetShardMaxRps(settings.max_rps, i)
+      ));
+    }
+  } else {
+    snapshot->rate_limiters = previous->rate_limiters;
+  }
+
+  if (!previous || previous->settings.max_rps_per_source != settings.max_rps_per_source ||
+      previous->settings.source_sketch_width != settings.source_sketch_width ||
+      previous->settings.source_sketch_depth != settings.source_sketch_depth ||
+      previous->settings.heavy_hitters != settings.heavy_hitters) {
+    if (settings.max_rps_per_source > 0) {
+      snapshot->source_rate_limiter = std::make_shared<rate_limiter::SourceRateLimiter>(
+          settings.max_rps_per_source,
+          settings.source_sketch_width,
+          settings.source_sketch_depth,
+          settings.heavy_hitters
+      );
+    }
+  } else {
+    snapshot->source_rate_limiter = previous->source_rate_limiter;
+  }
+  return snapshot;
+}
+
+std::unique_ptr<health::HealthChecker<LoadBalancer::ProtoFamily>>
+LoadBalancer::CreateHealthChecker(const Snapshot &snapshot) const {
+  if (health_check_options_.interval.count() == 0 &&
+      health_check_options_.ejection_time.count() == 0) {
+    return nullptr;
+  }
+  return std::make_unique<health::HealthChecker<ProtoFamily>>(
+      snapshot.server_end_points, *snapshot.server_health, health_check_options_
+  );
+}
+
+std::vector<const LoadBalancer::SocketType *> LoadBalancer::GetHealthCheckSenders() const {
+  std::vector<const SocketType *> senders;
+  for (const auto &shard : shards_) {
+    senders.push_back(&shard->sender);
+  }
+  for (const auto &socket : upstream_sockets_) {
+    senders.push_back(&socket);
+  }
+  return senders;
+}
+
+void LoadBalancer::SetSocketBuffers(SocketType &socket, bool &force) const {
+  const auto set_size = [&force](const auto &setter) {
+    if (force) {
+      try {
+        setter(true);
+        return;
+      } catch (const std::exception &ex) {
+        // Без CAP_NET_ADMIN размеры ограничиваются net.core.rmem_max и net.core.wmem_max.
+        std::cerr << "Can't force socket buffer size: " << ex.what() << ".\n";
+        force = false;
+      }
+    }
+    setter(false);
+  };
+  if (settings_.receive_buffer > 0) {
+    set_size([this, &socket](const bool force_size) {
+      socket.SetReceiveBufferSize(static_cast<int>(settings_.receive_buffer), force_size);
+    });
+  }
+  if (settings_.send_buffer > 0) {
+    set_size([this, &socket](const bool force_size) {
+      socket.SetSendBufferSize(static_cast<int>(settings_.send_buffer), force_size);
+    });
+  }
+}
+
+std::vector<metrics::SocketStats> LoadBalancer::GetSocketStats() const {
+  std::vector<metrics::SocketStats> stats;
+  const auto add = [&stats](const std::string &name, const SocketType &socket) {
+    try {
+      stats.push_back({
+          .name = name,
+          .kernel_dropped = socket.GetKernelDrops(),
+          .receive_queue = socket.GetReceiveQueueSize(),
+          .send_queue = socket.GetSendQueueSize(),
+          .receive_buffer = socket.GetReceiveBufferSize(),
+          .send_buffer = socket.GetSendBufferSize(),
+      });
+    } catch ([[maybe_unused]] const std::exception &ex) {
+      // Сокеты приема закрываются при остановке раньше сервера счетчиков.
+    }
+  };
+  for (const auto &shard : shards_) {
+    add(std::format("receiver{}", shard->index), shard->receiver);
+    for (const auto &receiver : shard->extra_receivers) {
+      add(
+          std::format("receiver{}:{}", shard->index, receiver.GetEndPoint().GetPort()), receiver
+      );
+    }
+    add(std::format("sender{}", shard->index), shard->sender);
+  }
+  return stats;
+}
+
+bool LoadBalancer::AddRequest(
+    const Snapshot &snapshot,
+    const Shard &shard,
+    const EndPointType &client,
+    metrics::ThreadMetrics &metrics
+) {
+  if (!AdmitSource(snapshot, client)) {
+    metrics.Add(metrics::Counter::kSourceRateLimited);
     return false;
   }
-  request_times_.emplace(now);
-  return true;
+  return AddRequests(snapshot, shard, 1, metrics) == 1;
+}
+
+std::size_t LoadBalancer::AddRequests(
+    const Snapshot &snapshot,
+    const Shard &shard,
+    const std::size_t count,
+    metrics::ThreadMetrics &metrics
+) {
+  if (shard.admission_queue && !shard.admission_queue->Empty()) {
+    return 0;
+  }
+  const auto admitted = snapshot.rate_limiters[shard.index]->TryAcquire(count);
+  metrics.Add(metrics::Counter::kAdmitted, admitted);
+  // Не допущенные запросы ставятся в очередь допуска и учитываются ею.
+  if (!shard.admission_queue) {
+    metrics.Add(metrics::Counter::kRateLimited, count - admitted);
+  }
+  return admitted;
+}
+
+bool LoadBalancer::AdmitSource(const Snapshot &snapshot, const EndPointType &client) {
+  return !snapshot.source_rate_limiter ||
+         snapshot.source_rate_limiter->TryAcquire(client.AddressHash());
+}
+
+template <typename Datagram, typename GetClient>
+std::size_t LoadBalancer::AdmitSources(
+    const Snapshot &snapshot,
+    const std::span<Datagram> datagrams,
+    GetClient client,
+    metrics::ThreadMetrics &metrics
+) {
+  if (!snapshot.source_rate_limiter) {
+    return datagrams.size();
+  }
+  std::size_t admitted = 0;
+  for (std::size_t i = 0; i < datagrams.size(); ++i) {
+    if (!AdmitSource(snapshot, client(datagrams[i]))) {
+      continue;
+    }
+    // Обмен, а не копирование, сохраняет за датаграммами их буферы.
+    if (admitted != i) {
+      std::swap(datagrams[admitted], datagrams[i]);
+    }
+    ++admitted;
+  }
+  metrics.Add(metrics::Counter::kSourceRateLimited, datagrams.size() - admitted);
+  return admitted;
 }
 
 }  // namespace load_balancer
@@ -1,12 +1,35 @@
 #ifndef LOAD_BALANCER_H
 #define LOAD_BALANCER_H
 
+#include <chrono>
 #include <cstdint>
-#include <queue>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+#include <string_view>
 #include <thread>
+#include <unordered_map>
+#include <vector>
 
+#include "balancing/balancing_strategy.h"
+#include "balancing/weighted_end_point.h"
+#include "capture/traffic_capture.h"
+#include "cluster/rate_share_gossip.h"
 #include "configuration/configuration.h"
+#include "configuration/configuration_watcher.h"
+#include "health/health_checker.h"
+#include "health/server_health.h"
+#include "metrics/metrics.h"
+#include "metrics/metrics_server.h"
+#include "proxy/flow_table.h"
+#include "rate_limiter/codel_queue.h"
+#include "rate_limiter/rate_limiter.h"
+#include "rate_limiter/source_rate_limiter.h"
+#include "rcu/rcu_pointer.h"
+#include "reactor/reactor.h"
+#include "transport_type.h"
 #include "udp_socket.h"
+#include "workers/worker_scaler.h"
 
 namespace load_balancer {
 
@@ -24,23 +47,258 @@ class LoadBalancer {
   static constexpr auto ProtoFamily = ProtocolFamily::kIpV4;
   using EndPointType = udp::UdpEndPoint<ProtoFamily>;
   using SocketType = udp::UdpSocket<ProtoFamily>;
+  using ServerType = balancing::WeightedEndPoint<EndPointType>;
 
   /// Ключ в конфигурации, задающий значение максимального количества входящих запросов в секунду.
   static constexpr auto kMaxRpsKey = "max_rps";
   /// Значение максимального количества входящих запросов в секунду по умолчанию.
   static constexpr std::size_t kDefaultMaxRps = 1000;
-  /// Ключ в конфигурации, задающий адреса серверов, принимающих запросы.
+  /// Ключ в конфигурации, задающий адреса серверов, принимающих запросы, и, при необходимости,
+  /// их веса.
   static constexpr auto kServersKey = "servers";
   /// Ключ в конфигурации, задающий порт балансировщика, на который принимаются входящие запросы.
   static constexpr auto kReceiverPortKey = "receiver_port";
   /// Значение порта балансировщика, на который принимаются входящие запросы, по умолчанию.
   static constexpr std::uint16_t kDefaultReceiverPort = 10000;
+  /// Ключ в конфигурации, задающий дополнительные порты балансировщика, на которые принимаются
+  /// входящие запросы; используется только с transport=epoll.
+  static constexpr auto kReceiverPortsKey = "receiver_ports";
   /// Ключ в конфигурации, задающий порт балансировщика, с которого перенаправляются принятые
   /// запросы.
   static constexpr auto kSenderPortKey = "sender_port";
   /// Значение порта балансировщика, с которого перенаправляются принятые запросы.
   static constexpr std::uint16_t kDefaultSenderPort = 10001;
+  /// Ключ в конфигурации, задающий максимальное количество датаграмм, принимаемых и отправляемых
+  /// за один системный вызов.
+  static constexpr auto kBatchSizeKey = "batch_size";
+  /// Размер пачки датаграмм по умолчанию (пакетная обработка отключена).
+  static constexpr std::size_t kDefaultBatchSize = 1;
+  /// Ключ в конфигурации, включающий режим шардирования: каждый поток владеет собственными
+  /// сокетами (SO_REUSEPORT), стратегией выбора сервера и долей ограничения нагрузки.
+  static constexpr auto kShardedKey = "sharded";
+  /// Режим шардирования по умолчанию.
+  static constexpr bool kDefaultSharded = false;
+  /// Ключ в конфигурации, задающий алгоритм ограничения нагрузки.
+  static constexpr auto kRateLimiterKey = "rate_limiter";
+  /// Алгоритм ограничения нагрузки по умолчанию.
+  static constexpr auto kDefaultRateLimiter = rate_limiter::RateLimiterType::kSlidingWindow;
+  /// Ключ в конфигурации, задающий стратегию выбора сервера.
+  static constexpr auto kBalancingStrategyKey = "balancing_strategy";
+  /// Стратегия выбора сервера по умолчанию.
+  static constexpr auto kDefaultBalancingStrategy = balancing::BalancingStrategyType::kRoundRobin;
+  /// Ключ в конфигурации, задающий способ приема и перенаправления датаграмм.
+  static constexpr auto kTransportKey = "transport";
+  /// Способ приема и перенаправления датаграмм по умолчанию.
+  static constexpr auto kDefaultTransport = TransportType::kSocket;
+  /// Ключ в конфигурации, включающий аппаратно-независимые UDP-оптимизации ядра: объединение
+  /// принимаемых датаграмм (UDP_GRO) и отправку датаграмм одному серверу одним буфером
+  /// (UDP_SEGMENT).
+  static constexpr auto kUdpOffloadKey = "udp_offload";
+  /// Использование UDP_GRO и UDP_SEGMENT по умолчанию.
+  static constexpr bool kDefaultUdpOffload = false;
+  /// Ключ в конфигурации, задающий размер буфера принимаемой датаграммы, более длинные
+  /// датаграммы обрезаются.
+  static constexpr auto kBufferSizeKey = "buffer_size";
+  /// Размер буфера принимаемой датаграммы по умолчанию, вмещающий датаграмму размером в MTU.
+  static constexpr std::size_t kDefaultBufferSize = 2048;
+  /// Ключ в конфигурации, включающий размещение буферов датаграмм в больших страницах памяти.
+  static constexpr auto kHugePagesKey = "huge_pages";
+  /// Использование больших страниц по умолчанию.
+  static constexpr bool kDefaultHugePages = false;
+  /// Ключ в конфигурации, задающий период активной проверки здоровья серверов в миллисекундах
+  /// (0 - активная проверка отключена).
+  static constexpr auto kHealthCheckIntervalKey = "health_check_interval";
+  /// Ключ в конфигурации, задающий время ожидания результата активной проверки в миллисекундах.
+  static constexpr auto kHealthCheckTimeoutKey = "health_check_timeout";
+  /// Ключ в конфигурации, задающий датаграмму, отправляемую серверу при активной проверке.
+  static constexpr auto kHealthCheckPayloadKey = "health_check_payload";
+  /// Ключ в конфигурации, требующий ответа сервера на активную проверку.
+  static constexpr auto kHealthCheckExpectReplyKey = "health_check_expect_reply";
+  /// Ключ в конфигурации, задающий количество неудачных проверок подряд для исключения сервера.
+  static constexpr auto kUnhealthyThresholdKey = "unhealthy_threshold";
+  /// Ключ в конфигурации, задающий количество успешных проверок подряд для возврата сервера.
+  static constexpr auto kHealthyThresholdKey = "healthy_threshold";
+  /// Ключ в конфигурации, задающий время исключения сервера после ошибки доставки запроса в
+  /// миллисекундах (0 - пассивная проверка отключена).
+  static constexpr auto kEjectionTimeKey = "ejection_time";
+  /// Ключ в конфигурации, включающий двунаправленное проксирование: ответы серверов
+  /// возвращаются клиентам через порт приема запросов.
+  static constexpr auto kProxyKey = "proxy";
+  /// Двунаправленное проксирование по умолчанию.
+  static constexpr bool kDefaultProxy = false;
+  /// Ключ в конфигурации, задающий максимальное количество одновременных потоков клиентов.
+  static constexpr auto kMaxFlowsKey = "max_flows";
+  /// Максимальное количество одновременных потоков клиентов по умолчанию.
+  static constexpr std::size_t kDefaultMaxFlows = 256;
+  /// Ключ в конфигурации, задающий время простоя потока клиента в миллисекундах, после
+  /// которого поток удаляется.
+  static constexpr auto kFlowIdleTimeoutKey = "flow_idle_timeout";
+  /// Время простоя потока клиента по умолчанию.
+  static constexpr auto kDefaultFlowIdleTimeout = std::chrono::milliseconds(30000);
+  /// Ключ в конфигурации, задающий максимальное количество запросов в секунду от одного адреса
+  /// клиента (0 - ограничение отключено).
+  static constexpr auto kMaxRpsPerSourceKey = "max_rps_per_source";
+  /// Ключ в конфигурации, задающий количество счетчиков в строке скетча запросов клиентов.
+  static constexpr auto kSourceSketchWidthKey = "source_sketch_width";
+  /// Количество счетчиков в строке скетча по умолчанию.
+  static constexpr std::size_t kDefaultSourceSketchWidth = 4096;
+  /// Ключ в конфигурации, задающий количество строк скетча запросов клиентов.
+  static constexpr auto kSourceSketchDepthKey = "source_sketch_depth";
+  /// Количество строк скетча по умолчанию.
+  static constexpr std::size_t kDefaultSourceSketchDepth = 4;
+  /// Ключ в конфигурации, задающий количество отслеживаемых клиентов с наибольшей нагрузкой.
+  static constexpr auto kHeavyHittersKey = "heavy_hitters";
+  /// Количество отслеживаемых клиентов с наибольшей нагрузкой по умолчанию.
+  static constexpr std::size_t kDefaultHeavyHitters = 16;
+  /// Ключ в конфигурации, задающий время затухания оценки задержки ответов серверов стратегии
+  /// peak_ewma.
+  static constexpr auto kPeakEwmaDecayKey = "peak_ewma_decay";
+  /// Время затухания оценки задержки по умолчанию.
+  static constexpr auto kDefaultPeakEwmaDecay = std::chrono::milliseconds(10000);
+  /// Ключ в конфигурации, задающий локальный порт HTTP-сервера, отдающего счетчики в формате
+  /// Prometheus (0 - сервер отключен).
+  static constexpr auto kMetricsPortKey = "metrics_port";
+  /// Ключ в конфигурации, задающий количество потоков приема и перенаправления запросов.
+  static constexpr auto kThreadCountKey = "thread_count";
+  /// Количество потоков по умолчанию без шардирования, в режиме шардирования по умолчанию
+  /// используется по потоку на доступный процессор. При изменении количества потоков по
+  /// загрузке - количество активных потоков при запуске.
   static constexpr std::size_t kDefaultThreadCount = 2;
+  /// Ключ в конфигурации, задающий время опроса очереди устройства ядром при блокирующем
+  /// приеме без данных (SO_BUSY_POLL) в микросекундах (0 - опрос отключен).
+  static constexpr auto kBusyPollKey = "busy_poll";
+  /// Ключ в конфигурации, задающий время, в течение которого поток повторяет прием без
+  /// ожидания перед блокирующим приемом, в микросекундах (0 - прием сразу блокирующий).
+  static constexpr auto kReceiveSpinKey = "receive_spin";
+  /// Ключ в конфигурации, задающий размер буфера приема сокетов балансировщика в байтах
+  /// (SO_RCVBUF, 0 - размер по умолчанию ядра).
+  static constexpr auto kReceiveBufferKey = "receive_buffer";
+  /// Ключ в конфигурации, задающий размер буфера отправки сокетов балансировщика в байтах
+  /// (SO_SNDBUF, 0 - размер по умолчанию ядра).
+  static constexpr auto kSendBufferKey = "send_buffer";
+  /// Ключ в конфигурации, включающий установку размеров буферов без ограничений
+  /// net.core.rmem_max и net.core.wmem_max (SO_RCVBUFFORCE, SO_SNDBUFFORCE).
+  static constexpr auto kSocketBufferForceKey = "socket_buffer_force";
+  /// Установка размеров буферов без ограничений по умолчанию.
+  static constexpr bool kDefaultSocketBufferForce = false;
+  /// Ключ в конфигурации, включающий привязку потоков приема к доступным процессорам по кругу.
+  static constexpr auto kCpuAffinityKey = "cpu_affinity";
+  /// Привязка потоков к процессорам по умолчанию.
+  static constexpr bool kDefaultCpuAffinity = false;
+  /// Ключ в конфигурации, включающий изменение количества активных потоков по их загрузке,
+  /// thread_count при этом задает наибольшее количество потоков.
+  static constexpr auto kWorkerAutoscaleKey = "worker_autoscale";
+  /// Изменение количества активных потоков по загрузке по умолчанию.
+  static constexpr bool kDefaultWorkerAutoscale = false;
+  /// Ключ в конфигурации, задающий период измерения загрузки потоков.
+  static constexpr auto kWorkerScalePeriodKey = "worker_scale_period";
+  /// Период измерения загрузки потоков по умолчанию.
+  static constexpr auto kDefaultWorkerScalePeriod = std::chrono::milliseconds(1000);
+  /// Ключ в конфигурации, включающий применение изменений файла конфигурации без перезапуска.
+  static constexpr auto kConfigReloadKey = "config_reload";
+  /// Применение изменений файла конфигурации по умолчанию.
+  static constexpr bool kDefaultConfigReload = false;
+  /// Ключ в конфигурации, задающий емкость очереди допуска шарда для датаграмм сверх
+  /// ограничения нагрузки (0 - такие датаграммы сразу отбрасываются).
+  static constexpr auto kAdmissionQueueKey = "admission_queue";
+  /// Ключ в конфигурации, задающий допустимую задержку в очереди допуска (target CoDel).
+  static constexpr auto kCoDelTargetKey = "codel_target";
+  /// Допустимая задержка в очереди допуска по умолчанию.
+  static constexpr auto kDefaultCoDelTarget = std::chrono::milliseconds(5);
+  /// Ключ в конфигурации, задающий время превышения допустимой задержки, после которого
+  /// очередь допуска начинает отбрасывать датаграммы (interval CoDel).
+  static constexpr auto kCoDelIntervalKey = "codel_interval";
+  /// Время превышения допустимой задержки по умолчанию.
+  static constexpr auto kDefaultCoDelInterval = std::chrono::milliseconds(100);
+  /// Ключ в конфигурации, задающий путь к файлу pcap, в который записываются принятые
+  /// датаграммы (пустой - захват отключен).
+  static constexpr auto kCaptureFileKey = "capture_file";
+  /// Ключ в конфигурации, задающий количество датаграмм в буфере захвата.
+  static constexpr auto kCaptureBufferKey = "capture_buffer";
+  /// Количество датаграмм в буфере захвата по умолчанию.
+  static constexpr std::size_t kDefaultCaptureBuffer = 8192;
+  /// Ключ в конфигурации, задающий максимальный сохраняемый размер захваченной датаграммы.
+  static constexpr auto kCaptureSnapLengthKey = "capture_snaplen";
+  /// Максимальный сохраняемый размер захваченной датаграммы по умолчанию.
+  static constexpr std::size_t kDefaultCaptureSnapLength = 2048;
+  /// Ключ в конфигурации, задающий порт обмена нагрузкой с остальными экземплярами
+  /// балансировщика (0 - max_rps ограничивает только этот экземпляр).
+  static constexpr auto kClusterPortKey = "cluster_port";
+  /// Ключ в конфигурации, задающий конечные точки обмена нагрузкой остальных экземпляров.
+  static constexpr auto kClusterPeersKey = "cluster_peers";
+  /// Ключ в конфигурации, задающий период обмена нагрузкой между экземплярами.
+  static constexpr auto kClusterSyncPeriodKey = "cluster_sync_period";
+  /// Период обмена нагрузкой между экземплярами по умолчанию.
+  static constexpr auto kDefaultClusterSyncPeriod = std::chrono::milliseconds(100);
+  /// Максимальное количество серверов в счетчиках с учетом добавленных при перезагрузке
+  /// конфигурации.
+  static constexpr std::size_t kMaxMetricsServers = 1024;
+  /// Параметры проверки здоровья серверов по умолчанию.
+  static inline const health::HealthCheckOptions kDefaultHealthCheck{};
+
+  /**
+   * \brief Параметры балансировщика, прочитанные из конфигурации по схеме.
+   */
+  struct Settings {
+    std::vector<ServerType> servers;
+    std::size_t max_rps = kDefaultMaxRps;
+    std::size_t max_rps_per_source = 0;
+    std::size_t source_sketch_width = kDefaultSourceSketchWidth;
+    std::size_t source_sketch_depth = kDefaultSourceSketchDepth;
+    std::size_t heavy_hitters = kDefaultHeavyHitters;
+    balancing::BalancingStrategyType balancing_strategy_type = kDefaultBalancingStrategy;
+    std::chrono::milliseconds peak_ewma_decay = kDefaultPeakEwmaDecay;
+    rate_limiter::RateLimiterType rate_limiter_type = kDefaultRateLimiter;
+    std::uint16_t receiver_port = kDefaultReceiverPort;
+    std::vector<std::uint16_t> receiver_ports;
+    std::uint16_t sender_port = kDefaultSenderPort;
+    std::size_t batch_size = kDefaultBatchSize;
+    /// Количество потоков, 0 - по потоку на доступный процессор в режиме шардирования и при
+    /// изменении количества потоков по загрузке, иначе @link kDefaultThreadCount @endlink.
+    std::size_t thread_count = 0;
+    bool cpu_affinity = kDefaultCpuAffinity;
+    bool worker_autoscale = kDefaultWorkerAutoscale;
+    std::chrono::milliseconds worker_scale_period = kDefaultWorkerScalePeriod;
+    std::chrono::microseconds busy_poll{0};
+    std::chrono::microseconds receive_spin{0};
+    std::size_t receive_buffer = 0;
+    std::size_t send_buffer = 0;
+    bool socket_buffer_force = kDefaultSocketBufferForce;
+    bool sharded = kDefaultSharded;
+    TransportType transport = kDefaultTransport;
+    bool udp_offload = kDefaultUdpOffload;
+    std::size_t buffer_size = kDefaultBufferSize;
+    bool huge_pages = kDefaultHugePages;
+    std::chrono::milliseconds health_check_interval = kDefaultHealthCheck.interval;
+    std::chrono::milliseconds health_check_timeout = kDefaultHealthCheck.timeout;
+    std::string health_check_payload = kDefaultHealthCheck.payload;
+    bool health_check_expect_reply = kDefaultHealthCheck.expect_reply;
+    std::size_t unhealthy_threshold = kDefaultHealthCheck.unhealthy_threshold;
+    std::size_t healthy_threshold = kDefaultHealthCheck.healthy_threshold;
+    std::chrono::milliseconds ejection_time = kDefaultHealthCheck.ejection_time;
+    bool proxy = kDefaultProxy;
+    std::size_t max_flows = kDefaultMaxFlows;
+    std::chrono::milliseconds flow_idle_timeout = kDefaultFlowIdleTimeout;
+    std::uint16_t metrics_port = 0;
+    bool config_reload = kDefaultConfigReload;
+    std::size_t admission_queue = 0;
+    std::chrono::milliseconds codel_target = kDefaultCoDelTarget;
+    std::chrono::milliseconds codel_interval = kDefaultCoDelInterval;
+    std::uint16_t cluster_port = 0;
+    std::vector<EndPointType> cluster_peers;
+    std::chrono::milliseconds cluster_sync_period = kDefaultClusterSyncPeriod;
+    std::string capture_file;
+    std::size_t capture_buffer = kDefaultCaptureBuffer;
+    std::size_t capture_snap_length = kDefaultCaptureSnapLength;
+
+    bool operator==(const Settings &other) const = default;
+  };
+
+  /**
+   * \brief Прочитать и проверить все параметры балансировщика из конфигурации.
+   * \throws config::ConfigurationError ошибки всех неизвестных ключей и некорректных значений.
+   */
+  static Settings ParseSettings(const config::Configuration &configuration);
 
   explicit LoadBalancer(std::shared_ptr<config::Configuration> configuration);
   LoadBalancer(const LoadBalancer &other) = delete;
@@ -59,6 +317,19 @@ class LoadBalancer {
    * \brief Ожидание остановки балансировки.
    */
   void Join() const;
+  /**
+   * \brief Перечитать файл конфигурации и применить параметры, изменяемые без перезапуска:
+   * серверы, стратегию выбора сервера и ограничения нагрузки.
+   *
+   * Потоки обработки запросов переходят на новые параметры со следующей пачки датаграмм без
+   * остановки и блокировок. Состояние ограничителей нагрузки и стратегий выбора сервера,
+   * параметры которых не изменились, сохраняется. Остальные параметры применяются только при
+   * перезапуске.
+   *
+   * \throws config::ConfigurationError новая конфигурация некорректна, прежние параметры
+   * сохраняются.
+   */
+  void Reload();
   /**
    * \brief Конечная точка, с которой балансировщик принимает запросы.
    */
@@ -67,54 +338,375 @@ class LoadBalancer {
    * \brief Конечная точка, с которой балансировщик отправляет
    */
   EndPointType SenderEndPoint() const;
+  /**
+   * \brief Счетчики обработки запросов всех потоков.
+   */
+  const metrics::MetricsRegistry &GetMetrics() const;
 
  private:
   using ServerEndPoints = std::vector<EndPointType>;
-  using Clock = std::chrono::steady_clock;
-  using TimePoint = std::chrono::time_point<Clock>;
+  using Datagrams = std::vector<std::pair<std::string, EndPointType>>;
+  /**
+   * \brief Датаграмма, ожидающая в очереди допуска, с уже выбранным сервером.
+   */
+  struct QueuedDatagram {
+    std::string data;
+    EndPointType server;
+    /// Индекс сервера в снимке, по которому выбран сервер.
+    std::size_t server_index = 0;
+    /// Индекс сервера в счетчиках @link metrics_registry_ @endlink.
+    std::size_t metric_index = 0;
+    /// Задержки ответов серверов снимка, по которому выбран сервер. После изменения серверов
+    /// индекс сервера в новом снимке может принадлежать другому серверу, поэтому отправка
+    /// учитывается, только если задержки снимка не изменились.
+    std::shared_ptr<balancing::ServerLatency> server_latency;
+  };
+  using AdmissionQueue = rate_limiter::CoDelQueue<QueuedDatagram>;
+  /**
+   * \brief Ресурсы, необходимые для приема и перенаправления запросов.
+   *
+   * В режиме шардирования каждый поток владеет своим шардом и работает с ним без блокировок,
+   * иначе все потоки разделяют единственный шард, отправка через который синхронизируется.
+   */
+  struct Shard {
+    /// Номер шарда, по которому выбираются его стратегия и ограничитель в @link Snapshot
+    /// @endlink.
+    const std::size_t index;
+    SocketType receiver;
+    /// Сокеты приема запросов с дополнительных портов, обслуживаемые реактором.
+    std::vector<SocketType> extra_receivers;
+    SocketType sender;
+    mutable std::mutex send_msg_mutex;
+    /// Очередь датаграмм, не допущенных ограничением нагрузки шарда, отсутствует, если
+    /// очередь допуска отключена.
+    std::unique_ptr<AdmissionQueue> admission_queue;
 
-  const std::shared_ptr<config::Configuration> configuration_;
-  ServerEndPoints server_end_points_;
-  std::size_t max_rps_ = kDefaultMaxRps;
+    Shard(std::size_t index, SocketType receiver, SocketType sender);
+  };
+
+  /**
+   * \brief Неизменяемый снимок параметров, изменяемых без перезапуска, и построенных по ним
+   * объектов, который потоки обработки запросов читают без блокировок.
+   *
+   * Объекты, не зависящие от изменившихся параметров, разделяются с предыдущим снимком и
+   * сохраняют свое состояние.
+   */
+  struct Snapshot {
+    /// Параметры, по которым построен снимок; параметры, применяемые только при запуске, не
+    /// используются.
+    Settings settings;
+    ServerEndPoints server_end_points;
+    /// Индексы серверов по их конечным точкам, для повторяющихся - индекс первого.
+    std::unordered_map<EndPointType, std::size_t> server_indexes;
+    /// Индексы серверов в счетчиках @link metrics_registry_ @endlink.
+    std::vector<std::size_t> metric_indexes;
+    /// Стратегии выбора сервера с собственным состоянием шардов, по одной на шард.
+    std::vector<std::shared_ptr<balancing::BalancingStrategy>> balancing_strategies;
+    /// Ограничители нагрузки с долей общего ограничения, приходящейся на шард, по одному на
+    /// шард.
+    std::vector<std::shared_ptr<rate_limiter::RateLimiter>> rate_limiters;
+    /// Ограничитель нагрузки от каждого адреса клиента, общий для всех шардов, отсутствует,
+    /// если ограничение отключено.
+    std::shared_ptr<rate_limiter::SourceRateLimiter> source_rate_limiter;
+    /// Исправность серверов, общая для всех шардов.
+    std::shared_ptr<health::ServerHealth> server_health;
+    /// Задержки ответов серверов, общие для всех шардов, отсутствуют, если стратегия выбора
+    /// сервера их не использует.
+    std::shared_ptr<balancing::ServerLatency> server_latency;
+  };
 
-  std::size_t next_server_ = 0;
-  mutable std::mutex next_server_mutex_;
+  const std::shared_ptr<config::Configuration> configuration_;
+  /// Параметры, прочитанные при запуске.
+  const Settings settings_;
+  const health::HealthCheckOptions health_check_options_;
+  const std::size_t thread_count_;
+  /// Процессоры, к которым по кругу привязываются потоки при @link kCpuAffinityKey @endlink.
+  const std::vector<int> cpus_;
+  std::vector<std::unique_ptr<Shard>> shards_;
+  /// Потоки клиентов в режиме проксирования.
+  std::unique_ptr<proxy::FlowTable<EndPointType>> flow_table_;
+  /// Сокеты, через которые запросы потоков отправляются серверам и принимаются их ответы,
+  /// по одному на запись таблицы потоков.
+  std::vector<SocketType> upstream_sockets_;
+  std::unique_ptr<metrics::MetricsRegistry> metrics_registry_;
+  /// Сервер счетчиков, отсутствует, если не задан порт счетчиков.
+  std::unique_ptr<metrics::MetricsServer> metrics_server_;
+  /// Текущий снимок параметров, изменяемых без перезапуска.
+  std::unique_ptr<rcu::RcuPointer<Snapshot>> snapshot_;
+  /// Синхронизирует перезагрузку конфигурации с запуском и остановкой балансировщика.
+  std::mutex reload_mutex_;
+  /// Проверка здоровья серверов текущего снимка, отсутствует, если отключены активная и
+  /// пассивная проверки.
+  std::unique_ptr<health::HealthChecker<ProtoFamily>> health_checker_;
+  /// Отслеживание изменений файла конфигурации, отсутствует, если оно отключено.
+  std::unique_ptr<config::ConfigurationWatcher> config_watcher_;
+  /// Доля экземпляра в общем ограничении нагрузки кластера.
+  std::atomic<double> rate_share_ = 1;
+  /// Обмен нагрузкой с остальными экземплярами, отсутствует, если не задан порт обмена.
+  std::unique_ptr<cluster::RateShareGossip> rate_share_gossip_;
 
-  std::uint16_t receiver_port_ = kDefaultReceiverPort;
-  SocketType receiver_;
+  /// Захват принятых датаграмм, отсутствует, если не задан файл захвата.
+  std::unique_ptr<capture::TrafficCapture> capture_;
 
-  std::uint16_t sender_port_ = kDefaultSenderPort;
-  SocketType sender_;
-  mutable std::mutex send_msg_mutex_;
+  /// Событие остановки реакторов, отсутствует, если реактор не используется.
+  std::unique_ptr<reactor::StopEvent> stop_event_;
 
-  std::queue<TimePoint> request_times_;
-  mutable std::mutex requests_mutex_;
+  /// Активные потоки приема из @link threads_ @endlink; без изменения количества потоков по
+  /// загрузке активны все потоки.
+  std::unique_ptr<workers::WorkerScaler> worker_scaler_;
 
-  size_t thread_count_ = kDefaultThreadCount;
   std::vector<std::jthread> threads_;
+  /// Потоки измерения задержек ответов, по одному на шард. Запускаются при публикации первого
+  /// снимка, стратегия которого использует задержки, и работают до остановки.
+  std::vector<std::jthread> latency_threads_;
 
   std::atomic_bool stopped_ = true;
 
   /**
    * \brief Прием и перенаправление запросов.
+   *
+   * Датаграмма принимается в буфер из пула потока и отправляется из него же, поэтому
+   * обработка запроса не выделяет память.
+   */
+  void Worker(Shard &shard);
+  /**
+   * \brief Прием и перенаправление запросов пачками по @link Settings::batch_size @endlink
+   * датаграмм.
+   *
+   * Датаграммы принимаются в буферы из пула потока и отправляются из них же. Ограничение
+   * нагрузки и выбор серверов выполняются один раз на всю пачку.
+   */
+  void BatchWorker(Shard &shard);
+  /**
+   * \brief Прием и перенаправление запросов со всех сокетов приема шарда через реактор epoll.
+   *
+   * Сокеты неблокирующие и отслеживаются по фронту, поэтому готовый сокет читается пачками по
+   * @link Settings::batch_size @endlink датаграмм, пока принимать нечего. Остановка пробуждает
+   * реактор событием, без закрытия сокетов.
+   */
+  void EpollWorker(Shard &shard);
+  /**
+   * \brief Допуск датаграмм из очереди шарда по мере появления разрешений ограничителя нагрузки.
+   *
+   * Датаграммы, отброшенные CoDel, разрешений не расходуют: оставшиеся после извлечения
+   * разрешения возвращаются ограничителю.
+   */
+  void QueueWorker(Shard &shard, std::stop_token stop);
+  /**
+   * \brief Прием ответов серверов на сокет отправки шарда и измерение задержек ответов, если
+   * стратегия выбора сервера их использует.
+   */
+  void LatencyWorker(const Shard &shard, std::stop_token stop) const;
+  /**
+   * \brief Запустить потоки измерения задержек ответов, если они еще не запущены и текущий
+   * снимок использует задержки. Вызывается под @link reload_mutex_ @endlink.
+   */
+  void StartLatencyWorkers();
+  /**
+   * \brief Учесть отправку запросов серверам в задержках ответов снимка, если они измеряются.
+   *
+   * Вызывается до отправки: ответ может быть принят раньше, чем отправка вернет управление.
+   */
+  static void RecordSent(const Snapshot &snapshot, std::span<const std::size_t> server_indexes);
+  /**
+   * \brief Захватить принятую датаграмму, если захват включен.
+   *
+   * Не блокирует поток: при заполненном буфере захвата датаграмма только учитывается в
+   * счетчике @link metrics::Counter::kCaptureDropped @endlink.
+   */
+  void Capture(
+      std::span<const char> datagram,
+      const EndPointType &client,
+      const SocketType &receiver,
+      metrics::ThreadMetrics &metrics
+  ) const;
+  /**
+   * \brief Поставить датаграмму, не допущенную ограничением нагрузки, в очередь допуска шарда.
+   */
+  static void QueueRequest(
+      const Snapshot &snapshot,
+      const Shard &shard,
+      std::string_view data,
+      std::size_t server_index,
+      metrics::ThreadMetrics &metrics
+  );
+  /**
+   * \brief Принять датаграмму в буфер, повторяя прием без ожидания в течение
+   * @link kReceiveSpinKey @endlink перед блокирующим приемом.
+   *
+   * Пробуждение заблокированного потока занимает больше времени, чем обработка датаграммы,
+   * поэтому при частых запросах повторный прием сокращает задержку ценой загрузки процессора.
+   */
+  std::pair<std::size_t, EndPointType> Receive(
+      const SocketType &receiver, std::span<char> buffer
+  ) const;
+  /**
+   * \brief Принять пачку датаграмм так же, как @link Receive @endlink.
+   * \return количество принятых датаграмм, 0 - неблокирующему сокету нечего принять.
+   */
+  std::size_t ReceiveBatch(
+      const SocketType &receiver, std::span<SocketType::DatagramView> datagrams
+  ) const;
+  /**
+   * \brief Принять пачку датаграмм из сокета и перенаправить допущенные серверам.
+   * \param datagrams датаграммы с буферами для приема;
+   * \param client_hashes, server_indexes буферы выбора серверов размером не меньше пачки.
+   * \return количество принятых датаграмм, 0 - неблокирующему сокету нечего принять.
+   */
+  std::size_t ForwardBatch(
+      Shard &shard,
+      const SocketType &receiver,
+      std::span<SocketType::DatagramView> datagrams,
+      std::span<std::size_t> client_hashes,
+      std::span<std::size_t> server_indexes,
+      const rcu::RcuPointer<Snapshot>::Reader &reader,
+      metrics::ThreadMetrics &metrics
+  ) const;
+  /**
+   * \brief Прием и перенаправление запросов пачками с использованием
+   * @link Settings::udp_offload @endlink.
+   *
+   * Пачка может содержать больше @link Settings::batch_size @endlink датаграмм за счет
+   * разделения объединенных ядром буферов, а датаграммы одному серверу отправляются одним
+   * буфером UDP_SEGMENT.
+   */
+  void OffloadWorker(Shard &shard);
+  /**
+   * \brief Прием и перенаправление запросов в режиме проксирования.
+   *
+   * Сервер выбирается при первом запросе клиента и закрепляется за его потоком. Запросы
+   * потока отправляются через сокет его записи в таблице потоков, поэтому ответы сервера
+   * приходят на собственный порт потока.
    */
-  void Worker();
+  void ProxyWorker(Shard &shard);
   /**
-   * \brief Обновить значения параметров, значениями из конфигурации.
+   * \brief Прием ответов серверов на сокетах потоков и их отправка клиентам через порт приема
+   * запросов, а также удаление простаивающих потоков.
    */
-  void UpdateConfigParameters();
+  void ReplyWorker();
   /**
-   * \brief Получить индекс следующего сервера для перенаправления ему запроса.
+   * \brief Расположить датаграммы одному серверу подряд, сохраняя порядок их приема.
+   * \param server_indexes индексы серверов, выбранных для датаграмм;
+   * \param datagrams датаграммы с адресами выбранных серверов;
+   * \param server_offsets переиспользуемый буфер смещений групп серверов;
+   * \param grouped датаграммы, сгруппированные по серверам, ссылаются на те же буферы.
+   */
+  void GroupByServer(
+      std::span<const std::size_t> server_indexes,
+      std::span<const SocketType::DatagramView> datagrams,
+      std::vector<std::size_t> &server_offsets,
+      std::vector<SocketType::DatagramView> &grouped
+  ) const;
+  /**
+   * \brief Прием и перенаправление запросов через io_uring.
+   *
+   * За одну итерацию обрабатываются все уже полученные датаграммы, а их отправки передаются ядру
+   * вместе с ожиданием следующих, поэтому @link Settings::batch_size @endlink не используется.
+   */
+  void IoUringWorker(Shard &shard);
+  /**
+   * \brief Ограничение нагрузки шарда: доля шарда в доле экземпляра в общем ограничении.
+   */
+  [[nodiscard]] std::size_t GetShardMaxRps(std::size_t max_rps, std::size_t shard) const;
+  /**
+   * \brief Применить новую долю экземпляра в общем ограничении к ограничителям текущего
+   * снимка, сохраняя их состояние.
+   */
+  void ApplyRateShare(double share);
+  /**
+   * \brief Привязать вызывающий поток приема к процессору по его номеру, если привязка
+   * включена.
    *
-   * После этого индекс будет указывать на следующий за выбранным сервер.
+   * Вызывается до выделения буферов потока, чтобы они оказались на узле NUMA процессора.
+   */
+  void PinWorker(std::size_t worker) const;
+  /**
+   * \brief Используется ли реактор epoll для приема запросов.
+   */
+  static bool UsesReactor(const Settings &settings);
+  /**
+   * \brief Захватить мьютекс шарда, если шард разделяется несколькими потоками.
+   */
+  [[nodiscard]] std::unique_lock<std::mutex> LockShard(std::mutex &mutex) const;
+  /**
+   * \brief Параметры проверки здоровья серверов.
+   */
+  static health::HealthCheckOptions GetHealthCheckOptions(const Settings &settings);
+  /**
+   * \brief Количество потоков приема и перенаправления запросов с учетом значения по умолчанию.
+   */
+  static std::size_t GetThreadCount(const Settings &settings);
+  /**
+   * \brief Построить снимок по параметрам, переиспользуя объекты предыдущего снимка, параметры
+   * которых не изменились.
+   * \param previous предыдущий снимок, nullptr - снимок строится впервые.
+   */
+  [[nodiscard]] std::unique_ptr<Snapshot> BuildSnapshot(
+      const Settings &settings, const Snapshot *previous
+  ) const;
+  /**
+   * \brief Создать проверку здоровья серверов снимка, если она включена.
+   */
+  [[nodiscard]] std::unique_ptr<health::HealthChecker<ProtoFamily>> CreateHealthChecker(
+      const Snapshot &snapshot
+  ) const;
+  /**
+   * \brief Сокеты, очереди ошибок которых читает пассивная проверка здоровья.
+   */
+  [[nodiscard]] std::vector<const SocketType *> GetHealthCheckSenders() const;
+  /**
+   * \brief Установить размеры буферов сокета, заданные в параметрах.
+   * \param force устанавливать размеры без ограничений ядра, сбрасывается с предупреждением,
+   * если для этого недостаточно прав (нет CAP_NET_ADMIN).
+   */
+  void SetSocketBuffers(SocketType &socket, bool &force) const;
+  /**
+   * \brief Состояние сокетов приема и отправки шардов для выгрузки счетчиков.
+   */
+  [[nodiscard]] std::vector<metrics::SocketStats> GetSocketStats() const;
+  /**
+   * \brief Допустить новый запрос клиента в систему.
+   * \return true - если запрос допущен, false - если превышено ограничение нагрузки клиента или
+   * шарда.
+   */
+  static bool AddRequest(
+      const Snapshot &snapshot,
+      const Shard &shard,
+      const EndPointType &client,
+      metrics::ThreadMetrics &metrics
+  );
+  /**
+   * \brief Допустить несколько новых запросов в систему.
+   *
+   * Пока очередь допуска шарда не пуста, новые запросы не допускаются, а ставятся в очередь
+   * вызывающим за ожидающими, сохраняя порядок.
+   *
+   * \return количество допущенных запросов, не превышающее ограничения нагрузки шарда.
+   */
+  static std::size_t AddRequests(
+      const Snapshot &snapshot,
+      const Shard &shard,
+      std::size_t count,
+      metrics::ThreadMetrics &metrics
+  );
+  /**
+   * \brief Проверить ограничение нагрузки от адреса клиента.
+   * \return true - если запрос клиента допущен.
    */
-  size_t GetNextServerIndex();
+  static bool AdmitSource(const Snapshot &snapshot, const EndPointType &client);
   /**
-   * \brief Добавить время получения нового запроса.
-   * \return true - если добавление прошло успешно, false - если кол-во запросов, поступивших в
-   * систему больше @link max_rps_ заданного@endlink.
+   * \brief Оставить в начале последовательности датаграммы клиентов, не превысивших
+   * ограничения нагрузки, сохраняя их порядок.
+   * \param client функция, возвращающая конечную точку клиента датаграммы.
+   * \return количество оставленных датаграмм.
    */
-  bool AddRequest();
+  template <typename Datagram, typename GetClient>
+  static std::size_t AdmitSources(
+      const Snapshot &snapshot,
+      std::span<Datagram> datagrams,
+      GetClient client,
+      metrics::ThreadMetrics &metrics
+  );
 };
 
 }  // namespace load_balancer
@@ -0,0 +1,210 @@
+#include "metrics.h"
+
+#include <algorithm>
+#include <format>
+
+namespace load_balancer::metrics {
+
+namespace {
+
+/**
+ * \brief Описание счетчика для выгрузки.
+ */
+struct CounterInfo {
+  const char *name;
+  const char *help;
+};
+
+constexpr std::array<CounterInfo, static_cast<std::size_t>(Counter::kCount)> kCounterInfos = {{
+    {"load_balancer_received_datagrams_total", "Datagrams received from clients."},
+    {"load_balancer_received_bytes_total", "Bytes of datagrams received from clients."},
+    {"load_balancer_admitted_datagrams_total", "Datagrams admitted by the rate limiters."},
+    {"load_balancer_rate_limited_datagrams_total", "Datagrams dropped by the global rate limit."},
+    {"load_balancer_source_rate_limited_datagrams_total",
+     "Datagrams dropped by the per-source rate limit."},
+    {"load_balancer_forward_errors_total", "Errors while receiving or forwarding datagrams."},
+    {"load_balancer_queued_datagrams_total", "Datagrams delayed in the admission queue."},
+    {"load_balancer_queue_dropped_datagrams_total",
+     "Datagrams dropped by the admission queue on overflow or by CoDel."},
+    {"load_balancer_queue_released_datagrams_total",
+     "Datagrams admitted from the admission queue."},
+    {"load_balancer_queue_delay_microseconds_total",
+     "Total queueing delay of datagrams admitted from the admission queue."},
+    {"load_balancer_capture_dropped_datagrams_total",
+     "Datagrams not captured because the capture buffer was full."},
+}};
+
+constexpr auto kForwardedName = "load_balancer_forwarded_datagrams_total";
+constexpr auto kForwardedBytesName = "load_balancer_forwarded_bytes_total";
+constexpr auto kKernelDroppedName = "load_balancer_kernel_dropped_datagrams_total";
+
+/**
+ * \brief Показатель сокета, выгружаемый как gauge.
+ */
+struct SocketGaugeInfo {
+  const char *name;
+  const char *help;
+  std::uint64_t SocketStats::*value;
+};
+
+constexpr std::array<SocketGaugeInfo, 4> kSocketGaugeInfos = {{
+    {"load_balancer_socket_receive_queue_bytes",
+     "Size of the first datagram waiting in the socket receive queue.",
+     &SocketStats::receive_queue},
+    {"load_balancer_socket_send_queue_bytes",
+     "Bytes not yet sent by the socket.",
+     &SocketStats::send_queue},
+    {"load_balancer_socket_receive_buffer_bytes",
+     "Socket receive buffer size.",
+     &SocketStats::receive_buffer},
+    {"load_balancer_socket_send_buffer_bytes",
+     "Socket send buffer size.",
+     &SocketStats::send_buffer},
+}};
+
+void AppendHeader(
+    std::string &out, const char *name, const char *help, const char *type = "counter"
+) {
+  out += std::format("# HELP {} {}\n# TYPE {} {}\n", name, help, name, type);
+}
+
+}  // namespace
+
+ThreadMetrics::ThreadMetrics(const std::size_t server_count)
+    : server_count_(server_count),
+      server_counters_(std::make_unique<CacheLine[]>(
+          (server_count * 2 + kValuesPerLine - 1) / kValuesPerLine
+      )) {
+}
+
+void ThreadMetrics::Add(const Counter counter, const std::uint64_t value) {
+  Increment(counters_[static_cast<std::size_t>(counter)], value);
+}
+
+void ThreadMetrics::AddForwarded(const std::size_t server, const std::uint64_t bytes) {
+  if (server >= server_count_) {
+    return;
+  }
+  Increment(ServerCounter(server * 2), 1);
+  Increment(ServerCounter(server * 2 + 1), bytes);
+}
+
+std::uint64_t ThreadMetrics::Get(const Counter counter) const {
+  return counters_[static_cast<std::size_t>(counter)].load(std::memory_order_relaxed);
+}
+
+std::uint64_t ThreadMetrics::GetForwarded(const std::size_t server) const {
+  return ServerCounter(server * 2).load(std::memory_order_relaxed);
+}
+
+std::uint64_t ThreadMetrics::GetForwardedBytes(const std::size_t server) const {
+  return ServerCounter(server * 2 + 1).load(std::memory_order_relaxed);
+}
+
+void ThreadMetrics::Increment(std::atomic<std::uint64_t> &counter, const std::uint64_t value) {
+  // Единственный писатель: атомарное сложение не требуется.
+  counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+std::atomic<std::uint64_t> &ThreadMetrics::ServerCounter(const std::size_t index) const {
+  return server_counters_[index / kValuesPerLine].values[index % kValuesPerLine];
+}
+
+MetricsRegistry::MetricsRegistry(std::vector<std::string> servers, const std::size_t max_servers)
+    : max_servers_(std::max(servers.size(), max_servers)), servers_(std::move(servers)) {
+}
+
+ThreadMetrics &MetricsRegistry::RegisterThread() {
+  const std::lock_guard lock(threads_mutex_);
+  return *threads_.emplace_back(std::make_unique<ThreadMetrics>(max_servers_));
+}
+
+std::size_t MetricsRegistry::AddServer(const std::string &name) {
+  const std::lock_guard lock(threads_mutex_);
+  const auto server = std::find(servers_.begin(), servers_.end(), name);
+  if (server != servers_.end()) {
+    return server - servers_.begin();
+  }
+  if (servers_.size() == max_servers_) {
+    return max_servers_;
+  }
+  servers_.push_back(name);
+  return servers_.size() - 1;
+}
+
+std::size_t MetricsRegistry::GetMaxServers() const {
+  return max_servers_;
+}
+
+std::uint64_t MetricsRegistry::Get(const Counter counter) const {
+  const std::lock_guard lock(threads_mutex_);
+  std::uint64_t sum = 0;
+  for (const auto &thread : threads_) {
+    sum += thread->Get(counter);
+  }
+  return sum;
+}
+
+void MetricsRegistry::SetSocketStatsSource(std::function<std::vector<SocketStats>()> source) {
+  socket_stats_source_ = std::move(source);
+}
+
+std::string MetricsRegistry::Export() const {
+  // Состояние сокетов запрашивается у ядра без блокировки потоков, регистрирующих счетчики.
+  const auto sockets =
+      socket_stats_source_ ? socket_stats_source_() : std::vector<SocketStats>();
+  const std::lock_guard lock(threads_mutex_);
+  std::string out;
+  for (std::size_t i = 0; i < kCounterInfos.size(); ++i) {
+    std::uint64_t sum = 0;
+    for (const auto &thread : threads_) {
+      sum += thread->Get(static_cast<Counter>(i));
+    }
+    AppendHeader(out, kCounterInfos[i].name, kCounterInfos[i].help);
+    out += std::format("{} {}\n", kCounterInfos[i].name, sum);
+    if (static_cast<Counter>(i) == Counter::kSourceRateLimited && !sockets.empty()) {
+      AppendHeader(
+          out, kKernelDroppedName, "Datagrams dropped by the kernel on receive buffer overflow."
+      );
+      for (const auto &socket : sockets) {
+        out += std::format(
+            "{}{{socket=\"{}\"}} {}\n", kKernelDroppedName, socket.name, socket.kernel_dropped
+        );
+      }
+    }
+  }
+  std::vector<std::uint64_t> forwarded(servers_.size());
+  std::vector<std::uint64_t> forwarded_bytes(servers_.size());
+  for (const auto &thread : threads_) {
+    for (std::size_t server = 0; server < servers_.size(); ++server) {
+      forwarded[server] += thread->GetForwarded(server);
+      forwarded_bytes[server] += thread->GetForwardedBytes(server);
+    }
+  }
+  AppendHeader(out, kForwardedName, "Datagrams forwarded to the server.");
+  for (std::size_t server = 0; server < servers_.size(); ++server) {
+    out += std::format(
+        "{}{{server=\"{}\"}} {}\n", kForwardedName, servers_[server], forwarded[server]
+    );
+  }
+  AppendHeader(out, kForwardedBytesName, "Bytes of datagrams forwarded to the server.");
+  for (std::size_t server = 0; server < servers_.size(); ++server) {
+    out += std::format(
+        "{}{{server=\"{}\"}} {}\n", kForwardedBytesName, servers_[server], forwarded_bytes[server]
+    );
+  }
+  if (sockets.empty()) {
+    return out;
+  }
+  for (const auto &gauge : kSocketGaugeInfos) {
+    AppendHeader(out, gauge.name, gauge.help, "gauge");
+    for (const auto &socket : sockets) {
+      out += std::format(
+          "{}{{socket=\"{}\"}} {}\n", gauge.name, socket.name, socket.*gauge.value
+      );
+    }
+  }
+  return out;
+}
+
+}  // namespace load_balancer::metrics
@@ -0,0 +1,165 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "cache_line.h"
+
+namespace load_balancer::metrics {
+
+/**
+ * \brief Счетчик событий обработки запросов.
+ */
+enum class Counter : std::size_t {
+  kReceived,           ///< Принятые датаграммы.
+  kReceivedBytes,      ///< Байты принятых датаграмм.
+  kAdmitted,           ///< Датаграммы, допущенные ограничениями нагрузки.
+  kRateLimited,        ///< Датаграммы, отброшенные общим ограничением нагрузки.
+  kSourceRateLimited,  ///< Датаграммы, отброшенные ограничением нагрузки от адреса клиента.
+  kForwardErrors,      ///< Ошибки приема и перенаправления датаграмм.
+  kQueued,             ///< Датаграммы, поставленные в очередь допуска.
+  kQueueDropped,       ///< Датаграммы, отброшенные очередью допуска: переполнение или CoDel.
+  kQueueReleased,      ///< Датаграммы, допущенные из очереди допуска.
+  kQueueDelayUs,       ///< Суммарное время ожидания допущенных из очереди датаграмм, мкс.
+  kCaptureDropped,     ///< Датаграммы, не захваченные из-за заполненного буфера захвата.
+  kCount,              ///< Количество счетчиков.
+};
+
+/**
+ * \brief Счетчики одного потока.
+ *
+ * Счетчики изменяет только поток-владелец, поэтому увеличение - это обычные чтение и запись
+ * без атомарного чтения-изменения-записи и без конкуренции за кэш-линию: объект и счетчики
+ * серверов занимают собственные кэш-линии. Атомарность нужна только для чтения счетчиков
+ * при выгрузке из другого потока.
+ */
+class alignas(kCacheLineSize) ThreadMetrics {
+ public:
+  explicit ThreadMetrics(std::size_t server_count);
+
+  ThreadMetrics(const ThreadMetrics &other) = delete;
+  ThreadMetrics &operator=(const ThreadMetrics &other) = delete;
+
+  /**
+   * \brief Увеличить счетчик.
+   */
+  void Add(Counter counter, std::uint64_t value = 1);
+  /**
+   * \brief Учесть датаграмму, перенаправленную серверу.
+   * \param server индекс сервера, датаграммы серверов вне реестра не учитываются;
+   * \param bytes размер датаграммы.
+   */
+  void AddForwarded(std::size_t server, std::uint64_t bytes);
+
+  [[nodiscard]] std::uint64_t Get(Counter counter) const;
+  /**
+   * \brief Количество датаграмм, перенаправленных серверу.
+   */
+  [[nodiscard]] std::uint64_t GetForwarded(std::size_t server) const;
+  /**
+   * \brief Количество байт, перенаправленных серверу.
+   */
+  [[nodiscard]] std::uint64_t GetForwardedBytes(std::size_t server) const;
+
+ private:
+  static constexpr std::size_t kValuesPerLine = kCacheLineSize / sizeof(std::uint64_t);
+
+  struct alignas(kCacheLineSize) CacheLine {
+    std::array<std::atomic<std::uint64_t>, kValuesPerLine> values = {};
+  };
+
+  std::array<std::atomic<std::uint64_t>, static_cast<std::size_t>(Counter::kCount)> counters_ =
+      {};
+  const std::size_t server_count_;
+  /// Пары счетчиков серверов: количество датаграмм - количество байт.
+  std::unique_ptr<CacheLine[]> server_counters_;
+
+  static void Increment(std::atomic<std::uint64_t> &counter, std::uint64_t value);
+  std::atomic<std::uint64_t> &ServerCounter(std::size_t index) const;
+};
+
+/**
+ * \brief Состояние сокета балансировщика, которое ядро не сообщает через счетчики потоков.
+ */
+struct SocketStats {
+  /// Имя сокета в метке socket.
+  std::string name;
+  /// Датаграммы, отброшенные ядром из-за переполнения буфера приема (SO_RXQ_OVFL).
+  std::uint64_t kernel_dropped = 0;
+  /// Размер первой ожидающей приема датаграммы (SIOCINQ), 0 - очередь приема пуста.
+  std::uint64_t receive_queue = 0;
+  /// Размер еще не переданных устройству данных (SIOCOUTQ).
+  std::uint64_t send_queue = 0;
+  /// Действующий размер буфера приема.
+  std::uint64_t receive_buffer = 0;
+  /// Действующий размер буфера отправки.
+  std::uint64_t send_buffer = 0;
+};
+
+/**
+ * \brief Реестр счетчиков всех потоков.
+ *
+ * Поток регистрирует собственные счетчики один раз при запуске, а суммы по потокам
+ * вычисляются только при выгрузке. Счетчики остановленных потоков сохраняются, поэтому
+ * выгружаемые значения не убывают. По той же причине серверы только добавляются в реестр:
+ * счетчики сервера, удаленного из конфигурации, продолжают выгружаться.
+ */
+class MetricsRegistry {
+ public:
+  /**
+   * \param servers имена серверов в порядке их индексов, используемые в метках;
+   * \param max_servers максимальное количество серверов с учетом добавляемых позже.
+   */
+  explicit MetricsRegistry(std::vector<std::string> servers, std::size_t max_servers = 0);
+
+  MetricsRegistry(const MetricsRegistry &other) = delete;
+  MetricsRegistry &operator=(const MetricsRegistry &other) = delete;
+
+  /**
+   * \brief Создать счетчики нового потока.
+   * \return счетчики, существующие до уничтожения реестра.
+   */
+  ThreadMetrics &RegisterThread();
+  /**
+   * \brief Найти сервер по имени либо добавить его.
+   * \return индекс сервера в счетчиках, @link GetMaxServers @endlink - реестр заполнен.
+   */
+  std::size_t AddServer(const std::string &name);
+  [[nodiscard]] std::size_t GetMaxServers() const;
+
+  /**
+   * \brief Сумма счетчика по всем потокам.
+   */
+  [[nodiscard]] std::uint64_t Get(Counter counter) const;
+  /**
+   * \brief Задать источник состояния сокетов, опрашиваемый при каждой выгрузке.
+   *
+   * Задается до начала выгрузки, например, до запуска сервера счетчиков.
+   */
+  void SetSocketStatsSource(std::function<std::vector<SocketStats>()> source);
+  /**
+   * \brief Выгрузить счетчики в текстовом формате Prometheus.
+   *
+   * Отброшенные ядром датаграммы выгружаются рядом с отброшенными ограничениями нагрузки,
+   * чтобы перегрузку приема можно было отличить от работы ограничений.
+   */
+  [[nodiscard]] std::string Export() const;
+
+ private:
+  const std::size_t max_servers_;
+  std::function<std::vector<SocketStats>()> socket_stats_source_;
+  mutable std::mutex threads_mutex_;
+  std::vector<std::string> servers_;
+  std::vector<std::unique_ptr<ThreadMetrics>> threads_;
+};
+
+}  // namespace load_balancer::metrics
+
+#endif  // METRICS_H
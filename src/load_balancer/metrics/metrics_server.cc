@@ -0,0 +1,97 @@
+#include "metrics_server.h"
+
+#include <poll.h>
+
+#include <array>
+#include <format>
+#include <iostream>
+
+#include "invalid_socket_exception.h"
+
+namespace load_balancer::metrics {
+
+MetricsServer::MetricsServer(const std::uint16_t port, const MetricsRegistry &registry)
+    : registry_(registry), listener_("127.0.0.1", port, {.reuse_address = true}) {
+  listener_.Listen();
+}
+
+MetricsServer::~MetricsServer() {
+  Stop();
+}
+
+void MetricsServer::Start() {
+  thread_ = std::jthread([this](const std::stop_token &stop_token) {
+    Worker(stop_token);
+  });
+}
+
+void MetricsServer::Stop() {
+  thread_ = {};
+}
+
+MetricsServer::EndPointType MetricsServer::GetEndPoint() const {
+  return listener_.GetEndPoint();
+}
+
+void MetricsServer::Worker(const std::stop_token &stop_token) {
+  while (!stop_token.stop_requested()) {
+    try {
+      pollfd fd = {.fd = listener_.GetNativeHandle(), .events = POLLIN, .revents = 0};
+      if (poll(&fd, 1, static_cast<int>(kPollTimeout.count())) <= 0) {
+        continue;
+      }
+      const auto connection = listener_.Accept();
+      HandleConnection(connection);
+    } catch ([[maybe_unused]] const socket_wrapper::InvalidSocketException &ex) {
+      return;
+    } catch (const std::exception &ex) {
+      std::cerr << "Error in metrics server: " << ex.what() << ".\n";
+    }
+  }
+}
+
+void MetricsServer::HandleConnection(const SocketType &connection) const {
+  connection.SetReceiveTimeout(kRequestTimeout);
+  std::array<char, kMaxRequestSize> buffer{};
+  std::size_t size = 0;
+  std::string_view request;
+  while (size < buffer.size()) {
+    const auto received = connection.ReceiveSome(std::span(buffer).subspan(size));
+    if (received == 0) {
+      return;
+    }
+    size += received;
+    request = std::string_view(buffer.data(), size);
+    if (request.find("\r\n\r\n") != std::string_view::npos) {
+      break;
+    }
+  }
+  connection.Send(MakeResponse(std::string(request.substr(0, request.find("\r\n")))));
+}
+
+std::string MetricsServer::MakeResponse(const std::string &request_line) const {
+  const auto method_end = request_line.find(' ');
+  const auto path_end = request_line.find(' ', method_end + 1);
+  const auto method = request_line.substr(0, method_end);
+  const auto path = method_end == std::string::npos
+                        ? std::string()
+                        : request_line.substr(method_end + 1, path_end - method_end - 1);
+  std::string status = "200 OK";
+  std::string body;
+  if (method != "GET") {
+    status = "405 Method Not Allowed";
+  } else if (path != kMetricsPath) {
+    status = "404 Not Found";
+  } else {
+    body = registry_.Export();
+  }
+  return std::format(
+      "HTTP/1.1 {}\r\nContent-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+      "Content-Length: {}\r\nConnection: close\r\n\r\n{}",
+      status,
+      body.size(),
+      body
+  );
+}
+
+}  // namespace load_balancer::metrics
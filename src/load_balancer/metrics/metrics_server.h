@@ -0,0 +1,70 @@
+#ifndef METRICS_SERVER_H
+#define METRICS_SERVER_H
+
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include "metrics.h"
+#include "tcp_socket.h"
+
+namespace load_balancer::metrics {
+
+/**
+ * \brief Встроенный HTTP-сервер, отдающий счетчики реестра в текстовом формате Prometheus по
+ * запросу GET /metrics.
+ *
+ * Сервер принимает соединения только на локальном адресе и обрабатывает их по одному в
+ * собственном потоке, поэтому не влияет на потоки перенаправления запросов.
+ */
+class MetricsServer {
+ public:
+  using SocketType = socket_wrapper::tcp::TcpSocket<socket_wrapper::ProtocolFamily::kIpV4>;
+  using EndPointType = SocketType::EndPointType;
+
+  /// Путь, по которому выгружаются счетчики.
+  static constexpr auto kMetricsPath = "/metrics";
+  /// Максимальный размер заголовка запроса.
+  static constexpr std::size_t kMaxRequestSize = 4096;
+  /// Максимальное время ожидания запроса после установления соединения.
+  static constexpr auto kRequestTimeout = std::chrono::milliseconds(1000);
+  /// Максимальное время ожидания соединения, после которого проверяется запрос остановки.
+  static constexpr auto kPollTimeout = std::chrono::milliseconds(100);
+
+  /**
+   * \param port локальный порт сервера, 0 - выбрать свободный порт;
+   * \param registry выгружаемый реестр, который должен существовать до остановки сервера.
+   */
+  MetricsServer(std::uint16_t port, const MetricsRegistry &registry);
+
+  MetricsServer(const MetricsServer &other) = delete;
+  MetricsServer &operator=(const MetricsServer &other) = delete;
+
+  ~MetricsServer();
+
+  /**
+   * \brief Запустить прием соединений.
+   */
+  void Start();
+  /**
+   * \brief Остановить прием соединений и дождаться завершения потока сервера.
+   */
+  void Stop();
+  [[nodiscard]] EndPointType GetEndPoint() const;
+
+ private:
+  const MetricsRegistry &registry_;
+  SocketType listener_;
+  std::jthread thread_;
+
+  void Worker(const std::stop_token &stop_token);
+  void HandleConnection(const SocketType &connection) const;
+  /**
+   * \brief Сформировать HTTP-ответ на запрос с указанной стартовой строкой.
+   */
+  [[nodiscard]] std::string MakeResponse(const std::string &request_line) const;
+};
+
+}  // namespace load_balancer::metrics
+
+#endif  // METRICS_SERVER_H
@@ -0,0 +1,292 @@
+#ifndef FLOW_TABLE_H
+#define FLOW_TABLE_H
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <type_traits>
+
+#include "cache_line.h"
+
+namespace load_balancer::proxy {
+
+/**
+ * \brief Таблица потоков: клиент - выбранный для него сервер.
+ *
+ * Открытая адресация по корзинам размером в кэш-линию: корзина хранит ключи (хеши клиентов)
+ * восьми записей, поэтому поиск обычно читает одну кэш-линию. Номер записи - ее позиция в
+ * таблице, он не меняется за время жизни потока и служит для привязки к записи внешних
+ * ресурсов, например, сокета, принимающего ответы сервера.
+ *
+ * Поиск, добавление и удаление не используют блокировок: ключ записи публикуется атомарно
+ * после ее заполнения, а конечная точка клиента копируется по словам и проверяется повторным
+ * чтением ключа. Одновременное добавление одного клиента несколькими потоками может создать
+ * две записи, лишняя из них удаляется по истечении времени простоя. Количество записей
+ * ограничено при создании таблицы.
+ *
+ * \tparam EndPoint тривиально копируемый тип конечной точки клиента.
+ */
+template <typename EndPoint>
+class FlowTable {
+  static_assert(std::is_trivially_copyable_v<EndPoint>);
+
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  /// Количество записей в корзине размером в кэш-линию.
+  static constexpr std::size_t kBucketSize = kCacheLineSize / sizeof(std::uint64_t);
+  /// Максимальное количество корзин, просматриваемых при поиске и добавлении.
+  static constexpr std::size_t kMaxProbeBuckets = 4;
+
+  /**
+   * \param max_flows минимальное количество записей, округляется вверх до степени двойки,
+   * не меньшей размера корзины;
+   * \param idle_timeout время простоя, после которого поток удаляется.
+   */
+  FlowTable(std::size_t max_flows, Clock::duration idle_timeout);
+
+  FlowTable(const FlowTable &other) = delete;
+  FlowTable &operator=(const FlowTable &other) = delete;
+
+  [[nodiscard]] std::size_t GetCapacity() const;
+
+  /**
+   * \brief Найти поток клиента и отметить его активность.
+   * \return номер записи потока.
+   */
+  [[nodiscard]] std::optional<std::size_t> Find(
+      const EndPoint &client, std::size_t client_hash, Clock::time_point now
+  );
+  /**
+   * \brief Добавить поток клиента.
+   * \return номер записи потока либо std::nullopt, если в окрестности ключа нет свободных
+   * записей.
+   */
+  [[nodiscard]] std::optional<std::size_t> Insert(
+      const EndPoint &client, std::size_t client_hash, std::size_t server, Clock::time_point now
+  );
+
+  /**
+   * \brief Сервер потока.
+   */
+  [[nodiscard]] std::size_t GetServer(std::size_t flow) const;
+  /**
+   * \brief Заменить сервер потока, например, исключенный проверкой здоровья.
+   */
+  void SetServer(std::size_t flow, std::size_t server);
+  /**
+   * \brief Клиент потока и отметка его активности.
+   * \return std::nullopt - если запись свободна.
+   */
+  [[nodiscard]] std::optional<EndPoint> GetClient(std::size_t flow, Clock::time_point now);
+
+  /**
+   * \brief Удалить потоки, простаивающие дольше времени простоя.
+   * \return количество удаленных потоков.
+   */
+  std::size_t ExpireIdle(Clock::time_point now);
+
+ private:
+  /// Свободная запись, завершающая цепочку поиска.
+  static constexpr std::uint64_t kEmpty = 0;
+  /// Запись, заполняемая добавляющим потоком.
+  static constexpr std::uint64_t kBusy = 1;
+  /// Удаленная запись: может быть занята снова, но не завершает цепочку поиска.
+  static constexpr std::uint64_t kDeleted = 2;
+  /// Минимальное значение ключа занятой записи.
+  static constexpr std::uint64_t kMinKey = 3;
+
+  static constexpr std::size_t kEndPointWords =
+      (sizeof(EndPoint) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+
+  struct alignas(kCacheLineSize) Bucket {
+    std::array<std::atomic<std::uint64_t>, kBucketSize> keys = {};
+  };
+
+  /**
+   * \brief Данные потока, читаемые без блокировок.
+   */
+  struct Flow {
+    /// Конечная точка клиента, скопированная по словам.
+    std::array<std::atomic<std::uint64_t>, kEndPointWords> client = {};
+    std::atomic<std::size_t> server = 0;
+    /// Время последней активности в миллисекундах от начала отсчета часов.
+    std::atomic<std::int64_t> last_active = 0;
+  };
+
+  const std::size_t bucket_mask_;
+  const std::int64_t idle_timeout_;
+  std::unique_ptr<Bucket[]> buckets_;
+  std::unique_ptr<Flow[]> flows_;
+
+  static std::uint64_t Key(std::size_t client_hash);
+  static std::int64_t Ticks(Clock::time_point now);
+  std::atomic<std::uint64_t> &KeyOf(std::size_t flow) const;
+  EndPoint LoadClient(std::size_t flow) const;
+  void StoreClient(std::size_t flow, const EndPoint &client);
+  void Touch(std::size_t flow, Clock::time_point now);
+};
+
+template <typename EndPoint>
+FlowTable<EndPoint>::FlowTable(const std::size_t max_flows, const Clock::duration idle_timeout)
+    : bucket_mask_(std::bit_ceil((max_flows + kBucketSize - 1) / kBucketSize) - 1),
+      idle_timeout_(std::chrono::ceil<std::chrono::milliseconds>(idle_timeout).count()),
+      buckets_(std::make_unique<Bucket[]>(bucket_mask_ + 1)),
+      flows_(std::make_unique<Flow[]>(GetCapacity())) {
+}
+
+template <typename EndPoint>
+std::size_t FlowTable<EndPoint>::GetCapacity() const {
+  return (bucket_mask_ + 1) * kBucketSize;
+}
+
+template <typename EndPoint>
+std::optional<std::size_t> FlowTable<EndPoint>::Find(
+    const EndPoint &client, const std::size_t client_hash, const Clock::time_point now
+) {
+  const auto key = Key(client_hash);
+  for (std::size_t probe = 0; probe < kMaxProbeBuckets && probe <= bucket_mask_; ++probe) {
+    const auto bucket = (client_hash + probe) & bucket_mask_;
+    for (std::size_t i = 0; i < kBucketSize; ++i) {
+      const auto flow = bucket * kBucketSize + i;
+      const auto current = KeyOf(flow).load(std::memory_order_acquire);
+      if (current == kEmpty) {
+        return std::nullopt;
+      }
+      if (current != key) {
+        continue;
+      }
+      const auto stored_client = LoadClient(flow);
+      // Запись могла быть удалена и занята снова, пока копировался клиент.
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (KeyOf(flow).load(std::memory_order_relaxed) == key && stored_client == client) {
+        Touch(flow, now);
+        return flow;
+      }
+    }
+  }
+  return std::nullopt;
+}
+
+template <typename EndPoint>
+std::optional<std::size_t> FlowTable<EndPoint>::Insert(
+    const EndPoint &client,
+    const std::size_t client_hash,
+    const std::size_t server,
+    const Clock::time_point now
+) {
+  for (std::size_t probe = 0; probe < kMaxProbeBuckets && probe <= bucket_mask_; ++probe) {
+    const auto bucket = (client_hash + probe) & bucket_mask_;
+    for (std::size_t i = 0; i < kBucketSize; ++i) {
+      const auto flow = bucket * kBucketSize + i;
+      auto current = KeyOf(flow).load(std::memory_order_relaxed);
+      if ((current != kEmpty && current != kDeleted) ||
+          !KeyOf(flow).compare_exchange_strong(current, kBusy, std::memory_order_acquire)) {
+        continue;
+      }
+      // Читатель, увидевший новые слова клиента, увидит и занятость записи.
+      std::atomic_thread_fence(std::memory_order_release);
+      StoreClient(flow, client);
+      flows_[flow].server.store(server, std::memory_order_relaxed);
+      flows_[flow].last_active.store(Ticks(now), std::memory_order_relaxed);
+      KeyOf(flow).store(Key(client_hash), std::memory_order_release);
+      return flow;
+    }
+  }
+  return std::nullopt;
+}
+
+template <typename EndPoint>
+std::size_t FlowTable<EndPoint>::GetServer(const std::size_t flow) const {
+  return flows_[flow].server.load(std::memory_order_relaxed);
+}
+
+template <typename EndPoint>
+void FlowTable<EndPoint>::SetServer(const std::size_t flow, const std::size_t server) {
+  flows_[flow].server.store(server, std::memory_order_relaxed);
+}
+
+template <typename EndPoint>
+std::optional<EndPoint> FlowTable<EndPoint>::GetClient(
+    const std::size_t flow, const Clock::time_point now
+) {
+  const auto key = KeyOf(flow).load(std::memory_order_acquire);
+  if (key < kMinKey) {
+    return std::nullopt;
+  }
+  const auto client = LoadClient(flow);
+  std::atomic_thread_fence(std::memory_order_acquire);
+  if (KeyOf(flow).load(std::memory_order_relaxed) != key) {
+    return std::nullopt;
+  }
+  Touch(flow, now);
+  return client;
+}
+
+template <typename EndPoint>
+std::size_t FlowTable<EndPoint>::ExpireIdle(const Clock::time_point now) {
+  const auto expired_before = Ticks(now) - idle_timeout_;
+  std::size_t expired = 0;
+  for (std::size_t flow = 0; flow < GetCapacity(); ++flow) {
+    auto key = KeyOf(flow).load(std::memory_order_relaxed);
+    if (key >= kMinKey &&
+        flows_[flow].last_active.load(std::memory_order_relaxed) < expired_before &&
+        KeyOf(flow).compare_exchange_strong(key, kDeleted, std::memory_order_relaxed)) {
+      ++expired;
+    }
+  }
+  return expired;
+}
+
+template <typename EndPoint>
+std::uint64_t FlowTable<EndPoint>::Key(const std::size_t client_hash) {
+  return client_hash < kMinKey ? kMinKey : client_hash;
+}
+
+template <typename EndPoint>
+std::int64_t FlowTable<EndPoint>::Ticks(const Clock::time_point now) {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count();
+}
+
+template <typename EndPoint>
+std::atomic<std::uint64_t> &FlowTable<EndPoint>::KeyOf(const std::size_t flow) const {
+  return buckets_[flow / kBucketSize].keys[flow % kBucketSize];
+}
+
+template <typename EndPoint>
+EndPoint FlowTable<EndPoint>::LoadClient(const std::size_t flow) const {
+  std::array<std::uint64_t, kEndPointWords> words;
+  for (std::size_t i = 0; i < kEndPointWords; ++i) {
+    words[i] = flows_[flow].client[i].load(std::memory_order_relaxed);
+  }
+  EndPoint client;
+  std::memcpy(static_cast<void *>(&client), words.data(), sizeof(client));
+  return client;
+}
+
+template <typename EndPoint>
+void FlowTable<EndPoint>::StoreClient(const std::size_t flow, const EndPoint &client) {
+  std::array<std::uint64_t, kEndPointWords> words = {};
+  std::memcpy(words.data(), &client, sizeof(client));
+  for (std::size_t i = 0; i < kEndPointWords; ++i) {
+    flows_[flow].client[i].store(words[i], std::memory_order_relaxed);
+  }
+}
+
+template <typename EndPoint>
+void FlowTable<EndPoint>::Touch(const std::size_t flow, const Clock::time_point now) {
+  // Запись выполняется не чаще раза в миллисекунду, чтобы не занимать кэш-линию потока.
+  const auto ticks = Ticks(now);
+  if (flows_[flow].last_active.load(std::memory_order_relaxed) != ticks) {
+    flows_[flow].last_active.store(ticks, std::memory_order_relaxed);
+  }
+}
+
+}  // namespace load_balancer::proxy
+
+#endif  // FLOW_TABLE_H
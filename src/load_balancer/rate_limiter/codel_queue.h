@@ -0,0 +1,216 @@
+#ifndef CODEL_QUEUE_H
+#define CODEL_QUEUE_H
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <stop_token>
+#include <utility>
+#include <vector>
+
+namespace load_balancer::rate_limiter {
+
+/**
+ * \brief Ограниченная очередь допуска с управлением задержкой по алгоритму CoDel (RFC 8289).
+ *
+ * Элементы, не допущенные ограничением нагрузки, ждут в очереди и извлекаются по мере
+ * появления разрешений ограничителя, поэтому короткий всплеск сглаживается, а не отбрасывается.
+ * Если время ожидания извлекаемых элементов не опускается ниже target дольше interval,
+ * очередь начинает отбрасывать элементы при извлечении с частотой, растущей как квадратный
+ * корень из количества отброшенных, пока задержка не вернется ниже target. Поэтому
+ * длительная перегрузка по-прежнему срезается, но без постоянно заполненной очереди.
+ *
+ * Память под элементы выделяется при создании. Добавление и извлечение синхронизируются
+ * мьютексом, проверка пустоты - без блокировок.
+ *
+ * \tparam Item тип элемента очереди.
+ */
+template <typename Item>
+class CoDelQueue {
+ public:
+  using Clock = std::chrono::steady_clock;
+  using TimePoint = Clock::time_point;
+  using Duration = Clock::duration;
+
+  /**
+   * \param capacity максимальное количество элементов в очереди;
+   * \param target допустимая задержка в очереди;
+   * \param interval время, в течение которого задержка может превышать target до начала
+   * отбрасывания.
+   */
+  CoDelQueue(std::size_t capacity, Duration target, Duration interval);
+
+  CoDelQueue(const CoDelQueue &other) = delete;
+  CoDelQueue &operator=(const CoDelQueue &other) = delete;
+
+  /**
+   * \brief Поставить элемент в конец очереди.
+   * \return false - очередь заполнена, элемент не добавлен.
+   */
+  bool Push(Item item, TimePoint now);
+  /**
+   * \brief Извлечь не более max_count элементов из начала очереди, отбрасывая элементы по
+   * закону управления CoDel.
+   * \param released извлеченные элементы и время их ожидания, добавляются в конец.
+   * \return количество отброшенных элементов, они не учитываются в max_count.
+   */
+  std::size_t Pop(
+      std::size_t max_count, TimePoint now, std::vector<std::pair<Item, Duration>> &released
+  );
+  /**
+   * \brief Ожидать появления элементов в очереди.
+   * \return false - запрошена остановка.
+   */
+  bool WaitNotEmpty(std::stop_token stop);
+
+  [[nodiscard]] std::size_t Size() const;
+  [[nodiscard]] bool Empty() const;
+
+ private:
+  struct Entry {
+    Item item;
+    TimePoint enqueue_time;
+  };
+
+  const Duration target_;
+  const Duration interval_;
+  mutable std::mutex mutex_;
+  std::condition_variable_any not_empty_;
+  /// Кольцевой буфер элементов.
+  std::vector<Entry> entries_;
+  std::size_t head_ = 0;
+  std::atomic<std::size_t> size_ = 0;
+
+  /// Момент, после которого задержка выше target дает право отбрасывать, нулевой - задержка
+  /// ниже target.
+  TimePoint first_above_time_{};
+  /// Момент следующего отбрасывания в состоянии отбрасывания.
+  TimePoint drop_next_{};
+  /// Количество отбрасываний в текущем состоянии отбрасывания.
+  std::size_t count_ = 0;
+  /// Количество отбрасываний при входе в предыдущее состояние отбрасывания.
+  std::size_t last_count_ = 0;
+  bool dropping_ = false;
+
+  /**
+   * \brief Извлечь элемент из начала непустой очереди.
+   * \param ok_to_drop задержка превышает target дольше interval.
+   */
+  Entry DoPop(TimePoint now, bool &ok_to_drop);
+  /**
+   * \brief Момент следующего отбрасывания: интервал уменьшается обратно пропорционально
+   * квадратному корню из количества отбрасываний.
+   */
+  TimePoint ControlLaw(TimePoint time) const;
+};
+
+template <typename Item>
+CoDelQueue<Item>::CoDelQueue(
+    const std::size_t capacity, const Duration target, const Duration interval
+)
+    : target_(target), interval_(interval), entries_(capacity) {
+}
+
+template <typename Item>
+bool CoDelQueue<Item>::Push(Item item, const TimePoint now) {
+  std::size_t size = 0;
+  {
+    const std::lock_guard lock(mutex_);
+    size = size_.load(std::memory_order_relaxed);
+    if (size == entries_.size()) {
+      return false;
+    }
+    entries_[(head_ + size) % entries_.size()] = {std::move(item), now};
+    size_.store(size + 1, std::memory_order_relaxed);
+  }
+  // Извлекающий поток ждет только пустую очередь.
+  if (size == 0) {
+    not_empty_.notify_one();
+  }
+  return true;
+}
+
+template <typename Item>
+std::size_t CoDelQueue<Item>::Pop(
+    const std::size_t max_count,
+    const TimePoint now,
+    std::vector<std::pair<Item, Duration>> &released
+) {
+  const std::lock_guard lock(mutex_);
+  std::size_t dropped = 0;
+  std::size_t popped = 0;
+  while (popped < max_count && size_.load(std::memory_order_relaxed) > 0) {
+    bool ok_to_drop = false;
+    auto entry = DoPop(now, ok_to_drop);
+    if (dropping_) {
+      if (!ok_to_drop) {
+        dropping_ = false;
+      } else if (now >= drop_next_) {
+        ++dropped;
+        ++count_;
+        drop_next_ = ControlLaw(drop_next_);
+        continue;
+      }
+    } else if (ok_to_drop) {
+      ++dropped;
+      dropping_ = true;
+      // Недавнее состояние отбрасывания продолжается с близкой частотой отбрасывания.
+      const auto delta = count_ - last_count_;
+      count_ = delta > 1 && now - drop_next_ < 16 * interval_ ? delta : 1;
+      last_count_ = count_;
+      drop_next_ = ControlLaw(now);
+      continue;
+    }
+    released.emplace_back(std::move(entry.item), now - entry.enqueue_time);
+    ++popped;
+  }
+  return dropped;
+}
+
+template <typename Item>
+bool CoDelQueue<Item>::WaitNotEmpty(std::stop_token stop) {
+  std::unique_lock lock(mutex_);
+  return not_empty_.wait(lock, stop, [this] {
+    return size_.load(std::memory_order_relaxed) > 0;
+  });
+}
+
+template <typename Item>
+std::size_t CoDelQueue<Item>::Size() const {
+  return size_.load(std::memory_order_relaxed);
+}
+
+template <typename Item>
+bool CoDelQueue<Item>::Empty() const {
+  return Size() == 0;
+}
+
+template <typename Item>
+typename CoDelQueue<Item>::Entry CoDelQueue<Item>::DoPop(const TimePoint now, bool &ok_to_drop) {
+  auto entry = std::move(entries_[head_]);
+  head_ = (head_ + 1) % entries_.size();
+  const auto size = size_.load(std::memory_order_relaxed) - 1;
+  size_.store(size, std::memory_order_relaxed);
+  // Последний элемент не отбрасывается: очередь уже опустела.
+  if (now - entry.enqueue_time < target_ || size == 0) {
+    first_above_time_ = {};
+  } else if (first_above_time_ == TimePoint{}) {
+    first_above_time_ = now + interval_;
+  } else {
+    ok_to_drop = now >= first_above_time_;
+  }
+  return entry;
+}
+
+template <typename Item>
+typename CoDelQueue<Item>::TimePoint CoDelQueue<Item>::ControlLaw(const TimePoint time) const {
+  const auto next_drop_interval = interval_ / std::sqrt(static_cast<double>(count_));
+  return time + std::chrono::duration_cast<Duration>(next_drop_interval);
+}
+
+}  // namespace load_balancer::rate_limiter
+
+#endif  // CODEL_QUEUE_H
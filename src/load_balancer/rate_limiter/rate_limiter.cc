@@ -0,0 +1,26 @@
+#include "rate_limiter.h"
+
+#include <stdexcept>
+
+#include "sliding_window_rate_limiter.h"
+#include "token_bucket_rate_limiter.h"
+
+namespace load_balancer::rate_limiter {
+
+std::size_t RateLimiter::TryAcquire(const std::size_t count) {
+  return TryAcquire(count, Clock::now());
+}
+
+std::unique_ptr<RateLimiter> CreateRateLimiter(
+    const RateLimiterType type, const std::size_t max_rps
+) {
+  switch (type) {
+    case RateLimiterType::kTokenBucket:
+      return std::make_unique<TokenBucketRateLimiter>(max_rps);
+    case RateLimiterType::kSlidingWindow:
+      return std::make_unique<SlidingWindowRateLimiter>(max_rps);
+  }
+  throw std::invalid_argument("Unknown rate limiter type.");
+}
+
+}  // namespace load_balancer::rate_limiter
@@ -0,0 +1,67 @@
+#ifndef RATE_LIMITER_H
+#define RATE_LIMITER_H
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+
+namespace load_balancer::rate_limiter {
+
+/**
+ * \brief Алгоритм ограничения нагрузки.
+ */
+enum class RateLimiterType {
+  kTokenBucket,    ///< Корзина маркеров (GCRA), см. @link TokenBucketRateLimiter @endlink.
+  kSlidingWindow,  ///< Скользящее окно, см. @link SlidingWindowRateLimiter @endlink.
+};
+
+/**
+ * \brief Ограничитель количества запросов, допускаемых в систему за секунду.
+ *
+ * Реализации используют постоянный объем памяти и допускают одновременный вызов
+ * @link TryAcquire @endlink и @link SetMaxRps @endlink из нескольких потоков без блокировок.
+ */
+class RateLimiter {
+ public:
+  using Clock = std::chrono::steady_clock;
+  using TimePoint = std::chrono::time_point<Clock>;
+
+  virtual ~RateLimiter() = default;
+
+  /**
+   * \brief Допустить в систему не более count запросов, поступивших в момент now.
+   * \return количество допущенных запросов.
+   */
+  virtual std::size_t TryAcquire(std::size_t count, TimePoint now) = 0;
+  /**
+   * \brief Допустить в систему не более count запросов, поступивших в текущий момент.
+   * \return количество допущенных запросов.
+   */
+  std::size_t TryAcquire(std::size_t count = 1);
+  /**
+   * \brief Вернуть count разрешений, полученных вызовом @link TryAcquire @endlink в момент now,
+   * но не израсходованных.
+   *
+   * Возвращенные разрешения снова доступны запросам, пока не истек интервал, в котором они
+   * учтены, но количество доступных разрешений не превышает допустимого всплеска.
+   */
+  virtual void Release(std::size_t count, TimePoint now) = 0;
+  /**
+   * \brief Изменить максимальное количество запросов в секунду, сохраняя историю допущенных
+   * запросов.
+   *
+   * Одновременный вызов @link TryAcquire @endlink может применить как прежнее, так и новое
+   * ограничение.
+   */
+  virtual void SetMaxRps(std::size_t max_rps) = 0;
+};
+
+/**
+ * \brief Создать ограничитель нагрузки указанного типа.
+ * \param max_rps максимальное количество запросов в секунду.
+ */
+std::unique_ptr<RateLimiter> CreateRateLimiter(RateLimiterType type, std::size_t max_rps);
+
+}  // namespace load_balancer::rate_limiter
+
+#endif  // RATE_LIMITER_H
@@ -0,0 +1,137 @@
+#include "sliding_window_rate_limiter.h"
+
+#include <algorithm>
+
+using namespace std::chrono_literals;
+
+namespace load_balancer::rate_limiter {
+
+namespace {
+
+constexpr auto kSubWindowLength =
+    std::chrono::nanoseconds(1s).count() / SlidingWindowRateLimiter::kSubWindowCount;
+
+}  // namespace
+
+SlidingWindowRateLimiter::SlidingWindowRateLimiter(const std::size_t max_rps) : max_rps_(max_rps) {
+}
+
+std::size_t SlidingWindowRateLimiter::TryAcquire(const std::size_t count, const TimePoint now) {
+  const auto max_rps = max_rps_.load(std::memory_order_relaxed);
+  if (max_rps == 0 || count == 0) {
+    return 0;
+  }
+  if (max_rps > kCountMask) {
+    return count;
+  }
+  const auto sub_window = static_cast<std::uint64_t>(
+      std::chrono::duration_cast<Nanoseconds>(now.time_since_epoch()).count() / kSubWindowLength
+  );
+  const auto epoch = sub_window & kEpochMask;
+  auto &slot = slots_[sub_window % kSlotCount];
+  auto current = slot.load(std::memory_order_acquire);
+  while (true) {
+    std::uint64_t used = 0;
+    if (Epoch(current) == epoch) {
+      used = Count(current);
+    } else if (Count(current) != 0 && ((Epoch(current) - epoch) & kEpochMask) < kEpochMask / 2) {
+      // Слот уже занят более поздним подокном: момент now устарел.
+      return 0;
+    }
+    const auto current_count = used;
+    used += GetOtherUsed(sub_window);
+    if (used >= max_rps) {
+      return 0;
+    }
+    auto admitted = std::min<std::uint64_t>(count, max_rps - used);
+    // Последовательная согласованность CAS и последующего чтения гарантирует, что из двух
+    // потоков, одновременно допустивших запросы в разных подокнах, хотя бы один увидит
+    // увеличение другого.
+    if (slot.compare_exchange_weak(
+            current,
+            Pack(epoch, current_count + admitted),
+            std::memory_order_seq_cst,
+            std::memory_order_acquire
+        )) {
+      const auto own = slot.load(std::memory_order_seq_cst);
+      const auto total =
+          (Epoch(own) == epoch ? Count(own) : current_count + admitted) + GetOtherUsed(sub_window);
+      if (total > max_rps) {
+        const auto excess = std::min<std::uint64_t>(total - max_rps, admitted);
+        Release(excess, now);
+        admitted -= excess;
+      }
+      return admitted;
+    }
+  }
+}
+
+std::uint64_t SlidingWindowRateLimiter::GetOtherUsed(const std::uint64_t sub_window) const {
+  // Счетчики по смещению подокна относительно sub_window от -kSubWindowCount до
+  // kSubWindowCount. Слот другого подокна содержит либо предшествующее подокно, либо, если
+  // момент устарел, более позднее.
+  std::array<std::uint64_t, 2 * kSubWindowCount + 1> counts{};
+  std::size_t latest = kSubWindowCount;
+  for (std::uint64_t i = 1; i < kSlotCount; ++i) {
+    const auto other = slots_[(sub_window + i) % kSlotCount].load(std::memory_order_seq_cst);
+    if (Count(other) == 0) {
+      continue;
+    }
+    const auto later = (Epoch(other) - sub_window) & kEpochMask;
+    const auto earlier = (sub_window - Epoch(other)) & kEpochMask;
+    if (later <= kSubWindowCount) {
+      counts[kSubWindowCount + later] += Count(other);
+      latest = std::max<std::size_t>(latest, kSubWindowCount + later);
+    } else if (earlier <= kSubWindowCount) {
+      counts[kSubWindowCount - earlier] += Count(other);
+    }
+  }
+  std::uint64_t max_used = 0;
+  for (std::size_t end = kSubWindowCount; end <= latest; ++end) {
+    std::uint64_t used = 0;
+    for (std::size_t i = end - kSubWindowCount; i <= end; ++i) {
+      used += counts[i];
+    }
+    max_used = std::max(max_used, used);
+  }
+  return max_used;
+}
+
+void SlidingWindowRateLimiter::Release(const std::size_t count, const TimePoint now) {
+  const auto sub_window = static_cast<std::uint64_t>(
+      std::chrono::duration_cast<Nanoseconds>(now.time_since_epoch()).count() / kSubWindowLength
+  );
+  const auto epoch = sub_window & kEpochMask;
+  auto &slot = slots_[sub_window % kSlotCount];
+  auto current = slot.load(std::memory_order_acquire);
+  // Слот, занятый другим подокном, уже не содержит разрешений момента now.
+  while (Epoch(current) == epoch && Count(current) > 0) {
+    const auto released = std::min<std::uint64_t>(count, Count(current));
+    if (slot.compare_exchange_weak(
+            current,
+            Pack(epoch, Count(current) - released),
+            std::memory_order_acq_rel,
+            std::memory_order_acquire
+        )) {
+      return;
+    }
+  }
+}
+
+void SlidingWindowRateLimiter::SetMaxRps(const std::size_t max_rps) {
+  max_rps_.store(max_rps, std::memory_order_relaxed);
+}
+
+std::uint64_t SlidingWindowRateLimiter::Pack(const std::uint64_t epoch, const std::uint64_t count) {
+  return (epoch << kCountBits) | count;
+}
+
+std::uint64_t SlidingWindowRateLimiter::Epoch(const std::uint64_t slot) {
+  return slot >> kCountBits;
+}
+
+std::uint64_t SlidingWindowRateLimiter::Count(const std::uint64_t slot) {
+  return slot & kCountMask;
+}
+
+}  // namespace load_balancer::rate_limiter
@@ -0,0 +1,63 @@
+#ifndef SLIDING_WINDOW_RATE_LIMITER_H
+#define SLIDING_WINDOW_RATE_LIMITER_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include "rate_limiter.h"
+
+namespace load_balancer::rate_limiter {
+
+/**
+ * \brief Ограничитель нагрузки на основе счетчиков скользящего окна.
+ *
+ * Секунда делится на @link kSubWindowCount @endlink подокон, для каждого из которых хранится
+ * счетчик допущенных запросов. Запрос допускается, если сумма счетчиков текущего и всех подокон,
+ * пересекающихся с последней секундой, меньше max_rps. Поэтому в любом секундном интервале
+ * допускается не более max_rps запросов, а после всплеска запросы отклоняются не дольше, чем на
+ * одно подокно сверх секунды.
+ *
+ * Каждый счетчик упакован вместе с номером своего подокна в одно 64-битное слово и обновляется
+ * с помощью CAS. Поток с устаревшим моментом может увеличить счетчик предыдущего подокна
+ * одновременно с тем, как другой поток допускает запросы в следующем, поэтому после CAS сумма
+ * окон перепроверяется, и превышение ограничения возвращается.
+ */
+class SlidingWindowRateLimiter : public RateLimiter {
+ public:
+  /// Количество подокон в секунде.
+  static constexpr std::size_t kSubWindowCount = 10;
+
+  explicit SlidingWindowRateLimiter(std::size_t max_rps);
+
+  std::size_t TryAcquire(std::size_t count, TimePoint now) override;
+  using RateLimiter::TryAcquire;
+  void Release(std::size_t count, TimePoint now) override;
+  void SetMaxRps(std::size_t max_rps) override;
+
+ private:
+  using Nanoseconds = std::chrono::nanoseconds;
+
+  static constexpr std::uint64_t kCountBits = 40;
+  static constexpr std::uint64_t kCountMask = (std::uint64_t{1} << kCountBits) - 1;
+  static constexpr std::uint64_t kEpochMask = (std::uint64_t{1} << (64 - kCountBits)) - 1;
+  /// Текущее подокно и подокна, пересекающиеся с предшествующей ему секундой.
+  static constexpr std::size_t kSlotCount = kSubWindowCount + 1;
+
+  std::atomic<std::size_t> max_rps_;
+  std::array<std::atomic<std::uint64_t>, kSlotCount> slots_{};
+
+  /**
+   * \brief Наибольшая сумма счетчиков других подокон в окнах, содержащих подокно sub_window:
+   * в окне, заканчивающемся им, и в окнах более поздних подокон, уже занявших слоты.
+   */
+  [[nodiscard]] std::uint64_t GetOtherUsed(std::uint64_t sub_window) const;
+
+  static std::uint64_t Pack(std::uint64_t epoch, std::uint64_t count);
+  static std::uint64_t Epoch(std::uint64_t slot);
+  static std::uint64_t Count(std::uint64_t slot);
+};
+
+}  // namespace load_balancer::rate_limiter
+
+#endif  // SLIDING_WINDOW_RATE_LIMITER_H
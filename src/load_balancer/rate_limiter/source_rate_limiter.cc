@@ -0,0 +1,179 @@
+#include "source_rate_limiter.h"
+
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+
+namespace load_balancer::rate_limiter {
+
+namespace {
+
+/**
+ * \brief Перемешивание битов хеша (финализатор splitmix64), чтобы строки скетча не зависели
+ * от качества хеша источника.
+ */
+std::uint64_t Mix(std::uint64_t value) {
+  value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+  return value ^ (value >> 31);
+}
+
+}  // namespace
+
+SourceRateLimiter::SourceRateLimiter(
+    const std::size_t max_rps,
+    const std::size_t width,
+    const std::size_t depth,
+    const std::size_t top_k
+)
+    : max_rps_(max_rps),
+      width_mask_(std::bit_ceil(std::max<std::size_t>(width, 1)) - 1),
+      depth_(depth),
+      top_k_(top_k) {
+  if (depth_ == 0) {
+    throw std::invalid_argument("Invalid source rate limiter sketch depth.");
+  }
+  counters_ = std::make_unique<std::atomic<std::uint64_t>[]>((width_mask_ + 1) * depth_);
+  hitters_ = std::make_unique<Hitter[]>(top_k_);
+}
+
+std::size_t SourceRateLimiter::GetWidth() const {
+  return width_mask_ + 1;
+}
+
+std::size_t SourceRateLimiter::GetDepth() const {
+  return depth_;
+}
+
+bool SourceRateLimiter::TryAcquire(const std::uint64_t source, const TimePoint now) {
+  const auto epoch = Epoch(now);
+  const auto hash = Mix(source);
+  const auto estimate = MinCount(hash, epoch);
+  const auto count = std::min(estimate + 1, kCountMask);
+  // Счетчики обновляются простой записью без атомарного чтения-изменения-записи: при
+  // одновременных запросах одного источника часть увеличений может потеряться, но не больше,
+  // чем по одному на поток, а запрос обходится без захвата кэш-линий на запись.
+  for (std::size_t row = 0; row < depth_; ++row) {
+    auto &counter = counters_[Index(hash, row)];
+    const auto current = counter.load(std::memory_order_relaxed);
+    const auto current_epoch = current >> kCountBits;
+    if (current_epoch != epoch && ((current_epoch - epoch) & kEpochMask) < kEpochMask / 2) {
+      // Счетчик уже относится к более поздней секунде: момент now устарел.
+      continue;
+    }
+    if (CountIn(current, epoch) < count) {
+      counter.store(Pack(epoch, count), std::memory_order_relaxed);
+    }
+  }
+  if (top_k_ > 0 && count % kHeavyHitterStep == 0 &&
+      count > CountIn(hitters_floor_.load(std::memory_order_relaxed), epoch)) {
+    UpdateHeavyHitters(source, count, epoch);
+  }
+  return estimate < max_rps_;
+}
+
+bool SourceRateLimiter::TryAcquire(const std::uint64_t source) {
+  return TryAcquire(source, Clock::now());
+}
+
+std::uint64_t SourceRateLimiter::Estimate(const std::uint64_t source, const TimePoint now) const {
+  const auto epoch = Epoch(now);
+  return MinCount(Mix(source), epoch);
+}
+
+std::vector<SourceRateLimiter::HeavyHitter> SourceRateLimiter::GetHeavyHitters(
+    const TimePoint now
+) const {
+  const auto epoch = Epoch(now);
+  std::vector<HeavyHitter> heavy_hitters;
+  for (std::size_t i = 0; i < top_k_; ++i) {
+    if (CountIn(hitters_[i].count.load(std::memory_order_relaxed), epoch) == 0) {
+      continue;
+    }
+    // Оценка в списке отстает от скетча не больше, чем на шаг обновления списка.
+    const auto source = hitters_[i].source.load(std::memory_order_relaxed);
+    const auto count = MinCount(Mix(source), epoch);
+    // Одновременные обновления могли занести источник в список дважды.
+    const auto it = std::find_if(
+        heavy_hitters.begin(),
+        heavy_hitters.end(),
+        [source](const HeavyHitter &heavy_hitter) { return heavy_hitter.source == source; }
+    );
+    if (it == heavy_hitters.end()) {
+      heavy_hitters.push_back({.source = source, .count = count});
+    } else {
+      it->count = std::max(it->count, count);
+    }
+  }
+  std::sort(heavy_hitters.begin(), heavy_hitters.end(), [](const auto &lhs, const auto &rhs) {
+    return lhs.count > rhs.count;
+  });
+  return heavy_hitters;
+}
+
+std::uint64_t SourceRateLimiter::Epoch(const TimePoint now) {
+  return static_cast<std::uint64_t>(
+             std::chrono::duration_cast<std::chrono::seconds>(now.time_since_epoch()).count()
+         ) &
+         kEpochMask;
+}
+
+std::uint64_t SourceRateLimiter::Pack(const std::uint64_t epoch, const std::uint64_t count) {
+  return (epoch << kCountBits) | count;
+}
+
+std::uint64_t SourceRateLimiter::CountIn(const std::uint64_t packed, const std::uint64_t epoch) {
+  return (packed >> kCountBits) == epoch ? packed & kCountMask : 0;
+}
+
+std::size_t SourceRateLimiter::Index(const std::uint64_t hash, const std::size_t row) const {
+  // Вторая функция хеширования нечетна, поэтому строки не вырождаются в одну при любой ширине.
+  const auto step = std::rotl(hash, 32) | 1;
+  return row * (width_mask_ + 1) + ((hash + row * step) & width_mask_);
+}
+
+std::uint64_t SourceRateLimiter::MinCount(
+    const std::uint64_t hash, const std::uint64_t epoch
+) const {
+  auto min_count = kCountMask;
+  for (std::size_t row = 0; row < depth_; ++row) {
+    min_count = std::min(
+        min_count, CountIn(counters_[Index(hash, row)].load(std::memory_order_relaxed), epoch)
+    );
+  }
+  return min_count;
+}
+
+void SourceRateLimiter::UpdateHeavyHitters(
+    const std::uint64_t source, const std::uint64_t count, const std::uint64_t epoch
+) {
+  // Список обновляется без блокировок и приближенно: одновременные обновления могут заменить
+  // одну и ту же запись, а источник и его оценка записываются не атомарно вместе.
+  bool found = false;
+  std::size_t min_index = 0;
+  auto min_count = kCountMask;
+  for (std::size_t i = 0; i < top_k_; ++i) {
+    auto &hitter = hitters_[i];
+    const auto hitter_count = CountIn(hitter.count.load(std::memory_order_relaxed), epoch);
+    if (hitter_count != 0 && hitter.source.load(std::memory_order_relaxed) == source) {
+      found = true;
+      if (hitter_count < count) {
+        hitter.count.store(Pack(epoch, count), std::memory_order_relaxed);
+      }
+    } else if (hitter_count < min_count) {
+      min_index = i;
+      min_count = hitter_count;
+    }
+  }
+  if (!found && count > min_count) {
+    hitters_[min_index].source.store(source, std::memory_order_relaxed);
+    hitters_[min_index].count.store(Pack(epoch, count), std::memory_order_relaxed);
+  }
+  auto floor = kCountMask;
+  for (std::size_t i = 0; i < top_k_; ++i) {
+    floor = std::min(floor, CountIn(hitters_[i].count.load(std::memory_order_relaxed), epoch));
+  }
+  hitters_floor_.store(Pack(epoch, floor), std::memory_order_relaxed);
+}
+
+}  // namespace load_balancer::rate_limiter
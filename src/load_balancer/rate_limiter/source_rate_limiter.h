@@ -0,0 +1,127 @@
+#ifndef SOURCE_RATE_LIMITER_H
+#define SOURCE_RATE_LIMITER_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "rate_limiter.h"
+
+namespace load_balancer::rate_limiter {
+
+/**
+ * \brief Ограничитель количества запросов в секунду от каждого источника.
+ *
+ * Количество запросов источника за текущую секунду оценивается скетчем count-min: depth строк
+ * по width счетчиков, источник увеличивает по одному счетчику в каждой строке, а оценкой служит
+ * минимальный из них. Оценка не бывает меньше истинного количества, поэтому источник, не
+ * превышающий ограничения, отклоняется только при коллизиях во всех строках. Счетчики
+ * обновляются консервативно: увеличиваются только до новой оценки, что уменьшает вклад
+ * коллизий. Объем памяти не зависит от количества источников.
+ *
+ * Дополнительно поддерживается приближенный список top-K источников с наибольшими оценками за
+ * текущую секунду. Список обновляется, только если оценка источника достигла очередного
+ * кратного @link kHeavyHitterStep @endlink значения и превышает минимальную оценку в списке,
+ * поэтому для большинства запросов его поддержка ничего не стоит.
+ *
+ * Каждый счетчик упакован вместе с номером своей секунды в одно 64-битное слово, поэтому
+ * счетчики прошлых секунд не нужно сбрасывать. Все операции выполняются без блокировок и могут
+ * вызываться из нескольких потоков одновременно.
+ */
+class SourceRateLimiter {
+ public:
+  using Clock = RateLimiter::Clock;
+  using TimePoint = RateLimiter::TimePoint;
+
+  /// Шаг оценки источника, с которым обновляется список top-K.
+  static constexpr std::uint64_t kHeavyHitterStep = 16;
+
+  /**
+   * \brief Источник с наибольшей оценкой количества запросов.
+   */
+  struct HeavyHitter {
+    std::uint64_t source;
+    std::uint64_t count;
+  };
+
+  /**
+   * \param max_rps максимальное количество запросов в секунду от одного источника;
+   * \param width количество счетчиков в строке скетча, округляется вверх до степени двойки;
+   * \param depth количество строк скетча;
+   * \param top_k количество отслеживаемых источников с наибольшим количеством запросов.
+   */
+  SourceRateLimiter(std::size_t max_rps, std::size_t width, std::size_t depth, std::size_t top_k);
+
+  SourceRateLimiter(const SourceRateLimiter &other) = delete;
+  SourceRateLimiter &operator=(const SourceRateLimiter &other) = delete;
+
+  [[nodiscard]] std::size_t GetWidth() const;
+  [[nodiscard]] std::size_t GetDepth() const;
+
+  /**
+   * \brief Учесть запрос источника, поступивший в момент now.
+   * \param source хеш адреса источника.
+   * \return true - если запрос допущен.
+   */
+  bool TryAcquire(std::uint64_t source, TimePoint now);
+  /**
+   * \brief Учесть запрос источника, поступивший в текущий момент.
+   * \return true - если запрос допущен.
+   */
+  bool TryAcquire(std::uint64_t source);
+
+  /**
+   * \brief Оценка количества запросов источника за секунду, содержащую момент now.
+   */
+  [[nodiscard]] std::uint64_t Estimate(std::uint64_t source, TimePoint now) const;
+  /**
+   * \brief Источники с наибольшим количеством запросов за секунду, содержащую момент now, в
+   * порядке убывания оценок.
+   */
+  [[nodiscard]] std::vector<HeavyHitter> GetHeavyHitters(TimePoint now) const;
+
+ private:
+  static constexpr std::uint64_t kCountBits = 40;
+  static constexpr std::uint64_t kCountMask = (std::uint64_t{1} << kCountBits) - 1;
+  static constexpr std::uint64_t kEpochMask = (std::uint64_t{1} << (64 - kCountBits)) - 1;
+
+  /**
+   * \brief Запись списка top-K.
+   */
+  struct Hitter {
+    std::atomic<std::uint64_t> source = 0;
+    /// Оценка, упакованная вместе с номером секунды.
+    std::atomic<std::uint64_t> count = 0;
+  };
+
+  const std::uint64_t max_rps_;
+  const std::size_t width_mask_;
+  const std::size_t depth_;
+  const std::size_t top_k_;
+  /// Строки скетча, расположенные подряд.
+  std::unique_ptr<std::atomic<std::uint64_t>[]> counters_;
+  std::unique_ptr<Hitter[]> hitters_;
+  /// Минимальная оценка в списке top-K, упакованная вместе с номером секунды.
+  std::atomic<std::uint64_t> hitters_floor_ = 0;
+
+  static std::uint64_t Epoch(TimePoint now);
+  static std::uint64_t Pack(std::uint64_t epoch, std::uint64_t count);
+  /**
+   * \return количество из упакованного слова либо 0, если слово относится к другой секунде.
+   */
+  static std::uint64_t CountIn(std::uint64_t packed, std::uint64_t epoch);
+  /**
+   * \brief Номер счетчика источника в строке скетча (двойное хеширование).
+   */
+  [[nodiscard]] std::size_t Index(std::uint64_t hash, std::size_t row) const;
+  /**
+   * \brief Минимальный из счетчиков источника за указанную секунду.
+   */
+  [[nodiscard]] std::uint64_t MinCount(std::uint64_t hash, std::uint64_t epoch) const;
+  void UpdateHeavyHitters(std::uint64_t source, std::uint64_t count, std::uint64_t epoch);
+};
+
+}  // namespace load_balancer::rate_limiter
+
+#endif  // SOURCE_RATE_LIMITER_H
@@ -0,0 +1,105 @@
+#include "token_bucket_rate_limiter.h"
+
+#include <algorithm>
+
+using namespace std::chrono_literals;
+
+namespace load_balancer::rate_limiter {
+
+namespace {
+
+constexpr std::int64_t kSecond = std::chrono::nanoseconds(1s).count();
+
+/**
+ * \brief Интервал между запросами, округленный вверх: вместе со всплеском за любую секунду
+ * пополняется не более max_rps маркеров.
+ */
+std::int64_t EmissionInterval(const std::size_t max_rps) {
+  if (max_rps == 0 || max_rps >= static_cast<std::size_t>(kSecond)) {
+    return 0;
+  }
+  // Всплеск из B маркеров и пополнение до B - 1 + R маркеров за секунду не превышают
+  // max_rps при скорости пополнения R = max_rps - B + 1.
+  const auto rps = static_cast<std::int64_t>(
+      max_rps - TokenBucketRateLimiter::GetBurst(max_rps) + 1
+  );
+  return (kSecond + rps - 1) / rps;
+}
+
+/**
+ * \brief Максимальное опережение TAT, при котором допускается всплеск из GetBurst маркеров.
+ */
+std::int64_t BurstTolerance(const std::size_t max_rps) {
+  return EmissionInterval(max_rps) *
+         static_cast<std::int64_t>(TokenBucketRateLimiter::GetBurst(max_rps));
+}
+
+}  // namespace
+
+TokenBucketRateLimiter::TokenBucketRateLimiter(const std::size_t max_rps)
+    : max_rps_(max_rps),
+      emission_interval_(EmissionInterval(max_rps)),
+      burst_tolerance_(BurstTolerance(max_rps)) {
+}
+
+std::size_t TokenBucketRateLimiter::GetBurst(const std::size_t max_rps) {
+  return std::max<std::size_t>(max_rps / kBurstShare, 1);
+}
+
+std::size_t TokenBucketRateLimiter::TryAcquire(const std::size_t count, const TimePoint now) {
+  if (max_rps_.load(std::memory_order_relaxed) == 0 || count == 0) {
+    return 0;
+  }
+  const auto emission_interval = emission_interval_.load(std::memory_order_relaxed);
+  if (emission_interval == 0) {
+    return count;
+  }
+  const auto burst_tolerance = burst_tolerance_.load(std::memory_order_relaxed);
+  const auto now_ns = std::chrono::duration_cast<Nanoseconds>(now.time_since_epoch()).count();
+  auto tat = theoretical_arrival_time_.load(std::memory_order_relaxed);
+  while (true) {
+    const auto base = std::max(tat, now_ns);
+    const auto free_tokens = (now_ns + burst_tolerance - base) / emission_interval;
+    if (free_tokens <= 0) {
+      return 0;
+    }
+    const auto admitted = std::min(count, static_cast<std::size_t>(free_tokens));
+    const auto new_tat = base + static_cast<std::int64_t>(admitted) * emission_interval;
+    if (theoretical_arrival_time_.compare_exchange_weak(
+            tat, new_tat, std::memory_order_relaxed, std::memory_order_relaxed
+        )) {
+      return admitted;
+    }
+  }
+}
+
+void TokenBucketRateLimiter::Release(const std::size_t count, const TimePoint now) {
+  const auto emission_interval = emission_interval_.load(std::memory_order_relaxed);
+  if (emission_interval == 0 || count == 0) {
+    return;
+  }
+  const auto now_ns = std::chrono::duration_cast<Nanoseconds>(now.time_since_epoch()).count();
+  auto tat = theoretical_arrival_time_.load(std::memory_order_relaxed);
+  // TAT раньше момента получения разрешений не дает дополнительных маркеров.
+  while (tat > now_ns) {
+    const auto new_tat =
+        count >= static_cast<std::size_t>((tat - now_ns) / emission_interval)
+            ? now_ns
+            : tat - static_cast<std::int64_t>(count) * emission_interval;
+    if (theoretical_arrival_time_.compare_exchange_weak(
+            tat, new_tat, std::memory_order_relaxed, std::memory_order_relaxed
+        )) {
+      return;
+    }
+  }
+}
+
+void TokenBucketRateLimiter::SetMaxRps(const std::size_t max_rps) {
+  const auto emission_interval = EmissionInterval(max_rps);
+  // TAT сохраняется: опережение, накопленное при прежнем ограничении, расходует новую емкость.
+  emission_interval_.store(emission_interval, std::memory_order_relaxed);
+  burst_tolerance_.store(BurstTolerance(max_rps), std::memory_order_relaxed);
+  max_rps_.store(max_rps, std::memory_order_relaxed);
+}
+
+}  // namespace load_balancer::rate_limiter
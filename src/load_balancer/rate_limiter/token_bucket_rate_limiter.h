@@ -0,0 +1,51 @@
+#ifndef TOKEN_BUCKET_RATE_LIMITER_H
+#define TOKEN_BUCKET_RATE_LIMITER_H
+
+#include <atomic>
+#include <cstdint>
+
+#include "rate_limiter.h"
+
+namespace load_balancer::rate_limiter {
+
+/**
+ * \brief Ограничитель нагрузки на основе корзины маркеров, реализованной алгоритмом GCRA.
+ *
+ * Вместо количества маркеров хранится единственное значение - теоретическое время прибытия (TAT)
+ * следующего запроса, которое обновляется с помощью CAS. Корзина вмещает
+ * @link GetBurst @endlink маркеров, а пополняется со скоростью, при которой всплеск вместе с
+ * пополнением за любой секундный интервал не превышает max_rps запросов. Поэтому при постоянной
+ * перегрузке допускается не менее 0.9 max_rps запросов в секунду.
+ */
+class TokenBucketRateLimiter : public RateLimiter {
+ public:
+  /// Доля max_rps, допускаемая всплеском.
+  static constexpr std::size_t kBurstShare = 10;
+
+  explicit TokenBucketRateLimiter(std::size_t max_rps);
+
+  /**
+   * \brief Емкость корзины: наибольший всплеск запросов при ограничении max_rps.
+   */
+  [[nodiscard]] static std::size_t GetBurst(std::size_t max_rps);
+
+  std::size_t TryAcquire(std::size_t count, TimePoint now) override;
+  using RateLimiter::TryAcquire;
+  void Release(std::size_t count, TimePoint now) override;
+  void SetMaxRps(std::size_t max_rps) override;
+
+ private:
+  using Nanoseconds = std::chrono::nanoseconds;
+
+  std::atomic<std::size_t> max_rps_;
+  /// Интервал между запросами при равномерной нагрузке, 0 - ограничение отсутствует.
+  std::atomic<std::int64_t> emission_interval_;
+  /// Максимальное опережение TAT относительно текущего времени (емкость корзины).
+  std::atomic<std::int64_t> burst_tolerance_;
+  /// Теоретическое время прибытия следующего запроса, нс от начала эпохи часов.
+  std::atomic<std::int64_t> theoretical_arrival_time_ = 0;
+};
+
+}  // namespace load_balancer::rate_limiter
+
+#endif  // TOKEN_BUCKET_RATE_LIMITER_H
@@ -0,0 +1,201 @@
+#ifndef RCU_POINTER_H
+#define RCU_POINTER_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "cache_line.h"
+
+namespace load_balancer::rcu {
+
+/**
+ * \brief Указатель на неизменяемый объект, заменяемый целиком без блокировки читателей
+ * (read-copy-update).
+ *
+ * Читатель перед чтением объявляет текущую эпоху в собственной записи и загружает указатель,
+ * по окончании чтения - сбрасывает эпоху, это две атомарные записи без конкуренции за
+ * кэш-линию. Писатель публикует новый объект, увеличивает эпоху и удаляет прежний объект,
+ * как только не останется читателей, объявивших эпоху не позже замены (эпохальное
+ * освобождение памяти). Читатели, начавшие чтение после замены, видят только новый объект,
+ * поэтому ожидание замены ограничено длительностью уже начатых чтений.
+ *
+ * Чтение не должно включать блокирующих ожиданий, например, приема датаграмм, иначе оно
+ * задерживает замену.
+ *
+ * \tparam T тип объекта.
+ */
+template <typename T>
+class RcuPointer {
+  /**
+   * \brief Запись читателя с эпохой начатого им чтения.
+   */
+  struct alignas(kCacheLineSize) Record {
+    std::atomic<std::uint64_t> epoch = kQuiescent;
+    /// Запись принадлежит читателю, изменяется под @link records_mutex_ @endlink.
+    bool used = false;
+  };
+
+ public:
+  /// Период проверки завершения чтений при замене объекта.
+  static constexpr auto kGracePeriodPollInterval = std::chrono::microseconds(50);
+
+  /**
+   * \brief Объект, защищенный от удаления до окончания чтения.
+   */
+  class ReadGuard {
+   public:
+    ReadGuard(const ReadGuard &other) = delete;
+    ReadGuard &operator=(const ReadGuard &other) = delete;
+
+    ~ReadGuard() {
+      record_.epoch.store(kQuiescent, std::memory_order_release);
+    }
+
+    const T &operator*() const {
+      return *value_;
+    }
+
+    const T *operator->() const {
+      return value_;
+    }
+
+   private:
+    friend class RcuPointer;
+
+    Record &record_;
+    const T *const value_;
+
+    ReadGuard(Record &record, const T *value) : record_(record), value_(value) {
+    }
+  };
+
+  /**
+   * \brief Читатель, принадлежащий одному потоку.
+   *
+   * Чтения одного читателя не могут быть вложенными.
+   */
+  class Reader {
+   public:
+    Reader(const Reader &other) = delete;
+    Reader &operator=(const Reader &other) = delete;
+
+    ~Reader() {
+      pointer_.ReleaseRecord(record_);
+    }
+
+    /**
+     * \brief Начать чтение текущего объекта.
+     * \return объект, который не будет удален до уничтожения результата.
+     */
+    [[nodiscard]] ReadGuard Read() const {
+      // Последовательная согласованность: загрузка указателя следует за объявлением эпохи,
+      // поэтому писатель, не увидевший объявления, уже заменил указатель.
+      record_.epoch.store(pointer_.epoch_.load());
+      return ReadGuard(record_, pointer_.value_.load());
+    }
+
+   private:
+    friend class RcuPointer;
+
+    const RcuPointer &pointer_;
+    Record &record_;
+
+    Reader(const RcuPointer &pointer, Record &record) : pointer_(pointer), record_(record) {
+    }
+  };
+
+  explicit RcuPointer(std::unique_ptr<T> value) : value_(value.release()) {
+  }
+
+  RcuPointer(const RcuPointer &other) = delete;
+  RcuPointer &operator=(const RcuPointer &other) = delete;
+
+  /**
+   * \brief Удалить объект, читатели к этому моменту должны быть уничтожены.
+   */
+  ~RcuPointer() {
+    delete value_.load();
+  }
+
+  /**
+   * \brief Зарегистрировать читателя для вызывающего потока.
+   * \return читатель, который должен быть уничтожен раньше указателя.
+   */
+  [[nodiscard]] Reader RegisterReader() const {
+    const std::lock_guard lock(records_mutex_);
+    auto record = std::find_if(records_.begin(), records_.end(), [](const auto &record) {
+      return !record->used;
+    });
+    if (record == records_.end()) {
+      records_.push_back(std::make_unique<Record>());
+      record = std::prev(records_.end());
+    }
+    (*record)->used = true;
+    return Reader(*this, **record);
+  }
+
+  /**
+   * \brief Текущий объект для писателя.
+   *
+   * Объект удаляется только при замене, поэтому его можно читать без защиты в потоке,
+   * выполняющем замены, либо при отсутствии замен.
+   */
+  [[nodiscard]] const T &Get() const {
+    return *value_.load();
+  }
+
+  /**
+   * \brief Заменить объект и дождаться окончания его чтений, начатых до замены.
+   *
+   * Замены выполняются последовательно.
+   */
+  void Update(std::unique_ptr<T> value) {
+    const std::lock_guard lock(writer_mutex_);
+    const std::unique_ptr<const T> old_value(value_.exchange(value.release()));
+    WaitForReaders(epoch_.fetch_add(1));
+  }
+
+ private:
+  /// Эпоха записи читателя, не выполняющего чтение.
+  static constexpr std::uint64_t kQuiescent = 0;
+
+  std::atomic<const T *> value_;
+  std::atomic<std::uint64_t> epoch_ = kQuiescent + 1;
+  std::mutex writer_mutex_;
+  mutable std::mutex records_mutex_;
+  mutable std::vector<std::unique_ptr<Record>> records_;
+
+  /**
+   * \brief Дождаться окончания чтений, начатых в указанную эпоху или раньше.
+   */
+  void WaitForReaders(const std::uint64_t epoch) const {
+    while (true) {
+      {
+        const std::lock_guard lock(records_mutex_);
+        if (std::none_of(records_.begin(), records_.end(), [epoch](const auto &record) {
+              const auto reader_epoch = record->epoch.load();
+              return record->used && reader_epoch != kQuiescent && reader_epoch <= epoch;
+            })) {
+          return;
+        }
+      }
+      std::this_thread::sleep_for(kGracePeriodPollInterval);
+    }
+  }
+
+  void ReleaseRecord(Record &record) const {
+    const std::lock_guard lock(records_mutex_);
+    record.epoch.store(kQuiescent);
+    record.used = false;
+  }
+};
+
+}  // namespace load_balancer::rcu
+
+#endif  // RCU_POINTER_H
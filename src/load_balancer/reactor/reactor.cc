@@ -0,0 +1,73 @@
+#include "reactor.h"
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <system_error>
+
+namespace load_balancer::reactor {
+
+StopEvent::StopEvent() : event_fd_(eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)) {
+  if (event_fd_ < 0) {
+    throw std::system_error(errno, std::generic_category(), "Can't create eventfd");
+  }
+}
+
+StopEvent::~StopEvent() {
+  close(event_fd_);
+}
+
+void StopEvent::Notify() const {
+  const std::uint64_t value = 1;
+  // Переполнение счетчика невозможно: он только увеличивается на единицу при остановке.
+  static_cast<void>(write(event_fd_, &value, sizeof(value)));
+}
+
+int StopEvent::GetNativeHandle() const {
+  return event_fd_;
+}
+
+Reactor::Reactor(const StopEvent &stop_event) : epoll_(epoll_create1(EPOLL_CLOEXEC)) {
+  if (epoll_ < 0) {
+    throw std::system_error(errno, std::generic_category(), "Can't create epoll");
+  }
+  // Событие остановки отслеживается по уровню: оно не сбрасывается и пробуждает каждое ожидание.
+  epoll_event event = {.events = EPOLLIN, .data = {.u64 = kStopData}};
+  if (epoll_ctl(epoll_, EPOLL_CTL_ADD, stop_event.GetNativeHandle(), &event) < 0) {
+    const auto error = errno;
+    close(epoll_);
+    throw std::system_error(error, std::generic_category(), "Can't watch stop event");
+  }
+}
+
+Reactor::~Reactor() {
+  close(epoll_);
+}
+
+void Reactor::Add(const int fd, const std::uint64_t data) const {
+  epoll_event event = {.events = EPOLLIN | EPOLLET | EPOLLEXCLUSIVE, .data = {.u64 = data}};
+  if (epoll_ctl(epoll_, EPOLL_CTL_ADD, fd, &event) < 0) {
+    throw std::system_error(errno, std::generic_category(), "Can't watch descriptor");
+  }
+}
+
+bool Reactor::Wait(std::vector<std::uint64_t> &ready) {
+  ready.clear();
+  const int count = epoll_wait(epoll_, events_.data(), static_cast<int>(events_.size()), -1);
+  if (count < 0) {
+    if (errno == EINTR) {
+      return true;
+    }
+    throw std::system_error(errno, std::generic_category(), "Can't wait for events");
+  }
+  for (int i = 0; i < count; ++i) {
+    if (events_[i].data.u64 == kStopData) {
+      return false;
+    }
+    ready.push_back(events_[i].data.u64);
+  }
+  return true;
+}
+
+}  // namespace load_balancer::reactor
@@ -0,0 +1,92 @@
+#ifndef REACTOR_H
+#define REACTOR_H
+
+#include <sys/epoll.h>
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace load_balancer::reactor {
+
+/**
+ * \brief Событие остановки на основе eventfd.
+ *
+ * Событие не сбрасывается, поэтому однократное уведомление пробуждает все реакторы, в которых
+ * оно зарегистрировано, и все их последующие ожидания.
+ */
+class StopEvent {
+ public:
+  /**
+   * \throws std::system_error не удалось создать eventfd.
+   */
+  StopEvent();
+
+  StopEvent(const StopEvent &other) = delete;
+  StopEvent &operator=(const StopEvent &other) = delete;
+
+  ~StopEvent();
+
+  /**
+   * \brief Уведомить о событии.
+   */
+  void Notify() const;
+  /**
+   * \brief Получить дескриптор eventfd.
+   */
+  [[nodiscard]] int GetNativeHandle() const;
+
+ private:
+  int event_fd_ = -1;
+};
+
+/**
+ * \brief Реактор epoll: ожидание готовности нескольких дескрипторов к чтению в одном потоке.
+ *
+ * Дескрипторы регистрируются с уведомлением по фронту (EPOLLET), поэтому после события
+ * дескриптор нужно читать, пока чтение не вернет EAGAIN. Если один дескриптор отслеживают
+ * несколько реакторов, событие получает только один из них (EPOLLEXCLUSIVE).
+ */
+class Reactor {
+ public:
+  /// Максимальное количество событий, забираемых одним ожиданием.
+  static constexpr std::size_t kMaxEvents = 64;
+
+  /**
+   * \param stop_event событие остановки, после которого ожидание сразу завершается.
+   * \throws std::system_error не удалось создать epoll.
+   */
+  explicit Reactor(const StopEvent &stop_event);
+
+  Reactor(const Reactor &other) = delete;
+  Reactor &operator=(const Reactor &other) = delete;
+
+  ~Reactor();
+
+  /**
+   * \brief Отслеживать готовность дескриптора к чтению.
+   * \param fd дескриптор, например, неблокирующего сокета;
+   * \param data значение, возвращаемое для дескриптора ожиданием.
+   * \throws std::system_error не удалось зарегистрировать дескриптор.
+   */
+  void Add(int fd, std::uint64_t data) const;
+  /**
+   * \brief Ожидать готовности зарегистрированных дескрипторов.
+   * \param ready значения готовых дескрипторов, заменяются при каждом ожидании.
+   * \return false - наступило событие остановки.
+   * \throws std::system_error ошибка ожидания.
+   */
+  [[nodiscard]] bool Wait(std::vector<std::uint64_t> &ready);
+
+ private:
+  /// Значение события остановки, не используемое для дескрипторов.
+  static constexpr std::uint64_t kStopData = std::numeric_limits<std::uint64_t>::max();
+
+  int epoll_ = -1;
+  std::array<epoll_event, kMaxEvents> events_{};
+};
+
+}  // namespace load_balancer::reactor
+
+#endif  // REACTOR_H
@@ -0,0 +1,17 @@
+#ifndef TRANSPORT_TYPE_H
+#define TRANSPORT_TYPE_H
+
+namespace load_balancer {
+
+/**
+ * \brief Способ приема и перенаправления датаграмм.
+ */
+enum class TransportType {
+  kSocket,   ///< Блокирующие системные вызовы recvfrom/sendto (recvmmsg/sendmmsg для пачек).
+  kIoUring,  ///< Асинхронный прием и отправка через io_uring.
+  kEpoll,    ///< Неблокирующие сокеты с ожиданием готовности через epoll (по фронту).
+};
+
+}  // namespace load_balancer
+
+#endif  // TRANSPORT_TYPE_H
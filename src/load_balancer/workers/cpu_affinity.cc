@@ -0,0 +1,37 @@
+#include "cpu_affinity.h"
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <system_error>
+
+namespace load_balancer::workers {
+
+std::vector<int> GetAllowedCpus() {
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  std::vector<int> cpus;
+  if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+      if (CPU_ISSET(cpu, &set)) {
+        cpus.push_back(cpu);
+      }
+    }
+  }
+  if (cpus.empty()) {
+    cpus.push_back(0);
+  }
+  return cpus;
+}
+
+void PinCurrentThread(const int cpu) {
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  const auto error = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+  if (error != 0) {
+    throw std::system_error(error, std::generic_category(), "Can't pin thread to CPU");
+  }
+}
+
+}  // namespace load_balancer::workers
@@ -0,0 +1,30 @@
+#ifndef CPU_AFFINITY_H
+#define CPU_AFFINITY_H
+
+#include <vector>
+
+namespace load_balancer::workers {
+
+/**
+ * \brief Процессоры, на которых разрешено выполнять процесс (sched_getaffinity).
+ *
+ * Учитывает ограничения taskset и cgroup cpuset, в отличие от
+ * std::thread::hardware_concurrency.
+ *
+ * \return номера процессоров по возрастанию, не пуст.
+ */
+std::vector<int> GetAllowedCpus();
+
+/**
+ * \brief Привязать вызывающий поток к процессору.
+ *
+ * Память, впервые затронутая потоком после привязки, выделяется ядром на узле NUMA этого
+ * процессора, поэтому буферы потока следует выделять после привязки.
+ *
+ * \throws std::system_error не удалось изменить привязку.
+ */
+void PinCurrentThread(int cpu);
+
+}  // namespace load_balancer::workers
+
+#endif  // CPU_AFFINITY_H
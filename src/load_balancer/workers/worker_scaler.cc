@@ -0,0 +1,125 @@
+#include "worker_scaler.h"
+
+#include <pthread.h>
+
+#include <algorithm>
+#include <iostream>
+
+namespace load_balancer::workers {
+
+WorkerScaler::Worker::Worker(const WorkerScaler &scaler, const std::size_t index)
+    : scaler_(scaler), index_(index) {}
+
+void WorkerScaler::Worker::WaitUntilActive() const {
+  auto active = scaler_.active_.load();
+  while (index_ >= active) {
+    scaler_.active_.wait(active);
+    active = scaler_.active_.load();
+  }
+}
+
+WorkerScaler::WorkerScaler(
+    const std::size_t max_workers,
+    const std::size_t active_workers,
+    const std::chrono::milliseconds period
+)
+    : max_workers_(max_workers),
+      period_(period),
+      active_(period.count() > 0 ? std::clamp<std::size_t>(active_workers, 1, max_workers)
+                                 : max_workers) {}
+
+WorkerScaler::~WorkerScaler() {
+  Stop();
+}
+
+WorkerScaler::Worker WorkerScaler::RegisterWorker() {
+  const std::lock_guard lock(workers_mutex_);
+  clockid_t clock = CLOCK_THREAD_CPUTIME_ID;
+  pthread_getcpuclockid(pthread_self(), &clock);
+  cpu_clocks_.push_back(clock);
+  return {*this, cpu_clocks_.size() - 1};
+}
+
+void WorkerScaler::Start() {
+  if (period_.count() <= 0) {
+    return;
+  }
+  thread_ = std::jthread([this](const std::stop_token &stop_token) {
+    Scale(stop_token);
+  });
+}
+
+void WorkerScaler::Stop() {
+  thread_ = {};
+  active_ = max_workers_;
+  active_.notify_all();
+}
+
+std::size_t WorkerScaler::GetActiveCount() const {
+  return active_;
+}
+
+std::size_t WorkerScaler::NextActiveCount(
+    const std::size_t active, const double utilization, const std::size_t max_workers
+) {
+  if (utilization > kScaleUpUtilization && active < max_workers) {
+    return active + 1;
+  }
+  if (utilization < kScaleDownUtilization && active > 1) {
+    return active - 1;
+  }
+  return active;
+}
+
+void WorkerScaler::Scale(const std::stop_token &stop_token) {
+  auto last_times = GetCpuTimes();
+  auto last_period = std::chrono::steady_clock::now();
+  while (!stop_token.stop_requested()) {
+    {
+      std::unique_lock lock(period_mutex_);
+      period_elapsed_.wait_for(lock, stop_token, period_, [] { return false; });
+    }
+    if (stop_token.stop_requested()) {
+      return;
+    }
+    const auto times = GetCpuTimes();
+    const auto now = std::chrono::steady_clock::now();
+    const auto active = active_.load();
+    std::chrono::nanoseconds busy{0};
+    for (std::size_t i = 0; i < active && i < times.size(); ++i) {
+      // Поток, зарегистрированный за период, учитывается с начала регистрации.
+      busy += times[i] - (i < last_times.size() ? last_times[i] : std::chrono::nanoseconds{0});
+    }
+    const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(now - last_period);
+    last_times = times;
+    last_period = now;
+    if (elapsed.count() <= 0) {
+      continue;
+    }
+    const auto utilization =
+        static_cast<double>(busy.count()) / static_cast<double>(elapsed.count() * active);
+    const auto next = NextActiveCount(active, utilization, max_workers_);
+    if (next != active) {
+      active_ = next;
+      active_.notify_all();
+      std::cout << "Worker pool scaled to " << next << " threads.\n";
+    }
+  }
+}
+
+std::vector<std::chrono::nanoseconds> WorkerScaler::GetCpuTimes() {
+  const std::lock_guard lock(workers_mutex_);
+  std::vector<std::chrono::nanoseconds> times;
+  times.reserve(cpu_clocks_.size());
+  for (const auto clock : cpu_clocks_) {
+    timespec time{};
+    // Часы завершившегося потока недоступны, его время считается нулевым.
+    if (clock_gettime(clock, &time) != 0) {
+      time = {};
+    }
+    times.push_back(std::chrono::seconds(time.tv_sec) + std::chrono::nanoseconds(time.tv_nsec));
+  }
+  return times;
+}
+
+}  // namespace load_balancer::workers
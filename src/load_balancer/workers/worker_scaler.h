@@ -0,0 +1,109 @@
+#ifndef WORKER_SCALER_H
+#define WORKER_SCALER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <ctime>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace load_balancer::workers {
+
+/**
+ * \brief Изменение количества активных потоков пула по их измеренной загрузке.
+ *
+ * Потоки пула создаются заранее, неактивные потоки ожидают активации и не принимают запросы.
+ * Загрузка потока - доля процессорного времени потока (CLOCK_THREAD_CPUTIME_ID) за период:
+ * поток, ожидающий датаграмму в блокирующем приеме, процессорное время не расходует. Если
+ * средняя загрузка активных потоков выше @link kScaleUpUtilization @endlink, активируется еще
+ * один поток, если ниже @link kScaleDownUtilization @endlink - последний активный поток
+ * останавливается после обработки текущего запроса.
+ */
+class WorkerScaler {
+ public:
+  /// Средняя загрузка активных потоков, выше которой активируется еще один поток.
+  static constexpr double kScaleUpUtilization = 0.75;
+  /// Средняя загрузка активных потоков, ниже которой останавливается один поток.
+  static constexpr double kScaleDownUtilization = 0.25;
+
+  /**
+   * \brief Поток пула, полученный при регистрации.
+   */
+  class Worker {
+   public:
+    /**
+     * \brief Ожидать, пока поток не окажется среди активных.
+     */
+    void WaitUntilActive() const;
+
+   private:
+    friend class WorkerScaler;
+
+    const WorkerScaler &scaler_;
+    const std::size_t index_;
+
+    Worker(const WorkerScaler &scaler, std::size_t index);
+  };
+
+  /**
+   * \param max_workers количество потоков пула;
+   * \param active_workers количество активных потоков при запуске;
+   * \param period период измерения загрузки, 0 - количество активных потоков не изменяется.
+   */
+  WorkerScaler(
+      std::size_t max_workers, std::size_t active_workers, std::chrono::milliseconds period
+  );
+
+  WorkerScaler(const WorkerScaler &other) = delete;
+  WorkerScaler &operator=(const WorkerScaler &other) = delete;
+
+  ~WorkerScaler();
+
+  /**
+   * \brief Зарегистрировать вызывающий поток в пуле.
+   *
+   * Потоки активируются в порядке регистрации.
+   */
+  [[nodiscard]] Worker RegisterWorker();
+  /**
+   * \brief Запустить измерение загрузки.
+   */
+  void Start();
+  /**
+   * \brief Остановить измерение загрузки и активировать все потоки, чтобы они могли
+   * завершиться.
+   */
+  void Stop();
+  [[nodiscard]] std::size_t GetActiveCount() const;
+
+  /**
+   * \brief Количество активных потоков после периода с указанной средней загрузкой.
+   */
+  [[nodiscard]] static std::size_t NextActiveCount(
+      std::size_t active, double utilization, std::size_t max_workers
+  );
+
+ private:
+  const std::size_t max_workers_;
+  const std::chrono::milliseconds period_;
+  std::atomic<std::size_t> active_;
+  std::mutex workers_mutex_;
+  /// Часы процессорного времени потоков в порядке регистрации.
+  std::vector<clockid_t> cpu_clocks_;
+  std::mutex period_mutex_;
+  std::condition_variable_any period_elapsed_;
+  std::jthread thread_;
+
+  void Scale(const std::stop_token &stop_token);
+  /**
+   * \brief Процессорное время потоков в порядке регистрации.
+   */
+  [[nodiscard]] std::vector<std::chrono::nanoseconds> GetCpuTimes();
+};
+
+}  // namespace load_balancer::workers
+
+#endif  // WORKER_SCALER_H
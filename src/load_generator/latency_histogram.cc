@@ -0,0 +1,68 @@
+#include "latency_histogram.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace load_balancer::generator {
+
+void LatencyHistogram::Record(const std::uint64_t value) {
+  ++buckets_[BucketIndex(value)];
+  ++count_;
+  max_ = std::max(max_, value);
+}
+
+void LatencyHistogram::Merge(const LatencyHistogram &other) {
+  for (std::size_t i = 0; i < kBucketCount; ++i) {
+    buckets_[i] += other.buckets_[i];
+  }
+  count_ += other.count_;
+  max_ = std::max(max_, other.max_);
+}
+
+std::uint64_t LatencyHistogram::GetCount() const {
+  return count_;
+}
+
+std::uint64_t LatencyHistogram::GetMax() const {
+  return max_;
+}
+
+std::uint64_t LatencyHistogram::GetQuantile(const double quantile) const {
+  if (count_ == 0) {
+    return 0;
+  }
+  const auto rank = std::max<std::uint64_t>(
+      static_cast<std::uint64_t>(std::ceil(std::clamp(quantile, 0.0, 1.0) * count_)), 1
+  );
+  std::uint64_t seen = 0;
+  for (std::size_t i = 0; i < kBucketCount; ++i) {
+    seen += buckets_[i];
+    if (seen >= rank) {
+      return std::min(BucketUpperBound(i), max_);
+    }
+  }
+  return max_;
+}
+
+std::size_t LatencyHistogram::BucketIndex(const std::uint64_t value) {
+  // Значения меньше 2 * kSubBucketCount учитываются точно, остальные - с шагом 2^shift, где
+  // shift выбирается так, чтобы старшие kSubBucketBits + 1 бит значения определяли интервал.
+  const auto width = static_cast<std::size_t>(std::bit_width(value));
+  if (width <= kSubBucketBits + 1) {
+    return static_cast<std::size_t>(value);
+  }
+  const auto shift = width - kSubBucketBits - 1;
+  return shift * kSubBucketCount + static_cast<std::size_t>(value >> shift);
+}
+
+std::uint64_t LatencyHistogram::BucketUpperBound(const std::size_t index) {
+  if (index < 2 * kSubBucketCount) {
+    return index;
+  }
+  const auto shift = index / kSubBucketCount - 1;
+  const auto sub_bucket = index - shift * kSubBucketCount;
+  return ((static_cast<std::uint64_t>(sub_bucket) + 1) << shift) - 1;
+}
+
+}  // namespace load_balancer::generator
@@ -0,0 +1,52 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <array>
+#include <cstdint>
+
+namespace load_balancer::generator {
+
+/**
+ * \brief Гистограмма задержек с логарифмически-линейными интервалами.
+ *
+ * Каждая степень двойки делится на @link kSubBucketCount @endlink равных интервалов, поэтому
+ * относительная погрешность значения не превышает 1/32 во всем диапазоне 64-битных значений, а
+ * запись - это вычисление индекса и увеличение счетчика без выделения памяти.
+ */
+class LatencyHistogram {
+ public:
+  /// Двоичный логарифм количества интервалов в одной степени двойки.
+  static constexpr std::size_t kSubBucketBits = 5;
+  static constexpr std::size_t kSubBucketCount = std::size_t{1} << kSubBucketBits;
+  static constexpr std::size_t kBucketCount = (64 - kSubBucketBits + 1) * kSubBucketCount;
+
+  /**
+   * \brief Учесть значение.
+   */
+  void Record(std::uint64_t value);
+  /**
+   * \brief Добавить значения другой гистограммы.
+   */
+  void Merge(const LatencyHistogram &other);
+
+  [[nodiscard]] std::uint64_t GetCount() const;
+  [[nodiscard]] std::uint64_t GetMax() const;
+  /**
+   * \brief Значение, не превышаемое указанной долей учтенных значений.
+   * \param quantile доля от 0 до 1.
+   * \return верхняя граница интервала, 0 - гистограмма пуста.
+   */
+  [[nodiscard]] std::uint64_t GetQuantile(double quantile) const;
+
+ private:
+  std::array<std::uint64_t, kBucketCount> buckets_ = {};
+  std::uint64_t count_ = 0;
+  std::uint64_t max_ = 0;
+
+  static std::size_t BucketIndex(std::uint64_t value);
+  static std::uint64_t BucketUpperBound(std::size_t index);
+};
+
+}  // namespace load_balancer::generator
+
+#endif  // LATENCY_HISTOGRAM_H
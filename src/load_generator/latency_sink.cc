@@ -0,0 +1,71 @@
+#include "latency_sink.h"
+
+#include <iostream>
+#include <vector>
+
+#include "invalid_socket_exception.h"
+#include "probe.h"
+
+namespace load_balancer::generator {
+
+LatencySink::LatencySink(const EndPointType &end_point) : socket_(end_point) {
+}
+
+LatencySink::~LatencySink() {
+  Stop();
+}
+
+void LatencySink::Start() {
+  thread_ = std::jthread([this] {
+    Worker();
+  });
+}
+
+void LatencySink::Stop() {
+  if (socket_.GetNativeHandle() != -1) {
+    socket_.Close();
+  }
+  thread_ = {};
+}
+
+std::uint64_t LatencySink::GetReceived() const {
+  return received_.load(std::memory_order_relaxed);
+}
+
+const LatencyHistogram &LatencySink::GetHistogram() const {
+  return histogram_;
+}
+
+LatencySink::EndPointType LatencySink::GetEndPoint() const {
+  return socket_.GetEndPoint();
+}
+
+void LatencySink::Worker() {
+  std::vector<char> buffer(kBatchSize * kBufferSize);
+  std::vector<SocketType::DatagramView> datagrams(kBatchSize);
+  for (std::size_t i = 0; i < kBatchSize; ++i) {
+    datagrams[i].buffer = std::span(buffer).subspan(i * kBufferSize, kBufferSize);
+  }
+  while (true) {
+    try {
+      const auto count = socket_.ReceiveBatchFrom(datagrams);
+      const auto now = ProbeNow();
+      std::uint64_t received = 0;
+      for (std::size_t i = 0; i < count; ++i) {
+        const auto probe = ReadProbe(datagrams[i].buffer.first(datagrams[i].size));
+        if (!probe) {
+          continue;
+        }
+        histogram_.Record(now > probe->send_time ? now - probe->send_time : 0);
+        ++received;
+      }
+      received_.fetch_add(received, std::memory_order_relaxed);
+    } catch ([[maybe_unused]] const socket_wrapper::InvalidSocketException &ex) {
+      return;
+    } catch (const std::exception &ex) {
+      std::cerr << "Error in latency sink: " << ex.what() << ".\n";
+    }
+  }
+}
+
+}  // namespace load_balancer::generator
@@ -0,0 +1,68 @@
+#ifndef LATENCY_SINK_H
+#define LATENCY_SINK_H
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+#include "latency_histogram.h"
+#include "udp_socket.h"
+
+namespace load_balancer::generator {
+
+/**
+ * \brief Приемник датаграмм генератора нагрузки, измеряющий задержку их доставки.
+ *
+ * Задержка - это разность времени приема и запланированного времени отправки, записанного
+ * генератором в @link Probe заголовок @endlink датаграммы. Генератор и приемник работают на
+ * одном узле и используют одни и те же монотонные часы. Прочие датаграммы, например,
+ * проверки здоровья балансировщика, не учитываются.
+ */
+class LatencySink {
+ public:
+  using SocketType = socket_wrapper::udp::UdpSocket<socket_wrapper::ProtocolFamily::kIpV4>;
+  using EndPointType = SocketType::EndPointType;
+
+  /// Максимальное количество датаграмм, принимаемых за один системный вызов.
+  static constexpr std::size_t kBatchSize = 64;
+  /// Размер буфера одной датаграммы, более длинные датаграммы обрезаются.
+  static constexpr std::size_t kBufferSize = 2048;
+
+  explicit LatencySink(const EndPointType &end_point);
+
+  LatencySink(const LatencySink &other) = delete;
+  LatencySink &operator=(const LatencySink &other) = delete;
+
+  ~LatencySink();
+
+  /**
+   * \brief Запустить прием датаграмм.
+   */
+  void Start();
+  /**
+   * \brief Остановить прием датаграмм и дождаться завершения потока приемника.
+   */
+  void Stop();
+
+  /**
+   * \brief Количество принятых датаграмм генератора.
+   */
+  [[nodiscard]] std::uint64_t GetReceived() const;
+  /**
+   * \brief Гистограмма задержек в наносекундах, доступная после остановки приемника.
+   */
+  [[nodiscard]] const LatencyHistogram &GetHistogram() const;
+  [[nodiscard]] EndPointType GetEndPoint() const;
+
+ private:
+  SocketType socket_;
+  std::atomic<std::uint64_t> received_ = 0;
+  LatencyHistogram histogram_;
+  std::jthread thread_;
+
+  void Worker();
+};
+
+}  // namespace load_balancer::generator
+
+#endif  // LATENCY_SINK_H
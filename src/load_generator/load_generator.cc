@@ -0,0 +1,123 @@
+#include "load_generator.h"
+
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+
+#include "probe.h"
+
+namespace load_balancer::generator {
+
+using namespace std::chrono_literals;
+
+namespace {
+
+/// Время до отправки, начиная с которого поток засыпает, а не уступает процессор.
+constexpr auto kSleepThreshold = std::chrono::nanoseconds(100us).count();
+/// Запас пробуждения до запланированного времени отправки.
+constexpr auto kWakeUpAdvance = std::chrono::nanoseconds(50us).count();
+
+}  // namespace
+
+LoadGenerator::LoadGenerator(const LoadGeneratorOptions &options, EndPointType target)
+    : options_(options), target_(std::move(target)) {
+  if (options_.rate == 0) {
+    throw std::invalid_argument("The rate must be positive.");
+  }
+  if (options_.payload_size < kProbeSize || options_.payload_size > SocketType::kMaxDatagramSize) {
+    throw std::invalid_argument("The payload size is out of range.");
+  }
+  if (options_.thread_count == 0 || options_.batch_size == 0) {
+    throw std::invalid_argument("The thread count and the batch size must be positive.");
+  }
+}
+
+void LoadGenerator::Run() {
+  const auto source_ports = std::max(options_.source_ports, options_.thread_count);
+  std::vector<SocketType> sockets;
+  sockets.reserve(source_ports);
+  for (std::size_t i = 0; i < source_ports; ++i) {
+    sockets.emplace_back(static_cast<std::uint16_t>(0));
+  }
+
+  const auto start = ProbeNow();
+  const auto end = start + static_cast<std::uint64_t>(
+                               std::chrono::nanoseconds(options_.duration).count()
+                           );
+  {
+    std::vector<std::jthread> threads;
+    for (std::size_t i = 0, first = 0; i < options_.thread_count; ++i) {
+      // Порты распределяются между потоками поровну, остаток - первым потокам.
+      const auto count = source_ports / options_.thread_count +
+                         (i < source_ports % options_.thread_count ? 1 : 0);
+      const auto thread_sockets = std::span<const SocketType>(sockets).subspan(first, count);
+      first += count;
+      threads.emplace_back([this, i, thread_sockets, start, end] {
+        Worker(static_cast<std::uint32_t>(i), thread_sockets, start, end);
+      });
+    }
+  }
+}
+
+std::uint64_t LoadGenerator::GetSent() const {
+  return sent_.load(std::memory_order_relaxed);
+}
+
+void LoadGenerator::Worker(
+    const std::uint32_t index,
+    const std::span<const SocketType> sockets,
+    const std::uint64_t start,
+    const std::uint64_t end
+) {
+  // Потоки отправляют с одинаковой скоростью со сдвигом, чтобы суммарный поток был равномерным.
+  const auto interval = 1e9 * static_cast<double>(options_.thread_count) /
+                        static_cast<double>(options_.rate);
+  const auto offset = interval * index / static_cast<double>(options_.thread_count);
+  const auto scheduled_time = [start, interval, offset](const std::uint64_t sequence) {
+    return start + static_cast<std::uint64_t>(offset + interval * static_cast<double>(sequence));
+  };
+
+  std::vector<char> buffer(options_.batch_size * options_.payload_size);
+  std::vector<SocketType::DatagramView> datagrams(options_.batch_size);
+  for (std::size_t i = 0; i < datagrams.size(); ++i) {
+    datagrams[i] = {
+        .buffer = std::span(buffer).subspan(i * options_.payload_size, options_.payload_size),
+        .size = options_.payload_size,
+        .end_point = target_,
+    };
+  }
+
+  std::uint64_t sequence = 0;
+  for (std::size_t socket = 0;; socket = (socket + 1) % sockets.size()) {
+    auto now = ProbeNow();
+    while (now < end && scheduled_time(sequence) > now) {
+      const auto wait = scheduled_time(sequence) - now;
+      if (wait > static_cast<std::uint64_t>(kSleepThreshold)) {
+        std::this_thread::sleep_for(std::chrono::nanoseconds(wait - kWakeUpAdvance));
+      } else {
+        std::this_thread::yield();
+      }
+      now = ProbeNow();
+    }
+    if (now >= end) {
+      break;
+    }
+    std::size_t count = 0;
+    while (count < datagrams.size() && scheduled_time(sequence) <= now) {
+      WriteProbe(
+          {.thread = index, .sequence = sequence, .send_time = scheduled_time(sequence)},
+          datagrams[count].buffer
+      );
+      ++count;
+      ++sequence;
+    }
+    try {
+      sockets[socket].SendBatchTo(std::span(datagrams).first(count));
+      sent_.fetch_add(count, std::memory_order_relaxed);
+    } catch (const std::exception &ex) {
+      std::cerr << "Error while sending datagrams: " << ex.what() << ".\n";
+    }
+  }
+}
+
+}  // namespace load_balancer::generator
@@ -0,0 +1,107 @@
+#ifndef LOAD_GENERATOR_H
+#define LOAD_GENERATOR_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "udp_socket.h"
+
+namespace load_balancer::generator {
+
+/**
+ * \brief Параметры генератора нагрузки.
+ */
+struct LoadGeneratorOptions {
+  /// Суммарная скорость отправки, датаграмм в секунду.
+  std::size_t rate = 100000;
+  /// Размер датаграммы, не меньше размера заголовка @link Probe @endlink.
+  std::size_t payload_size = 64;
+  /// Количество потоков отправки, скорость делится между ними поровну.
+  std::size_t thread_count = 2;
+  /// Количество сокетов отправки с разными портами, не меньше одного на поток. Порты
+  /// отправителя определяют распределение датаграмм между шардами балансировщика.
+  std::size_t source_ports = 64;
+  /// Максимальное количество датаграмм, отправляемых за один системный вызов.
+  std::size_t batch_size = 32;
+  /// Длительность отправки.
+  std::chrono::milliseconds duration{5000};
+  /// Файл pcap, датаграммы которого воспроизводятся @link TrafficReplay @endlink вместо
+  /// генерации; пустой - датаграммы генерируются.
+  std::string replay_file{};
+  /// Множитель скорости воспроизведения: 1 - исходная скорость, 2 - вдвое быстрее,
+  /// 0 - максимальная скорость.
+  double replay_speed = 1;
+};
+
+/**
+ * \brief Многопоточный генератор нагрузки с открытым циклом.
+ *
+ * Каждая датаграмма имеет запланированное время отправки, определяемое только заданной
+ * скоростью, и отправляется, как только оно наступило, независимо от доставки предыдущих.
+ * В датаграмму записывается запланированное, а не фактическое время, поэтому задержка
+ * отправки самого генератора не скрывает задержку обработки (coordinated omission).
+ */
+class LoadGenerator {
+ public:
+  using SocketType = socket_wrapper::udp::UdpSocket<socket_wrapper::ProtocolFamily::kIpV4>;
+  using EndPointType = SocketType::EndPointType;
+
+  /// Ключ скорости отправки в файле конфигурации.
+  static constexpr auto kRateKey = "rate";
+  /// Ключ размера датаграммы в файле конфигурации.
+  static constexpr auto kPayloadSizeKey = "payload_size";
+  /// Ключ количества потоков отправки в файле конфигурации.
+  static constexpr auto kThreadCountKey = "thread_count";
+  /// Ключ количества портов отправителя в файле конфигурации.
+  static constexpr auto kSourcePortsKey = "source_ports";
+  /// Ключ размера пачки в файле конфигурации.
+  static constexpr auto kBatchSizeKey = "batch_size";
+  /// Ключ длительности отправки в миллисекундах в файле конфигурации.
+  static constexpr auto kDurationKey = "duration";
+
+  /**
+   * \param options параметры генератора;
+   * \param target получатель датаграмм.
+   * \throws std::invalid_argument некорректные параметры.
+   */
+  LoadGenerator(const LoadGeneratorOptions &options, EndPointType target);
+
+  LoadGenerator(const LoadGenerator &other) = delete;
+  LoadGenerator &operator=(const LoadGenerator &other) = delete;
+
+  /**
+   * \brief Отправлять датаграммы в течение заданного времени и дождаться завершения потоков.
+   */
+  void Run();
+  /**
+   * \brief Количество отправленных датаграмм.
+   */
+  [[nodiscard]] std::uint64_t GetSent() const;
+
+ private:
+  const LoadGeneratorOptions options_;
+  const EndPointType target_;
+  std::atomic<std::uint64_t> sent_ = 0;
+
+  /**
+   * \brief Отправлять датаграммы одного потока до окончания времени отправки.
+   * \param index номер потока;
+   * \param sockets сокеты потока, используемые по очереди для каждой пачки;
+   * \param start время отправки первой датаграммы, нс;
+   * \param end время окончания отправки, нс.
+   */
+  void Worker(
+      std::uint32_t index,
+      std::span<const SocketType> sockets,
+      std::uint64_t start,
+      std::uint64_t end
+  );
+};
+
+}  // namespace load_balancer::generator
+
+#endif  // LOAD_GENERATOR_H
@@ -0,0 +1,121 @@
+#include <format>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+#include "configuration/configuration.h"
+#include "configuration/schema.h"
+#include "latency_sink.h"
+#include "load_balancer.h"
+#include "load_generator.h"
+#include "traffic_replay.h"
+
+using namespace load_balancer;
+using namespace load_balancer::config;
+using namespace load_balancer::generator;
+
+namespace {
+
+/// Имя файла с параметрами генератора по умолчанию.
+constexpr auto kDefaultGeneratorFileName = "load_generator.properties";
+/// Время ожидания датаграмм, еще не доставленных после окончания отправки.
+constexpr auto kDrainTime = std::chrono::milliseconds(500);
+
+/// Схема параметров генератора, значения проверяются конструктором @link LoadGenerator
+/// @endlink.
+constexpr Schema kOptionsSchema(
+    Field(LoadGenerator::kRateKey, &LoadGeneratorOptions::rate),
+    Field(LoadGenerator::kPayloadSizeKey, &LoadGeneratorOptions::payload_size),
+    Field(LoadGenerator::kThreadCountKey, &LoadGeneratorOptions::thread_count),
+    Field(LoadGenerator::kSourcePortsKey, &LoadGeneratorOptions::source_ports),
+    Field(LoadGenerator::kBatchSizeKey, &LoadGeneratorOptions::batch_size),
+    Field(LoadGenerator::kDurationKey, &LoadGeneratorOptions::duration),
+    Field(TrafficReplay::kReplayFileKey, &LoadGeneratorOptions::replay_file),
+    Field(TrafficReplay::kReplaySpeedKey, &LoadGeneratorOptions::replay_speed)
+);
+
+double ToMicroseconds(const std::uint64_t nanoseconds) {
+  return static_cast<double>(nanoseconds) / 1000.0;
+}
+
+}  // namespace
+
+/**
+ * \brief Измерить пропускную способность, потери и задержку перенаправления балансировщика.
+ *
+ * Запускает балансировщик с конфигурацией из второго аргумента (по умолчанию -
+ * config.properties), приемники на адресах его серверов и генератор нагрузки с параметрами из
+ * первого аргумента (по умолчанию - load_generator.properties), отправляющий датаграммы на
+ * порт приема балансировщика на локальном интерфейсе. Если задан файл pcap, вместо генерации
+ * воспроизводятся его датаграммы.
+ */
+int main(const int argc, const char *argv[]) {
+  try {
+    const auto options = kOptionsSchema.Parse(
+        Configuration(argc > 1 ? argv[1] : kDefaultGeneratorFileName)
+    );
+    const auto configuration =
+        std::make_shared<Configuration>(argc > 2 ? argv[2] : Configuration::kDefaultFileName);
+
+    std::vector<std::unique_ptr<LatencySink>> sinks;
+    for (const auto &server : LoadBalancer::ParseSettings(*configuration).servers) {
+      sinks.emplace_back(std::make_unique<LatencySink>(server.end_point));
+      sinks.back()->Start();
+    }
+
+    LoadBalancer load_balancer(configuration);
+    load_balancer.Start();
+    const LoadGenerator::EndPointType target(
+        "127.0.0.1", load_balancer.ReceiverEndPoint().GetPort()
+    );
+    std::uint64_t sent = 0;
+    auto seconds = std::chrono::duration<double>(options.duration).count();
+    if (options.replay_file.empty()) {
+      LoadGenerator generator(options, target);
+      generator.Run();
+      sent = generator.GetSent();
+      std::cout << std::format("target: {} pps\n", options.rate);
+    } else {
+      TrafficReplay replay(options, target);
+      const auto start = std::chrono::steady_clock::now();
+      replay.Run();
+      seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      sent = replay.GetSent();
+      std::cout << std::format(
+          "replay: {} at speed {}, skipped packets: {}\n",
+          options.replay_file,
+          options.replay_speed,
+          replay.GetSkipped()
+      );
+    }
+    std::this_thread::sleep_for(kDrainTime);
+    load_balancer.Stop();
+
+    LatencyHistogram histogram;
+    for (const auto &sink : sinks) {
+      sink->Stop();
+      histogram.Merge(sink->GetHistogram());
+    }
+    const auto received = histogram.GetCount();
+    std::cout << std::format(
+        "sent: {} ({:.0f} pps)\nbalancer received: {}, admitted: {}\nreceived: {} ({:.0f} pps)\n"
+        "drop rate: {:.4f}%\nlatency, us: p50 {:.1f}, p99 {:.1f}, p99.9 {:.1f}, max {:.1f}\n",
+        sent,
+        static_cast<double>(sent) / seconds,
+        load_balancer.GetMetrics().Get(metrics::Counter::kReceived),
+        load_balancer.GetMetrics().Get(metrics::Counter::kAdmitted),
+        received,
+        static_cast<double>(received) / seconds,
+        sent == 0 ? 0.0
+                  : 100.0 * static_cast<double>(sent - std::min(sent, received)) /
+                        static_cast<double>(sent),
+        ToMicroseconds(histogram.GetQuantile(0.5)),
+        ToMicroseconds(histogram.GetQuantile(0.99)),
+        ToMicroseconds(histogram.GetQuantile(0.999)),
+        ToMicroseconds(histogram.GetMax())
+    );
+  } catch (const std::exception &ex) {
+    std::cout << "Error: " << ex.what() << std::endl;
+    return 1;
+  }
+}
@@ -0,0 +1,67 @@
+#ifndef PROBE_H
+#define PROBE_H
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+
+namespace load_balancer::generator {
+
+/**
+ * \brief Заголовок датаграммы генератора нагрузки, по которому приемник вычисляет задержку.
+ */
+struct Probe {
+  /// Признак датаграммы генератора, отличающий ее от прочих, например, проверок здоровья.
+  static constexpr std::uint32_t kMagic = 0x4C425052;
+
+  std::uint32_t magic = kMagic;
+  /// Номер потока генератора.
+  std::uint32_t thread = 0;
+  /// Порядковый номер датаграммы в потоке генератора.
+  std::uint64_t sequence = 0;
+  /// Запланированное время отправки, нс от эпохи std::chrono::steady_clock.
+  std::uint64_t send_time = 0;
+};
+
+/// Минимальный размер датаграммы генератора.
+constexpr std::size_t kProbeSize = sizeof(Probe);
+
+/**
+ * \brief Текущее время, сравнимое с @link Probe::send_time @endlink.
+ */
+inline std::uint64_t ProbeNow() {
+  const auto now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()
+  );
+  return static_cast<std::uint64_t>(now.count());
+}
+
+/**
+ * \brief Записать заголовок в начало датаграммы, размер которой не меньше @link kProbeSize
+ * @endlink.
+ */
+inline void WriteProbe(const Probe &probe, const std::span<char> datagram) {
+  std::memcpy(datagram.data(), &probe, kProbeSize);
+}
+
+/**
+ * \brief Прочитать заголовок датаграммы.
+ * \return заголовок, если датаграмма отправлена генератором.
+ */
+inline std::optional<Probe> ReadProbe(const std::span<const char> datagram) {
+  if (datagram.size() < kProbeSize) {
+    return std::nullopt;
+  }
+  Probe probe;
+  std::memcpy(&probe, datagram.data(), kProbeSize);
+  if (probe.magic != Probe::kMagic) {
+    return std::nullopt;
+  }
+  return probe;
+}
+
+}  // namespace load_balancer::generator
+
+#endif  // PROBE_H
@@ -0,0 +1,128 @@
+#include "traffic_replay.h"
+
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+
+#include "probe.h"
+
+namespace load_balancer::generator {
+
+using namespace std::chrono_literals;
+
+namespace {
+
+/// Время до отправки, начиная с которого поток засыпает, а не уступает процессор.
+constexpr auto kSleepThreshold = std::chrono::nanoseconds(100us).count();
+/// Запас пробуждения до запланированного времени отправки.
+constexpr auto kWakeUpAdvance = std::chrono::nanoseconds(50us).count();
+
+/**
+ * \brief Дождаться наступления времени, сравнимого с @link ProbeNow @endlink.
+ */
+void WaitUntil(const std::uint64_t time) {
+  for (auto now = ProbeNow(); now < time; now = ProbeNow()) {
+    const auto wait = time - now;
+    if (wait > static_cast<std::uint64_t>(kSleepThreshold)) {
+      std::this_thread::sleep_for(std::chrono::nanoseconds(wait - kWakeUpAdvance));
+    } else {
+      std::this_thread::yield();
+    }
+  }
+}
+
+}  // namespace
+
+TrafficReplay::TrafficReplay(const LoadGeneratorOptions &options, EndPointType target)
+    : options_(options), target_(std::move(target)), reader_(options.replay_file) {
+  if (options_.replay_speed < 0) {
+    throw std::invalid_argument("The replay speed must not be negative.");
+  }
+  if (options_.batch_size == 0) {
+    throw std::invalid_argument("The batch size must be positive.");
+  }
+  const auto source_ports = std::max<std::size_t>(options_.source_ports, 1);
+  sockets_.reserve(source_ports);
+  for (std::size_t i = 0; i < source_ports; ++i) {
+    sockets_.emplace_back(static_cast<std::uint16_t>(0));
+  }
+}
+
+void TrafficReplay::Run() {
+  reader_.Rewind();
+  std::vector<SocketType::DatagramView> datagrams(options_.batch_size);
+  std::size_t count = 0;
+  std::size_t batch_socket = 0;
+  const auto flush = [this, &datagrams, &count, &batch_socket] {
+    if (count > 0) {
+      Send(batch_socket, std::span(datagrams).first(count));
+      count = 0;
+    }
+  };
+
+  const auto start = ProbeNow();
+  std::optional<std::chrono::nanoseconds> first_timestamp;
+  while (auto packet = reader_.Next()) {
+    const auto socket = GetSocket(packet->source);
+    if (count > 0 && socket != batch_socket) {
+      flush();
+    }
+    auto scheduled_time = ProbeNow();
+    if (options_.replay_speed > 0) {
+      if (!first_timestamp) {
+        first_timestamp = packet->timestamp;
+      }
+      // Метки времени файла могут идти не по порядку, датаграмма не отправляется раньше
+      // предыдущей.
+      const auto offset = std::max(packet->timestamp - *first_timestamp, 0ns);
+      scheduled_time = std::max(
+          scheduled_time,
+          start + static_cast<std::uint64_t>(
+                      static_cast<double>(offset.count()) / options_.replay_speed
+                  )
+      );
+      if (scheduled_time > ProbeNow()) {
+        flush();
+        WaitUntil(scheduled_time);
+      }
+    }
+    if (auto probe = ReadProbe(packet->payload)) {
+      probe->send_time = scheduled_time;
+      WriteProbe(*probe, packet->payload);
+    }
+    batch_socket = socket;
+    datagrams[count++] = {
+        .buffer = packet->payload, .size = packet->payload.size(), .end_point = target_
+    };
+    if (count == datagrams.size()) {
+      flush();
+    }
+  }
+  flush();
+}
+
+std::uint64_t TrafficReplay::GetSent() const {
+  return sent_.load(std::memory_order_relaxed);
+}
+
+std::size_t TrafficReplay::GetSkipped() const {
+  return reader_.GetSkipped();
+}
+
+std::size_t TrafficReplay::GetSocket(const capture::PacketAddress &source) const {
+  const auto key = (static_cast<std::uint64_t>(source.address) << 16) | source.port;
+  return std::hash<std::uint64_t>()(key) % sockets_.size();
+}
+
+void TrafficReplay::Send(
+    const std::size_t socket, const std::span<const SocketType::DatagramView> datagrams
+) {
+  try {
+    sockets_[socket].SendBatchTo(datagrams);
+    sent_.fetch_add(datagrams.size(), std::memory_order_relaxed);
+  } catch (const std::exception &ex) {
+    std::cerr << "Error while sending datagrams: " << ex.what() << ".\n";
+  }
+}
+
+}  // namespace load_balancer::generator
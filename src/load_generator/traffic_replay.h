@@ -0,0 +1,78 @@
+#ifndef TRAFFIC_REPLAY_H
+#define TRAFFIC_REPLAY_H
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "capture/pcap_file.h"
+#include "load_generator.h"
+
+namespace load_balancer::generator {
+
+/**
+ * \brief Воспроизведение датаграмм, захваченных в файл pcap, на заданного получателя.
+ *
+ * Файл отображается в память, датаграммы отправляются из отображения без копирования в
+ * порядке записи одним потоком. Интервалы между датаграммами сохраняются, деленные на
+ * множитель скорости, либо отсутствуют при воспроизведении с максимальной скоростью.
+ * Датаграммы одного отправителя (адрес и порт) всегда отправляются с одного и того же сокета,
+ * поэтому привязка клиентов к серверам и шардам балансировщика воспроизводится от запуска к
+ * запуску. В датаграммы генератора записывается новое запланированное время отправки, и
+ * приемники измеряют задержку воспроизведения.
+ */
+class TrafficReplay {
+ public:
+  using SocketType = LoadGenerator::SocketType;
+  using EndPointType = LoadGenerator::EndPointType;
+
+  /// Ключ пути к воспроизводимому файлу pcap в файле конфигурации.
+  static constexpr auto kReplayFileKey = "replay_file";
+  /// Ключ множителя скорости воспроизведения в файле конфигурации.
+  static constexpr auto kReplaySpeedKey = "replay_speed";
+
+  /**
+   * \param options параметры генератора: файл, скорость, количество портов отправителя и
+   * размер пачки;
+   * \param target получатель датаграмм.
+   * \throws std::invalid_argument некорректные параметры.
+   * \throws std::runtime_error не удалось прочитать файл pcap.
+   */
+  TrafficReplay(const LoadGeneratorOptions &options, EndPointType target);
+
+  TrafficReplay(const TrafficReplay &other) = delete;
+  TrafficReplay &operator=(const TrafficReplay &other) = delete;
+
+  /**
+   * \brief Отправить все датаграммы файла.
+   */
+  void Run();
+  /**
+   * \brief Количество отправленных датаграмм.
+   */
+  [[nodiscard]] std::uint64_t GetSent() const;
+  /**
+   * \brief Количество пакетов файла, не являющихся UDP-датаграммами IPv4.
+   */
+  [[nodiscard]] std::size_t GetSkipped() const;
+
+ private:
+  const LoadGeneratorOptions options_;
+  const EndPointType target_;
+  capture::PcapReader reader_;
+  std::vector<SocketType> sockets_;
+  std::atomic<std::uint64_t> sent_ = 0;
+
+  /**
+   * \brief Сокет, с которого отправляются датаграммы отправителя.
+   */
+  [[nodiscard]] std::size_t GetSocket(const capture::PacketAddress &source) const;
+  /**
+   * \brief Отправить пачку датаграмм с сокета.
+   */
+  void Send(std::size_t socket, std::span<const SocketType::DatagramView> datagrams);
+};
+
+}  // namespace load_balancer::generator
+
+#endif  // TRAFFIC_REPLAY_H
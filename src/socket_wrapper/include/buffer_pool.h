@@ -0,0 +1,131 @@
+#ifndef BUFFER_POOL_H
+#define BUFFER_POOL_H
+
+#include <sys/mman.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <format>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace socket_wrapper {
+
+/**
+ * \brief Пул буферов датаграмм: непрерывная область памяти, разделенная на слоты равного размера.
+ *
+ * Память выделяется и отображается заранее, после чего получение и освобождение слота сводится
+ * к операции со стеком свободных слотов без обращения к куче. Пул не синхронизирован и
+ * предназначен для использования одним потоком.
+ */
+class BufferPool {
+ public:
+  /// Размер большой страницы, которой выравнивается область при использовании MAP_HUGETLB.
+  static constexpr std::size_t kHugePageSize = std::size_t{2} << 20;
+  /// Выравнивание слотов.
+  static constexpr std::size_t kSlotAlignment = 64;
+
+  /**
+   * \param slot_size минимальный размер слота, округляется вверх до @link kSlotAlignment @endlink;
+   * \param slot_count количество слотов;
+   * \param huge_pages использовать большие страницы: явные (MAP_HUGETLB), если они
+   * зарезервированы в системе, иначе прозрачные (MADV_HUGEPAGE).
+   */
+  BufferPool(std::size_t slot_size, std::size_t slot_count, bool huge_pages = false);
+
+  BufferPool(const BufferPool &other) = delete;
+  BufferPool(BufferPool &&other) = delete;
+  BufferPool &operator=(const BufferPool &other) = delete;
+  BufferPool &operator=(BufferPool &&other) = delete;
+
+  ~BufferPool();
+
+  /**
+   * \brief Получить свободный слот.
+   * \throw std::runtime_error если свободных слотов нет.
+   */
+  [[nodiscard]] std::span<char> Acquire();
+  /**
+   * \brief Вернуть слот, полученный из этого пула.
+   */
+  void Release(std::span<char> slot);
+
+  [[nodiscard]] std::size_t GetSlotSize() const;
+  [[nodiscard]] std::size_t GetFreeCount() const;
+
+ private:
+  const std::size_t slot_size_;
+  std::size_t memory_size_ = 0;
+  char *memory_ = nullptr;
+  std::vector<std::uint32_t> free_slots_;
+
+  static void *Map(std::size_t size, bool huge_pages);
+};
+
+inline BufferPool::BufferPool(
+    const std::size_t slot_size, const std::size_t slot_count, const bool huge_pages
+)
+    : slot_size_((slot_size + kSlotAlignment - 1) / kSlotAlignment * kSlotAlignment) {
+  if (slot_count == 0 || slot_count > UINT32_MAX) {
+    throw std::invalid_argument("Invalid buffer pool slot count.");
+  }
+  memory_size_ = slot_size_ * slot_count;
+  if (huge_pages) {
+    memory_size_ = (memory_size_ + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+  }
+  memory_ = static_cast<char *>(Map(memory_size_, huge_pages));
+  free_slots_.reserve(slot_count);
+  for (std::size_t i = slot_count; i > 0; --i) {
+    free_slots_.push_back(static_cast<std::uint32_t>(i - 1));
+  }
+}
+
+inline BufferPool::~BufferPool() {
+  munmap(memory_, memory_size_);
+}
+
+inline std::span<char> BufferPool::Acquire() {
+  if (free_slots_.empty()) {
+    throw std::runtime_error("Buffer pool is exhausted.");
+  }
+  const auto slot = free_slots_.back();
+  free_slots_.pop_back();
+  return {memory_ + slot * slot_size_, slot_size_};
+}
+
+inline void BufferPool::Release(const std::span<char> slot) {
+  free_slots_.push_back(static_cast<std::uint32_t>((slot.data() - memory_) / slot_size_));
+}
+
+inline std::size_t BufferPool::GetSlotSize() const {
+  return slot_size_;
+}
+
+inline std::size_t BufferPool::GetFreeCount() const {
+  return free_slots_.size();
+}
+
+inline void *BufferPool::Map(const std::size_t size, const bool huge_pages) {
+  // Страницы отображаются сразу (MAP_POPULATE), чтобы прием не прерывался на их выделение.
+  constexpr auto kFlags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE;
+  if (huge_pages) {
+    auto *const memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, kFlags | MAP_HUGETLB, -1, 0);
+    if (memory != MAP_FAILED) {
+      return memory;
+    }
+  }
+  auto *const memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, kFlags, -1, 0);
+  if (memory == MAP_FAILED) {
+    throw std::runtime_error(std::format("Can't allocate buffer pool. {}", strerror(errno)));
+  }
+  if (huge_pages) {
+    madvise(memory, size, MADV_HUGEPAGE);
+  }
+  return memory;
+}
+
+}  // namespace socket_wrapper
+
+#endif  // BUFFER_POOL_H
@@ -1,26 +1,32 @@
 #ifndef END_POINT_H
 #define END_POINT_H
 
+#include <arpa/inet.h>
 #include <netdb.h>
 #include <netinet/in.h>
 #include <sys/socket.h>
 #include <unistd.h>
 
 #include <algorithm>
-#include <cerrno>
-#include <charconv>
+#include <array>
+#include <cstring>
 #include <format>
 #include <functional>
 #include <iostream>
 #include <memory>
-#include <ranges>
+#include <stdexcept>
 #include <string>
+#include <string_view>
 
 namespace socket_wrapper {
 
 /**
  * \brief Конечная точка, определяющая адрес в указанном протоколе.
  *
+ * Адрес хранится в закодированном виде внутри @link sockaddr_storage @endlink, поэтому экземпляр
+ * тривиально копируется и сравнивается без обращения к резолверу и выделения памяти, а текстовое
+ * представление формируется только при выводе.
+ *
  * \tparam Proto тип протокола (см. @link Protocol @endlink).
  */
 template <typename Proto>
@@ -31,74 +37,79 @@ class EndPoint {
   /**
    * \brief Преобразовать закодированный адрес конечной точки в экзмепляр @link EndPoint @endlink.
    */
-  static EndPoint ParseEndPoint(sockaddr addr, socklen_t addr_len);
+  static EndPoint ParseEndPoint(const sockaddr *addr, socklen_t addr_len);
 
-  EndPoint(const EndPoint &other);
-  EndPoint(EndPoint &&other) noexcept;
   EndPoint(const std::string &address, uint16_t port);
   explicit EndPoint(uint16_t port = 0);
-  ~EndPoint();
-
-  EndPoint &operator=(EndPoint other);
 
-  [[nodiscard]] const std::string &GetAddress() const;
-  [[nodiscard]] const std::string &GetPort() const;
-  [[nodiscard]] std::weak_ptr<const sockaddr> GetAddressImpl() const;
+  [[nodiscard]] std::string GetAddress() const;
+  [[nodiscard]] uint16_t GetPort() const;
+  [[nodiscard]] const sockaddr *GetAddressImpl() const;
   [[nodiscard]] socklen_t GetAddressLen() const;
+  /**
+   * \brief Хеш адреса и порта конечной точки.
+   */
+  [[nodiscard]] std::size_t Hash() const;
+  /**
+   * \brief Хеш адреса конечной точки без учета порта.
+   */
+  [[nodiscard]] std::size_t AddressHash() const;
+
+  friend bool operator==(const EndPoint &first, const EndPoint &second) {
+    return first.addr_len_ == second.addr_len_ && first.GetPort() == second.GetPort() &&
+           first.AddressBytes() == second.AddressBytes();
+  }
 
   friend std::ostream &operator<<(std::ostream &os, const EndPoint &end_point) {
-    return os << end_point.address_ << ":" << end_point.port_;
+    return os << end_point.GetAddress() << ":" << end_point.GetPort();
   }
 
  private:
-  struct AddrinfoDeleter {
-    void operator()(addrinfo *addrinfo) const;
-  };
-
-  std::string address_;
-  std::string port_;
-  std::unique_ptr<addrinfo, AddrinfoDeleter> addrinfo_;
-  std::shared_ptr<sockaddr> sockaddr_;
+  sockaddr_storage addr_{};
+  socklen_t addr_len_ = 0;
 
-  void SetFields(addrinfo *addrinfo);
+  EndPoint(const sockaddr *addr, socklen_t addr_len);
 
-  friend void Swap(EndPoint &first, EndPoint &second) {
-    using std::swap;
-    std::swap(first.sockaddr_, second.sockaddr_);
-    std::swap(first.addrinfo_, second.addrinfo_);
-    std::swap(first.address_, second.address_);
-    std::swap(first.port_, second.port_);
-  }
+  /**
+   * \brief Байты адреса без учета порта.
+   */
+  [[nodiscard]] std::string_view AddressBytes() const;
 };
 
 template <typename Proto>
-EndPoint<Proto> EndPoint<Proto>::ParseEndPoint(const sockaddr addr, const socklen_t addr_len) {
-  std::array<char, 50> address_buf = {};
-  std::array<char, 6> port_buf = {};
-  getnameinfo(
-      &addr,
-      addr_len,
-      address_buf.data(),
-      address_buf.size(),
-      port_buf.data(),
-      port_buf.size(),
-      NI_NUMERICHOST | NI_NUMERICSERV
-  );
-  return EndPoint(
-      std::string(address_buf.begin(), std::ranges::find(address_buf, '\0')), atoi(port_buf.data())
-  );
+EndPoint<Proto> EndPoint<Proto>::ParseEndPoint(const sockaddr *addr, const socklen_t addr_len) {
+  return EndPoint(addr, addr_len);
 }
 
 template <typename Proto>
-EndPoint<Proto>::EndPoint(const EndPoint &other)
-    : EndPoint(other.GetAddress(), atoi(other.GetPort().c_str())) {
+EndPoint<Proto>::EndPoint(const sockaddr *addr, const socklen_t addr_len)
+    : addr_len_(std::min<socklen_t>(addr_len, sizeof(addr_))) {
+  std::memcpy(&addr_, addr, addr_len_);
 }
 
 template <typename Proto>
 EndPoint<Proto>::EndPoint(const std::string &address, const uint16_t port) {
+  const Proto protocol;
+  const auto family = static_cast<int>(protocol.family);
+  addr_.ss_family = family;
+  if (family == AF_INET) {
+    auto &addr = reinterpret_cast<sockaddr_in &>(addr_);
+    addr.sin_port = htons(port);
+    addr_len_ = sizeof(addr);
+    if (inet_pton(AF_INET, address.c_str(), &addr.sin_addr) == 1) {
+      return;
+    }
+  } else if (family == AF_INET6) {
+    auto &addr = reinterpret_cast<sockaddr_in6 &>(addr_);
+    addr.sin6_port = htons(port);
+    addr_len_ = sizeof(addr);
+    if (inet_pton(AF_INET6, address.c_str(), &addr.sin6_addr) == 1) {
+      return;
+    }
+  }
+
   addrinfo hints = {};
-  Proto protocol;
-  hints.ai_family = static_cast<int>(protocol.family);
+  hints.ai_family = family;
   hints.ai_socktype = static_cast<int>(protocol.socket_type);
   hints.ai_flags = AI_NUMERICSERV;
   hints.ai_protocol = static_cast<int>(protocol.name);
@@ -106,88 +117,100 @@ EndPoint<Proto>::EndPoint(const std::string &address, const uint16_t port) {
   if (const int err = getaddrinfo(address.data(), std::to_string(port).data(), &hints, &addrinfo)) {
     throw std::runtime_error(std::format("Can't create end point: {}", gai_strerror(err)));
   }
-  SetFields(addrinfo);
+  const std::unique_ptr<::addrinfo, decltype(&freeaddrinfo)> guard(addrinfo, &freeaddrinfo);
+  *this = ParseEndPoint(addrinfo->ai_addr, addrinfo->ai_addrlen);
 }
 
 template <typename Proto>
-EndPoint<Proto>::~EndPoint() {
-  sockaddr_.reset();
-}
-
-template <typename Proto>
-EndPoint<Proto> &EndPoint<Proto>::operator=(EndPoint other) {
-  Swap(*this, other);
-  return *this;
+EndPoint<Proto>::EndPoint(const uint16_t port) {
+  const Proto protocol;
+  const auto family = static_cast<int>(protocol.family);
+  addr_.ss_family = family;
+  if (family == AF_INET6) {
+    auto &addr = reinterpret_cast<sockaddr_in6 &>(addr_);
+    addr.sin6_addr = in6addr_any;
+    addr.sin6_port = htons(port);
+    addr_len_ = sizeof(addr);
+  } else {
+    auto &addr = reinterpret_cast<sockaddr_in &>(addr_);
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(port);
+    addr_len_ = sizeof(addr);
+  }
 }
 
 template <typename Proto>
-const std::string &EndPoint<Proto>::GetAddress() const {
-  return address_;
+std::string EndPoint<Proto>::GetAddress() const {
+  std::array<char, INET6_ADDRSTRLEN> address_buf{};
+  const void *address = addr_.ss_family == AF_INET6
+                            ? static_cast<const void *>(
+                                  &reinterpret_cast<const sockaddr_in6 &>(addr_).sin6_addr
+                              )
+                            : &reinterpret_cast<const sockaddr_in &>(addr_).sin_addr;
+  if (!inet_ntop(addr_.ss_family, address, address_buf.data(), address_buf.size())) {
+    return {};
+  }
+  return address_buf.data();
 }
 
 template <typename Proto>
-const std::string &EndPoint<Proto>::GetPort() const {
-  return port_;
+uint16_t EndPoint<Proto>::GetPort() const {
+  if (addr_.ss_family == AF_INET6) {
+    return ntohs(reinterpret_cast<const sockaddr_in6 &>(addr_).sin6_port);
+  }
+  return ntohs(reinterpret_cast<const sockaddr_in &>(addr_).sin_port);
 }
 
 template <typename Proto>
-std::weak_ptr<const sockaddr> EndPoint<Proto>::GetAddressImpl() const {
-  return sockaddr_;
+const sockaddr *EndPoint<Proto>::GetAddressImpl() const {
+  return reinterpret_cast<const sockaddr *>(&addr_);
 }
 
 template <typename Proto>
 socklen_t EndPoint<Proto>::GetAddressLen() const {
-  return addrinfo_->ai_addrlen;
+  return addr_len_;
 }
 
 template <typename Proto>
-void EndPoint<Proto>::AddrinfoDeleter::operator()(addrinfo *addrinfo) const {
-  freeaddrinfo(addrinfo);
+std::size_t EndPoint<Proto>::Hash() const {
+  // FNV-1a по байтам адреса и порта.
+  std::size_t hash = AddressHash();
+  const auto mix = [&hash](const unsigned char byte) {
+    hash = (hash ^ byte) * 1099511628211ULL;
+  };
+  const auto port = GetPort();
+  mix(port & 0xFF);
+  mix(port >> 8);
+  return hash;
 }
 
 template <typename Proto>
-void EndPoint<Proto>::SetFields(addrinfo *addrinfo) {
-  addrinfo_.reset(addrinfo);
-  sockaddr_.reset(addrinfo_->ai_addr, [](auto *) {});
-  std::array<char, 32> address_buf{};
-  address_buf.fill(0);
-  std::array<char, 6> port_buf{};
-  port_buf.fill(0);
-  if (const int err = getnameinfo(
-          addrinfo_->ai_addr,
-          addrinfo_->ai_addrlen,
-          address_buf.data(),
-          address_buf.size(),
-          port_buf.data(),
-          port_buf.size(),
-          NI_NUMERICHOST | NI_NUMERICSERV
-      )) {
-    throw std::runtime_error(std::format("Can't create end point: {}", gai_strerror(err)));
+std::size_t EndPoint<Proto>::AddressHash() const {
+  // FNV-1a по байтам адреса.
+  std::size_t hash = 14695981039346656037ULL;
+  for (const auto byte : AddressBytes()) {
+    hash = (hash ^ static_cast<unsigned char>(byte)) * 1099511628211ULL;
   }
-  address_.append(address_buf.begin(), std::ranges::find(address_buf, '\0'));
-  port_.append(port_buf.begin(), std::ranges::find(port_buf, '\0'));
+  return hash;
 }
 
 template <typename Proto>
-EndPoint<Proto>::EndPoint(const uint16_t port) {
-  addrinfo hints = {};
-  Proto protocol;
-  hints.ai_family = static_cast<int>(protocol.family);
-  hints.ai_socktype = static_cast<int>(protocol.socket_type);
-  hints.ai_flags = AI_PASSIVE | AI_NUMERICSERV;
-  hints.ai_protocol = static_cast<int>(protocol.name);
-  addrinfo *addrinfo;
-  if (const int err = getaddrinfo(nullptr, std::to_string(port).data(), &hints, &addrinfo)) {
-    throw std::runtime_error(std::format("Can't create end point: {}", gai_strerror(err)));
+std::string_view EndPoint<Proto>::AddressBytes() const {
+  if (addr_.ss_family == AF_INET6) {
+    const auto &addr = reinterpret_cast<const sockaddr_in6 &>(addr_).sin6_addr;
+    return {reinterpret_cast<const char *>(&addr), sizeof(addr)};
   }
-  SetFields(addrinfo);
-}
-
-template <typename Proto>
-EndPoint<Proto>::EndPoint(EndPoint &&other) noexcept {
-  Swap(*this, other);
+  const auto &addr = reinterpret_cast<const sockaddr_in &>(addr_).sin_addr;
+  return {reinterpret_cast<const char *>(&addr), sizeof(addr)};
 }
 
 }  // namespace socket_wrapper
 
+template <typename Proto>
+struct std::hash<socket_wrapper::EndPoint<Proto>> {
+  std::size_t operator()(const socket_wrapper::EndPoint<Proto> &end_point) const noexcept {
+    return end_point.Hash();
+  }
+};
+
 #endif  // END_POINT_H
@@ -0,0 +1,356 @@
+#ifndef IO_URING_H
+#define IO_URING_H
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstring>
+#include <format>
+#include <span>
+#include <stdexcept>
+
+namespace socket_wrapper {
+
+/**
+ * \brief Кольцо буферов фиксированного размера, предоставляемых ядру для приема (provided
+ * buffer ring).
+ *
+ * Ядро само выбирает свободный буфер при завершении приема и сообщает его номер в завершении,
+ * после обработки буфер возвращается в кольцо методом @link Recycle @endlink. Память буферов
+ * должна освобождаться после закрытия кольца io_uring, в котором они зарегистрированы.
+ */
+class ProvidedBufferRing {
+ public:
+  /**
+   * \param group_id номер группы буферов, указываемый в операциях приема;
+   * \param buffer_count количество буферов (степень двойки, не более 32768);
+   * \param buffer_size размер каждого буфера.
+   */
+  ProvidedBufferRing(std::uint16_t group_id, std::size_t buffer_count, std::size_t buffer_size);
+
+  ProvidedBufferRing(const ProvidedBufferRing &other) = delete;
+  ProvidedBufferRing(ProvidedBufferRing &&other) = delete;
+  ProvidedBufferRing &operator=(const ProvidedBufferRing &other) = delete;
+  ProvidedBufferRing &operator=(ProvidedBufferRing &&other) = delete;
+
+  ~ProvidedBufferRing();
+
+  /**
+   * \brief Буфер с указанным номером.
+   */
+  [[nodiscard]] std::span<char> GetBuffer(std::uint16_t buffer_id) const;
+  /**
+   * \brief Вернуть буфер в кольцо, сделав его доступным ядру для следующего приема.
+   */
+  void Recycle(std::uint16_t buffer_id);
+
+  [[nodiscard]] std::uint16_t GetGroupId() const;
+  [[nodiscard]] std::size_t GetBufferSize() const;
+  /**
+   * \brief Параметры регистрации кольца в io_uring.
+   */
+  [[nodiscard]] io_uring_buf_reg GetRegistration() const;
+
+ private:
+  const std::uint16_t group_id_;
+  const std::size_t buffer_count_;
+  const std::size_t buffer_size_;
+  std::size_t memory_size_ = 0;
+  void *memory_ = MAP_FAILED;
+  io_uring_buf_ring *ring_ = nullptr;
+  /// Записи кольца. В C++ io_uring_buf_ring::bufs смещен из-за пустой структуры в
+  /// __DECLARE_FLEX_ARRAY, поэтому записи адресуются от начала кольца напрямую.
+  io_uring_buf *entries_ = nullptr;
+  char *buffers_ = nullptr;
+};
+
+/**
+ * \brief Кольца отправки и завершения io_uring, работающие через системные вызовы напрямую.
+ *
+ * Кольцо предназначено для использования одним потоком, создавшим его: при поддержке ядром
+ * включаются IORING_SETUP_SINGLE_ISSUER и IORING_SETUP_DEFER_TASKRUN, и завершения
+ * обрабатываются только во время @link Submit ожидания@endlink.
+ */
+class IoUring {
+ public:
+  /**
+   * \param entries размер кольца отправки (степень двойки), кольцо завершения вдвое больше.
+   */
+  explicit IoUring(unsigned entries);
+
+  IoUring(const IoUring &other) = delete;
+  IoUring(IoUring &&other) = delete;
+  IoUring &operator=(const IoUring &other) = delete;
+  IoUring &operator=(IoUring &&other) = delete;
+
+  ~IoUring();
+
+  /**
+   * \brief Получить свободную запись кольца отправки, очищенную от прежнего содержимого.
+   *
+   * Если кольцо заполнено, накопленные записи предварительно отправляются ядру.
+   */
+  io_uring_sqe *GetSqe();
+  /**
+   * \brief Передать ядру накопленные записи и дождаться завершения хотя бы wait_count операций.
+   * \param wait_count минимальное количество ожидаемых завершений;
+   * \param timeout максимальное время ожидания завершений.
+   */
+  void Submit(unsigned wait_count = 0, std::chrono::nanoseconds timeout = {});
+  /**
+   * \brief Обработать все готовые завершения и освободить их записи.
+   * \param handler вызывается для каждой записи кольца завершения.
+   * \return количество обработанных завершений.
+   */
+  template <typename Handler>
+  unsigned ForEachCqe(Handler &&handler);
+  /**
+   * \brief Зарегистрировать кольцо буферов, из которого ядро выбирает буфер для приема.
+   */
+  void RegisterBufferRing(const ProvidedBufferRing &buffers) const;
+
+ private:
+  int ring_fd_ = -1;
+  io_uring_params params_ = {};
+
+  void *rings_ = MAP_FAILED;
+  std::size_t rings_size_ = 0;
+  io_uring_sqe *sqes_ = static_cast<io_uring_sqe *>(MAP_FAILED);
+  std::size_t sqes_size_ = 0;
+
+  unsigned *sq_head_ = nullptr;
+  unsigned *sq_tail_ = nullptr;
+  unsigned sq_mask_ = 0;
+  /// Хвост кольца отправки, еще не опубликованный для ядра.
+  unsigned sqe_tail_ = 0;
+
+  unsigned *cq_head_ = nullptr;
+  unsigned *cq_tail_ = nullptr;
+  unsigned cq_mask_ = 0;
+  io_uring_cqe *cqes_ = nullptr;
+
+  static int Setup(unsigned entries, io_uring_params &params);
+  void Close();
+  /**
+   * \brief Преобразовать ошибку, сохраненную в errno в исключение и выбросить его.
+   */
+  static void ThrowErrno(const std::string &msg);
+};
+
+inline IoUring::IoUring(const unsigned entries) {
+  ring_fd_ = Setup(entries, params_);
+
+  const auto sq_size = params_.sq_off.array + params_.sq_entries * sizeof(unsigned);
+  const auto cq_size = params_.cq_off.cqes + params_.cq_entries * sizeof(io_uring_cqe);
+  if (!(params_.features & IORING_FEAT_SINGLE_MMAP)) {
+    Close();
+    throw std::runtime_error("Can't set up io_uring. Kernel is too old.");
+  }
+  rings_size_ = std::max(sq_size, cq_size);
+  rings_ = mmap(
+      nullptr,
+      rings_size_,
+      PROT_READ | PROT_WRITE,
+      MAP_SHARED | MAP_POPULATE,
+      ring_fd_,
+      IORING_OFF_SQ_RING
+  );
+  if (rings_ == MAP_FAILED) {
+    Close();
+    ThrowErrno("Can't map io_uring rings.");
+  }
+  sqes_size_ = params_.sq_entries * sizeof(io_uring_sqe);
+  sqes_ = static_cast<io_uring_sqe *>(mmap(
+      nullptr,
+      sqes_size_,
+      PROT_READ | PROT_WRITE,
+      MAP_SHARED | MAP_POPULATE,
+      ring_fd_,
+      IORING_OFF_SQES
+  ));
+  if (sqes_ == MAP_FAILED) {
+    Close();
+    ThrowErrno("Can't map io_uring submission entries.");
+  }
+
+  auto *const rings = static_cast<char *>(rings_);
+  sq_head_ = reinterpret_cast<unsigned *>(rings + params_.sq_off.head);
+  sq_tail_ = reinterpret_cast<unsigned *>(rings + params_.sq_off.tail);
+  sq_mask_ = *reinterpret_cast<unsigned *>(rings + params_.sq_off.ring_mask);
+  sqe_tail_ = *sq_tail_;
+  // Записи кольца отправки используются по порядку, поэтому массив индексов тождественный.
+  auto *const sq_array = reinterpret_cast<unsigned *>(rings + params_.sq_off.array);
+  for (unsigned i = 0; i < params_.sq_entries; ++i) {
+    sq_array[i] = i;
+  }
+
+  cq_head_ = reinterpret_cast<unsigned *>(rings + params_.cq_off.head);
+  cq_tail_ = reinterpret_cast<unsigned *>(rings + params_.cq_off.tail);
+  cq_mask_ = *reinterpret_cast<unsigned *>(rings + params_.cq_off.ring_mask);
+  cqes_ = reinterpret_cast<io_uring_cqe *>(rings + params_.cq_off.cqes);
+}
+
+inline IoUring::~IoUring() {
+  Close();
+}
+
+inline io_uring_sqe *IoUring::GetSqe() {
+  if (sqe_tail_ - std::atomic_ref(*sq_head_).load(std::memory_order_acquire) >=
+      params_.sq_entries) {
+    Submit();
+  }
+  auto *const sqe = &sqes_[sqe_tail_ & sq_mask_];
+  ++sqe_tail_;
+  std::memset(sqe, 0, sizeof(*sqe));
+  return sqe;
+}
+
+inline void IoUring::Submit(const unsigned wait_count, const std::chrono::nanoseconds timeout) {
+  std::atomic_ref(*sq_tail_).store(sqe_tail_, std::memory_order_release);
+  const auto to_submit = sqe_tail_ - std::atomic_ref(*sq_head_).load(std::memory_order_acquire);
+  if (to_submit == 0 && wait_count == 0) {
+    return;
+  }
+
+  unsigned flags = 0;
+  __kernel_timespec timeout_spec = {};
+  io_uring_getevents_arg getevents_arg = {};
+  const void *arg = nullptr;
+  std::size_t arg_size = 0;
+  if (wait_count > 0) {
+    flags |= IORING_ENTER_GETEVENTS;
+    if (timeout.count() > 0) {
+      timeout_spec.tv_sec = timeout.count() / 1'000'000'000;
+      timeout_spec.tv_nsec = timeout.count() % 1'000'000'000;
+      getevents_arg.sigmask_sz = _NSIG / 8;
+      getevents_arg.ts = reinterpret_cast<std::uintptr_t>(&timeout_spec);
+      flags |= IORING_ENTER_EXT_ARG;
+      arg = &getevents_arg;
+      arg_size = sizeof(getevents_arg);
+    }
+  }
+  const auto result =
+      syscall(__NR_io_uring_enter, ring_fd_, to_submit, wait_count, flags, arg, arg_size);
+  if (result < 0 && errno != ETIME && errno != EINTR && errno != EBUSY) {
+    ThrowErrno("Can't submit io_uring entries.");
+  }
+}
+
+template <typename Handler>
+unsigned IoUring::ForEachCqe(Handler &&handler) {
+  auto head = *cq_head_;
+  const auto tail = std::atomic_ref(*cq_tail_).load(std::memory_order_acquire);
+  const auto count = tail - head;
+  for (; head != tail; ++head) {
+    handler(cqes_[head & cq_mask_]);
+  }
+  std::atomic_ref(*cq_head_).store(head, std::memory_order_release);
+  return count;
+}
+
+inline void IoUring::RegisterBufferRing(const ProvidedBufferRing &buffers) const {
+  auto registration = buffers.GetRegistration();
+  if (syscall(__NR_io_uring_register, ring_fd_, IORING_REGISTER_PBUF_RING, &registration, 1) <
+      0) {
+    ThrowErrno("Can't register io_uring buffer ring.");
+  }
+}
+
+inline int IoUring::Setup(const unsigned entries, io_uring_params &params) {
+  params = {};
+  params.flags = IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_DEFER_TASKRUN;
+  auto ring_fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+  if (ring_fd < 0 && errno == EINVAL) {
+    // Ядро не поддерживает флаги, ускоряющие обработку завершений одним потоком.
+    params = {};
+    ring_fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+  }
+  if (ring_fd < 0) {
+    ThrowErrno("Can't set up io_uring.");
+  }
+  return ring_fd;
+}
+
+inline void IoUring::Close() {
+  if (sqes_ != MAP_FAILED) {
+    munmap(sqes_, sqes_size_);
+  }
+  if (rings_ != MAP_FAILED) {
+    munmap(rings_, rings_size_);
+  }
+  if (ring_fd_ >= 0) {
+    close(ring_fd_);
+  }
+}
+
+inline void IoUring::ThrowErrno(const std::string &msg) {
+  throw std::runtime_error(std::format("{} {}", msg, strerror(errno)));
+}
+
+inline ProvidedBufferRing::ProvidedBufferRing(
+    const std::uint16_t group_id, const std::size_t buffer_count, const std::size_t buffer_size
+)
+    : group_id_(group_id), buffer_count_(buffer_count), buffer_size_(buffer_size) {
+  const auto ring_size = buffer_count_ * sizeof(io_uring_buf);
+  memory_size_ = ring_size + buffer_count_ * buffer_size_;
+  memory_ =
+      mmap(nullptr, memory_size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (memory_ == MAP_FAILED) {
+    throw std::runtime_error(
+        std::format("Can't allocate io_uring buffer ring. {}", strerror(errno))
+    );
+  }
+  ring_ = static_cast<io_uring_buf_ring *>(memory_);
+  entries_ = static_cast<io_uring_buf *>(memory_);
+  buffers_ = static_cast<char *>(memory_) + ring_size;
+  for (std::size_t i = 0; i < buffer_count_; ++i) {
+    Recycle(static_cast<std::uint16_t>(i));
+  }
+}
+
+inline ProvidedBufferRing::~ProvidedBufferRing() {
+  munmap(memory_, memory_size_);
+}
+
+inline std::span<char> ProvidedBufferRing::GetBuffer(const std::uint16_t buffer_id) const {
+  return {buffers_ + buffer_id * buffer_size_, buffer_size_};
+}
+
+inline void ProvidedBufferRing::Recycle(const std::uint16_t buffer_id) {
+  // Хвост кольца буферов совмещен с полем первой записи и изменяется только приложением.
+  std::atomic_ref tail(ring_->tail);
+  const auto current_tail = tail.load(std::memory_order_relaxed);
+  auto &buffer = entries_[current_tail & (buffer_count_ - 1)];
+  buffer.addr = reinterpret_cast<std::uintptr_t>(GetBuffer(buffer_id).data());
+  buffer.len = buffer_size_;
+  buffer.bid = buffer_id;
+  tail.store(current_tail + 1, std::memory_order_release);
+}
+
+inline std::uint16_t ProvidedBufferRing::GetGroupId() const {
+  return group_id_;
+}
+
+inline std::size_t ProvidedBufferRing::GetBufferSize() const {
+  return buffer_size_;
+}
+
+inline io_uring_buf_reg ProvidedBufferRing::GetRegistration() const {
+  io_uring_buf_reg registration = {};
+  registration.ring_addr = reinterpret_cast<std::uintptr_t>(ring_);
+  registration.ring_entries = buffer_count_;
+  registration.bgid = group_id_;
+  return registration;
+}
+
+}  // namespace socket_wrapper
+
+#endif  // IO_URING_H
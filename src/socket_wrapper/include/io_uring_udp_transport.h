@@ -0,0 +1,273 @@
+#ifndef IO_URING_UDP_TRANSPORT_H
+#define IO_URING_UDP_TRANSPORT_H
+
+#include <sys/socket.h>
+
+#include <algorithm>
+#include <chrono>
+#include <span>
+#include <vector>
+
+#include "invalid_socket_exception.h"
+#include "io_uring.h"
+#include "udp_socket.h"
+
+namespace socket_wrapper::udp {
+
+/**
+ * \brief Прием и перенаправление UDP-датаграмм через io_uring.
+ *
+ * Прием выполняет одна многоразовая (multishot) операция recvmsg, которая складывает
+ * датаграммы в буферы из @link ProvidedBufferRing кольца буферов@endlink без повторной
+ * постановки. Перенаправляемая датаграмма отправляется прямо из буфера приема, и буфер
+ * возвращается в кольцо после завершения отправки. Отправки, накопленные между ожиданиями,
+ * передаются ядру одним системным вызовом и связываются в цепочку (IOSQE_IO_HARDLINK), поэтому
+ * уходят в порядке приема.
+ *
+ * Объект должен использоваться только потоком, создавшим его. Сокеты должны существовать,
+ * пока существует объект.
+ */
+template <ProtocolFamily ProtoFamily>
+class IoUringUdpTransport {
+ public:
+  using EndPointType = UdpEndPoint<ProtoFamily>;
+  using SocketType = UdpSocket<ProtoFamily>;
+
+  /// Количество буферов приема.
+  static constexpr std::size_t kBufferCount = 1024;
+  /// Максимальное время ожидания завершений, после которого проверяется, открыт ли сокет.
+  static constexpr auto kWaitTimeout = std::chrono::milliseconds(100);
+
+  /**
+   * \brief Полученная датаграмма, занимающая буфер до вызова @link Forward @endlink или
+   * @link Release @endlink.
+   */
+  struct Datagram {
+    std::span<const char> payload;
+    EndPointType sender;
+    std::uint16_t buffer_id;
+  };
+
+  /**
+   * \param receiver сокет, с которого принимаются датаграммы;
+   * \param sender сокет, через который датаграммы перенаправляются;
+   * \param max_size максимальный размер принимаемой датаграммы, более длинные обрезаются.
+   */
+  IoUringUdpTransport(
+      const SocketType &receiver, const SocketType &sender, size_t max_size = 1024
+  );
+
+  IoUringUdpTransport(const IoUringUdpTransport &other) = delete;
+  IoUringUdpTransport(IoUringUdpTransport &&other) = delete;
+  IoUringUdpTransport &operator=(const IoUringUdpTransport &other) = delete;
+  IoUringUdpTransport &operator=(IoUringUdpTransport &&other) = delete;
+
+  /**
+   * \brief Отменить прием и дождаться завершения отправок.
+   *
+   * Закрытие кольца освобождает сокеты асинхронно, поэтому незавершенные операции
+   * отменяются явно, чтобы после уничтожения объекта порт сокета можно было занять повторно.
+   */
+  ~IoUringUdpTransport();
+
+  /**
+   * \brief Передать ядру накопленные отправки и дождаться получения хотя бы одной датаграммы.
+   * \return полученные датаграммы, действительные до следующего вызова.
+   */
+  std::span<const Datagram> Receive();
+  /**
+   * \brief Отправить датаграмму указанному получателю и освободить ее буфер после отправки.
+   */
+  void Forward(const Datagram &datagram, const EndPointType &receiver);
+  /**
+   * \brief Освободить буфер отброшенной датаграммы.
+   */
+  void Release(const Datagram &datagram);
+
+ private:
+  /// Признак завершения приема в user_data, завершения отправок содержат номер буфера.
+  static constexpr std::uint64_t kReceiveTag = UINT64_MAX;
+  /// Признак завершения отмены приема в user_data.
+  static constexpr std::uint64_t kCancelTag = UINT64_MAX - 1;
+  /// Максимальное количество ожиданий при отмене незавершенных операций.
+  static constexpr std::size_t kMaxCancelWaits = 10;
+
+  /**
+   * \brief Заголовок отправки, который должен существовать до ее завершения.
+   */
+  struct SendRequest {
+    msghdr header;
+    iovec payload;
+    EndPointType receiver;
+  };
+
+  const SocketType &receiver_;
+  const SocketType &sender_;
+  /// Буферы объявлены раньше кольца, поэтому освобождаются после его закрытия.
+  ProvidedBufferRing buffers_;
+  IoUring ring_;
+
+  msghdr receive_header_ = {};
+  bool receive_armed_ = false;
+  /// Заголовки отправок по номерам буферов, каждый буфер отправляется не более одного раза.
+  std::vector<SendRequest> send_requests_;
+  /// Последняя отправка, еще не переданная ядру.
+  io_uring_sqe *last_send_ = nullptr;
+  std::size_t sends_in_flight_ = 0;
+  std::vector<Datagram> received_;
+
+  void ArmReceive();
+  /**
+   * \brief Передать ядру накопленные записи, дождаться и обработать завершения.
+   */
+  void SubmitAndHandleCompletions();
+  void HandleReceive(const io_uring_cqe &cqe);
+};
+
+template <ProtocolFamily ProtoFamily>
+IoUringUdpTransport<ProtoFamily>::IoUringUdpTransport(
+    const SocketType &receiver, const SocketType &sender, const size_t max_size
+)
+    : receiver_(receiver),
+      sender_(sender),
+      buffers_(
+          0, kBufferCount, sizeof(io_uring_recvmsg_out) + sizeof(sockaddr_storage) + max_size
+      ),
+      ring_(kBufferCount),
+      send_requests_(kBufferCount) {
+  ring_.RegisterBufferRing(buffers_);
+  receive_header_.msg_namelen = sizeof(sockaddr_storage);
+  received_.reserve(kBufferCount);
+}
+
+template <ProtocolFamily ProtoFamily>
+IoUringUdpTransport<ProtoFamily>::~IoUringUdpTransport() {
+  try {
+    if (receive_armed_) {
+      auto *const sqe = ring_.GetSqe();
+      sqe->opcode = IORING_OP_ASYNC_CANCEL;
+      sqe->addr = kReceiveTag;
+      sqe->user_data = kCancelTag;
+    }
+    for (std::size_t i = 0; i < kMaxCancelWaits && (receive_armed_ || sends_in_flight_ > 0);
+         ++i) {
+      SubmitAndHandleCompletions();
+    }
+  } catch (...) {
+    // Кольцо все равно будет закрыто, а сокеты освобождены ядром позже.
+  }
+}
+
+template <ProtocolFamily ProtoFamily>
+std::span<const typename IoUringUdpTransport<ProtoFamily>::Datagram> IoUringUdpTransport<
+    ProtoFamily>::Receive() {
+  received_.clear();
+  while (received_.empty()) {
+    if (!receive_armed_) {
+      ArmReceive();
+    }
+    SubmitAndHandleCompletions();
+    if (received_.empty() && receiver_.GetNativeHandle() < 0) {
+      throw InvalidSocketException("Can't recv. Socket is shut down.");
+    }
+  }
+  return received_;
+}
+
+template <ProtocolFamily ProtoFamily>
+void IoUringUdpTransport<ProtoFamily>::Forward(
+    const Datagram &datagram, const EndPointType &receiver
+) {
+  auto &request = send_requests_[datagram.buffer_id];
+  request.receiver = receiver;
+  request.payload = {
+      .iov_base = const_cast<char *>(datagram.payload.data()), .iov_len = datagram.payload.size()
+  };
+  request.header = {};
+  request.header.msg_name = const_cast<sockaddr *>(request.receiver.GetAddressImpl());
+  request.header.msg_namelen = request.receiver.GetAddressLen();
+  request.header.msg_iov = &request.payload;
+  request.header.msg_iovlen = 1;
+
+  auto *const sqe = ring_.GetSqe();
+  sqe->opcode = IORING_OP_SENDMSG;
+  sqe->fd = sender_.GetNativeHandle();
+  sqe->addr = reinterpret_cast<std::uintptr_t>(&request.header);
+  sqe->len = 1;
+  sqe->user_data = datagram.buffer_id;
+  // Жесткая связь, в отличие от IOSQE_IO_LINK, не отменяет цепочку при ошибке одной отправки.
+  sqe->flags = IOSQE_IO_HARDLINK;
+  last_send_ = sqe;
+  ++sends_in_flight_;
+}
+
+template <ProtocolFamily ProtoFamily>
+void IoUringUdpTransport<ProtoFamily>::Release(const Datagram &datagram) {
+  buffers_.Recycle(datagram.buffer_id);
+}
+
+template <ProtocolFamily ProtoFamily>
+void IoUringUdpTransport<ProtoFamily>::ArmReceive() {
+  auto *const sqe = ring_.GetSqe();
+  sqe->opcode = IORING_OP_RECVMSG;
+  sqe->fd = receiver_.GetNativeHandle();
+  sqe->addr = reinterpret_cast<std::uintptr_t>(&receive_header_);
+  sqe->len = 1;
+  sqe->msg_flags = MSG_TRUNC;
+  sqe->ioprio = IORING_RECV_MULTISHOT;
+  sqe->flags = IOSQE_BUFFER_SELECT;
+  sqe->buf_group = buffers_.GetGroupId();
+  sqe->user_data = kReceiveTag;
+  receive_armed_ = true;
+}
+
+template <ProtocolFamily ProtoFamily>
+void IoUringUdpTransport<ProtoFamily>::SubmitAndHandleCompletions() {
+  // Цепочка отправок заканчивается на последней из них и не захватывает следующие операции.
+  if (last_send_ != nullptr) {
+    last_send_->flags &= ~IOSQE_IO_HARDLINK;
+    last_send_ = nullptr;
+  }
+  ring_.Submit(1, kWaitTimeout);
+  ring_.ForEachCqe([this](const io_uring_cqe &cqe) {
+    if (cqe.user_data == kReceiveTag) {
+      HandleReceive(cqe);
+    } else if (cqe.user_data != kCancelTag) {
+      buffers_.Recycle(static_cast<std::uint16_t>(cqe.user_data));
+      --sends_in_flight_;
+    }
+  });
+}
+
+template <ProtocolFamily ProtoFamily>
+void IoUringUdpTransport<ProtoFamily>::HandleReceive(const io_uring_cqe &cqe) {
+  if (!(cqe.flags & IORING_CQE_F_MORE)) {
+    receive_armed_ = false;
+  }
+  if (!(cqe.flags & IORING_CQE_F_BUFFER)) {
+    // Ошибка приема без буфера, например, ENOBUFS: прием будет поставлен заново.
+    return;
+  }
+  const auto buffer_id = static_cast<std::uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+  const auto buffer = buffers_.GetBuffer(buffer_id);
+  const auto *const out = reinterpret_cast<const io_uring_recvmsg_out *>(buffer.data());
+  if (cqe.res <= 0 || out->namelen == 0 || out->namelen > receive_header_.msg_namelen) {
+    buffers_.Recycle(buffer_id);
+    return;
+  }
+  const auto *const name = buffer.data() + sizeof(io_uring_recvmsg_out);
+  const auto *const payload = name + receive_header_.msg_namelen + receive_header_.msg_controllen;
+  const auto payload_size =
+      std::min<std::size_t>(out->payloadlen, buffer.data() + cqe.res - payload);
+  received_.push_back(
+      {.payload = {payload, payload_size},
+       .sender = EndPointType::ParseEndPoint(
+           reinterpret_cast<const sockaddr *>(name), out->namelen
+       ),
+       .buffer_id = buffer_id}
+  );
+}
+
+}  // namespace socket_wrapper::udp
+
+#endif  // IO_URING_UDP_TRANSPORT_H
@@ -1,11 +1,14 @@
 #ifndef SOCKET_H
 #define SOCKET_H
 
+#include <fcntl.h>
+
 #include <cerrno>
 #include <cstring>
 
 #include "end_point.h"
 #include "invalid_socket_exception.h"
+#include "socket_options.h"
 
 namespace socket_wrapper {
 
@@ -20,8 +23,8 @@ class Socket {
 
   Socket();
   Socket(const std::string &address, uint16_t port);
-  explicit Socket(uint16_t port);
-  explicit Socket(EndPointType end_point);
+  explicit Socket(uint16_t port, const SocketOptions &options = {});
+  explicit Socket(EndPointType end_point, const SocketOptions &options = {});
 
   Socket(const Socket &other) = delete;
   Socket(Socket &&other) noexcept;
@@ -53,17 +56,41 @@ class Socket {
    * \brief Получить адрес сокета.
    */
   [[nodiscard]] const EndPointType &GetEndPoint() const;
+  /**
+   * \brief Получить дескриптор сокета, -1 после закрытия.
+   */
+  [[nodiscard]] int GetNativeHandle() const;
 
  protected:
   EndPointType end_point_;
   int socket_;
 
+  /**
+   * \brief Принять во владение дескриптор уже созданного сокета, например, принятого
+   * соединения.
+   */
+  Socket(int socket, EndPointType end_point);
+
   /**
    * \brief Преобразовать ошибку, сохраненную в errno в исключение и выбросить его.
    * \param msg сообщение о выполняемой операции, в которой произошла ошибка.
    */
   static void ParseErrnoAndThrow(const std::string &msg);
 
+  /**
+   * \brief Установить значение параметра сокета.
+   * \param level уровень, на котором определен параметр (например, SOL_SOCKET);
+   * \param name имя параметра;
+   * \param value значение параметра.
+   */
+  void SetOption(int level, int name, int value) const;
+  /**
+   * \brief Получить значение целочисленного параметра сокета.
+   * \param level уровень, на котором определен параметр (например, SOL_SOCKET);
+   * \param name имя параметра.
+   */
+  [[nodiscard]] int GetOption(int level, int name) const;
+
   /**
    * \brief Проверка валидности дескриптора сокета.
    */
@@ -80,6 +107,10 @@ class Socket {
    * \brief Связать сокет с адресом @link end_point_ конечной точки@endlink.
    */
   void Bind();
+  /**
+   * \brief Применить параметры, которые должны быть установлены до связывания с адресом.
+   */
+  void ApplyOptions(const SocketOptions &options) const;
 };
 
 template <typename Proto>
@@ -92,11 +123,13 @@ Socket<Proto>::Socket(const std::string &address, const uint16_t port)
 }
 
 template <typename Proto>
-Socket<Proto>::Socket(const uint16_t port) : Socket(EndPointType(port)) {
+Socket<Proto>::Socket(const uint16_t port, const SocketOptions &options)
+    : Socket(EndPointType(port), options) {
 }
 
 template <typename Proto>
-Socket<Proto>::Socket(EndPointType end_point) : end_point_(std::move(end_point)) {
+Socket<Proto>::Socket(EndPointType end_point, const SocketOptions &options)
+    : end_point_(std::move(end_point)) {
   const Proto protocol;
   socket_ = socket(
       static_cast<int>(protocol.family),
@@ -106,9 +139,15 @@ Socket<Proto>::Socket(EndPointType end_point) : end_point_(std::move(end_point))
   if (socket_ < 0) {
     ParseErrnoAndThrow("Can't create socket.");
   }
+  ApplyOptions(options);
   Bind();
 }
 
+template <typename Proto>
+Socket<Proto>::Socket(const int socket, EndPointType end_point)
+    : end_point_(std::move(end_point)), socket_(socket) {
+}
+
 template <typename Proto>
 Socket<Proto>::Socket(Socket &&other) noexcept
     : end_point_(std::move(other.end_point_)), socket_(other.socket_) {
@@ -128,7 +167,7 @@ Socket<Proto>::~Socket() {
 
 template <typename Proto>
 void Socket<Proto>::Connect(const EndPointType &end_point) const {
-  if (connect(socket_, end_point.GetAddressImpl().lock().get(), end_point.GetAddressLen())) {
+  if (connect(socket_, end_point.GetAddressImpl(), end_point.GetAddressLen())) {
     ParseErrnoAndThrow(std::format(
         "Can't connect to end point ({}:{}).", end_point.GetAddress(), end_point.GetPort()
     ));
@@ -176,6 +215,11 @@ const EndPoint<Proto> &Socket<Proto>::GetEndPoint() const {
   return end_point_;
 }
 
+template <typename Proto>
+int Socket<Proto>::GetNativeHandle() const {
+  return socket_;
+}
+
 template <typename Proto>
 void Socket<Proto>::ParseErrnoAndThrow(const std::string &msg) {
   switch (errno) {
@@ -188,6 +232,23 @@ void Socket<Proto>::ParseErrnoAndThrow(const std::string &msg) {
   }
 }
 
+template <typename Proto>
+void Socket<Proto>::SetOption(const int level, const int name, const int value) const {
+  if (setsockopt(socket_, level, name, &value, sizeof(value))) {
+    ParseErrnoAndThrow(std::format("Can't set socket option ({}).", name));
+  }
+}
+
+template <typename Proto>
+int Socket<Proto>::GetOption(const int level, const int name) const {
+  int value = 0;
+  socklen_t value_len = sizeof(value);
+  if (getsockopt(socket_, level, name, &value, &value_len)) {
+    ParseErrnoAndThrow(std::format("Can't get socket option ({}).", name));
+  }
+  return value;
+}
+
 template <typename Proto>
 bool Socket<Proto>::IsValid() const {
   return socket_ >= 0;
@@ -195,15 +256,33 @@ bool Socket<Proto>::IsValid() const {
 
 template <typename Proto>
 void Socket<Proto>::Bind() {
-  if (bind(socket_, end_point_.GetAddressImpl().lock().get(), end_point_.GetAddressLen())) {
+  if (bind(socket_, end_point_.GetAddressImpl(), end_point_.GetAddressLen())) {
     ParseErrnoAndThrow(std::format(
         "Can't bind to end point ({}:{}).", end_point_.GetAddress(), end_point_.GetPort()
     ));
   }
-  sockaddr binded_addr = {};
+  sockaddr_storage binded_addr = {};
   socklen_t binded_addr_len = sizeof(binded_addr);
-  getsockname(socket_, &binded_addr, &binded_addr_len);
-  end_point_ = EndPointType::ParseEndPoint(binded_addr, binded_addr_len);
+  getsockname(socket_, reinterpret_cast<sockaddr *>(&binded_addr), &binded_addr_len);
+  end_point_ = EndPointType::ParseEndPoint(
+      reinterpret_cast<const sockaddr *>(&binded_addr), binded_addr_len
+  );
+}
+
+template <typename Proto>
+void Socket<Proto>::ApplyOptions(const SocketOptions &options) const {
+  if (options.reuse_port) {
+    SetOption(SOL_SOCKET, SO_REUSEPORT, 1);
+  }
+  if (options.reuse_address) {
+    SetOption(SOL_SOCKET, SO_REUSEADDR, 1);
+  }
+  if (options.non_blocking) {
+    const int flags = fcntl(socket_, F_GETFL);
+    if (flags < 0 || fcntl(socket_, F_SETFL, flags | O_NONBLOCK) < 0) {
+      ParseErrnoAndThrow("Can't set non-blocking mode.");
+    }
+  }
 }
 
 }  // namespace socket_wrapper
@@ -0,0 +1,23 @@
+#ifndef SOCKET_OPTIONS_H
+#define SOCKET_OPTIONS_H
+
+namespace socket_wrapper {
+
+/**
+ * \brief Параметры сокета, применяемые при его создании до связывания с адресом.
+ */
+struct SocketOptions {
+  /// Разрешить нескольким сокетам связываться с одним и тем же адресом (SO_REUSEPORT), при этом
+  /// ядро распределяет входящие потоки датаграмм между ними.
+  bool reuse_port = false;
+  /// Разрешить связывание с адресом, соединения которого еще находятся в состоянии TIME_WAIT
+  /// (SO_REUSEADDR), чтобы прослушивающий сокет можно было сразу создать заново.
+  bool reuse_address = false;
+  /// Неблокирующий режим (O_NONBLOCK): прием, которому нечего принять, завершается сразу, а не
+  /// ожидает датаграмму. Используется вместе с ожиданием готовности сокета, например, epoll.
+  bool non_blocking = false;
+};
+
+}  // namespace socket_wrapper
+
+#endif  // SOCKET_OPTIONS_H
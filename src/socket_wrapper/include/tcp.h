@@ -0,0 +1,21 @@
+#ifndef TCP_END_POINT_H
+#define TCP_END_POINT_H
+
+#include "end_point.h"
+#include "protocol.h"
+
+namespace socket_wrapper::tcp {
+
+template <ProtocolFamily ProtoFamily>
+struct TcpProtocol : Protocol {
+  TcpProtocol() : Protocol(SocketType::kStream, ProtoFamily, ProtocolName::kTcp) {
+  }
+};
+
+/// Конечная точка, используемая для TCP-протокола.
+template <ProtocolFamily ProtoFamily>
+using TcpEndPoint = EndPoint<TcpProtocol<ProtoFamily>>;
+
+}  // namespace socket_wrapper::tcp
+
+#endif  // TCP_END_POINT_H
@@ -0,0 +1,130 @@
+#ifndef TCP_SOCKET_H
+#define TCP_SOCKET_H
+
+#include <sys/time.h>
+
+#include <chrono>
+#include <span>
+
+#include "end_point.h"
+#include "socket.h"
+#include "tcp.h"
+
+namespace socket_wrapper::tcp {
+
+/**
+ * \brief Класс, определяющий сокет для связи по TCP-протоколу: прослушивающий либо сокет
+ * принятого соединения.
+ *
+ * \tparam ProtoFamily семейство протоколов с возможными значениями IPv4, IPv6.
+ */
+template <ProtocolFamily ProtoFamily>
+class TcpSocket : public Socket<TcpProtocol<ProtoFamily>> {
+ public:
+  using EndPointType = TcpEndPoint<ProtoFamily>;
+
+  TcpSocket() = default;
+  TcpSocket(const std::string &address, uint16_t port, const SocketOptions &options = {});
+  explicit TcpSocket(uint16_t port, const SocketOptions &options = {});
+  explicit TcpSocket(EndPointType end_point, const SocketOptions &options = {});
+
+  TcpSocket(const TcpSocket &other) = delete;
+  TcpSocket(TcpSocket &&other) = default;
+  TcpSocket &operator=(const TcpSocket &other) = delete;
+  TcpSocket &operator=(TcpSocket &&other) = default;
+
+  /**
+   * \brief Начать прием входящих соединений.
+   * \param backlog максимальная длина очереди непринятых соединений.
+   */
+  void Listen(int backlog = SOMAXCONN) const;
+  /**
+   * \brief Принять входящее соединение, ожидая его, если очередь пуста.
+   * \return сокет соединения, конечная точка которого - адрес удаленного узла.
+   */
+  [[nodiscard]] TcpSocket Accept() const;
+  /**
+   * \brief Получить уже пришедшие данные соединения в буфер вызывающей стороны, ожидая их,
+   * если их еще нет.
+   * \return количество полученных байт, 0 - если соединение закрыто удаленным узлом.
+   */
+  size_t ReceiveSome(std::span<char> buffer) const;
+  /**
+   * \brief Ограничить время ожидания данных при приеме (SO_RCVTIMEO).
+   */
+  void SetReceiveTimeout(std::chrono::milliseconds timeout) const;
+
+ private:
+  using SocketType = Socket<TcpProtocol<ProtoFamily>>;
+
+  TcpSocket(int socket, EndPointType end_point);
+};
+
+template <ProtocolFamily ProtoFamily>
+TcpSocket<ProtoFamily>::TcpSocket(
+    const std::string &address, const uint16_t port, const SocketOptions &options
+)
+    : SocketType(EndPointType(address, port), options) {
+}
+
+template <ProtocolFamily ProtoFamily>
+TcpSocket<ProtoFamily>::TcpSocket(const uint16_t port, const SocketOptions &options)
+    : SocketType(port, options) {
+}
+
+template <ProtocolFamily ProtoFamily>
+TcpSocket<ProtoFamily>::TcpSocket(EndPointType end_point, const SocketOptions &options)
+    : SocketType(end_point, options) {
+}
+
+template <ProtocolFamily ProtoFamily>
+TcpSocket<ProtoFamily>::TcpSocket(const int socket, EndPointType end_point)
+    : SocketType(socket, std::move(end_point)) {
+}
+
+template <ProtocolFamily ProtoFamily>
+void TcpSocket<ProtoFamily>::Listen(const int backlog) const {
+  if (listen(SocketType::socket_, backlog)) {
+    SocketType::ParseErrnoAndThrow("Can't listen.");
+  }
+}
+
+template <ProtocolFamily ProtoFamily>
+TcpSocket<ProtoFamily> TcpSocket<ProtoFamily>::Accept() const {
+  sockaddr_storage peer_addr = {};
+  socklen_t peer_addr_len = sizeof(peer_addr);
+  const int socket = accept4(
+      SocketType::socket_, reinterpret_cast<sockaddr *>(&peer_addr), &peer_addr_len, SOCK_CLOEXEC
+  );
+  if (socket < 0) {
+    SocketType::ParseErrnoAndThrow("Can't accept.");
+  }
+  return TcpSocket(
+      socket,
+      EndPointType::ParseEndPoint(reinterpret_cast<const sockaddr *>(&peer_addr), peer_addr_len)
+  );
+}
+
+template <ProtocolFamily ProtoFamily>
+size_t TcpSocket<ProtoFamily>::ReceiveSome(const std::span<char> buffer) const {
+  const ssize_t recv_count = recv(SocketType::socket_, buffer.data(), buffer.size(), 0);
+  if (recv_count < 0) {
+    SocketType::ParseErrnoAndThrow("Can't recv.");
+  }
+  return static_cast<size_t>(recv_count);
+}
+
+template <ProtocolFamily ProtoFamily>
+void TcpSocket<ProtoFamily>::SetReceiveTimeout(const std::chrono::milliseconds timeout) const {
+  const timeval value = {
+      .tv_sec = static_cast<time_t>(timeout.count() / 1000),
+      .tv_usec = static_cast<suseconds_t>(timeout.count() % 1000 * 1000)
+  };
+  if (setsockopt(SocketType::socket_, SOL_SOCKET, SO_RCVTIMEO, &value, sizeof(value))) {
+    SocketType::ParseErrnoAndThrow("Can't set receive timeout.");
+  }
+}
+
+}  // namespace socket_wrapper::tcp
+
+#endif  // TCP_SOCKET_H
@@ -1,6 +1,9 @@
 #ifndef UDP_END_POINT_H
 #define UDP_END_POINT_H
 
+#include <type_traits>
+
+#include "end_point.h"
 #include "protocol.h"
 
 namespace socket_wrapper::udp {
@@ -15,6 +18,9 @@ struct UdpProtocol : Protocol {
 template <ProtocolFamily ProtoFamily>
 using UdpEndPoint = EndPoint<UdpProtocol<ProtoFamily>>;
 
+static_assert(std::is_trivially_copyable_v<UdpEndPoint<ProtocolFamily::kIpV4>>);
+static_assert(std::is_trivially_copyable_v<UdpEndPoint<ProtocolFamily::kIpV6>>);
+
 }  // namespace socket_wrapper::udp
 
 #endif  // UDP_END_POINT_H
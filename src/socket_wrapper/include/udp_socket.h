@@ -1,6 +1,18 @@
 #ifndef UDP_SOCKET_H
 #define UDP_SOCKET_H
 
+#include <linux/sockios.h>
+#include <netinet/udp.h>
+#include <sys/ioctl.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <optional>
+#include <span>
+#include <vector>
+
 #include "end_point.h"
 #include "socket.h"
 #include "udp.h"
@@ -17,29 +29,298 @@ class UdpSocket : public Socket<UdpProtocol<ProtoFamily>> {
  public:
   using EndPointType = UdpEndPoint<ProtoFamily>;
 
+  /// Максимальный размер полезной нагрузки UDP-датаграммы.
+  static constexpr size_t kMaxDatagramSize = 65507;
+  /// Максимальное количество сегментов в одном буфере UDP_SEGMENT.
+  static constexpr size_t kMaxSegmentCount = 64;
+  /// Максимальный размер сегмента UDP_SEGMENT, не превышающий MTU Ethernet для IPv4 и IPv6.
+  static constexpr size_t kMaxSegmentSize = 1452;
+  /// Максимальный запрашиваемый размер буфера сокета: ядро удваивает его в int.
+  static constexpr int kMaxBufferSize = std::numeric_limits<int>::max() / 2;
+
   UdpSocket() = default;
   UdpSocket(const std::string &address, uint16_t port);
-  explicit UdpSocket(uint16_t port);
-  explicit UdpSocket(EndPointType end_point);
+  explicit UdpSocket(uint16_t port, const SocketOptions &options = {});
+  explicit UdpSocket(EndPointType end_point, const SocketOptions &options = {});
 
   UdpSocket(const UdpSocket &other) = delete;
   UdpSocket(UdpSocket &&other) = default;
   UdpSocket &operator=(const UdpSocket &other) = delete;
   UdpSocket &operator=(UdpSocket &&other) = default;
 
+  /**
+   * \brief Датаграмма в буфере, которым владеет вызывающая сторона, например, в слоте
+   * @link BufferPool пула буферов@endlink.
+   */
+  struct DatagramView {
+    /// Буфер, при приеме - вся доступная для датаграммы память.
+    std::span<char> buffer;
+    /// Размер датаграммы в начале буфера.
+    size_t size = 0;
+    /// Отправитель принятой либо получатель отправляемой датаграммы.
+    EndPointType end_point;
+  };
+
   /**
    * \brief Отправить сообщения указанному получателю.
    */
   void SendTo(const std::string &message, const UdpEndPoint<ProtoFamily> &receiver) const;
+  /**
+   * \brief Отправить сообщение из буфера вызывающей стороны указанному получателю.
+   */
+  void SendTo(std::span<const char> message, const UdpEndPoint<ProtoFamily> &receiver) const;
   /**
    * \brief Получить сообщение.
    * \param max_size максимальный размер принимаемого сообщения.
    * \return пара: сообщение - отправитель.
    */
   std::pair<std::string, EndPointType> ReceiveFrom(size_t max_size = 1024) const;
+  /**
+   * \brief Получить сообщение в буфер вызывающей стороны без выделения памяти.
+   * \param buffer буфер, более длинные сообщения обрезаются до его размера.
+   * \return пара: размер сообщения - отправитель.
+   */
+  std::pair<size_t, EndPointType> ReceiveFrom(std::span<char> buffer) const;
+  /**
+   * \brief Получить сообщение в буфер вызывающей стороны без ожидания (MSG_DONTWAIT).
+   *
+   * С включенным @link SetBusyPoll опросом очереди устройства@endlink каждый вызов также
+   * опрашивает очередь устройства, поэтому повторные вызовы заменяют ожидание прерывания.
+   *
+   * \return пара: размер сообщения - отправитель, std::nullopt - принимать нечего.
+   */
+  std::optional<std::pair<size_t, EndPointType>> TryReceiveFrom(std::span<char> buffer) const;
+  /**
+   * \brief Отправить несколько сообщений, возможно разным получателям, за один системный вызов.
+   * \param messages пары: сообщение - получатель.
+   */
+  void SendBatchTo(std::span<const std::pair<std::string, EndPointType>> messages) const;
+  /**
+   * \brief Получить несколько сообщений за один системный вызов в буферы вызывающей стороны.
+   *
+   * Служебные структуры системного вызова переиспользуются потоком, поэтому при неизменном
+   * размере пакета прием не выделяет память. Буферы, объединенные UDP_GRO, не разделяются.
+   *
+   * \param datagrams датаграммы с буферами для приема, в первых из них заполняются размер и
+   * отправитель.
+   * \return количество принятых сообщений, в неблокирующем режиме - 0, если принимать нечего.
+   */
+  size_t ReceiveBatchFrom(std::span<DatagramView> datagrams) const;
+  /**
+   * \brief Получить несколько сообщений в буферы вызывающей стороны без ожидания
+   * (MSG_DONTWAIT).
+   * \return количество принятых сообщений, 0 - принимать нечего.
+   */
+  size_t TryReceiveBatchFrom(std::span<DatagramView> datagrams) const;
+  /**
+   * \brief Отправить несколько сообщений из буферов вызывающей стороны за один системный вызов.
+   *
+   * Служебные структуры системного вызова переиспользуются потоком, поэтому при неизменном
+   * размере пакета отправка не выделяет память.
+   *
+   * \param datagrams датаграммы с получателями.
+   */
+  void SendBatchTo(std::span<const DatagramView> datagrams) const;
+  /**
+   * \brief Получить несколько сообщений за один системный вызов в буферы вызывающей стороны и
+   * разделить буферы, объединенные UDP_GRO, на исходные датаграммы без копирования.
+   *
+   * Ожидает получения хотя бы одного сообщения, после чего забирает уже пришедшие без ожидания.
+   *
+   * \param buffers датаграммы с буферами для приема; объединенный буфер может иметь размер
+   * @link kMaxDatagramSize @endlink, более длинные данные обрезаются;
+   * \param datagrams принятые датаграммы, ссылающиеся на части буферов. Очищаются перед приемом,
+   * их память переиспользуется между вызовами.
+   * \return количество заполненных буферов.
+   */
+  size_t ReceiveSegmentedBatchFrom(
+      std::span<DatagramView> buffers, std::vector<DatagramView> &datagrams
+  ) const;
+  /**
+   * \brief Отправить несколько сообщений за один системный вызов, объединяя подряд идущие
+   * сообщения одному получателю в буферы с сегментацией на стороне ядра (UDP_SEGMENT, GSO).
+   *
+   * В один буфер попадают сообщения одинакового размера, последнее из них может быть короче.
+   * Порядок сообщений сохраняется, поэтому сообщения одному получателю стоит располагать подряд.
+   * Служебные структуры системного вызова переиспользуются потоком.
+   *
+   * \param datagrams датаграммы с получателями.
+   */
+  void SendSegmentedBatchTo(std::span<const DatagramView> datagrams) const;
+  /**
+   * \brief Разрешить ядру объединять принимаемые датаграммы одного потока в один буфер
+   * (UDP_GRO).
+   *
+   * Объединенные буферы разделяются на исходные датаграммы методом
+   * @link ReceiveSegmentedBatchFrom @endlink, остальные методы приема их не разделяют.
+   */
+  void SetGro(bool enabled);
+  /**
+   * \brief Включить очередь ошибок сокета (IP_RECVERR, IPV6_RECVERR), в которую попадают
+   * ICMP-ошибки доставки отправленных датаграмм.
+   *
+   * Ошибка доставки также возвращается следующим вызовом отправки, поэтому методы отправки
+   * один раз повторяют вызов, завершившийся такой ошибкой.
+   */
+  void SetRecvErr(bool enabled);
+  /**
+   * \brief Предпочитать сокет при выборе среди сокетов SO_REUSEPORT для датаграмм, которые
+   * обрабатываются ядром на указанном процессоре (SO_INCOMING_CPU).
+   *
+   * Вместе с привязкой принимающего потока к тому же процессору датаграмма обрабатывается
+   * ядром и потоком на одном процессоре.
+   */
+  void SetIncomingCpu(int cpu);
+  /**
+   * \brief Опрашивать очередь устройства при приеме вместо ожидания прерывания
+   * (SO_BUSY_POLL) и предпочитать опрос обработке прерываний (SO_PREFER_BUSY_POLL).
+   *
+   * Значения больше net.core.busy_read и SO_PREFER_BUSY_POLL требуют CAP_NET_ADMIN.
+   *
+   * \param budget время опроса при блокирующем приеме без данных.
+   */
+  void SetBusyPoll(std::chrono::microseconds budget);
+  /**
+   * \brief Установить размер буфера приема (SO_RCVBUF).
+   *
+   * Ядро удваивает запрошенный размер для служебных данных и ограничивает его
+   * net.core.rmem_max.
+   *
+   * \param size запрашиваемый размер в байтах;
+   * \param force установить размер без ограничения net.core.rmem_max (SO_RCVBUFFORCE),
+   * требует CAP_NET_ADMIN.
+   */
+  void SetReceiveBufferSize(int size, bool force = false);
+  /**
+   * \brief Установить размер буфера отправки (SO_SNDBUF).
+   * \param size запрашиваемый размер в байтах;
+   * \param force установить размер без ограничения net.core.wmem_max (SO_SNDBUFFORCE),
+   * требует CAP_NET_ADMIN.
+   */
+  void SetSendBufferSize(int size, bool force = false);
+  /**
+   * \brief Действующий размер буфера приема в байтах с учетом удвоения ядром.
+   */
+  [[nodiscard]] size_t GetReceiveBufferSize() const;
+  /**
+   * \brief Действующий размер буфера отправки в байтах с учетом удвоения ядром.
+   */
+  [[nodiscard]] size_t GetSendBufferSize() const;
+  /**
+   * \brief Получать с датаграммами счетчик датаграмм, отброшенных ядром из-за переполнения
+   * буфера приема (SO_RXQ_OVFL).
+   *
+   * Ядро добавляет счетчик к датаграмме, только если отброшенные датаграммы уже были, поэтому
+   * прием без потерь не разбирает управляющие сообщения. Счетчик читают все методы приема,
+   * кроме приема через io_uring.
+   */
+  void SetRxqOverflow(bool enabled);
+  /**
+   * \brief Количество датаграмм, отброшенных ядром до последнего приема, с включенным
+   * @link SetRxqOverflow SO_RXQ_OVFL@endlink.
+   *
+   * Ядро считает 32-разрядным счетчиком, который может переполниться.
+   */
+  [[nodiscard]] uint32_t GetKernelDrops() const;
+  /**
+   * \brief Размер данных в очереди приема (SIOCINQ).
+   *
+   * Для UDP ядро возвращает размер первой ожидающей датаграммы, а не всей очереди, поэтому
+   * ненулевое значение означает, что прием отстает от поступления датаграмм.
+   */
+  [[nodiscard]] size_t GetReceiveQueueSize() const;
+  /**
+   * \brief Размер отправленных, но еще не переданных устройству данных (SIOCOUTQ).
+   */
+  [[nodiscard]] size_t GetSendQueueSize() const;
+  /**
+   * \brief Забрать из очереди ошибок сокета все ошибки доставки без ожидания.
+   * \return получатели датаграмм, доставка которых завершилась ошибкой.
+   */
+  std::vector<EndPointType> ReceiveErrors() const;
 
  private:
   using SocketType = Socket<UdpProtocol<ProtoFamily>>;
+
+  /**
+   * \brief Буфер управляющего сообщения с размером сегмента UDP_SEGMENT или UDP_GRO.
+   */
+  struct SegmentControl {
+    alignas(cmsghdr) char buffer[CMSG_SPACE(sizeof(int))];
+  };
+  /**
+   * \brief Буфер управляющих сообщений приема: размер сегмента UDP_GRO и счетчик
+   * отброшенных ядром датаграмм SO_RXQ_OVFL.
+   */
+  struct ReceiveControl {
+    alignas(cmsghdr) char buffer[CMSG_SPACE(sizeof(int)) + CMSG_SPACE(sizeof(uint32_t))];
+  };
+  /**
+   * \brief Счетчик отброшенных ядром датаграмм, перемещаемый вместе с сокетом.
+   */
+  struct KernelDrops {
+    std::atomic<uint32_t> value = 0;
+
+    KernelDrops() = default;
+    KernelDrops(KernelDrops &&other) noexcept : value(other.value.load()) {
+    }
+    KernelDrops &operator=(KernelDrops &&other) noexcept {
+      value.store(other.value.load());
+      return *this;
+    }
+  };
+
+  bool gro_ = false;
+  bool rxq_overflow_ = false;
+  /// Последний принятый счетчик SO_RXQ_OVFL, обновляется потоками приема.
+  mutable KernelDrops kernel_drops_;
+
+  /**
+   * \brief Получить сообщение с флагами recvfrom.
+   * \return std::nullopt только с MSG_DONTWAIT, если принимать нечего.
+   */
+  std::optional<std::pair<size_t, EndPointType>> ReceiveFrom(
+      std::span<char> buffer, int flags
+  ) const;
+  /**
+   * \brief Получить несколько сообщений с флагами recvmmsg.
+   * \param segments если задан, в него добавляются датаграммы, на которые разделены принятые
+   * буферы, объединенные UDP_GRO.
+   */
+  size_t ReceiveBatchFrom(
+      std::span<DatagramView> datagrams, int flags, std::vector<DatagramView> *segments = nullptr
+  ) const;
+  /**
+   * \brief Запомнить счетчик SO_RXQ_OVFL из управляющих сообщений принятой датаграммы.
+   *
+   * Потоки, принимающие с одного сокета, могут разобрать счетчики не по порядку, поэтому
+   * сохраняется наибольший с учетом переполнения.
+   */
+  void ReadKernelDrops(const msghdr &header) const;
+  /**
+   * \brief Получить целочисленное значение ioctl сокета.
+   */
+  size_t GetIoctlValue(unsigned long request) const;
+
+  /**
+   * \brief Ошибка, которую ядро возвращает при отправке, если ранее отправленная датаграмма
+   * не была доставлена.
+   */
+  static bool IsDeferredError(int error);
+  /**
+   * \brief Отправить подготовленные заголовки одним или несколькими вызовами sendmmsg.
+   */
+  void SendHeaders(std::span<mmsghdr> headers) const;
+
+  /**
+   * \brief Разделить буфер, объединенный UDP_GRO, на датаграммы и добавить их к принятым.
+   * \param header заголовок принятого буфера с управляющими сообщениями;
+   * \param buffer принятый буфер с размером и отправителем;
+   * \param datagrams принятые датаграммы, ссылающиеся на части буфера.
+   */
+  static void SplitGroBuffer(
+      const msghdr &header, const DatagramView &buffer, std::vector<DatagramView> &datagrams
+  );
 };
 
 template <ProtocolFamily ProtoFamily>
@@ -48,30 +329,45 @@ UdpSocket<ProtoFamily>::UdpSocket(const std::string &address, uint16_t port)
 }
 
 template <ProtocolFamily ProtoFamily>
-UdpSocket<ProtoFamily>::UdpSocket(uint16_t port) : SocketType(port) {
+UdpSocket<ProtoFamily>::UdpSocket(uint16_t port, const SocketOptions &options)
+    : SocketType(port, options) {
 }
 
 template <ProtocolFamily ProtoFamily>
-UdpSocket<ProtoFamily>::UdpSocket(EndPointType end_point) : SocketType(end_point) {
+UdpSocket<ProtoFamily>::UdpSocket(EndPointType end_point, const SocketOptions &options)
+    : SocketType(end_point, options) {
 }
 
 template <ProtocolFamily ProtoFamily>
 void UdpSocket<ProtoFamily>::SendTo(
     const std::string &message, const UdpEndPoint<ProtoFamily> &receiver
+) const {
+  SendTo(std::span<const char>(message), receiver);
+}
+
+template <ProtocolFamily ProtoFamily>
+void UdpSocket<ProtoFamily>::SendTo(
+    const std::span<const char> message, const UdpEndPoint<ProtoFamily> &receiver
 ) const {
   size_t send_count = 0;
+  bool deferred_error_skipped = false;
   while (send_count < message.size()) {
     const ssize_t cur_send_cont = sendto(
         SocketType::socket_,
         message.data() + send_count,
         message.size() - send_count,
         0,
-        receiver.GetAddressImpl().lock().get(),
+        receiver.GetAddressImpl(),
         receiver.GetAddressLen()
     );
     if (cur_send_cont < 0) {
+      if (!deferred_error_skipped && IsDeferredError(errno)) {
+        deferred_error_skipped = true;
+        continue;
+      }
       SocketType::ParseErrnoAndThrow("Can't send.");
     }
+    deferred_error_skipped = false;
     send_count += cur_send_cont;
   }
 }
@@ -81,20 +377,387 @@ std::pair<std::string, UdpEndPoint<ProtoFamily>> UdpSocket<ProtoFamily>::Receive
     const size_t max_size
 ) const {
   std::string buffer(max_size, '\0');
-  sockaddr sender_addr = {};
-  socklen_t sender_addr_len = sizeof(sender_addr);
-  const int recv_count = recvfrom(
-      SocketType::socket_, buffer.data(), buffer.size(), 0, &sender_addr, &sender_addr_len
-  );
-  if (sender_addr_len == 0) {
+  const auto [recv_count, sender_end_point] = ReceiveFrom(std::span<char>(buffer));
+  buffer.resize(recv_count);
+  return std::make_pair(std::move(buffer), sender_end_point);
+}
+
+template <ProtocolFamily ProtoFamily>
+std::pair<size_t, UdpEndPoint<ProtoFamily>> UdpSocket<ProtoFamily>::ReceiveFrom(
+    const std::span<char> buffer
+) const {
+  return ReceiveFrom(buffer, 0).value();
+}
+
+template <ProtocolFamily ProtoFamily>
+std::optional<std::pair<size_t, UdpEndPoint<ProtoFamily>>> UdpSocket<
+    ProtoFamily>::TryReceiveFrom(const std::span<char> buffer) const {
+  return ReceiveFrom(buffer, MSG_DONTWAIT);
+}
+
+template <ProtocolFamily ProtoFamily>
+std::optional<std::pair<size_t, UdpEndPoint<ProtoFamily>>> UdpSocket<ProtoFamily>::ReceiveFrom(
+    const std::span<char> buffer, const int flags
+) const {
+  sockaddr_storage sender_addr = {};
+  iovec data = {.iov_base = buffer.data(), .iov_len = buffer.size()};
+  ReceiveControl control;
+  msghdr header = {};
+  header.msg_name = &sender_addr;
+  header.msg_namelen = sizeof(sender_addr);
+  header.msg_iov = &data;
+  header.msg_iovlen = 1;
+  if (rxq_overflow_) {
+    header.msg_control = control.buffer;
+    header.msg_controllen = sizeof(control.buffer);
+  }
+  const ssize_t recv_count = recvmsg(SocketType::socket_, &header, flags);
+  if (header.msg_namelen == 0) {
     throw InvalidSocketException("Can't recv. Socket is shut down.");
   }
   if (recv_count < 0) {
+    if ((flags & MSG_DONTWAIT) != 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      return std::nullopt;
+    }
     SocketType::ParseErrnoAndThrow("Can't recv.");
   }
-  buffer.resize(recv_count);
-  auto sender_end_point = EndPointType::ParseEndPoint(sender_addr, sender_addr_len);
-  return std::make_pair(std::move(buffer), std::move(sender_end_point));
+  if (rxq_overflow_) {
+    ReadKernelDrops(header);
+  }
+  const auto sender_end_point = EndPointType::ParseEndPoint(
+      reinterpret_cast<const sockaddr *>(&sender_addr), header.msg_namelen
+  );
+  return std::make_pair(static_cast<size_t>(recv_count), sender_end_point);
+}
+
+template <ProtocolFamily ProtoFamily>
+void UdpSocket<ProtoFamily>::SendBatchTo(
+    const std::span<const std::pair<std::string, EndPointType>> messages
+) const {
+  std::vector<iovec> iovecs(messages.size());
+  std::vector<mmsghdr> headers(messages.size());
+  for (size_t i = 0; i < messages.size(); ++i) {
+    const auto &[message, receiver] = messages[i];
+    iovecs[i] = {.iov_base = const_cast<char *>(message.data()), .iov_len = message.size()};
+    headers[i].msg_hdr = {};
+    headers[i].msg_hdr.msg_name = const_cast<sockaddr *>(receiver.GetAddressImpl());
+    headers[i].msg_hdr.msg_namelen = receiver.GetAddressLen();
+    headers[i].msg_hdr.msg_iov = &iovecs[i];
+    headers[i].msg_hdr.msg_iovlen = 1;
+  }
+  SendHeaders(headers);
+}
+
+template <ProtocolFamily ProtoFamily>
+size_t UdpSocket<ProtoFamily>::ReceiveBatchFrom(const std::span<DatagramView> datagrams) const {
+  return ReceiveBatchFrom(datagrams, MSG_WAITFORONE);
+}
+
+template <ProtocolFamily ProtoFamily>
+size_t UdpSocket<ProtoFamily>::TryReceiveBatchFrom(const std::span<DatagramView> datagrams) const {
+  return ReceiveBatchFrom(datagrams, MSG_DONTWAIT);
+}
+
+template <ProtocolFamily ProtoFamily>
+size_t UdpSocket<ProtoFamily>::ReceiveSegmentedBatchFrom(
+    const std::span<DatagramView> buffers, std::vector<DatagramView> &datagrams
+) const {
+  datagrams.clear();
+  return ReceiveBatchFrom(buffers, MSG_WAITFORONE, &datagrams);
+}
+
+template <ProtocolFamily ProtoFamily>
+size_t UdpSocket<ProtoFamily>::ReceiveBatchFrom(
+    const std::span<DatagramView> datagrams, const int flags, std::vector<DatagramView> *segments
+) const {
+  thread_local std::vector<sockaddr_storage> sender_addrs;
+  thread_local std::vector<iovec> iovecs;
+  thread_local std::vector<mmsghdr> headers;
+  thread_local std::vector<ReceiveControl> controls;
+  const bool split_gro = gro_ && segments != nullptr;
+  const bool has_control = split_gro || rxq_overflow_;
+  sender_addrs.resize(datagrams.size());
+  iovecs.resize(datagrams.size());
+  headers.resize(datagrams.size());
+  if (has_control) {
+    controls.resize(datagrams.size());
+  }
+  for (size_t i = 0; i < datagrams.size(); ++i) {
+    iovecs[i] = {.iov_base = datagrams[i].buffer.data(), .iov_len = datagrams[i].buffer.size()};
+    headers[i].msg_hdr = {};
+    headers[i].msg_hdr.msg_name = &sender_addrs[i];
+    headers[i].msg_hdr.msg_namelen = sizeof(sender_addrs[i]);
+    headers[i].msg_hdr.msg_iov = &iovecs[i];
+    headers[i].msg_hdr.msg_iovlen = 1;
+    if (has_control) {
+      headers[i].msg_hdr.msg_control = controls[i].buffer;
+      headers[i].msg_hdr.msg_controllen = sizeof(controls[i].buffer);
+    }
+  }
+  const int recv_count =
+      recvmmsg(SocketType::socket_, headers.data(), headers.size(), flags, nullptr);
+  if (recv_count < 0) {
+    if (errno == EAGAIN || errno == EWOULDBLOCK) {
+      return 0;
+    }
+    SocketType::ParseErrnoAndThrow("Can't recv.");
+  }
+  for (int i = 0; i < recv_count; ++i) {
+    const auto &header = headers[i].msg_hdr;
+    if (header.msg_namelen == 0) {
+      throw InvalidSocketException("Can't recv. Socket is shut down.");
+    }
+    datagrams[i].size = std::min<size_t>(headers[i].msg_len, datagrams[i].buffer.size());
+    if (rxq_overflow_) {
+      ReadKernelDrops(header);
+    }
+    datagrams[i].end_point = EndPointType::ParseEndPoint(
+        reinterpret_cast<const sockaddr *>(&sender_addrs[i]), header.msg_namelen
+    );
+    if (split_gro) {
+      SplitGroBuffer(header, datagrams[i], *segments);
+    } else if (segments != nullptr) {
+      segments->push_back(datagrams[i]);
+    }
+  }
+  return recv_count;
+}
+
+template <ProtocolFamily ProtoFamily>
+void UdpSocket<ProtoFamily>::SendBatchTo(const std::span<const DatagramView> datagrams) const {
+  thread_local std::vector<iovec> iovecs;
+  thread_local std::vector<mmsghdr> headers;
+  iovecs.resize(datagrams.size());
+  headers.resize(datagrams.size());
+  for (size_t i = 0; i < datagrams.size(); ++i) {
+    const auto &datagram = datagrams[i];
+    iovecs[i] = {.iov_base = datagram.buffer.data(), .iov_len = datagram.size};
+    headers[i].msg_hdr = {};
+    headers[i].msg_hdr.msg_name = const_cast<sockaddr *>(datagram.end_point.GetAddressImpl());
+    headers[i].msg_hdr.msg_namelen = datagram.end_point.GetAddressLen();
+    headers[i].msg_hdr.msg_iov = &iovecs[i];
+    headers[i].msg_hdr.msg_iovlen = 1;
+  }
+  SendHeaders(headers);
+}
+
+template <ProtocolFamily ProtoFamily>
+void UdpSocket<ProtoFamily>::SendSegmentedBatchTo(
+    const std::span<const DatagramView> datagrams
+) const {
+  thread_local std::vector<iovec> iovecs;
+  thread_local std::vector<SegmentControl> controls;
+  thread_local std::vector<mmsghdr> headers;
+  iovecs.resize(datagrams.size());
+  controls.resize(datagrams.size());
+  headers.resize(datagrams.size());
+  size_t header_count = 0;
+  for (size_t first = 0; first < datagrams.size();) {
+    const auto &receiver = datagrams[first].end_point;
+    const auto segment_size = datagrams[first].size;
+    const auto max_count =
+        segment_size > 0 && segment_size <= kMaxSegmentSize ? kMaxSegmentCount : 1;
+    // Сообщения одинакового размера одному получателю, последнее может быть короче.
+    size_t last = first;
+    size_t total_size = 0;
+    while (last < datagrams.size() && last - first < max_count &&
+           datagrams[last].end_point == receiver && datagrams[last].size <= segment_size &&
+           total_size + datagrams[last].size <= kMaxDatagramSize) {
+      const auto &datagram = datagrams[last];
+      iovecs[last] = {.iov_base = datagram.buffer.data(), .iov_len = datagram.size};
+      total_size += datagram.size;
+      ++last;
+      if (datagram.size < segment_size) {
+        break;
+      }
+    }
+
+    auto &header = headers[header_count++].msg_hdr;
+    header = {};
+    header.msg_name = const_cast<sockaddr *>(receiver.GetAddressImpl());
+    header.msg_namelen = receiver.GetAddressLen();
+    header.msg_iov = &iovecs[first];
+    header.msg_iovlen = last - first;
+    if (last - first > 1) {
+      header.msg_control = controls[first].buffer;
+      header.msg_controllen = sizeof(controls[first].buffer);
+      auto *const control = CMSG_FIRSTHDR(&header);
+      control->cmsg_level = SOL_UDP;
+      control->cmsg_type = UDP_SEGMENT;
+      control->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+      const auto gso_size = static_cast<uint16_t>(segment_size);
+      std::memcpy(CMSG_DATA(control), &gso_size, sizeof(gso_size));
+    }
+    first = last;
+  }
+  SendHeaders(std::span(headers).first(header_count));
+}
+
+template <ProtocolFamily ProtoFamily>
+void UdpSocket<ProtoFamily>::SetGro(const bool enabled) {
+  SocketType::SetOption(SOL_UDP, UDP_GRO, enabled ? 1 : 0);
+  gro_ = enabled;
+}
+
+template <ProtocolFamily ProtoFamily>
+void UdpSocket<ProtoFamily>::SetIncomingCpu(const int cpu) {
+  SocketType::SetOption(SOL_SOCKET, SO_INCOMING_CPU, cpu);
+}
+
+template <ProtocolFamily ProtoFamily>
+void UdpSocket<ProtoFamily>::SetBusyPoll(const std::chrono::microseconds budget) {
+  SocketType::SetOption(SOL_SOCKET, SO_BUSY_POLL, static_cast<int>(budget.count()));
+  SocketType::SetOption(SOL_SOCKET, SO_PREFER_BUSY_POLL, budget.count() > 0 ? 1 : 0);
+}
+
+template <ProtocolFamily ProtoFamily>
+void UdpSocket<ProtoFamily>::SetReceiveBufferSize(const int size, const bool force) {
+  SocketType::SetOption(SOL_SOCKET, force ? SO_RCVBUFFORCE : SO_RCVBUF, size);
+}
+
+template <ProtocolFamily ProtoFamily>
+void UdpSocket<ProtoFamily>::SetSendBufferSize(const int size, const bool force) {
+  SocketType::SetOption(SOL_SOCKET, force ? SO_SNDBUFFORCE : SO_SNDBUF, size);
+}
+
+template <ProtocolFamily ProtoFamily>
+size_t UdpSocket<ProtoFamily>::GetReceiveBufferSize() const {
+  return SocketType::GetOption(SOL_SOCKET, SO_RCVBUF);
+}
+
+template <ProtocolFamily ProtoFamily>
+size_t UdpSocket<ProtoFamily>::GetSendBufferSize() const {
+  return SocketType::GetOption(SOL_SOCKET, SO_SNDBUF);
+}
+
+template <ProtocolFamily ProtoFamily>
+void UdpSocket<ProtoFamily>::SetRxqOverflow(const bool enabled) {
+  SocketType::SetOption(SOL_SOCKET, SO_RXQ_OVFL, enabled ? 1 : 0);
+  rxq_overflow_ = enabled;
+}
+
+template <ProtocolFamily ProtoFamily>
+uint32_t UdpSocket<ProtoFamily>::GetKernelDrops() const {
+  return kernel_drops_.value.load(std::memory_order_relaxed);
+}
+
+template <ProtocolFamily ProtoFamily>
+size_t UdpSocket<ProtoFamily>::GetReceiveQueueSize() const {
+  return GetIoctlValue(SIOCINQ);
+}
+
+template <ProtocolFamily ProtoFamily>
+size_t UdpSocket<ProtoFamily>::GetSendQueueSize() const {
+  return GetIoctlValue(SIOCOUTQ);
+}
+
+template <ProtocolFamily ProtoFamily>
+void UdpSocket<ProtoFamily>::SetRecvErr(const bool enabled) {
+  if constexpr (ProtoFamily == ProtocolFamily::kIpV6) {
+    SocketType::SetOption(SOL_IPV6, IPV6_RECVERR, enabled ? 1 : 0);
+  } else {
+    SocketType::SetOption(SOL_IP, IP_RECVERR, enabled ? 1 : 0);
+  }
+}
+
+template <ProtocolFamily ProtoFamily>
+std::vector<UdpEndPoint<ProtoFamily>> UdpSocket<ProtoFamily>::ReceiveErrors() const {
+  std::vector<EndPointType> receivers;
+  while (true) {
+    // Ни исходная датаграмма, ни описание ошибки не нужны: получатель датаграммы передается
+    // в адресе сообщения.
+    sockaddr_storage receiver_addr = {};
+    msghdr header = {};
+    header.msg_name = &receiver_addr;
+    header.msg_namelen = sizeof(receiver_addr);
+    if (recvmsg(SocketType::socket_, &header, MSG_ERRQUEUE | MSG_DONTWAIT) < 0) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        return receivers;
+      }
+      SocketType::ParseErrnoAndThrow("Can't recv errors.");
+    }
+    if (header.msg_namelen > 0) {
+      receivers.push_back(EndPointType::ParseEndPoint(
+          reinterpret_cast<const sockaddr *>(&receiver_addr), header.msg_namelen
+      ));
+    }
+  }
+}
+
+template <ProtocolFamily ProtoFamily>
+void UdpSocket<ProtoFamily>::ReadKernelDrops(const msghdr &header) const {
+  for (auto *control = CMSG_FIRSTHDR(&header); control != nullptr;
+       control = CMSG_NXTHDR(const_cast<msghdr *>(&header), control)) {
+    if (control->cmsg_level != SOL_SOCKET || control->cmsg_type != SO_RXQ_OVFL) {
+      continue;
+    }
+    uint32_t drops = 0;
+    std::memcpy(&drops, CMSG_DATA(control), sizeof(drops));
+    auto current = kernel_drops_.value.load(std::memory_order_relaxed);
+    // Сравнение разности сохраняет порядок счетчиков после переполнения.
+    while (static_cast<int32_t>(drops - current) > 0 &&
+           !kernel_drops_.value.compare_exchange_weak(current, drops, std::memory_order_relaxed)) {
+    }
+  }
+}
+
+template <ProtocolFamily ProtoFamily>
+size_t UdpSocket<ProtoFamily>::GetIoctlValue(const unsigned long request) const {
+  int value = 0;
+  if (ioctl(SocketType::socket_, request, &value) < 0) {
+    SocketType::ParseErrnoAndThrow("Can't get socket queue size.");
+  }
+  return value;
+}
+
+template <ProtocolFamily ProtoFamily>
+bool UdpSocket<ProtoFamily>::IsDeferredError(const int error) {
+  return error == ECONNREFUSED || error == EHOSTUNREACH || error == ENETUNREACH;
+}
+
+template <ProtocolFamily ProtoFamily>
+void UdpSocket<ProtoFamily>::SendHeaders(const std::span<mmsghdr> headers) const {
+  size_t send_count = 0;
+  // Повтор допускается один раз подряд: ошибка, повторившаяся сразу, относится к этой отправке.
+  bool deferred_error_skipped = false;
+  while (send_count < headers.size()) {
+    const int cur_send_count =
+        sendmmsg(SocketType::socket_, headers.data() + send_count, headers.size() - send_count, 0);
+    if (cur_send_count < 0) {
+      if (!deferred_error_skipped && IsDeferredError(errno)) {
+        deferred_error_skipped = true;
+        continue;
+      }
+      SocketType::ParseErrnoAndThrow("Can't send.");
+    }
+    deferred_error_skipped = false;
+    send_count += cur_send_count;
+  }
+}
+
+template <ProtocolFamily ProtoFamily>
+void UdpSocket<ProtoFamily>::SplitGroBuffer(
+    const msghdr &header, const DatagramView &buffer, std::vector<DatagramView> &datagrams
+) {
+  size_t segment_size = 0;
+  for (auto *control = CMSG_FIRSTHDR(&header); control != nullptr;
+       control = CMSG_NXTHDR(const_cast<msghdr *>(&header), control)) {
+    if (control->cmsg_level == SOL_UDP && control->cmsg_type == UDP_GRO) {
+      int gso_size = 0;
+      std::memcpy(&gso_size, CMSG_DATA(control), sizeof(gso_size));
+      segment_size = gso_size;
+    }
+  }
+  if (segment_size == 0 || segment_size >= buffer.size) {
+    datagrams.push_back(buffer);
+    return;
+  }
+  for (size_t offset = 0; offset < buffer.size; offset += segment_size) {
+    const auto size = std::min(segment_size, buffer.size - offset);
+    datagrams.push_back(
+        {.buffer = buffer.buffer.subspan(offset, size), .size = size, .end_point = buffer.end_point}
+    );
+  }
 }
 
 }  // namespace socket_wrapper::udp
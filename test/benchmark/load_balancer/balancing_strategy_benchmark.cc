@@ -0,0 +1,89 @@
+#include "balancing/balancing_strategy.h"
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+namespace load_balancer::benchmark {
+
+using balancing::BalancingStrategyType;
+using balancing::CreateBalancingStrategy;
+using balancing::ServerInfo;
+using balancing::ServerLatency;
+
+namespace {
+
+constexpr std::size_t kServerCount = 16;
+constexpr std::size_t kBatchSize = 64;
+
+std::vector<ServerInfo> MakeServers() {
+  std::vector<ServerInfo> servers;
+  for (std::size_t i = 0; i < kServerCount; ++i) {
+    servers.push_back({.key = i * 0x9E3779B97F4A7C15ULL, .weight = i % 3 + 1});
+  }
+  return servers;
+}
+
+/**
+ * \brief Стратегия указанного типа; задержки серверов peak-EWMA измерены по одному ответу.
+ */
+std::unique_ptr<balancing::BalancingStrategy> CreateStrategy(const std::int64_t type) {
+  const auto latency = std::make_shared<ServerLatency>(kServerCount, std::chrono::seconds(10));
+  const auto now = ServerLatency::Clock::now();
+  for (std::size_t i = 0; i < kServerCount; ++i) {
+    latency->OnSent(i, now);
+    latency->OnReply(i, now + std::chrono::microseconds(100 * (i + 1)));
+  }
+  return CreateBalancingStrategy(static_cast<BalancingStrategyType>(type), MakeServers(), latency);
+}
+
+/**
+ * \brief Выбор сервера для одного запроса.
+ */
+void BM_SelectServer(::benchmark::State &state) {
+  static const auto strategy = CreateStrategy(state.range(0));
+  std::size_t client_hash = static_cast<std::size_t>(state.thread_index());
+  for (auto _ : state) {
+    ::benchmark::DoNotOptimize(strategy->SelectServer(client_hash));
+    client_hash += 0x9E3779B97F4A7C15ULL;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+/**
+ * \brief Выбор серверов для пачки запросов.
+ */
+void BM_SelectServers(::benchmark::State &state) {
+  const auto strategy = CreateStrategy(state.range(0));
+  std::vector<std::size_t> client_hashes(kBatchSize);
+  std::iota(client_hashes.begin(), client_hashes.end(), 0);
+  std::vector<std::size_t> server_indexes(kBatchSize);
+  for (auto _ : state) {
+    strategy->SelectServers(client_hashes, server_indexes);
+    ::benchmark::DoNotOptimize(server_indexes.data());
+    ::benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * kBatchSize);
+}
+
+void StrategyArgs(::benchmark::internal::Benchmark *benchmark) {
+  benchmark->ArgName("strategy");
+  for (const auto type :
+       {BalancingStrategyType::kRoundRobin,
+        BalancingStrategyType::kWeightedRoundRobin,
+        BalancingStrategyType::kPowerOfTwoChoices,
+        BalancingStrategyType::kMaglev,
+        BalancingStrategyType::kPeakEwma}) {
+    benchmark->Arg(static_cast<int>(type));
+  }
+}
+
+}  // namespace
+
+BENCHMARK(BM_SelectServer)->Apply(StrategyArgs)->ThreadRange(1, 8);
+BENCHMARK(BM_SelectServers)->Apply(StrategyArgs);
+
+}  // namespace load_balancer::benchmark
@@ -0,0 +1,127 @@
+#include "configuration/configuration.h"
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+#include "configuration/converters.h"
+#include "load_balancer.h"
+
+namespace load_balancer::benchmark {
+
+using config::StringConverter;
+using EndPointType = LoadBalancer::EndPointType;
+using ServerType = LoadBalancer::ServerType;
+using Servers = std::vector<ServerType>;
+
+namespace {
+
+/**
+ * \brief Конфигурация со значениями, заданными строками, как после чтения файла.
+ */
+class StringConfiguration : public config::Configuration {
+ public:
+  StringConfiguration() : Configuration("") {
+    params_[LoadBalancer::kMaxRpsKey] = std::string("1000");
+    params_[LoadBalancer::kServersKey] =
+        std::string("127.0.0.1:10002,127.0.0.1:10003@2,127.0.0.1:10004");
+  }
+};
+
+/**
+ * \brief Чтение и проверка всех параметров балансировщика по схеме, выполняемые при запуске
+ * и перезагрузке конфигурации.
+ */
+void BM_ParseSettings(::benchmark::State &state) {
+  const StringConfiguration configuration;
+  for (auto _ : state) {
+    ::benchmark::DoNotOptimize(LoadBalancer::ParseSettings(configuration));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+/**
+ * \brief Получение прочитанного параметра - обращение к полю без блокировок.
+ */
+void BM_ReadSetting(::benchmark::State &state) {
+  const auto settings = LoadBalancer::ParseSettings(StringConfiguration());
+  for (auto _ : state) {
+    ::benchmark::DoNotOptimize(settings.max_rps);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+/**
+ * \brief Значение свойства в виде строки, преобразуемое в указанный тип.
+ */
+template <typename T>
+std::string StringValue();
+
+template <>
+std::string StringValue<std::size_t>() {
+  return "1000";
+}
+
+template <>
+std::string StringValue<bool>() {
+  return "true";
+}
+
+template <>
+std::string StringValue<std::string>() {
+  return "ping";
+}
+
+template <>
+std::string StringValue<EndPointType>() {
+  return "127.0.0.1:10002";
+}
+
+template <>
+std::string StringValue<ServerType>() {
+  return "127.0.0.1:10002@3";
+}
+
+template <>
+std::string StringValue<Servers>() {
+  return "127.0.0.1:10002,127.0.0.1:10003@2,127.0.0.1:10004";
+}
+
+template <>
+std::string StringValue<balancing::BalancingStrategyType>() {
+  return "maglev";
+}
+
+template <>
+std::string StringValue<rate_limiter::RateLimiterType>() {
+  return "token_bucket";
+}
+
+/**
+ * \brief Преобразование строкового значения свойства при чтении конфигурации.
+ */
+template <typename T>
+void BM_StringConverter(::benchmark::State &state) {
+  const StringConverter<T> converter;
+  const auto value = StringValue<T>();
+  for (auto _ : state) {
+    ::benchmark::DoNotOptimize(converter(value));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+}  // namespace
+
+BENCHMARK(BM_ParseSettings);
+BENCHMARK(BM_ReadSetting);
+BENCHMARK_TEMPLATE(BM_StringConverter, std::size_t);
+BENCHMARK_TEMPLATE(BM_StringConverter, bool);
+BENCHMARK_TEMPLATE(BM_StringConverter, std::string);
+BENCHMARK_TEMPLATE(BM_StringConverter, EndPointType);
+BENCHMARK_TEMPLATE(BM_StringConverter, ServerType);
+BENCHMARK_TEMPLATE(BM_StringConverter, Servers);
+BENCHMARK_TEMPLATE(BM_StringConverter, balancing::BalancingStrategyType);
+BENCHMARK_TEMPLATE(BM_StringConverter, rate_limiter::RateLimiterType);
+
+}  // namespace load_balancer::benchmark
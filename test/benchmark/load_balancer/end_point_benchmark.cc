@@ -0,0 +1,69 @@
+#include "end_point.h"
+
+#include <benchmark/benchmark.h>
+
+#include "udp.h"
+
+namespace load_balancer::benchmark {
+
+using EndPointType = socket_wrapper::udp::UdpEndPoint<socket_wrapper::ProtocolFamily::kIpV4>;
+
+namespace {
+
+/**
+ * \brief Разбор адреса отправителя, возвращенного системным вызовом приема.
+ */
+void BM_EndPointParse(::benchmark::State &state) {
+  const EndPointType source("127.0.0.1", 10000);
+  const auto *const address = source.GetAddressImpl();
+  const auto address_len = source.GetAddressLen();
+  for (auto _ : state) {
+    ::benchmark::DoNotOptimize(EndPointType::ParseEndPoint(address, address_len));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+/**
+ * \brief Копирование конечной точки, например, при подстановке адреса сервера в датаграмму.
+ */
+void BM_EndPointCopy(::benchmark::State &state) {
+  const EndPointType source("127.0.0.1", 10000);
+  EndPointType destination;
+  for (auto _ : state) {
+    ::benchmark::DoNotOptimize(&source);
+    destination = source;
+    ::benchmark::DoNotOptimize(&destination);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+/**
+ * \brief Хеш конечной точки клиента, по которому выбирается сервер.
+ */
+void BM_EndPointHash(::benchmark::State &state) {
+  const EndPointType source("127.0.0.1", 10000);
+  for (auto _ : state) {
+    ::benchmark::DoNotOptimize(&source);
+    ::benchmark::DoNotOptimize(source.Hash());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+/**
+ * \brief Создание конечной точки из строки адреса (getaddrinfo).
+ */
+void BM_EndPointFromString(::benchmark::State &state) {
+  for (auto _ : state) {
+    ::benchmark::DoNotOptimize(EndPointType("127.0.0.1", 10000));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+}  // namespace
+
+BENCHMARK(BM_EndPointParse);
+BENCHMARK(BM_EndPointCopy);
+BENCHMARK(BM_EndPointHash);
+BENCHMARK(BM_EndPointFromString);
+
+}  // namespace load_balancer::benchmark
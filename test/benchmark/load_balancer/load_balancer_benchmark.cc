@@ -0,0 +1,249 @@
+#include "load_balancer.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "fake_configuration.h"
+#include "invalid_socket_exception.h"
+
+namespace load_balancer::benchmark {
+
+using namespace std::chrono_literals;
+
+using SocketType = LoadBalancer::SocketType;
+using EndPointType = LoadBalancer::EndPointType;
+using DatagramView = SocketType::DatagramView;
+
+namespace {
+
+constexpr std::uint16_t kReceiverPort = 61000;
+constexpr std::uint16_t kSenderPort = 61001;
+constexpr std::uint16_t kServerPortStart = 61010;
+constexpr std::uint16_t kClientPortStart = 61020;
+constexpr std::size_t kServerCount = 4;
+/// Клиенты с разными портами, чтобы ядро распределяло их между сокетами шардов.
+constexpr std::size_t kClientCount = 8;
+constexpr std::size_t kDatagramSize = 64;
+/// Датаграммы, отправляемые каждым клиентом за одну итерацию.
+constexpr std::size_t kBurstSize = 32;
+constexpr std::size_t kBatchSize = 64;
+/// Время ожидания недоставленных датаграмм, после которого они считаются потерянными.
+constexpr auto kDeliveryTimeout = 200ms;
+/// Время опроса очереди устройства и повторного приема в режиме опроса.
+constexpr auto kBusyPoll = 50us;
+constexpr auto kReceiveSpin = 200us;
+/// Пауза между запросами при измерении задержки: короче повторного приема, как при частых
+/// запросах, но достаточна, чтобы блокирующий поток балансировщика успел уснуть.
+constexpr auto kLatencyPause = 50us;
+
+/**
+ * \brief Режим пересылки при измерении задержки.
+ */
+enum class LatencyMode : std::int64_t {
+  kDirect,    ///< Клиент отправляет запрос серверу напрямую, без балансировщика.
+  kBlocking,  ///< Блокирующий прием в балансировщике.
+  kBusyPoll,  ///< Опрос очереди устройства и повторный прием перед блокирующим приемом.
+};
+
+/**
+ * \brief Сервер, только подсчитывающий принятые датаграммы.
+ */
+class CountingServer {
+ public:
+  explicit CountingServer(const std::uint16_t port) : socket_(port) {
+    thread_ = std::jthread([this] {
+      Worker();
+    });
+  }
+
+  ~CountingServer() {
+    socket_.Close();
+  }
+
+  [[nodiscard]] std::size_t GetReceived() const {
+    return received_.load(std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] EndPointType GetEndPoint() const {
+    return socket_.GetEndPoint();
+  }
+
+ private:
+  SocketType socket_;
+  std::atomic<std::size_t> received_ = 0;
+  std::jthread thread_;
+
+  void Worker() {
+    std::vector<char> buffer(kBatchSize * kDatagramSize);
+    std::vector<DatagramView> datagrams(kBatchSize);
+    for (std::size_t i = 0; i < kBatchSize; ++i) {
+      datagrams[i].buffer = std::span(buffer).subspan(i * kDatagramSize, kDatagramSize);
+    }
+    try {
+      while (true) {
+        received_.fetch_add(socket_.ReceiveBatchFrom(datagrams), std::memory_order_relaxed);
+      }
+    } catch ([[maybe_unused]] const socket_wrapper::InvalidSocketException &ex) {
+    }
+  }
+};
+
+std::size_t CountReceived(const std::vector<std::unique_ptr<CountingServer>> &servers) {
+  std::size_t received = 0;
+  for (const auto &server : servers) {
+    received += server->GetReceived();
+  }
+  return received;
+}
+
+/**
+ * \brief Сквозное перенаправление датаграмм через балансировщик на локальном интерфейсе.
+ *
+ * Каждая итерация отправляет пачку датаграмм от всех клиентов и ожидает их доставки серверам.
+ * Аргументы: количество рабочих потоков балансировщика и режим шардирования.
+ */
+void BM_LoopbackForwarding(::benchmark::State &state) {
+  const auto config = std::make_shared<test::FakeConfiguration>();
+  config->SetReceiverPort(kReceiverPort);
+  config->SetSenderPort(kSenderPort);
+  config->SetMaxRps(std::numeric_limits<std::uint32_t>::max());
+  config->SetBatchSize(kBatchSize);
+  config->SetThreadCount(static_cast<std::size_t>(state.range(0)));
+  config->SetSharded(state.range(1) != 0);
+
+  std::vector<std::unique_ptr<CountingServer>> servers;
+  std::vector<EndPointType> server_end_points;
+  for (std::size_t i = 0; i < kServerCount; ++i) {
+    servers.emplace_back(std::make_unique<CountingServer>(kServerPortStart + i));
+    server_end_points.emplace_back(servers.back()->GetEndPoint());
+  }
+  config->SetServersAddresses(server_end_points);
+
+  LoadBalancer load_balancer(config);
+  load_balancer.Start();
+  const auto receiver = load_balancer.ReceiverEndPoint();
+
+  std::vector<SocketType> clients;
+  for (std::size_t i = 0; i < kClientCount; ++i) {
+    clients.emplace_back(static_cast<std::uint16_t>(kClientPortStart + i));
+  }
+  std::vector<char> payload(kDatagramSize, 'x');
+  const std::vector<DatagramView> burst(
+      kBurstSize, {.buffer = payload, .size = payload.size(), .end_point = receiver}
+  );
+
+  std::size_t sent = 0;
+  std::size_t expected = 0;
+  std::size_t delivered = 0;
+  std::chrono::nanoseconds elapsed{0};
+  for (auto _ : state) {
+    const auto start = std::chrono::steady_clock::now();
+    for (const auto &client : clients) {
+      client.SendBatchTo(burst);
+    }
+    sent += kClientCount * kBurstSize;
+    expected += kClientCount * kBurstSize;
+    const auto deadline = std::chrono::steady_clock::now() + kDeliveryTimeout;
+    while ((delivered = CountReceived(servers)) < expected) {
+      if (std::chrono::steady_clock::now() > deadline) {
+        // Потерянные датаграммы не ожидаются повторно.
+        expected = delivered;
+        break;
+      }
+      std::this_thread::yield();
+    }
+    elapsed += std::chrono::steady_clock::now() - start;
+  }
+  load_balancer.Stop();
+
+  state.SetItemsProcessed(static_cast<std::int64_t>(delivered));
+  state.counters["pps"] =
+      ::benchmark::Counter(static_cast<double>(delivered), ::benchmark::Counter::kIsRate);
+  state.counters["ns_per_packet"] =
+      delivered == 0 ? 0.0
+                     : static_cast<double>(elapsed.count()) / static_cast<double>(delivered);
+  state.counters["delivery_ratio"] =
+      sent == 0 ? 0.0 : static_cast<double>(delivered) / static_cast<double>(sent);
+}
+
+/**
+ * \brief Задержка доставки одиночного запроса серверу на локальном интерфейсе.
+ *
+ * Запросы отправляются по одному с паузой, поэтому поток балансировщика к приходу каждого
+ * запроса бездействует. Задержка, добавленная балансировщиком, - разница процентилей режима
+ * балансировщика и прямой отправки. Аргумент: @link LatencyMode @endlink.
+ */
+void BM_LoopbackLatency(::benchmark::State &state) {
+  const auto mode = static_cast<LatencyMode>(state.range(0));
+  const SocketType server(kServerPortStart);
+  std::unique_ptr<LoadBalancer> load_balancer;
+  auto target = server.GetEndPoint();
+  if (mode != LatencyMode::kDirect) {
+    const auto config = std::make_shared<test::FakeConfiguration>();
+    config->SetReceiverPort(kReceiverPort);
+    config->SetSenderPort(kSenderPort);
+    config->SetMaxRps(std::numeric_limits<std::uint32_t>::max());
+    config->SetThreadCount(1);
+    config->SetServersAddresses({server.GetEndPoint()});
+    if (mode == LatencyMode::kBusyPoll) {
+      config->SetBusyPoll(kBusyPoll, kReceiveSpin);
+    }
+    load_balancer = std::make_unique<LoadBalancer>(config);
+    load_balancer->Start();
+    target = load_balancer->ReceiverEndPoint();
+  }
+
+  const SocketType client(kClientPortStart);
+  std::vector<char> payload(kDatagramSize, 'x');
+  std::vector<char> buffer(kDatagramSize);
+  std::vector<std::chrono::nanoseconds> latencies;
+  for (auto _ : state) {
+    state.PauseTiming();
+    std::this_thread::sleep_for(kLatencyPause);
+    state.ResumeTiming();
+    const auto start = std::chrono::steady_clock::now();
+    client.SendTo(payload, target);
+    static_cast<void>(server.ReceiveFrom(buffer));
+    latencies.push_back(std::chrono::steady_clock::now() - start);
+  }
+  if (load_balancer) {
+    load_balancer->Stop();
+  }
+
+  std::ranges::sort(latencies);
+  const auto percentile = [&latencies](const double rank) {
+    if (latencies.empty()) {
+      return 0.0;
+    }
+    const auto index = static_cast<std::size_t>(rank * static_cast<double>(latencies.size() - 1));
+    return static_cast<double>(latencies[index].count()) / 1000;
+  };
+  state.counters["p50_us"] = percentile(0.5);
+  state.counters["p99_us"] = percentile(0.99);
+}
+
+}  // namespace
+
+BENCHMARK(BM_LoopbackLatency)
+    ->ArgName("mode")
+    ->DenseRange(
+        static_cast<std::int64_t>(LatencyMode::kDirect),
+        static_cast<std::int64_t>(LatencyMode::kBusyPoll)
+    )
+    ->Iterations(2000)
+    ->Unit(::benchmark::kMicrosecond);
+
+BENCHMARK(BM_LoopbackForwarding)
+    ->ArgNames({"threads", "sharded"})
+    ->ArgsProduct({::benchmark::CreateRange(1, 8, 2), {0, 1}})
+    ->UseRealTime()
+    ->Unit(::benchmark::kMicrosecond);
+
+}  // namespace load_balancer::benchmark
@@ -0,0 +1,69 @@
+#include "rate_limiter/rate_limiter.h"
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+
+namespace load_balancer::benchmark {
+
+using rate_limiter::CreateRateLimiter;
+using rate_limiter::RateLimiter;
+using rate_limiter::RateLimiterType;
+
+namespace {
+
+/// Ограничение, которое не достигается за время измерения, чтобы измерялся допуск запроса.
+constexpr std::size_t kMaxRps = 1'000'000'000;
+
+/**
+ * \brief Ограничитель указанного типа, общий для всех потоков измерения.
+ */
+RateLimiter &GetRateLimiter(const std::int64_t type) {
+  static const std::array rate_limiters = {
+      CreateRateLimiter(RateLimiterType::kTokenBucket, kMaxRps),
+      CreateRateLimiter(RateLimiterType::kSlidingWindow, kMaxRps),
+  };
+  return *rate_limiters.at(static_cast<std::size_t>(type));
+}
+
+/**
+ * \brief Допуск одного запроса, выполняемый балансировщиком для каждой датаграммы
+ * (LoadBalancer::AddRequest).
+ */
+void BM_AddRequest(::benchmark::State &state) {
+  auto &rate_limiter = GetRateLimiter(state.range(0));
+  for (auto _ : state) {
+    ::benchmark::DoNotOptimize(rate_limiter.TryAcquire(1));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+/**
+ * \brief Допуск пачки запросов (LoadBalancer::AddRequests).
+ */
+void BM_AddRequests(::benchmark::State &state) {
+  auto &rate_limiter = GetRateLimiter(state.range(0));
+  const auto count = static_cast<std::size_t>(state.range(1));
+  for (auto _ : state) {
+    ::benchmark::DoNotOptimize(rate_limiter.TryAcquire(count));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+
+}  // namespace
+
+BENCHMARK(BM_AddRequest)
+    ->ArgName("type")
+    ->Arg(static_cast<int>(RateLimiterType::kTokenBucket))
+    ->Arg(static_cast<int>(RateLimiterType::kSlidingWindow))
+    ->ThreadRange(1, 8);
+BENCHMARK(BM_AddRequests)
+    ->ArgNames({"type", "count"})
+    ->ArgsProduct(
+        {{static_cast<int>(RateLimiterType::kTokenBucket),
+          static_cast<int>(RateLimiterType::kSlidingWindow)},
+         {32}}
+    )
+    ->ThreadRange(1, 8);
+
+}  // namespace load_balancer::benchmark
@@ -0,0 +1,81 @@
+#include "rate_limiter/source_rate_limiter.h"
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+namespace load_balancer::benchmark {
+
+using rate_limiter::SourceRateLimiter;
+
+namespace {
+
+constexpr std::size_t kMaxRps = 1000;
+constexpr std::size_t kWidth = 4096;
+constexpr std::size_t kDepth = 4;
+constexpr std::size_t kTopK = 16;
+constexpr std::size_t kSourceCount = 1 << 16;
+
+/**
+ * \brief Хеши адресов источников, распределенные равномерно.
+ */
+std::vector<std::uint64_t> MakeSources(const std::size_t count) {
+  std::mt19937_64 random(count);
+  std::vector<std::uint64_t> sources(count);
+  for (auto &source : sources) {
+    source = random();
+  }
+  return sources;
+}
+
+/**
+ * \brief Запросы множества источников, из которых ни один не выделяется нагрузкой.
+ */
+void BM_SourceRateLimiterUniform(::benchmark::State &state) {
+  static SourceRateLimiter rate_limiter(kMaxRps, kWidth, kDepth, kTopK);
+  const auto sources = MakeSources(static_cast<std::size_t>(state.range(0)));
+  const auto now = SourceRateLimiter::Clock::now();
+  std::size_t i = static_cast<std::size_t>(state.thread_index());
+  for (auto _ : state) {
+    ::benchmark::DoNotOptimize(rate_limiter.TryAcquire(sources[i++ % sources.size()], now));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+/**
+ * \brief Запросы, половину которых отправляет один источник, превышающий ограничение.
+ */
+void BM_SourceRateLimiterHeavyHitter(::benchmark::State &state) {
+  static SourceRateLimiter rate_limiter(kMaxRps, kWidth, kDepth, kTopK);
+  const auto sources = MakeSources(kSourceCount);
+  const auto now = SourceRateLimiter::Clock::now();
+  std::size_t i = static_cast<std::size_t>(state.thread_index());
+  for (auto _ : state) {
+    const auto source = (i & 1) != 0 ? sources.front() : sources[i % sources.size()];
+    ::benchmark::DoNotOptimize(rate_limiter.TryAcquire(source, now));
+    ++i;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+/**
+ * \brief Запросы со считыванием текущего времени, как при работе балансировщика.
+ */
+void BM_SourceRateLimiterWithClock(::benchmark::State &state) {
+  SourceRateLimiter rate_limiter(kMaxRps, kWidth, kDepth, kTopK);
+  const auto sources = MakeSources(kSourceCount);
+  std::size_t i = 0;
+  for (auto _ : state) {
+    ::benchmark::DoNotOptimize(rate_limiter.TryAcquire(sources[i++ % sources.size()]));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+}  // namespace
+
+BENCHMARK(BM_SourceRateLimiterUniform)->Arg(256)->Arg(kSourceCount)->ThreadRange(1, 8);
+BENCHMARK(BM_SourceRateLimiterHeavyHitter)->ThreadRange(1, 8);
+BENCHMARK(BM_SourceRateLimiterWithClock);
+
+}  // namespace load_balancer::benchmark
@@ -0,0 +1,276 @@
+#include "balancing/balancing_strategy.h"
+
+#include <gtest/gtest.h>
+
+#include <numeric>
+#include <thread>
+#include <vector>
+
+#include "balancing/maglev_strategy.h"
+#include "balancing/peak_ewma_strategy.h"
+#include "balancing/power_of_two_choices_strategy.h"
+#include "balancing/weighted_round_robin_strategy.h"
+#include "configuration/converters.h"
+#include "load_balancer.h"
+
+namespace load_balancer::test {
+
+using namespace load_balancer::balancing;
+using namespace load_balancer::config;
+
+using ServerType = LoadBalancer::ServerType;
+
+/**
+ * \brief Сведения о серверах с указанными весами, ключ сервера - его индекс.
+ */
+static std::vector<ServerInfo> MakeServers(const std::vector<size_t> &weights) {
+  std::vector<ServerInfo> servers;
+  for (size_t i = 0; i < weights.size(); ++i) {
+    servers.push_back({.key = i, .weight = weights[i]});
+  }
+  return servers;
+}
+
+/**
+ * \brief Выбрать серверы заданное количество раз, хеш клиента каждого выбора - его номер.
+ * \return количество выборов каждого сервера.
+ */
+static std::vector<size_t> CountSelections(
+    BalancingStrategy &strategy, const size_t server_count, const size_t selection_count
+) {
+  std::vector<size_t> selections(server_count);
+  for (size_t i = 0; i < selection_count; ++i) {
+    ++selections.at(strategy.SelectServer(i));
+  }
+  return selections;
+}
+
+TEST(RoundRobinStrategyTest, SelectsServersInTurn) {
+  const auto strategy =
+      CreateBalancingStrategy(BalancingStrategyType::kRoundRobin, MakeServers({5, 1, 1}));
+
+  for (size_t i = 0; i < 10; ++i) {
+    EXPECT_EQ(i % 3, strategy->SelectServer(i));
+  }
+}
+
+TEST(RoundRobinStrategyTest, SelectsBatchInTurn) {
+  const auto strategy =
+      CreateBalancingStrategy(BalancingStrategyType::kRoundRobin, MakeServers({1, 1, 1}));
+  const std::vector<size_t> client_hashes(4);
+  std::vector<size_t> server_indexes(4);
+
+  strategy->SelectServers(client_hashes, server_indexes);
+  EXPECT_EQ(std::vector<size_t>({0, 1, 2, 0}), server_indexes);
+  strategy->SelectServers(client_hashes, server_indexes);
+  EXPECT_EQ(std::vector<size_t>({1, 2, 0, 1}), server_indexes);
+}
+
+TEST(RoundRobinStrategyTest, ConcurrentSelectionIsUniform) {
+  constexpr size_t server_count = 4;
+  constexpr size_t thread_count = 8;
+  constexpr size_t selection_per_thread = 1000;
+  const auto strategy = CreateBalancingStrategy(
+      BalancingStrategyType::kRoundRobin, MakeServers(std::vector<size_t>(server_count, 1))
+  );
+
+  std::vector<std::vector<size_t>> selections(thread_count);
+  {
+    std::vector<std::jthread> threads;
+    for (size_t i = 0; i < thread_count; ++i) {
+      threads.emplace_back([&, i] {
+        selections[i] = CountSelections(*strategy, server_count, selection_per_thread);
+      });
+    }
+  }
+
+  for (size_t server = 0; server < server_count; ++server) {
+    size_t server_selections = 0;
+    for (const auto &thread_selections : selections) {
+      server_selections += thread_selections[server];
+    }
+    EXPECT_EQ(thread_count * selection_per_thread / server_count, server_selections);
+  }
+}
+
+TEST(WeightedRoundRobinStrategyTest, InterleavesSelectionsSmoothly) {
+  WeightedRoundRobinStrategy strategy({5, 1, 1});
+
+  std::vector<size_t> period;
+  for (size_t i = 0; i < 7; ++i) {
+    period.push_back(strategy.SelectServer(0));
+  }
+  EXPECT_EQ(std::vector<size_t>({0, 0, 1, 0, 2, 0, 0}), period);
+}
+
+TEST(WeightedRoundRobinStrategyTest, SelectsProportionallyToWeights) {
+  const std::vector<size_t> weights = {3, 2, 1};
+  WeightedRoundRobinStrategy strategy(weights);
+
+  const auto selections = CountSelections(strategy, weights.size(), 600);
+  EXPECT_EQ(std::vector<size_t>({300, 200, 100}), selections);
+}
+
+TEST(WeightedRoundRobinStrategyTest, ScalesDownHugeWeights) {
+  const std::vector<size_t> weights = {SIZE_MAX / 4, SIZE_MAX / 4 - 1, 1};
+  WeightedRoundRobinStrategy strategy(weights);
+
+  const auto selections = CountSelections(strategy, weights.size(), 10000);
+  EXPECT_NEAR(selections[0], selections[1], 2);
+  EXPECT_LE(selections[2], 2);
+}
+
+TEST(PowerOfTwoChoicesStrategyTest, BalancesEqualServers) {
+  constexpr size_t server_count = 5;
+  constexpr size_t selection_count = 5000;
+  PowerOfTwoChoicesStrategy strategy(std::vector<size_t>(server_count, 1));
+
+  const auto selections = CountSelections(strategy, server_count, selection_count);
+  for (const auto server_selections : selections) {
+    EXPECT_NEAR(selection_count / server_count, server_selections, selection_count / 50);
+  }
+}
+
+TEST(PowerOfTwoChoicesStrategyTest, PrefersHeavierWeights) {
+  const std::vector<size_t> weights = {4, 1, 1, 2};
+  constexpr size_t selection_count = 8000;
+  PowerOfTwoChoicesStrategy strategy(weights);
+
+  const auto selections = CountSelections(strategy, weights.size(), selection_count);
+  EXPECT_GT(selections[0], selections[3]);
+  EXPECT_GT(selections[3], selections[1]);
+  EXPECT_GT(selections[3], selections[2]);
+  for (size_t i = 0; i < weights.size(); ++i) {
+    EXPECT_GT(strategy.GetRecentSends(i), 0);
+  }
+}
+
+TEST(PeakEwmaStrategyTest, PrefersFastServer) {
+  constexpr size_t selection_count = 1000;
+  const auto latency = std::make_shared<ServerLatency>(3, std::chrono::seconds(10));
+  const auto start = ServerLatency::Clock::now();
+  for (size_t server = 0; server < 3; ++server) {
+    latency->OnSent(server, start);
+    latency->OnReply(server, start + std::chrono::milliseconds(server == 1 ? 200 : 2));
+  }
+  PeakEwmaStrategy strategy({1, 1, 1}, latency);
+
+  const auto selections = CountSelections(strategy, 3, selection_count);
+  EXPECT_EQ(0, selections[1]);
+  EXPECT_NEAR(selection_count / 2, selections[0], selection_count / 10);
+  EXPECT_NEAR(selection_count / 2, selections[2], selection_count / 10);
+}
+
+TEST(PeakEwmaStrategyTest, RequiresLatencyOfEveryServer) {
+  EXPECT_THROW(
+      static_cast<void>(
+          CreateBalancingStrategy(BalancingStrategyType::kPeakEwma, MakeServers({1, 1}))
+      ),
+      std::invalid_argument
+  );
+  const auto latency = std::make_shared<ServerLatency>(2, std::chrono::seconds(10));
+  EXPECT_NE(
+      nullptr,
+      CreateBalancingStrategy(BalancingStrategyType::kPeakEwma, MakeServers({1, 1}), latency)
+  );
+}
+
+/**
+ * \brief Индексы серверов, на которые таблица Maglev отображает каждую из своих записей.
+ */
+static std::vector<size_t> LookupAll(BalancingStrategy &strategy) {
+  std::vector<size_t> client_hashes(MaglevStrategy::kTableSize);
+  std::iota(client_hashes.begin(), client_hashes.end(), 0);
+  std::vector<size_t> server_indexes(MaglevStrategy::kTableSize);
+  strategy.SelectServers(client_hashes, server_indexes);
+  return server_indexes;
+}
+
+TEST(MaglevStrategyTest, SelectsSameServerForSameClient) {
+  const auto servers = MakeServers({1, 1, 1, 1});
+  MaglevStrategy strategy(servers);
+  MaglevStrategy same_servers_strategy(servers);
+
+  for (const auto port : {1000, 1001, 60000}) {
+    const auto client_hash = LoadBalancer::EndPointType("10.0.0.1", port).Hash();
+    const auto server = strategy.SelectServer(client_hash);
+    for (size_t i = 0; i < 10; ++i) {
+      EXPECT_EQ(server, strategy.SelectServer(client_hash));
+    }
+    EXPECT_EQ(server, same_servers_strategy.SelectServer(client_hash));
+  }
+}
+
+TEST(MaglevStrategyTest, FillsTableEvenly) {
+  constexpr size_t server_count = 7;
+  MaglevStrategy strategy(MakeServers(std::vector<size_t>(server_count, 1)));
+
+  const auto selections = CountSelections(strategy, server_count, MaglevStrategy::kTableSize);
+  for (const auto server_selections : selections) {
+    EXPECT_NEAR(MaglevStrategy::kTableSize / server_count, server_selections, 1);
+  }
+}
+
+TEST(MaglevStrategyTest, FillsTableProportionallyToWeights) {
+  const std::vector<size_t> weights = {3, 1, 2};
+  MaglevStrategy strategy(MakeServers(weights));
+
+  const auto selections = CountSelections(strategy, weights.size(), MaglevStrategy::kTableSize);
+  for (size_t i = 0; i < weights.size(); ++i) {
+    EXPECT_NEAR(MaglevStrategy::kTableSize * weights[i] / 6, selections[i], weights[i]);
+  }
+}
+
+TEST(MaglevStrategyTest, ServerRemovalCausesMinimalDisruption) {
+  constexpr size_t server_count = 10;
+  constexpr size_t removed_server = 3;
+  auto servers = MakeServers(std::vector<size_t>(server_count, 1));
+  MaglevStrategy strategy(servers);
+  // При перезагрузке конфигурации таблица строится заново по оставшимся серверам.
+  servers.erase(servers.begin() + removed_server);
+  MaglevStrategy remaining_strategy(servers);
+
+  const auto before = LookupAll(strategy);
+  auto after = LookupAll(remaining_strategy);
+  size_t moved = 0;
+  for (size_t i = 0; i < MaglevStrategy::kTableSize; ++i) {
+    // Индексы серверов после удаленного сдвигаются.
+    if (after[i] >= removed_server) {
+      ++after[i];
+    }
+    if (before[i] != removed_server && before[i] != after[i]) {
+      ++moved;
+    }
+  }
+  // Клиенты оставшихся серверов почти не перемещаются.
+  EXPECT_LT(moved, MaglevStrategy::kTableSize / 20);
+}
+
+TEST(MaglevStrategyTest, ZeroWeightCountsAsOne) {
+  MaglevStrategy strategy(MakeServers({0, 1}));
+
+  const auto selections = CountSelections(strategy, 2, MaglevStrategy::kTableSize);
+  EXPECT_NEAR(selections[0], selections[1], 1);
+  EXPECT_THROW(MaglevStrategy({}), std::invalid_argument);
+}
+
+TEST(WeightedEndPointConverterTest, ParsesOptionalWeight) {
+  const auto servers =
+      StringConverter<std::vector<ServerType>>()("10.0.0.1:1001@3,10.0.0.2:1002");
+
+  ASSERT_TRUE(servers);
+  ASSERT_EQ(2, servers->size());
+  EXPECT_EQ(LoadBalancer::EndPointType("10.0.0.1", 1001), (*servers)[0].end_point);
+  EXPECT_EQ(3, (*servers)[0].weight);
+  EXPECT_EQ(LoadBalancer::EndPointType("10.0.0.2", 1002), (*servers)[1].end_point);
+  EXPECT_EQ(ServerType::kDefaultWeight, (*servers)[1].weight);
+}
+
+TEST(WeightedEndPointConverterTest, RejectsInvalidWeight) {
+  EXPECT_FALSE(StringConverter<ServerType>()("10.0.0.1:1001@0"));
+  EXPECT_FALSE(StringConverter<ServerType>()("10.0.0.1:1001@"));
+  EXPECT_FALSE(StringConverter<ServerType>()("10.0.0.1:1001@heavy"));
+  EXPECT_FALSE(StringConverter<ServerType>()("10.0.0.1@3"));
+}
+
+}  // namespace load_balancer::test
@@ -0,0 +1,52 @@
+#include "buffer_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <set>
+
+namespace load_balancer::test {
+
+using socket_wrapper::BufferPool;
+
+TEST(BufferPoolTest, SlotsAreAlignedAndDisjoint) {
+  BufferPool pool(1500, 8);
+  EXPECT_EQ(1536, pool.GetSlotSize());
+
+  std::set<const char *> slots;
+  for (size_t i = 0; i < 8; ++i) {
+    const auto slot = pool.Acquire();
+    EXPECT_EQ(pool.GetSlotSize(), slot.size());
+    EXPECT_EQ(0, reinterpret_cast<std::uintptr_t>(slot.data()) % BufferPool::kSlotAlignment);
+    slots.insert(slot.data());
+  }
+  EXPECT_EQ(8, slots.size());
+  for (auto it = slots.begin(); std::next(it) != slots.end(); ++it) {
+    EXPECT_GE(*std::next(it) - *it, static_cast<std::ptrdiff_t>(pool.GetSlotSize()));
+  }
+}
+
+TEST(BufferPoolTest, ReleasedSlotIsReused) {
+  BufferPool pool(2048, 2);
+  const auto first = pool.Acquire();
+  const auto second = pool.Acquire();
+  EXPECT_EQ(0, pool.GetFreeCount());
+  EXPECT_THROW(static_cast<void>(pool.Acquire()), std::runtime_error);
+
+  pool.Release(second);
+  EXPECT_EQ(1, pool.GetFreeCount());
+  EXPECT_EQ(second.data(), pool.Acquire().data());
+  EXPECT_NE(first.data(), second.data());
+}
+
+TEST(BufferPoolTest, HugePagesFallBackToRegularPages) {
+  BufferPool pool(65536, 4, true);
+  auto slot = pool.Acquire();
+  slot.back() = 'x';
+  EXPECT_EQ('x', slot.back());
+}
+
+TEST(BufferPoolTest, EmptyPoolIsRejected) {
+  EXPECT_THROW(BufferPool(2048, 0), std::invalid_argument);
+}
+
+}  // namespace load_balancer::test
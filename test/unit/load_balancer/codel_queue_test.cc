@@ -0,0 +1,72 @@
+#include "rate_limiter/codel_queue.h"
+
+#include <gtest/gtest.h>
+
+namespace load_balancer::test {
+
+using namespace std::chrono_literals;
+
+using CoDelQueue = rate_limiter::CoDelQueue<int>;
+using Released = std::vector<std::pair<int, CoDelQueue::Duration>>;
+
+TEST(CoDelQueueTest, ShortBurstIsReleasedInOrder) {
+  CoDelQueue queue(16, 5ms, 100ms);
+  const auto start = CoDelQueue::Clock::now();
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_TRUE(queue.Push(i, start));
+  }
+
+  Released released;
+  EXPECT_EQ(0, queue.Pop(4, start + 1ms, released));
+  EXPECT_EQ(0, queue.Pop(10, start + 2ms, released));
+  ASSERT_EQ(10, released.size());
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(i, released[i].first);
+  }
+  EXPECT_EQ(1ms, released.front().second);
+  EXPECT_EQ(2ms, released.back().second);
+  EXPECT_TRUE(queue.Empty());
+}
+
+TEST(CoDelQueueTest, FullQueueRejects) {
+  CoDelQueue queue(2, 5ms, 100ms);
+  const auto now = CoDelQueue::Clock::now();
+  EXPECT_TRUE(queue.Push(1, now));
+  EXPECT_TRUE(queue.Push(2, now));
+  EXPECT_FALSE(queue.Push(3, now));
+  EXPECT_EQ(2, queue.Size());
+}
+
+TEST(CoDelQueueTest, SustainedDelayIsShed) {
+  CoDelQueue queue(1024, 5ms, 100ms);
+  auto now = CoDelQueue::Clock::now();
+  // Постоянная перегрузка: за миллисекунду поступают две датаграммы, допускается одна.
+  std::size_t dropped = 0;
+  std::size_t released_count = 0;
+  int value = 0;
+  for (int ms = 0; ms < 1000; ++ms, now += 1ms) {
+    ASSERT_TRUE(queue.Push(value++, now));
+    ASSERT_TRUE(queue.Push(value++, now));
+    Released released;
+    dropped += queue.Pop(1, now, released);
+    released_count += released.size();
+  }
+
+  EXPECT_GT(dropped, 0);
+  EXPECT_EQ(1000, released_count);
+  // Без отбрасывания задержка первой датаграммы в очереди достигла бы 500 мс.
+  Released released;
+  queue.Pop(1, now, released);
+  EXPECT_LT(released.front().second, 500ms);
+}
+
+TEST(CoDelQueueTest, WaitReturnsOnStop) {
+  CoDelQueue queue(2, 5ms, 100ms);
+  std::stop_source stop;
+  stop.request_stop();
+  EXPECT_FALSE(queue.WaitNotEmpty(stop.get_token()));
+  ASSERT_TRUE(queue.Push(1, CoDelQueue::Clock::now()));
+  EXPECT_TRUE(queue.WaitNotEmpty(stop.get_token()));
+}
+
+}  // namespace load_balancer::test
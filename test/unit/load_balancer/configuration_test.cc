@@ -0,0 +1,153 @@
+#include "configuration/schema.h"
+
+#include <gtest/gtest.h>
+
+#include "load_balancer.h"
+
+namespace load_balancer::test {
+
+using namespace config;
+using namespace std::chrono_literals;
+
+/**
+ * \brief Конфигурация со значениями, заданными строками, как после чтения файла.
+ */
+class StringConfiguration : public Configuration {
+ public:
+  explicit StringConfiguration(const std::vector<std::pair<std::string, std::string>> &params)
+      : Configuration("") {
+    for (const auto &[key, value] : params) {
+      params_[key] = value;
+    }
+  }
+};
+
+TEST(ConfigurationTest, ParsesStringValuesIntoSettings) {
+  const StringConfiguration configuration({
+      {LoadBalancer::kServersKey, "127.0.0.1:10002,127.0.0.1:10003@2"},
+      {LoadBalancer::kMaxRpsKey, "500"},
+      {LoadBalancer::kBalancingStrategyKey, "maglev"},
+      {LoadBalancer::kShardedKey, "true"},
+      {LoadBalancer::kFlowIdleTimeoutKey, "1500"},
+      {LoadBalancer::kHealthCheckPayloadKey, "health"},
+  });
+
+  const auto settings = LoadBalancer::ParseSettings(configuration);
+  ASSERT_EQ(2, settings.servers.size());
+  EXPECT_EQ(10003, settings.servers[1].end_point.GetPort());
+  EXPECT_EQ(2, settings.servers[1].weight);
+  EXPECT_EQ(500, settings.max_rps);
+  EXPECT_EQ(balancing::BalancingStrategyType::kMaglev, settings.balancing_strategy_type);
+  EXPECT_TRUE(settings.sharded);
+  EXPECT_EQ(1500ms, settings.flow_idle_timeout);
+  EXPECT_EQ("health", settings.health_check_payload);
+  // Отсутствующие свойства имеют значения по умолчанию.
+  EXPECT_EQ(LoadBalancer::kDefaultBatchSize, settings.batch_size);
+  EXPECT_EQ(LoadBalancer::kDefaultHealthCheck.timeout, settings.health_check_timeout);
+}
+
+TEST(ConfigurationTest, ReportsEveryInvalidKey) {
+  const StringConfiguration configuration({
+      {LoadBalancer::kServersKey, "127.0.0.1:10002"},
+      {LoadBalancer::kMaxRpsKey, "100o"},
+      {LoadBalancer::kBatchSizeKey, "0"},
+      {LoadBalancer::kRateLimiterKey, "leaky_bucket"},
+      {"max_rsp", "100"},
+  });
+
+  try {
+    static_cast<void>(LoadBalancer::ParseSettings(configuration));
+    FAIL() << "The configuration must be rejected.";
+  } catch (const ConfigurationError &ex) {
+    const std::vector<std::string> expected = {
+        "unknown key 'max_rsp'",
+        "key 'max_rps': cannot parse '100o'",
+        "key 'rate_limiter': cannot parse 'leaky_bucket'",
+        "key 'batch_size': value must be positive",
+    };
+    EXPECT_EQ(expected, ex.GetErrors());
+  }
+}
+
+TEST(ConfigurationTest, RequiresServers) {
+  EXPECT_THROW(
+      static_cast<void>(LoadBalancer::ParseSettings(StringConfiguration({}))), ConfigurationError
+  );
+}
+
+TEST(ConfigurationTest, ReceiveSpinRequiresSocketTransport) {
+  const StringConfiguration configuration({
+      {LoadBalancer::kServersKey, "127.0.0.1:10002"},
+      {LoadBalancer::kReceiveSpinKey, "100"},
+      {LoadBalancer::kTransportKey, "io_uring"},
+  });
+  EXPECT_THROW(static_cast<void>(LoadBalancer::ParseSettings(configuration)), ConfigurationError);
+
+  const StringConfiguration socket_configuration({
+      {LoadBalancer::kServersKey, "127.0.0.1:10002"},
+      {LoadBalancer::kReceiveSpinKey, "100"},
+      {LoadBalancer::kBusyPollKey, "50"},
+  });
+  const auto settings = LoadBalancer::ParseSettings(socket_configuration);
+  EXPECT_EQ(100us, settings.receive_spin);
+  EXPECT_EQ(50us, settings.busy_poll);
+}
+
+TEST(ConfigurationTest, WorkerAutoscaleRequiresSharedSocket) {
+  const StringConfiguration configuration({
+      {LoadBalancer::kServersKey, "127.0.0.1:10002"},
+      {LoadBalancer::kWorkerAutoscaleKey, "true"},
+      {LoadBalancer::kShardedKey, "true"},
+  });
+  EXPECT_THROW(static_cast<void>(LoadBalancer::ParseSettings(configuration)), ConfigurationError);
+
+  const StringConfiguration shared_configuration({
+      {LoadBalancer::kServersKey, "127.0.0.1:10002"},
+      {LoadBalancer::kWorkerAutoscaleKey, "true"},
+      {LoadBalancer::kWorkerScalePeriodKey, "250"},
+      {LoadBalancer::kCpuAffinityKey, "true"},
+  });
+  const auto settings = LoadBalancer::ParseSettings(shared_configuration);
+  EXPECT_TRUE(settings.worker_autoscale);
+  EXPECT_TRUE(settings.cpu_affinity);
+  EXPECT_EQ(250ms, settings.worker_scale_period);
+}
+
+TEST(ConfigurationTest, ReceiverPortsRequireEpoll) {
+  const StringConfiguration configuration({
+      {LoadBalancer::kServersKey, "127.0.0.1:10002"},
+      {LoadBalancer::kReceiverPortsKey, "10004,10005"},
+  });
+  EXPECT_THROW(static_cast<void>(LoadBalancer::ParseSettings(configuration)), ConfigurationError);
+
+  const StringConfiguration epoll_configuration({
+      {LoadBalancer::kServersKey, "127.0.0.1:10002"},
+      {LoadBalancer::kReceiverPortsKey, "10004,10005"},
+      {LoadBalancer::kTransportKey, "epoll"},
+  });
+  const auto settings = LoadBalancer::ParseSettings(epoll_configuration);
+  EXPECT_EQ(TransportType::kEpoll, settings.transport);
+  EXPECT_EQ((std::vector<std::uint16_t>{10004, 10005}), settings.receiver_ports);
+}
+
+TEST(ConfigurationTest, SchemaKnowsEveryKey) {
+  struct Options {
+    std::size_t count = 1;
+    std::chrono::milliseconds period{100};
+  };
+  constexpr Schema schema(
+      Field("count", &Options::count, InRange<std::size_t{1}, std::size_t{8}>, "must be 1..8"),
+      Field("period", &Options::period)
+  );
+  static_assert(schema.HasKey("count"));
+  static_assert(!schema.HasKey("size"));
+
+  const auto options = schema.Parse(StringConfiguration({{"period", "250"}}));
+  EXPECT_EQ(1, options.count);
+  EXPECT_EQ(250ms, options.period);
+  EXPECT_THROW(
+      static_cast<void>(schema.Parse(StringConfiguration({{"count", "9"}}))), ConfigurationError
+  );
+}
+
+}  // namespace load_balancer::test
@@ -1,5 +1,7 @@
 #include "fake_client.h"
 
+#include <poll.h>
+
 namespace load_balancer::test {
 
 FakeClient::FakeClient(const uint16_t port, EndPointType load_balancer_ep)
@@ -20,4 +22,15 @@ std::vector<std::string> FakeClient::Send(const size_t count) const {
   return messages;
 }
 
+std::vector<std::pair<std::string, FakeClient::EndPointType>> FakeClient::Receive(
+    const size_t count, const std::chrono::milliseconds timeout
+) const {
+  std::vector<std::pair<std::string, EndPointType>> replies;
+  pollfd fd = {.fd = socket_.GetNativeHandle(), .events = POLLIN, .revents = 0};
+  while (replies.size() < count && poll(&fd, 1, static_cast<int>(timeout.count())) > 0) {
+    replies.push_back(socket_.ReceiveFrom());
+  }
+  return replies;
+}
+
 }  // namespace load_balancer::test
@@ -27,6 +27,14 @@ class FakeClient {
    * \return отправленные сообщения.
    */
   [[nodiscard]] std::vector<std::string> Send(size_t count) const;
+  /**
+   * \brief Принимать ответы, пока не будет получено заданное количество либо не истечет
+   * время ожидания следующего ответа.
+   * \return пары: ответ - отправитель.
+   */
+  [[nodiscard]] std::vector<std::pair<std::string, EndPointType>> Receive(
+      size_t count, std::chrono::milliseconds timeout
+  ) const;
 
  private:
   SocketType socket_;
@@ -9,18 +9,131 @@ void FakeConfiguration::SetMaxRps(size_t rps) {
   params_[LoadBalancer::kMaxRpsKey] = rps;
 }
 
+void FakeConfiguration::SetMaxRpsPerSource(size_t rps) {
+  params_[LoadBalancer::kMaxRpsPerSourceKey] = rps;
+}
+
 void FakeConfiguration::SetServersAddresses(
     const std::vector<udp::UdpEndPoint<ProtocolFamily::kIpV4>> &end_points
 ) {
-  params_[LoadBalancer::kServersKey] = end_points;
+  std::vector<LoadBalancer::ServerType> servers;
+  for (const auto &end_point : end_points) {
+    servers.push_back({.end_point = end_point});
+  }
+  SetServers(servers);
+}
+
+void FakeConfiguration::SetServers(const std::vector<LoadBalancer::ServerType> &servers) {
+  params_[LoadBalancer::kServersKey] = servers;
 }
 
 void FakeConfiguration::SetReceiverPort(uint16_t port) {
   params_[LoadBalancer::kReceiverPortKey] = port;
 }
 
+void FakeConfiguration::SetReceiverPorts(const std::vector<uint16_t> &ports) {
+  params_[LoadBalancer::kReceiverPortsKey] = ports;
+}
+
 void FakeConfiguration::SetSenderPort(uint16_t port) {
   params_[LoadBalancer::kSenderPortKey] = port;
 }
 
+void FakeConfiguration::SetBatchSize(size_t batch_size) {
+  params_[LoadBalancer::kBatchSizeKey] = batch_size;
+}
+
+void FakeConfiguration::SetSharded(bool sharded) {
+  params_[LoadBalancer::kShardedKey] = sharded;
+}
+
+void FakeConfiguration::SetThreadCount(size_t thread_count) {
+  params_[LoadBalancer::kThreadCountKey] = thread_count;
+}
+
+void FakeConfiguration::SetBusyPoll(
+    std::chrono::microseconds busy_poll, std::chrono::microseconds receive_spin
+) {
+  params_[LoadBalancer::kBusyPollKey] = busy_poll;
+  params_[LoadBalancer::kReceiveSpinKey] = receive_spin;
+}
+
+void FakeConfiguration::SetCpuAffinity(bool cpu_affinity) {
+  params_[LoadBalancer::kCpuAffinityKey] = cpu_affinity;
+}
+
+void FakeConfiguration::SetWorkerAutoscale(bool autoscale, std::chrono::milliseconds scale_period) {
+  params_[LoadBalancer::kWorkerAutoscaleKey] = autoscale;
+  params_[LoadBalancer::kWorkerScalePeriodKey] = scale_period;
+}
+
+void FakeConfiguration::SetRateLimiter(rate_limiter::RateLimiterType type) {
+  params_[LoadBalancer::kRateLimiterKey] = type;
+}
+
+void FakeConfiguration::SetBalancingStrategy(balancing::BalancingStrategyType type) {
+  params_[LoadBalancer::kBalancingStrategyKey] = type;
+}
+
+void FakeConfiguration::SetTransport(TransportType transport) {
+  params_[LoadBalancer::kTransportKey] = transport;
+}
+
+void FakeConfiguration::SetUdpOffload(bool udp_offload) {
+  params_[LoadBalancer::kUdpOffloadKey] = udp_offload;
+}
+
+void FakeConfiguration::SetHealthCheck(const health::HealthCheckOptions &options) {
+  params_[LoadBalancer::kHealthCheckIntervalKey] = options.interval;
+  params_[LoadBalancer::kHealthCheckTimeoutKey] = options.timeout;
+  params_[LoadBalancer::kHealthCheckPayloadKey] = options.payload;
+  params_[LoadBalancer::kHealthCheckExpectReplyKey] = options.expect_reply;
+  params_[LoadBalancer::kUnhealthyThresholdKey] = options.unhealthy_threshold;
+  params_[LoadBalancer::kHealthyThresholdKey] = options.healthy_threshold;
+  params_[LoadBalancer::kEjectionTimeKey] = options.ejection_time;
+}
+
+void FakeConfiguration::SetProxy(bool proxy, size_t max_flows) {
+  params_[LoadBalancer::kProxyKey] = proxy;
+  params_[LoadBalancer::kMaxFlowsKey] = max_flows;
+}
+
+void FakeConfiguration::SetMetricsPort(uint16_t port) {
+  params_[LoadBalancer::kMetricsPortKey] = port;
+}
+
+void FakeConfiguration::SetAdmissionQueue(
+    size_t capacity, std::chrono::milliseconds target, std::chrono::milliseconds interval
+) {
+  params_[LoadBalancer::kAdmissionQueueKey] = capacity;
+  params_[LoadBalancer::kCoDelTargetKey] = target;
+  params_[LoadBalancer::kCoDelIntervalKey] = interval;
+}
+
+void FakeConfiguration::SetCluster(
+    uint16_t port,
+    const std::vector<LoadBalancer::EndPointType> &peers,
+    std::chrono::milliseconds sync_period
+) {
+  params_[LoadBalancer::kClusterPortKey] = port;
+  params_[LoadBalancer::kClusterPeersKey] = peers;
+  params_[LoadBalancer::kClusterSyncPeriodKey] = sync_period;
+}
+
+void FakeConfiguration::SetCapture(
+    const std::string &file_name, size_t buffer, size_t snap_length
+) {
+  params_[LoadBalancer::kCaptureFileKey] = file_name;
+  params_[LoadBalancer::kCaptureBufferKey] = buffer;
+  params_[LoadBalancer::kCaptureSnapLengthKey] = snap_length;
+}
+
+void FakeConfiguration::SetSocketBuffers(
+    const size_t receive_buffer, const size_t send_buffer, const bool force
+) {
+  params_[LoadBalancer::kReceiveBufferKey] = receive_buffer;
+  params_[LoadBalancer::kSendBufferKey] = send_buffer;
+  params_[LoadBalancer::kSocketBufferForceKey] = force;
+}
+
 }  // namespace load_balancer::test
@@ -2,6 +2,8 @@
 #define FAKE_CONFIGURATION_H
 
 #include "configuration/configuration.h"
+#include "load_balancer.h"
+#include "rate_limiter/rate_limiter.h"
 #include "udp_socket.h"
 
 namespace load_balancer::test {
@@ -14,9 +16,39 @@ using namespace socket_wrapper;
 class FakeConfiguration : public config::Configuration {
  public:
   void SetMaxRps(size_t rps);
+  void SetMaxRpsPerSource(size_t rps);
   void SetServersAddresses(const std::vector<udp::UdpEndPoint<ProtocolFamily::kIpV4>> &end_points);
+  void SetServers(const std::vector<LoadBalancer::ServerType> &servers);
   void SetReceiverPort(uint16_t port);
+  void SetReceiverPorts(const std::vector<uint16_t> &ports);
   void SetSenderPort(uint16_t port);
+  void SetBatchSize(size_t batch_size);
+  void SetSharded(bool sharded);
+  void SetThreadCount(size_t thread_count);
+  void SetBusyPoll(std::chrono::microseconds busy_poll, std::chrono::microseconds receive_spin);
+  void SetCpuAffinity(bool cpu_affinity);
+  void SetWorkerAutoscale(bool autoscale, std::chrono::milliseconds scale_period);
+  void SetRateLimiter(rate_limiter::RateLimiterType type);
+  void SetBalancingStrategy(balancing::BalancingStrategyType type);
+  void SetTransport(TransportType transport);
+  void SetUdpOffload(bool udp_offload);
+  void SetHealthCheck(const health::HealthCheckOptions &options);
+  void SetProxy(bool proxy, size_t max_flows = LoadBalancer::kDefaultMaxFlows);
+  void SetMetricsPort(uint16_t port);
+  void SetAdmissionQueue(
+      size_t capacity, std::chrono::milliseconds target, std::chrono::milliseconds interval
+  );
+  void SetCluster(
+      uint16_t port,
+      const std::vector<LoadBalancer::EndPointType> &peers,
+      std::chrono::milliseconds sync_period
+  );
+  void SetCapture(
+      const std::string &file_name,
+      size_t buffer = LoadBalancer::kDefaultCaptureBuffer,
+      size_t snap_length = LoadBalancer::kDefaultCaptureSnapLength
+  );
+  void SetSocketBuffers(size_t receive_buffer, size_t send_buffer, bool force = false);
 };
 
 }  // namespace load_balancer::test
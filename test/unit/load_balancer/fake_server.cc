@@ -4,7 +4,10 @@
 
 namespace load_balancer::test {
 
-FakeServer::FakeServer(const std::uint16_t port) : socket_(port) {
+FakeServer::FakeServer(
+    const std::uint16_t port, const bool echo, const std::chrono::milliseconds reply_delay
+)
+    : socket_(port), echo_(echo), reply_delay_(reply_delay) {
   thread_ = std::jthread([this] {
     Worker();
   });
@@ -28,6 +31,10 @@ void FakeServer::Worker() {
   while (true) {
     try {
       auto &&received = socket_.ReceiveFrom();
+      if (echo_) {
+        std::this_thread::sleep_for(reply_delay_);
+        socket_.SendTo(received.first, received.second);
+      }
       std::lock_guard lock(mutex_);
       received_.emplace_back(received);
     } catch (InvalidSocketException &ex) {
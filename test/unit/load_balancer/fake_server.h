@@ -10,14 +10,20 @@ namespace load_balancer::test {
 /**
  * \brief Класс, имитирующий реальный сервер.
  *
- * Сохраняет все полученные сообщения для дальнейшей проверки в тестах.
+ * Сохраняет все полученные сообщения для дальнейшей проверки в тестах и, при необходимости,
+ * отправляет их обратно отправителю. Задержка ответа имитирует медленный сервер: сообщения
+ * обрабатываются по одному.
  */
 class FakeServer {
  public:
   using SocketType = LoadBalancer::SocketType;
   using EndPointType = LoadBalancer::EndPointType;
 
-  explicit FakeServer(std::uint16_t port);
+  explicit FakeServer(
+      std::uint16_t port,
+      bool echo = false,
+      std::chrono::milliseconds reply_delay = std::chrono::milliseconds(0)
+  );
   ~FakeServer();
 
   [[nodiscard]] const std::vector<std::pair<std::string, EndPointType>> &GetReceived() const;
@@ -25,6 +31,8 @@ class FakeServer {
 
  private:
   SocketType socket_;
+  const bool echo_;
+  const std::chrono::milliseconds reply_delay_;
   std::jthread thread_;
   std::vector<std::pair<std::string, EndPointType>> received_;
   mutable std::mutex mutex_;
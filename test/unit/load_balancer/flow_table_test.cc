@@ -0,0 +1,111 @@
+#include "proxy/flow_table.h"
+
+#include <gtest/gtest.h>
+
+#include <set>
+#include <thread>
+
+#include "load_balancer.h"
+
+namespace load_balancer::test {
+
+using namespace std::chrono_literals;
+
+using EndPointType = LoadBalancer::EndPointType;
+using FlowTable = proxy::FlowTable<EndPointType>;
+
+static EndPointType MakeClient(const size_t id) {
+  return EndPointType("10.0.0." + std::to_string(id % 250 + 1), 1000 + id / 250);
+}
+
+TEST(FlowTableTest, ClientKeepsItsFlow) {
+  FlowTable table(64, 1s);
+  const auto now = FlowTable::Clock::now();
+  const auto client = MakeClient(1);
+
+  EXPECT_FALSE(table.Find(client, client.Hash(), now));
+  const auto flow = table.Insert(client, client.Hash(), 5, now);
+  ASSERT_TRUE(flow);
+
+  EXPECT_EQ(flow, table.Find(client, client.Hash(), now));
+  EXPECT_EQ(5, table.GetServer(*flow));
+  EXPECT_EQ(client, table.GetClient(*flow, now));
+}
+
+TEST(FlowTableTest, ClientsWithSameHashAreDistinguished) {
+  FlowTable table(64, 1s);
+  const auto now = FlowTable::Clock::now();
+  const auto first = MakeClient(1);
+  const auto second = MakeClient(2);
+
+  const auto first_flow = table.Insert(first, 42, 0, now);
+  const auto second_flow = table.Insert(second, 42, 1, now);
+
+  ASSERT_TRUE(first_flow && second_flow);
+  EXPECT_NE(*first_flow, *second_flow);
+  EXPECT_EQ(first_flow, table.Find(first, 42, now));
+  EXPECT_EQ(second_flow, table.Find(second, 42, now));
+}
+
+TEST(FlowTableTest, IdleFlowsExpire) {
+  FlowTable table(64, 100ms);
+  const auto start = FlowTable::Clock::now();
+  const auto idle = MakeClient(1);
+  const auto active = MakeClient(2);
+  const auto idle_flow = table.Insert(idle, idle.Hash(), 0, start);
+  ASSERT_TRUE(idle_flow);
+  ASSERT_TRUE(table.Insert(active, active.Hash(), 0, start));
+
+  EXPECT_TRUE(table.Find(active, active.Hash(), start + 80ms));
+  EXPECT_EQ(1, table.ExpireIdle(start + 150ms));
+
+  EXPECT_FALSE(table.Find(idle, idle.Hash(), start + 150ms));
+  EXPECT_FALSE(table.GetClient(*idle_flow, start + 150ms));
+  EXPECT_TRUE(table.Find(active, active.Hash(), start + 150ms));
+}
+
+TEST(FlowTableTest, MemoryIsBounded) {
+  FlowTable table(8, 1s);
+  ASSERT_EQ(FlowTable::kBucketSize, table.GetCapacity());
+  const auto now = FlowTable::Clock::now();
+
+  for (size_t i = 0; i < table.GetCapacity(); ++i) {
+    EXPECT_TRUE(table.Insert(MakeClient(i), i, 0, now));
+  }
+  EXPECT_FALSE(table.Insert(MakeClient(100), 100, 0, now));
+
+  EXPECT_EQ(table.GetCapacity(), table.ExpireIdle(now + 2s));
+  EXPECT_TRUE(table.Insert(MakeClient(100), 100, 0, now + 2s));
+}
+
+TEST(FlowTableTest, ConcurrentInsertAndFind) {
+  constexpr size_t kThreadCount = 4;
+  constexpr size_t kClientsPerThread = 200;
+  FlowTable table(kThreadCount * kClientsPerThread * 2, 10s);
+  const auto now = FlowTable::Clock::now();
+
+  std::vector<std::jthread> threads;
+  for (size_t t = 0; t < kThreadCount; ++t) {
+    threads.emplace_back([&table, now, t] {
+      for (size_t i = 0; i < kClientsPerThread; ++i) {
+        const auto client = MakeClient(t * kClientsPerThread + i);
+        const auto flow = table.Insert(client, client.Hash(), t, now);
+        ASSERT_TRUE(flow);
+        ASSERT_EQ(flow, table.Find(client, client.Hash(), now));
+      }
+    });
+  }
+  threads.clear();
+
+  std::set<size_t> flows;
+  for (size_t i = 0; i < kThreadCount * kClientsPerThread; ++i) {
+    const auto client = MakeClient(i);
+    const auto flow = table.Find(client, client.Hash(), now);
+    ASSERT_TRUE(flow);
+    EXPECT_EQ(i / kClientsPerThread, table.GetServer(*flow));
+    flows.insert(*flow);
+  }
+  EXPECT_EQ(kThreadCount * kClientsPerThread, flows.size());
+}
+
+}  // namespace load_balancer::test
@@ -2,9 +2,15 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <filesystem>
+#include <format>
+#include <fstream>
+
 #include "fake_client.h"
 #include "fake_configuration.h"
 #include "fake_server.h"
+#include "rate_limiter/token_bucket_rate_limiter.h"
 
 namespace load_balancer::test {
 
@@ -67,6 +73,14 @@ static void VerifyServerRecivedCount(
   EXPECT_EQ(expected_count, actual_messages_count);
 }
 
+static size_t CountServerReceived(const Servers &servers) {
+  size_t messages_count = 0;
+  for (const auto &server : servers) {
+    messages_count += server->GetReceived().size();
+  }
+  return messages_count;
+}
+
 TEST_F(LoadBalancerTest, UniformLoadDistribution) {
   constexpr auto server_count = 10;
   constexpr auto server_port_start = 60010;
@@ -103,4 +117,843 @@ TEST_F(LoadBalancerTest, LoadLimitation) {
   VerifyServerRecivedCount(servers, messages_count, message_count_per_server);
 }
 
+TEST_F(LoadBalancerTest, TokenBucketLoadLimitation) {
+  constexpr auto server_count = 10;
+  constexpr auto server_port_start = 60010;
+  constexpr auto max_rps = 100;
+
+  const auto servers = SetUpFakeServers(server_port_start, server_count);
+  config->SetMaxRps(max_rps);
+  config->SetRateLimiter(rate_limiter::RateLimiterType::kTokenBucket);
+  SetUpLoadBalancer();
+
+  const FakeClient client(60000, load_balancer->ReceiverEndPoint());
+  const auto messages = client.Send(2 * max_rps);
+  std::this_thread::sleep_for(1s);
+
+  // Всплеск допускается сразу, остальные запросы - по мере пополнения корзины за время отправки.
+  const auto admitted = load_balancer->GetMetrics().Get(metrics::Counter::kAdmitted);
+  EXPECT_GE(admitted, rate_limiter::TokenBucketRateLimiter::GetBurst(max_rps));
+  EXPECT_LE(admitted, max_rps);
+  EXPECT_EQ(admitted, CountServerReceived(servers));
+}
+
+TEST_F(LoadBalancerTest, SourceLoadLimitation) {
+  constexpr auto server_count = 10;
+  constexpr auto server_port_start = 60010;
+  constexpr auto message_count_per_server = 10;
+  constexpr auto max_rps_per_source = server_count * message_count_per_server;
+  constexpr auto messages_count = max_rps_per_source;
+
+  const auto servers = SetUpFakeServers(server_port_start, server_count);
+  config->SetMaxRps(SIZE_MAX);
+  config->SetMaxRpsPerSource(max_rps_per_source);
+  SetUpLoadBalancer();
+
+  // Счетчики клиентов сбрасываются каждую секунду, поэтому запросы отправляются в начале секунды.
+  const auto now = steady_clock::now().time_since_epoch();
+  std::this_thread::sleep_for(ceil<seconds>(now) - now);
+  const FakeClient client(60000, load_balancer->ReceiverEndPoint());
+  const auto messages = client.Send(messages_count);
+  const auto rejected = client.Send(messages_count);
+  std::this_thread::sleep_for(1s);
+
+  VerifyServerRecivedCount(servers, messages_count, message_count_per_server);
+}
+
+TEST_F(LoadBalancerTest, MetricsCountDatagrams) {
+  constexpr auto server_count = 10;
+  constexpr auto server_port_start = 60010;
+  constexpr auto max_rps = 100;
+  constexpr auto metrics_port = 60009;
+
+  const auto servers = SetUpFakeServers(server_port_start, server_count);
+  config->SetMaxRps(max_rps);
+  config->SetMetricsPort(metrics_port);
+  SetUpLoadBalancer();
+
+  const FakeClient client(60000, load_balancer->ReceiverEndPoint());
+  const auto messages = client.Send(max_rps);
+  const auto rejected = client.Send(max_rps);
+  std::this_thread::sleep_for(1s);
+
+  const auto &metrics = load_balancer->GetMetrics();
+  EXPECT_EQ(2 * max_rps, metrics.Get(metrics::Counter::kReceived));
+  EXPECT_EQ(max_rps, metrics.Get(metrics::Counter::kAdmitted));
+  EXPECT_EQ(max_rps, metrics.Get(metrics::Counter::kRateLimited));
+  EXPECT_EQ(0, metrics.Get(metrics::Counter::kForwardErrors));
+  EXPECT_EQ(max_rps, CountServerReceived(servers));
+
+  const metrics::MetricsServer::SocketType scraper;
+  scraper.Connect(metrics::MetricsServer::EndPointType("127.0.0.1", metrics_port));
+  scraper.Send("GET /metrics HTTP/1.1\r\n\r\n");
+  const auto response = scraper.Receive();
+  EXPECT_NE(std::string::npos, response.find("\nload_balancer_rate_limited_datagrams_total 100\n"));
+}
+
+TEST_F(LoadBalancerTest, SocketBuffersAreAppliedAndExported) {
+  constexpr auto receive_buffer = 65536;
+  constexpr auto send_buffer = 32768;
+
+  const auto servers = SetUpFakeServers(60010, 1);
+  config->SetSocketBuffers(receive_buffer, send_buffer);
+  SetUpLoadBalancer();
+
+  const FakeClient client(60000, load_balancer->ReceiverEndPoint());
+  const auto messages = client.Send(10);
+  std::this_thread::sleep_for(100ms);
+
+  // Ядро удваивает запрошенный размер буфера.
+  const auto exported = load_balancer->GetMetrics().Export();
+  EXPECT_NE(
+      std::string::npos,
+      exported.find("load_balancer_kernel_dropped_datagrams_total{socket=\"receiver0\"} 0\n")
+  );
+  EXPECT_NE(
+      std::string::npos,
+      exported.find(std::format(
+          "load_balancer_socket_receive_buffer_bytes{{socket=\"receiver0\"}} {}\n",
+          2 * receive_buffer
+      ))
+  );
+  EXPECT_NE(
+      std::string::npos,
+      exported.find(std::format(
+          "load_balancer_socket_send_buffer_bytes{{socket=\"sender0\"}} {}\n", 2 * send_buffer
+      ))
+  );
+  EXPECT_NE(
+      std::string::npos,
+      exported.find("load_balancer_socket_receive_queue_bytes{socket=\"receiver0\"} 0\n")
+  );
+}
+
+TEST_F(LoadBalancerTest, WeightedLoadDistribution) {
+  constexpr auto server_count = 3;
+  constexpr auto server_port_start = 60010;
+  constexpr auto messages_count_per_weight = 10;
+  constexpr auto messages_count = messages_count_per_weight * (1 + 2 + 3);
+
+  const auto servers = SetUpFakeServers(server_port_start, server_count);
+  std::vector<LoadBalancer::ServerType> weighted_servers;
+  for (size_t i = 0; i < server_count; ++i) {
+    weighted_servers.push_back({.end_point = servers[i]->GetEndPoint(), .weight = i + 1});
+  }
+  config->SetServers(weighted_servers);
+  config->SetMaxRps(SIZE_MAX);
+  config->SetBalancingStrategy(balancing::BalancingStrategyType::kWeightedRoundRobin);
+  SetUpLoadBalancer();
+
+  const FakeClient client(60000, load_balancer->ReceiverEndPoint());
+  const auto messages = client.Send(messages_count);
+  std::this_thread::sleep_for(1s);
+
+  for (size_t i = 0; i < server_count; ++i) {
+    EXPECT_EQ(messages_count_per_weight * (i + 1), servers[i]->GetReceived().size());
+  }
+}
+
+TEST_F(LoadBalancerTest, MaglevClientAffinity) {
+  constexpr auto server_count = 5;
+  constexpr auto server_port_start = 60010;
+  constexpr auto client_count = 8;
+  constexpr auto client_port_start = 60100;
+  constexpr auto messages_count_per_client = 10;
+
+  const auto servers = SetUpFakeServers(server_port_start, server_count);
+  config->SetMaxRps(SIZE_MAX);
+  config->SetBalancingStrategy(balancing::BalancingStrategyType::kMaglev);
+  config->SetBatchSize(4);
+  SetUpLoadBalancer();
+
+  std::vector<std::vector<std::string>> client_messages;
+  for (size_t i = 0; i < client_count; ++i) {
+    const FakeClient client(client_port_start + i, load_balancer->ReceiverEndPoint());
+    client_messages.push_back(client.Send(messages_count_per_client));
+  }
+  std::this_thread::sleep_for(1s);
+
+  EXPECT_EQ(client_count * messages_count_per_client, CountServerReceived(servers));
+  for (const auto &messages : client_messages) {
+    // Все сообщения клиента должны попасть на один сервер.
+    size_t receiving_servers = 0;
+    for (const auto &server : servers) {
+      const auto received = std::ranges::count_if(server->GetReceived(), [&](const auto &msg) {
+        return std::ranges::find(messages, msg.first) != messages.end();
+      });
+      if (received > 0) {
+        ++receiving_servers;
+        EXPECT_EQ(messages_count_per_client, received);
+      }
+    }
+    EXPECT_EQ(1, receiving_servers);
+  }
+}
+
+TEST_F(LoadBalancerTest, BatchedUniformLoadDistribution) {
+  constexpr auto server_count = 10;
+  constexpr auto server_port_start = 60010;
+  constexpr auto message_count_per_server = 10;
+  constexpr auto messages_count = server_count * message_count_per_server;
+
+  const auto servers = SetUpFakeServers(server_port_start, server_count);
+  config->SetMaxRps(SIZE_MAX);
+  config->SetBatchSize(16);
+  SetUpLoadBalancer();
+
+  const FakeClient client(60000, load_balancer->ReceiverEndPoint());
+  const auto messages = client.Send(messages_count);
+  std::this_thread::sleep_for(1s);
+
+  VerifyServerRecivedCount(servers, messages_count, message_count_per_server);
+}
+
+TEST_F(LoadBalancerTest, BatchedLoadLimitation) {
+  constexpr auto server_count = 10;
+  constexpr auto server_port_start = 60010;
+  constexpr auto message_count_per_server = 10;
+  constexpr auto max_rps = server_count * message_count_per_server;
+  constexpr auto messages_count = max_rps;
+
+  const auto servers = SetUpFakeServers(server_port_start, server_count);
+  config->SetMaxRps(max_rps);
+  config->SetBatchSize(16);
+  SetUpLoadBalancer();
+
+  const FakeClient client(60000, load_balancer->ReceiverEndPoint());
+  const auto messages = client.Send(messages_count);
+  const auto rejected = client.Send(messages_count);
+  std::this_thread::sleep_for(1s);
+
+  VerifyServerRecivedCount(servers, messages_count, message_count_per_server);
+}
+
+TEST_F(LoadBalancerTest, BusyPollUniformLoadDistribution) {
+  constexpr auto server_count = 10;
+  constexpr auto server_port_start = 60010;
+  constexpr auto message_count_per_server = 10;
+  constexpr auto messages_count = server_count * message_count_per_server;
+
+  const auto servers = SetUpFakeServers(server_port_start, server_count);
+  config->SetMaxRps(SIZE_MAX);
+  config->SetBusyPoll(50us, 200us);
+  SetUpLoadBalancer();
+
+  const FakeClient client(60000, load_balancer->ReceiverEndPoint());
+  const auto messages = client.Send(messages_count);
+  std::this_thread::sleep_for(1s);
+
+  VerifyServerRecivedCount(servers, messages_count, message_count_per_server);
+}
+
+TEST_F(LoadBalancerTest, BatchedBusyPollUniformLoadDistribution) {
+  constexpr auto server_count = 10;
+  constexpr auto server_port_start = 60010;
+  constexpr auto message_count_per_server = 10;
+  constexpr auto messages_count = server_count * message_count_per_server;
+
+  const auto servers = SetUpFakeServers(server_port_start, server_count);
+  config->SetMaxRps(SIZE_MAX);
+  config->SetBatchSize(16);
+  config->SetBusyPoll(0us, 200us);
+  SetUpLoadBalancer();
+
+  const FakeClient client(60000, load_balancer->ReceiverEndPoint());
+  const auto messages = client.Send(messages_count);
+  std::this_thread::sleep_for(1s);
+
+  VerifyServerRecivedCount(servers, messages_count, message_count_per_server);
+}
+
+TEST_F(LoadBalancerTest, CaptureRecordsReceivedDatagrams) {
+  constexpr auto server_count = 2;
+  constexpr auto server_port_start = 60010;
+  constexpr auto messages_count = 20;
+  constexpr std::size_t max_rps = 10;
+
+  const auto file_name = testing::TempDir() + "load_balancer_capture.pcap";
+  const auto servers = SetUpFakeServers(server_port_start, server_count);
+  config->SetMaxRps(max_rps);
+  config->SetBatchSize(4);
+  config->SetCapture(file_name);
+  SetUpLoadBalancer();
+
+  const FakeClient client(60000, load_balancer->ReceiverEndPoint());
+  const auto messages = client.Send(messages_count);
+  std::this_thread::sleep_for(200ms);
+  load_balancer->Stop();
+
+  // Захватываются все принятые датаграммы, в том числе отброшенные ограничением нагрузки.
+  EXPECT_EQ(max_rps, CountServerReceived(servers));
+  capture::PcapReader reader(file_name);
+  std::vector<std::string> captured;
+  while (const auto packet = reader.Next()) {
+    EXPECT_EQ(60000, packet->source.port);
+    EXPECT_EQ(kReceiverPort, packet->destination.port);
+    captured.emplace_back(packet->payload.begin(), packet->payload.end());
+  }
+  // Потоки обработки захватывают датаграммы независимо друг от друга.
+  auto expected = messages;
+  std::ranges::sort(expected);
+  std::ranges::sort(captured);
+  EXPECT_EQ(expected, captured);
+  EXPECT_EQ(0, load_balancer->GetMetrics().Get(metrics::Counter::kCaptureDropped));
+  std::filesystem::remove(file_name);
+}
+
+TEST_F(LoadBalancerTest, ShardedUniformLoadDistribution) {
+  constexpr auto server_count = 10;
+  constexpr auto server_port_start = 60010;
+  constexpr auto message_count_per_server = 10;
+  constexpr auto messages_count = server_count * message_count_per_server;
+
+  const auto servers = SetUpFakeServers(server_port_start, server_count);
+  config->SetMaxRps(SIZE_MAX);
+  config->SetSharded(true);
+  SetUpLoadBalancer();
+
+  const FakeClient client(60000, load_balancer->ReceiverEndPoint());
+  const auto messages = client.Send(messages_count);
+  std::this_thread::sleep_for(1s);
+
+  VerifyServerRecivedCount(servers, messages_count, message_count_per_server);
+}
+
+TEST_F(LoadBalancerTest, PinnedShardedUniformLoadDistribution) {
+  constexpr auto server_count = 10;
+  constexpr auto server_port_start = 60010;
+  constexpr auto message_count_per_server = 10;
+  constexpr auto messages_count = server_count * message_count_per_server;
+
+  const auto servers = SetUpFakeServers(server_port_start, server_count);
+  config->SetMaxRps(SIZE_MAX);
+  config->SetSharded(true);
+  config->SetCpuAffinity(true);
+  SetUpLoadBalancer();
+
+  const FakeClient client(60000, load_balancer->ReceiverEndPoint());
+  const auto messages = client.Send(messages_count);
+  std::this_thread::sleep_for(1s);
+
+  VerifyServerRecivedCount(servers, messages_count, message_count_per_server);
+}
+
+TEST_F(LoadBalancerTest, AutoscaledWorkersForwardAllDatagrams) {
+  constexpr auto server_count = 10;
+  constexpr auto server_port_start = 60010;
+  constexpr auto message_count_per_server = 10;
+  constexpr auto messages_count = server_count * message_count_per_server;
+
+  const auto servers = SetUpFakeServers(server_port_start, server_count);
+  config->SetMaxRps(SIZE_MAX);
+  config->SetThreadCount(4);
+  config->SetCpuAffinity(true);
+  config->SetWorkerAutoscale(true, 20ms);
+  SetUpLoadBalancer();
+
+  const FakeClient client(60000, load_balancer->ReceiverEndPoint());
+  const auto messages = client.Send(messages_count);
+  std::this_thread::sleep_for(1s);
+
+  VerifyServerRecivedCount(servers, messages_count, message_count_per_server);
+}
+
+TEST_F(LoadBalancerTest, ShardedLoadLimitation) {
+  constexpr auto server_count = 10;
+  constexpr auto server_port_start = 60010;
+  constexpr auto client_count = 8;
+  constexpr auto client_port_start = 60100;
+  constexpr auto max_rps = 100;
+
+  const auto servers = SetUpFakeServers(server_port_start, server_count);
+  config->SetMaxRps(max_rps);
+  config->SetSharded(true);
+  SetUpLoadBalancer();
+
+  for (size_t i = 0; i < client_count; ++i) {
+    const FakeClient client(client_port_start + i, load_balancer->ReceiverEndPoint());
+    const auto messages = client.Send(max_rps);
+  }
+  std::this_thread::sleep_for(1s);
+
+  const auto received_count = CountServerReceived(servers);
+  EXPECT_LE(received_count, max_rps);
+  EXPECT_GT(received_count, 0);
+}
+
+TEST_F(LoadBalancerTest, IoUringUniformLoadDistribution) {
+  constexpr auto server_count = 10;
+  constexpr auto server_port_start = 60010;
+  constexpr auto message_count_per_server = 10;
+  constexpr auto messages_count = server_count * message_count_per_server;
+
+  const auto servers = SetUpFakeServers(server_port_start, server_count);
+  config->SetMaxRps(SIZE_MAX);
+  config->SetTransport(TransportType::kIoUring);
+  SetUpLoadBalancer();
+
+  const FakeClient client(60000, load_balancer->ReceiverEndPoint());
+  auto messages = client.Send(messages_count);
+  std::this_thread::sleep_for(1s);
+
+  VerifyServerRecivedCount(servers, messages_count, message_count_per_server);
+  std::vector<std::string> received;
+  for (const auto &server : servers) {
+    for (const auto &[message, sender] : server->GetReceived()) {
+      received.push_back(message);
+    }
+  }
+  std::ranges::sort(messages);
+  std::ranges::sort(received);
+  EXPECT_EQ(messages, received);
+}
+
+TEST_F(LoadBalancerTest, IoUringLoadLimitation) {
+  constexpr auto server_count = 10;
+  constexpr auto server_port_start = 60010;
+  constexpr auto message_count_per_server = 10;
+  constexpr auto max_rps = server_count * message_count_per_server;
+  constexpr auto messages_count = max_rps;
+
+  const auto servers = SetUpFakeServers(server_port_start, server_count);
+  config->SetMaxRps(max_rps);
+  config->SetTransport(TransportType::kIoUring);
+  SetUpLoadBalancer();
+
+  const FakeClient client(60000, load_balancer->ReceiverEndPoint());
+  const auto messages = client.Send(messages_count);
+  const auto rejected = client.Send(messages_count);
+  std::this_thread::sleep_for(1s);
+
+  VerifyServerRecivedCount(servers, messages_count, message_count_per_server);
+}
+
+TEST_F(LoadBalancerTest, IoUringShardedUniformLoadDistribution) {
+  constexpr auto server_count = 10;
+  constexpr auto server_port_start = 60010;
+  constexpr auto message_count_per_server = 10;
+  constexpr auto messages_count = server_count * message_count_per_server;
+
+  const auto servers = SetUpFakeServers(server_port_start, server_count);
+  config->SetMaxRps(SIZE_MAX);
+  config->SetSharded(true);
+  config->SetTransport(TransportType::kIoUring);
+  SetUpLoadBalancer();
+
+  const FakeClient client(60000, load_balancer->ReceiverEndPoint());
+  const auto messages = client.Send(messages_count);
+  std::this_thread::sleep_for(1s);
+
+  VerifyServerRecivedCount(servers, messages_count, message_count_per_server);
+}
+
+TEST_F(LoadBalancerTest, UdpOffloadUniformLoadDistribution) {
+  constexpr auto server_count = 10;
+  constexpr auto server_port_start = 60010;
+  constexpr auto message_count_per_server = 10;
+  constexpr auto messages_count = server_count * message_count_per_server;
+
+  const auto servers = SetUpFakeServers(server_port_start, server_count);
+  config->SetMaxRps(SIZE_MAX);
+  config->SetBatchSize(16);
+  config->SetUdpOffload(true);
+  SetUpLoadBalancer();
+
+  const FakeClient client(60000, load_balancer->ReceiverEndPoint());
+  auto messages = client.Send(messages_count);
+  std::this_thread::sleep_for(1s);
+
+  VerifyServerRecivedCount(servers, messages_count, message_count_per_server);
+}
+
+TEST_F(LoadBalancerTest, EpollUniformLoadDistribution) {
+  constexpr auto server_count = 10;
+  constexpr auto server_port_start = 60010;
+  constexpr auto message_count_per_server = 10;
+  constexpr auto messages_count = server_count * message_count_per_server;
+
+  const auto servers = SetUpFakeServers(server_port_start, server_count);
+  config->SetMaxRps(SIZE_MAX);
+  config->SetBatchSize(8);
+  config->SetThreadCount(2);
+  config->SetTransport(TransportType::kEpoll);
+  SetUpLoadBalancer();
+
+  const FakeClient client(60000, load_balancer->ReceiverEndPoint());
+  const auto messages = client.Send(messages_count);
+  std::this_thread::sleep_for(1s);
+
+  VerifyServerRecivedCount(servers, messages_count, message_count_per_server);
+}
+
+TEST_F(LoadBalancerTest, EpollServesMultipleReceiverPorts) {
+  constexpr auto server_count = 10;
+  constexpr auto server_port_start = 60010;
+  constexpr auto message_count_per_server = 10;
+  constexpr auto messages_count = server_count * message_count_per_server;
+  constexpr std::uint16_t extra_receiver_port = 60005;
+
+  const auto servers = SetUpFakeServers(server_port_start, server_count);
+  config->SetMaxRps(SIZE_MAX);
+  config->SetThreadCount(1);
+  config->SetTransport(TransportType::kEpoll);
+  config->SetReceiverPorts({extra_receiver_port});
+  SetUpLoadBalancer();
+
+  const FakeClient client(60000, load_balancer->ReceiverEndPoint());
+  const FakeClient extra_client(60006, EndPointType("127.0.0.1", extra_receiver_port));
+  const auto messages = client.Send(messages_count / 2);
+  const auto extra_messages = extra_client.Send(messages_count / 2);
+  std::this_thread::sleep_for(1s);
+
+  EXPECT_EQ(messages_count, CountServerReceived(servers));
+  const auto &metrics = load_balancer->GetMetrics();
+  EXPECT_EQ(messages_count, metrics.Get(metrics::Counter::kReceived));
+}
+
+TEST_F(LoadBalancerTest, AdmissionQueueSmoothsBurst) {
+  constexpr auto server_count = 10;
+  constexpr auto server_port_start = 60010;
+  constexpr auto max_rps = 100;
+  constexpr auto messages_count = max_rps + max_rps / 2;
+
+  const auto servers = SetUpFakeServers(server_port_start, server_count);
+  config->SetMaxRps(max_rps);
+  config->SetBatchSize(8);
+  // Задержка допуска сверх ограничения - до 0,5 с, поэтому CoDel не отбрасывает датаграммы.
+  config->SetAdmissionQueue(max_rps, 1s, 1s);
+  SetUpLoadBalancer();
+
+  const FakeClient client(60000, load_balancer->ReceiverEndPoint());
+  const auto messages = client.Send(messages_count);
+  std::this_thread::sleep_for(100ms);
+  EXPECT_GT(messages_count, CountServerReceived(servers));
+  std::this_thread::sleep_for(1s);
+
+  EXPECT_EQ(messages_count, CountServerReceived(servers));
+  const auto &metrics = load_balancer->GetMetrics();
+  EXPECT_EQ(messages_count, metrics.Get(metrics::Counter::kAdmitted));
+  EXPECT_EQ(0, metrics.Get(metrics::Counter::kRateLimited));
+  EXPECT_EQ(0, metrics.Get(metrics::Counter::kQueueDropped));
+  EXPECT_EQ(
+      metrics.Get(metrics::Counter::kQueued), metrics.Get(metrics::Counter::kQueueReleased)
+  );
+  EXPECT_LT(0, metrics.Get(metrics::Counter::kQueued));
+  EXPECT_LT(0, metrics.Get(metrics::Counter::kQueueDelayUs));
+}
+
+TEST_F(LoadBalancerTest, ClusterSharesGlobalRateLimit) {
+  constexpr auto server_count = 10;
+  constexpr auto server_port_start = 60010;
+  constexpr auto max_rps = 100;
+  constexpr std::uint16_t cluster_port = 60030;
+  constexpr std::uint16_t peer_cluster_port = 60031;
+
+  const auto servers = SetUpFakeServers(server_port_start, server_count);
+  config->SetMaxRps(max_rps);
+  config->SetCluster(cluster_port, {EndPointType("127.0.0.1", peer_cluster_port)}, 20ms);
+  const auto peer_config = std::make_shared<FakeConfiguration>();
+  peer_config->SetServers(LoadBalancer::ParseSettings(*config).servers);
+  peer_config->SetMaxRps(max_rps);
+  peer_config->SetReceiverPort(60003);
+  peer_config->SetSenderPort(60004);
+  peer_config->SetCluster(peer_cluster_port, {EndPointType("127.0.0.1", cluster_port)}, 20ms);
+  SetUpLoadBalancer();
+  LoadBalancer peer(peer_config);
+  peer.Start();
+  std::this_thread::sleep_for(200ms);
+
+  // Оба экземпляра без нагрузки: общее ограничение делится между ними поровну.
+  const FakeClient client(60000, load_balancer->ReceiverEndPoint());
+  const auto messages = client.Send(max_rps);
+  std::this_thread::sleep_for(1s);
+
+  const auto received = CountServerReceived(servers);
+  EXPECT_LE(max_rps / 2 - 5, received);
+  EXPECT_GE(max_rps / 2 + 5, received);
+}
+
+TEST_F(LoadBalancerTest, PeakEwmaAvoidsSlowServer) {
+  constexpr auto server_port_start = 60010;
+  constexpr auto messages_count = 200;
+
+  Servers servers;
+  servers.emplace_back(std::make_unique<FakeServer>(server_port_start, true));
+  servers.emplace_back(std::make_unique<FakeServer>(server_port_start + 1, true, 20ms));
+  // Ответ сервера сопоставляется с запросами по адресу отправителя.
+  config->SetServersAddresses(
+      {EndPointType("127.0.0.1", server_port_start),
+       EndPointType("127.0.0.1", server_port_start + 1)}
+  );
+  config->SetMaxRps(SIZE_MAX);
+  config->SetBalancingStrategy(balancing::BalancingStrategyType::kPeakEwma);
+  SetUpLoadBalancer();
+
+  const FakeClient client(60000, load_balancer->ReceiverEndPoint());
+  for (size_t i = 0; i < messages_count; ++i) {
+    client.Send(std::to_string(i));
+    std::this_thread::sleep_for(2ms);
+  }
+  std::this_thread::sleep_for(500ms);
+
+  const auto fast_received = servers[0]->GetReceived().size();
+  const auto slow_received = servers[1]->GetReceived().size();
+  EXPECT_EQ(messages_count, fast_received + slow_received);
+  EXPECT_GT(fast_received, 4 * slow_received);
+}
+
+TEST_F(LoadBalancerTest, PassiveHealthCheckEjectsUnreachableServer) {
+  constexpr auto server_port_start = 60010;
+  constexpr auto messages_count = 60;
+
+  Servers servers;
+  servers.emplace_back(std::make_unique<FakeServer>(server_port_start));
+  servers.emplace_back(std::make_unique<FakeServer>(server_port_start + 1));
+  // На третьем порту никто не принимает датаграммы, ядро отвечает ICMP port unreachable.
+  config->SetServersAddresses(
+      {servers[0]->GetEndPoint(),
+       servers[1]->GetEndPoint(),
+       EndPointType("127.0.0.1", server_port_start + 2)}
+  );
+  config->SetMaxRps(SIZE_MAX);
+  SetUpLoadBalancer();
+
+  const FakeClient client(60000, load_balancer->ReceiverEndPoint());
+  auto messages = client.Send(messages_count);
+  std::this_thread::sleep_for(300ms);
+  const auto received_before_ejection = CountServerReceived(servers);
+  EXPECT_LT(received_before_ejection, messages_count);
+
+  messages = client.Send(messages_count);
+  std::this_thread::sleep_for(1s);
+
+  EXPECT_EQ(received_before_ejection + messages_count, CountServerReceived(servers));
+}
+
+TEST_F(LoadBalancerTest, ActiveHealthCheckReadmitsRecoveredServer) {
+  constexpr auto server_port_start = 60010;
+  constexpr auto messages_count = 30;
+  const health::HealthCheckOptions options = {
+      .interval = 50ms,
+      .timeout = 20ms,
+      .payload = "probe",
+      .unhealthy_threshold = 1,
+      .healthy_threshold = 1,
+      .ejection_time = 0ms
+  };
+
+  Servers servers;
+  servers.emplace_back(std::make_unique<FakeServer>(server_port_start));
+  servers.emplace_back(std::make_unique<FakeServer>(server_port_start + 1));
+  const EndPointType recovering_end_point("127.0.0.1", server_port_start + 2);
+  config->SetServersAddresses(
+      {servers[0]->GetEndPoint(), servers[1]->GetEndPoint(), recovering_end_point}
+  );
+  config->SetMaxRps(SIZE_MAX);
+  config->SetHealthCheck(options);
+  SetUpLoadBalancer();
+
+  std::this_thread::sleep_for(300ms);
+  const FakeClient client(60000, load_balancer->ReceiverEndPoint());
+  auto messages = client.Send(messages_count);
+  std::this_thread::sleep_for(300ms);
+
+  const FakeServer recovered(recovering_end_point.GetPort());
+  std::this_thread::sleep_for(300ms);
+  messages = client.Send(messages_count);
+  std::this_thread::sleep_for(300ms);
+  load_balancer->Stop();
+
+  const auto count_requests = [&options](const FakeServer &server) {
+    return std::ranges::count_if(server.GetReceived(), [&options](const auto &datagram) {
+      return datagram.first != options.payload;
+    });
+  };
+  EXPECT_EQ(2 * messages_count - messages_count / 3,
+            count_requests(*servers[0]) + count_requests(*servers[1]));
+  EXPECT_EQ(messages_count / 3, count_requests(recovered));
+}
+
+TEST_F(LoadBalancerTest, ActiveHealthCheckEjectsServerWithFailingProbeSend) {
+  constexpr auto server_port_start = 60010;
+  constexpr auto messages_count = 30;
+  const health::HealthCheckOptions options = {
+      .interval = 50ms,
+      .timeout = 20ms,
+      .payload = "probe",
+      .unhealthy_threshold = 1,
+      .healthy_threshold = 1,
+      .ejection_time = 0ms
+  };
+
+  Servers servers;
+  servers.emplace_back(std::make_unique<FakeServer>(server_port_start));
+  servers.emplace_back(std::make_unique<FakeServer>(server_port_start + 1));
+  // Отправка на широковещательный адрес без SO_BROADCAST сразу завершается ошибкой.
+  config->SetServersAddresses(
+      {EndPointType("255.255.255.255", server_port_start + 2),
+       servers[0]->GetEndPoint(),
+       servers[1]->GetEndPoint()}
+  );
+  config->SetMaxRps(SIZE_MAX);
+  config->SetHealthCheck(options);
+  SetUpLoadBalancer();
+
+  std::this_thread::sleep_for(300ms);
+  const FakeClient client(60000, load_balancer->ReceiverEndPoint());
+  const auto messages = client.Send(messages_count);
+  std::this_thread::sleep_for(300ms);
+  load_balancer->Stop();
+
+  std::size_t requests = 0;
+  for (const auto &server : servers) {
+    const auto &received = server->GetReceived();
+    const auto probes = std::ranges::count_if(received, [&options](const auto &datagram) {
+      return datagram.first == options.payload;
+    });
+    EXPECT_GT(probes, 0);
+    requests += received.size() - probes;
+  }
+  EXPECT_EQ(messages_count, requests);
+}
+
+TEST_F(LoadBalancerTest, ProxyReturnsRepliesToClients) {
+  constexpr auto server_count = 3;
+  constexpr auto server_port_start = 60010;
+  constexpr auto messages_count = 20;
+
+  Servers servers;
+  std::vector<EndPointType> server_end_points;
+  for (size_t i = 0; i < server_count; ++i) {
+    servers.emplace_back(std::make_unique<FakeServer>(server_port_start + i, true));
+    // Ответ сервера проверяется по адресу отправителя, поэтому адрес указывается явно.
+    server_end_points.emplace_back("127.0.0.1", server_port_start + i);
+  }
+  config->SetServersAddresses(server_end_points);
+  config->SetMaxRps(SIZE_MAX);
+  config->SetProxy(true, 16);
+  SetUpLoadBalancer();
+
+  const FakeClient first_client(60000, load_balancer->ReceiverEndPoint());
+  const FakeClient second_client(60003, load_balancer->ReceiverEndPoint());
+  const auto first_messages = first_client.Send(messages_count);
+  const auto second_messages = second_client.Send(messages_count);
+
+  for (const auto &[client, messages] :
+       {std::pair(&first_client, first_messages), std::pair(&second_client, second_messages)}) {
+    const auto replies = client->Receive(messages_count, 1s);
+    ASSERT_EQ(messages.size(), replies.size());
+    std::vector<std::string> replied;
+    for (const auto &[reply, sender] : replies) {
+      EXPECT_EQ(kReceiverPort, sender.GetPort());
+      replied.push_back(reply);
+    }
+    std::ranges::sort(replied);
+    auto expected = messages;
+    std::ranges::sort(expected);
+    EXPECT_EQ(expected, replied);
+  }
+  // Запросы клиента закреплены за одним сервером.
+  const auto busy_servers = std::ranges::count_if(servers, [](const auto &server) {
+    return !server->GetReceived().empty();
+  });
+  EXPECT_LE(busy_servers, 2);
+}
+
+/**
+ * \brief Записать файл конфигурации балансировщика с заданными серверами и стратегией.
+ */
+static void WriteConfiguration(
+    const std::string &file_name,
+    const std::string &servers,
+    const std::string &balancing_strategy = "round_robin"
+) {
+  // Файл заменяется целиком, как при сохранении текстовым редактором.
+  const auto temp_file_name = file_name + ".tmp";
+  {
+    std::ofstream output(temp_file_name);
+    output << "receiver_port=" << LoadBalancerTest::kReceiverPort << "\n"
+           << "sender_port=" << LoadBalancerTest::kSenderPort << "\n"
+           << "max_rps=1000000\n"
+           << "config_reload=true\n"
+           << "balancing_strategy=" << balancing_strategy << "\n"
+           << "servers=" << servers << "\n";
+  }
+  std::filesystem::rename(temp_file_name, file_name);
+}
+
+TEST(LoadBalancerReloadTest, ReloadRedirectsToNewServers) {
+  constexpr auto message_count = 10;
+
+  const auto file_name = testing::TempDir() + "load_balancer_reload.properties";
+  const FakeServer first_server(60010);
+  const FakeServer second_server(60011);
+  WriteConfiguration(file_name, "127.0.0.1:60010");
+  LoadBalancer load_balancer(std::make_shared<Configuration>(file_name));
+  load_balancer.Start();
+
+  const FakeClient client(60000, load_balancer.ReceiverEndPoint());
+  const auto messages = client.Send(message_count);
+  std::this_thread::sleep_for(200ms);
+  EXPECT_EQ(message_count, first_server.GetReceived().size());
+
+  WriteConfiguration(file_name, "127.0.0.1:60010,127.0.0.1:60011");
+  std::this_thread::sleep_for(500ms);
+  const auto reloaded_messages = client.Send(message_count);
+  std::this_thread::sleep_for(200ms);
+
+  EXPECT_EQ(message_count * 3 / 2, first_server.GetReceived().size());
+  EXPECT_EQ(message_count / 2, second_server.GetReceived().size());
+  load_balancer.Stop();
+  std::filesystem::remove(file_name);
+}
+
+TEST(LoadBalancerReloadTest, ReloadToPeakEwmaStartsLatencyMeasurement) {
+  constexpr auto messages_count = 200;
+
+  const auto file_name = testing::TempDir() + "load_balancer_ewma_reload.properties";
+  const FakeServer fast_server(60010, true);
+  const FakeServer slow_server(60011, true, 20ms);
+  const auto servers = "127.0.0.1:60010,127.0.0.1:60011";
+  WriteConfiguration(file_name, servers);
+  LoadBalancer load_balancer(std::make_shared<Configuration>(file_name));
+  load_balancer.Start();
+
+  WriteConfiguration(file_name, servers, "peak_ewma");
+  std::this_thread::sleep_for(500ms);
+  const FakeClient client(60000, load_balancer.ReceiverEndPoint());
+  for (size_t i = 0; i < messages_count; ++i) {
+    client.Send(std::to_string(i));
+    std::this_thread::sleep_for(2ms);
+  }
+  std::this_thread::sleep_for(500ms);
+  load_balancer.Stop();
+  std::filesystem::remove(file_name);
+
+  const auto fast_received = fast_server.GetReceived().size();
+  const auto slow_received = slow_server.GetReceived().size();
+  EXPECT_EQ(messages_count, fast_received + slow_received);
+  EXPECT_GT(fast_received, 4 * slow_received);
+}
+
+TEST(LoadBalancerReloadTest, InvalidReloadKeepsServers) {
+  constexpr auto message_count = 10;
+
+  const auto file_name = testing::TempDir() + "load_balancer_invalid_reload.properties";
+  const FakeServer server(60010);
+  WriteConfiguration(file_name, "127.0.0.1:60010");
+  LoadBalancer load_balancer(std::make_shared<Configuration>(file_name));
+  load_balancer.Start();
+
+  WriteConfiguration(file_name, "");
+  EXPECT_THROW(load_balancer.Reload(), std::runtime_error);
+  const FakeClient client(60000, load_balancer.ReceiverEndPoint());
+  const auto messages = client.Send(message_count);
+  std::this_thread::sleep_for(200ms);
+
+  EXPECT_EQ(message_count, server.GetReceived().size());
+  load_balancer.Stop();
+  std::filesystem::remove(file_name);
+}
+
 }  // namespace load_balancer::test
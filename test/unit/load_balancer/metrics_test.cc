@@ -0,0 +1,112 @@
+#include "metrics/metrics.h"
+
+#include <gtest/gtest.h>
+
+#include <format>
+#include <thread>
+
+#include "metrics/metrics_server.h"
+
+namespace load_balancer::test {
+
+using namespace metrics;
+
+/**
+ * \brief Выполнить HTTP-запрос GET к серверу счетчиков.
+ * \return ответ целиком.
+ */
+static std::string HttpGet(const MetricsServer::EndPointType &server, const std::string &path) {
+  const MetricsServer::SocketType client;
+  client.Connect(server);
+  client.Send(std::format("GET {} HTTP/1.1\r\nHost: localhost\r\n\r\n", path));
+  return client.Receive();
+}
+
+TEST(MetricsTest, ThreadCountersAreSummedOnExport) {
+  MetricsRegistry registry({"127.0.0.1:1", "127.0.0.1:2"});
+  {
+    std::vector<std::jthread> threads;
+    for (size_t i = 0; i < 4; ++i) {
+      threads.emplace_back([&registry] {
+        auto &metrics = registry.RegisterThread();
+        for (size_t j = 0; j < 1000; ++j) {
+          metrics.Add(Counter::kReceived);
+          metrics.Add(Counter::kReceivedBytes, 10);
+          metrics.AddForwarded(j % 2, 10);
+        }
+      });
+    }
+  }
+
+  EXPECT_EQ(4000, registry.Get(Counter::kReceived));
+  EXPECT_EQ(40000, registry.Get(Counter::kReceivedBytes));
+  EXPECT_EQ(0, registry.Get(Counter::kRateLimited));
+  const auto exported = registry.Export();
+  EXPECT_NE(std::string::npos, exported.find("\nload_balancer_received_datagrams_total 4000\n"));
+  EXPECT_NE(
+      std::string::npos, exported.find("# TYPE load_balancer_received_bytes_total counter\n")
+  );
+  EXPECT_NE(
+      std::string::npos,
+      exported.find("load_balancer_forwarded_datagrams_total{server=\"127.0.0.1:2\"} 2000\n")
+  );
+  EXPECT_NE(
+      std::string::npos,
+      exported.find("load_balancer_forwarded_bytes_total{server=\"127.0.0.1:1\"} 20000\n")
+  );
+}
+
+TEST(MetricsTest, SocketStatsAreExportedNextToRateLimits) {
+  MetricsRegistry registry({});
+  registry.RegisterThread().Add(Counter::kRateLimited, 3);
+  registry.SetSocketStatsSource([] {
+    return std::vector<SocketStats>{
+        {.name = "receiver0", .kernel_dropped = 7, .receive_queue = 100, .receive_buffer = 4608},
+        {.name = "sender0", .send_queue = 200},
+    };
+  });
+
+  const auto exported = registry.Export();
+  const auto rate_limited = exported.find("\nload_balancer_rate_limited_datagrams_total 3\n");
+  const auto kernel_dropped =
+      exported.find("load_balancer_kernel_dropped_datagrams_total{socket=\"receiver0\"} 7\n");
+  ASSERT_NE(std::string::npos, rate_limited);
+  ASSERT_NE(std::string::npos, kernel_dropped);
+  // Ограничения нагрузки и ядро отбрасывают датаграммы в соседних счетчиках.
+  EXPECT_EQ(
+      kernel_dropped,
+      exported.find("load_balancer_kernel_dropped_datagrams_total{socket=", rate_limited)
+  );
+  EXPECT_LT(kernel_dropped, exported.find("load_balancer_forward_errors_total"));
+  EXPECT_NE(
+      std::string::npos, exported.find("# TYPE load_balancer_socket_receive_queue_bytes gauge\n")
+  );
+  EXPECT_NE(
+      std::string::npos,
+      exported.find("load_balancer_socket_receive_queue_bytes{socket=\"receiver0\"} 100\n")
+  );
+  EXPECT_NE(
+      std::string::npos,
+      exported.find("load_balancer_socket_send_queue_bytes{socket=\"sender0\"} 200\n")
+  );
+  EXPECT_NE(
+      std::string::npos,
+      exported.find("load_balancer_socket_receive_buffer_bytes{socket=\"receiver0\"} 4608\n")
+  );
+}
+
+TEST(MetricsTest, ServerExportsMetricsOverHttp) {
+  MetricsRegistry registry({"127.0.0.1:1"});
+  registry.RegisterThread().Add(Counter::kAdmitted, 5);
+  MetricsServer server(0, registry);
+  server.Start();
+
+  const auto response = HttpGet(server.GetEndPoint(), MetricsServer::kMetricsPath);
+  EXPECT_TRUE(response.starts_with("HTTP/1.1 200 OK\r\n"));
+  EXPECT_NE(std::string::npos, response.find("\r\n\r\n# HELP "));
+  EXPECT_NE(std::string::npos, response.find("\nload_balancer_admitted_datagrams_total 5\n"));
+
+  EXPECT_TRUE(HttpGet(server.GetEndPoint(), "/").starts_with("HTTP/1.1 404 Not Found\r\n"));
+}
+
+}  // namespace load_balancer::test
@@ -0,0 +1,288 @@
+#include "rate_limiter/rate_limiter.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <unordered_map>
+#include <thread>
+#include <vector>
+
+#include "rate_limiter/source_rate_limiter.h"
+#include "rate_limiter/token_bucket_rate_limiter.h"
+
+namespace load_balancer::test {
+
+using namespace load_balancer::rate_limiter;
+
+using namespace std::chrono;
+using namespace std::chrono_literals;
+
+using TimePoint = RateLimiter::TimePoint;
+
+class RateLimiterTest : public testing::TestWithParam<RateLimiterType> {
+ public:
+  static constexpr size_t kMaxRps = 1000;
+
+  /// Начальный момент времени, не совпадающий с началом эпохи часов.
+  const TimePoint start = TimePoint(12345678s + 250ms);
+
+  /**
+   * \brief Наибольший всплеск, допускаемый проверяемым ограничителем.
+   */
+  static size_t GetBurst(const size_t max_rps) {
+    return GetParam() == RateLimiterType::kTokenBucket ? TokenBucketRateLimiter::GetBurst(max_rps)
+                                                       : max_rps;
+  }
+};
+
+/**
+ * \brief Одновременно запрашивать допуск запросов из нескольких потоков в один и тот же момент.
+ * \return общее количество допущенных запросов.
+ */
+static size_t AcquireConcurrently(
+    RateLimiter &rate_limiter,
+    const TimePoint now,
+    const size_t thread_count,
+    const size_t attempts_per_thread,
+    const size_t count_per_attempt
+) {
+  std::atomic_size_t admitted = 0;
+  std::atomic_bool go = false;
+  {
+    std::vector<std::jthread> threads;
+    for (size_t i = 0; i < thread_count; ++i) {
+      threads.emplace_back([&] {
+        while (!go.load()) {
+          std::this_thread::yield();
+        }
+        for (size_t j = 0; j < attempts_per_thread; ++j) {
+          admitted += rate_limiter.TryAcquire(count_per_attempt, now);
+        }
+      });
+    }
+    go = true;
+  }
+  return admitted;
+}
+
+TEST_P(RateLimiterTest, AdmitsBurstUpToLimit) {
+  const auto rate_limiter = CreateRateLimiter(GetParam(), kMaxRps);
+
+  EXPECT_EQ(GetBurst(kMaxRps), rate_limiter->TryAcquire(kMaxRps + 10, start));
+  EXPECT_EQ(0, rate_limiter->TryAcquire(1, start));
+  EXPECT_EQ(0, rate_limiter->TryAcquire(1, start + 500us));
+}
+
+TEST_P(RateLimiterTest, AdmitsAgainAfterSecond) {
+  const auto rate_limiter = CreateRateLimiter(GetParam(), kMaxRps);
+
+  EXPECT_EQ(GetBurst(kMaxRps), rate_limiter->TryAcquire(kMaxRps, start));
+  EXPECT_EQ(GetBurst(kMaxRps), rate_limiter->TryAcquire(kMaxRps, start + 1100ms));
+}
+
+TEST_P(RateLimiterTest, SetMaxRpsKeepsHistory) {
+  const auto rate_limiter = CreateRateLimiter(GetParam(), kMaxRps);
+
+  EXPECT_EQ(GetBurst(kMaxRps), rate_limiter->TryAcquire(kMaxRps, start));
+  rate_limiter->SetMaxRps(kMaxRps / 2);
+  EXPECT_EQ(GetBurst(kMaxRps / 2), rate_limiter->TryAcquire(kMaxRps, start + 1100ms));
+  rate_limiter->SetMaxRps(0);
+  EXPECT_EQ(0, rate_limiter->TryAcquire(1, start + 5s));
+}
+
+TEST_P(RateLimiterTest, ReleasedPermitsAreAdmittedAgain) {
+  const auto rate_limiter = CreateRateLimiter(GetParam(), kMaxRps);
+
+  EXPECT_EQ(GetBurst(kMaxRps), rate_limiter->TryAcquire(kMaxRps, start));
+  rate_limiter->Release(3, start);
+  EXPECT_EQ(3, rate_limiter->TryAcquire(kMaxRps, start + 1ms));
+  // Возврат сверх полученного не увеличивает всплеск.
+  rate_limiter->Release(kMaxRps * 10, start + 1ms);
+  EXPECT_EQ(GetBurst(kMaxRps), rate_limiter->TryAcquire(kMaxRps * 10, start + 2ms));
+}
+
+TEST_P(RateLimiterTest, ZeroLimitRejectsEverything) {
+  const auto rate_limiter = CreateRateLimiter(GetParam(), 0);
+
+  EXPECT_EQ(0, rate_limiter->TryAcquire(1, start));
+  EXPECT_EQ(0, rate_limiter->TryAcquire(1, start + 5s));
+}
+
+TEST_P(RateLimiterTest, UnlimitedAdmitsEverything) {
+  const auto rate_limiter = CreateRateLimiter(GetParam(), SIZE_MAX);
+
+  for (size_t i = 0; i < 100; ++i) {
+    EXPECT_EQ(1000, rate_limiter->TryAcquire(1000, start));
+  }
+}
+
+TEST_P(RateLimiterTest, ConcurrentAcquireIsExact) {
+  const auto rate_limiter = CreateRateLimiter(GetParam(), kMaxRps);
+
+  EXPECT_EQ(GetBurst(kMaxRps), AcquireConcurrently(*rate_limiter, start, 8, kMaxRps, 1));
+}
+
+TEST_P(RateLimiterTest, ConcurrentBatchAcquireIsExact) {
+  const auto rate_limiter = CreateRateLimiter(GetParam(), kMaxRps);
+
+  EXPECT_EQ(GetBurst(kMaxRps), AcquireConcurrently(*rate_limiter, start, 8, kMaxRps, 7));
+}
+
+TEST_P(RateLimiterTest, StaleMomentDoesNotExceedLimit) {
+  const auto rate_limiter = CreateRateLimiter(GetParam(), kMaxRps);
+
+  EXPECT_EQ(GetBurst(kMaxRps), rate_limiter->TryAcquire(kMaxRps, start + 100ms));
+  EXPECT_EQ(0, rate_limiter->TryAcquire(kMaxRps, start));
+}
+
+TEST_P(RateLimiterTest, ConcurrentAcquireAtAdjacentMomentsKeepsLimit) {
+  constexpr size_t thread_count = 8;
+  const auto rate_limiter = CreateRateLimiter(GetParam(), kMaxRps);
+
+  std::atomic_size_t admitted = 0;
+  std::atomic_bool go = false;
+  {
+    std::vector<std::jthread> threads;
+    for (size_t i = 0; i < thread_count; ++i) {
+      // Половина потоков использует момент предыдущего подокна.
+      const auto now = i % 2 == 0 ? start : start + 100ms;
+      threads.emplace_back([&, now] {
+        while (!go.load()) {
+          std::this_thread::yield();
+        }
+        for (size_t j = 0; j < kMaxRps; ++j) {
+          admitted += rate_limiter->TryAcquire(1, now);
+        }
+      });
+    }
+    go = true;
+  }
+
+  EXPECT_LE(admitted, kMaxRps);
+}
+
+TEST_P(RateLimiterTest, ConcurrentAcquireKeepsRateOverTime) {
+  constexpr auto seconds = 3;
+  constexpr auto step = 10ms;
+  const auto rate_limiter = CreateRateLimiter(GetParam(), kMaxRps);
+
+  size_t admitted = 0;
+  for (auto now = start; now < start + seconds * 1s; now += step) {
+    admitted += AcquireConcurrently(*rate_limiter, now, 4, 20, 3);
+  }
+
+  // Всплеск в первый момент и пополнение в течение последующих секунд.
+  EXPECT_LE(admitted, kMaxRps * seconds);
+  EXPECT_GE(admitted, kMaxRps * (seconds - 1));
+}
+
+TEST_P(RateLimiterTest, NeverExceedsLimitInAnySecond) {
+  constexpr size_t max_rps = 100;
+  constexpr auto step = 1ms;
+  const auto rate_limiter = CreateRateLimiter(GetParam(), max_rps);
+
+  std::vector<TimePoint> admitted;
+  for (auto now = start; now < start + 5s; now += step) {
+    const auto count = rate_limiter->TryAcquire(3, now);
+    admitted.insert(admitted.end(), count, now);
+  }
+
+  EXPECT_GE(admitted.size(), max_rps * 4);
+  for (size_t first = 0, last = 0; last < admitted.size(); ++last) {
+    while (admitted[last] - admitted[first] >= 1s) {
+      ++first;
+    }
+    ASSERT_LE(last - first + 1, max_rps);
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    RateLimiters,
+    RateLimiterTest,
+    testing::Values(RateLimiterType::kTokenBucket, RateLimiterType::kSlidingWindow)
+);
+
+TEST(TokenBucketRateLimiterTest, RefillsAtConfiguredRate) {
+  const auto start = RateLimiter::TimePoint(1000s);
+  // Всплеск из 10 маркеров и пополнение 91 маркер в секунду: один маркер за ~10.99 мс.
+  TokenBucketRateLimiter rate_limiter(100);
+
+  EXPECT_EQ(10, rate_limiter.TryAcquire(100, start));
+  EXPECT_EQ(9, rate_limiter.TryAcquire(100, start + 100ms));
+  EXPECT_EQ(0, rate_limiter.TryAcquire(100, start + 105ms));
+  EXPECT_EQ(10, rate_limiter.TryAcquire(100, start + 600ms));
+}
+
+TEST(SourceRateLimiterTest, NoisySourceDoesNotStarveOthers) {
+  const auto start = RateLimiter::TimePoint(1000s + 250ms);
+  SourceRateLimiter rate_limiter(100, 1024, 4, 4);
+
+  size_t noisy_admitted = 0;
+  for (size_t i = 0; i < 1000; ++i) {
+    noisy_admitted += rate_limiter.TryAcquire(1, start) ? 1 : 0;
+  }
+  EXPECT_EQ(100, noisy_admitted);
+
+  for (uint64_t source = 2; source < 50; ++source) {
+    for (size_t i = 0; i < 100; ++i) {
+      ASSERT_TRUE(rate_limiter.TryAcquire(source, start));
+    }
+  }
+  EXPECT_FALSE(rate_limiter.TryAcquire(1, start + 500ms));
+}
+
+TEST(SourceRateLimiterTest, AdmitsAgainNextSecond) {
+  const auto start = RateLimiter::TimePoint(1000s);
+  SourceRateLimiter rate_limiter(10, 64, 2, 0);
+
+  for (size_t i = 0; i < 10; ++i) {
+    EXPECT_TRUE(rate_limiter.TryAcquire(7, start));
+  }
+  EXPECT_FALSE(rate_limiter.TryAcquire(7, start + 999ms));
+  EXPECT_TRUE(rate_limiter.TryAcquire(7, start + 1s));
+  EXPECT_EQ(1, rate_limiter.Estimate(7, start + 1s));
+}
+
+TEST(SourceRateLimiterTest, EstimateNeverUnderestimates) {
+  const auto start = RateLimiter::TimePoint(1000s);
+  // Узкий скетч, в котором неизбежны коллизии.
+  SourceRateLimiter rate_limiter(SIZE_MAX, 16, 3, 0);
+
+  std::unordered_map<uint64_t, uint64_t> counts;
+  for (uint64_t i = 0; i < 5000; ++i) {
+    const auto source = (i * 7919) % 200;
+    rate_limiter.TryAcquire(source, start);
+    ++counts[source];
+  }
+  for (const auto &[source, count] : counts) {
+    EXPECT_GE(rate_limiter.Estimate(source, start), count);
+  }
+}
+
+TEST(SourceRateLimiterTest, ReportsHeavyHitters) {
+  const auto start = RateLimiter::TimePoint(1000s);
+  SourceRateLimiter rate_limiter(SIZE_MAX, 4096, 4, 3);
+
+  for (uint64_t source = 100; source < 1100; ++source) {
+    rate_limiter.TryAcquire(source, start);
+  }
+  for (size_t i = 0; i < 300; ++i) {
+    rate_limiter.TryAcquire(1, start);
+    if (i < 200) {
+      rate_limiter.TryAcquire(2, start);
+    }
+    if (i < 100) {
+      rate_limiter.TryAcquire(3, start);
+    }
+  }
+
+  const auto heavy_hitters = rate_limiter.GetHeavyHitters(start);
+  ASSERT_EQ(3, heavy_hitters.size());
+  EXPECT_EQ(1, heavy_hitters[0].source);
+  EXPECT_EQ(2, heavy_hitters[1].source);
+  EXPECT_EQ(3, heavy_hitters[2].source);
+  EXPECT_GE(heavy_hitters[0].count, 300);
+  EXPECT_TRUE(rate_limiter.GetHeavyHitters(start + 1s).empty());
+}
+
+}  // namespace load_balancer::test
@@ -0,0 +1,82 @@
+#include "cluster/rate_share_gossip.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+
+namespace load_balancer::test {
+
+using namespace std::chrono_literals;
+
+using cluster::RateShareGossip;
+using EndPointType = RateShareGossip::EndPointType;
+
+/**
+ * \brief Счетчик нагрузки, растущий с постоянной частотой.
+ */
+static RateShareGossip::LoadCounter ConstantLoad(const std::uint64_t rps) {
+  const auto start = RateShareGossip::Clock::now();
+  return [start, rps] {
+    const auto elapsed = RateShareGossip::Clock::now() - start;
+    return static_cast<std::uint64_t>(elapsed / 1ms) * rps / 1000;
+  };
+}
+
+TEST(RateShareGossipTest, ShareFollowsLoad) {
+  const std::vector<double> idle_peers = {0, 0, 0};
+  EXPECT_DOUBLE_EQ(0.25, RateShareGossip::ComputeShare(0, idle_peers));
+  EXPECT_DOUBLE_EQ(1, RateShareGossip::ComputeShare(100, {}));
+
+  const std::vector<double> peers = {300};
+  const auto share = RateShareGossip::ComputeShare(100, peers);
+  const auto peer_share = RateShareGossip::ComputeShare(300, std::vector<double>{100});
+  EXPECT_DOUBLE_EQ(0.9 * 0.25 + 0.05, share);
+  EXPECT_DOUBLE_EQ(1, share + peer_share);
+}
+
+TEST(RateShareGossipTest, InstancesSplitBudgetByLoad) {
+  constexpr std::uint16_t first_port = 60030;
+  constexpr std::uint16_t second_port = 60031;
+  std::atomic<double> first_share = 0;
+  std::atomic<double> second_share = 0;
+  RateShareGossip first(
+      first_port,
+      {EndPointType("127.0.0.1", second_port)},
+      20ms,
+      ConstantLoad(3000),
+      [&first_share](const double share) { first_share = share; }
+  );
+  RateShareGossip second(
+      second_port,
+      {EndPointType("127.0.0.1", first_port)},
+      20ms,
+      ConstantLoad(1000),
+      [&second_share](const double share) { second_share = share; }
+  );
+  first.Start();
+  second.Start();
+  std::this_thread::sleep_for(500ms);
+  first.Stop();
+  second.Stop();
+
+  EXPECT_NEAR(0.9 * 0.75 + 0.05, first_share.load(), 0.05);
+  EXPECT_NEAR(0.9 * 0.25 + 0.05, second_share.load(), 0.05);
+}
+
+TEST(RateShareGossipTest, UnreachablePeerIsExcluded) {
+  std::atomic<double> share = 0;
+  RateShareGossip gossip(
+      60030,
+      {EndPointType("127.0.0.1", 60032)},
+      10ms,
+      ConstantLoad(1000),
+      [&share](const double value) { share = value; }
+  );
+  gossip.Start();
+  std::this_thread::sleep_for(200ms);
+  gossip.Stop();
+
+  EXPECT_DOUBLE_EQ(1, share.load());
+}
+
+}  // namespace load_balancer::test
@@ -0,0 +1,110 @@
+#include "rcu/rcu_pointer.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace load_balancer::test {
+
+using namespace rcu;
+using namespace std::chrono_literals;
+
+/**
+ * \brief Значение, отмечающее свое удаление.
+ */
+struct TrackedValue {
+  int first;
+  int second;
+  std::atomic<bool> *deleted;
+
+  TrackedValue(const int value, std::atomic<bool> *deleted)
+      : first(value), second(value), deleted(deleted) {
+  }
+
+  ~TrackedValue() {
+    if (deleted) {
+      *deleted = true;
+    }
+  }
+};
+
+TEST(RcuPointerTest, ReadSeesLatestValue) {
+  RcuPointer<int> pointer(std::make_unique<int>(1));
+  const auto reader = pointer.RegisterReader();
+  EXPECT_EQ(1, *reader.Read());
+
+  pointer.Update(std::make_unique<int>(2));
+  EXPECT_EQ(2, *reader.Read());
+  EXPECT_EQ(2, pointer.Get());
+}
+
+TEST(RcuPointerTest, UpdateWaitsForStartedReads) {
+  std::atomic<bool> deleted = false;
+  RcuPointer<TrackedValue> pointer(std::make_unique<TrackedValue>(1, &deleted));
+  const auto reader = pointer.RegisterReader();
+  std::atomic<bool> updated = false;
+  std::jthread updater;
+  {
+    const auto value = reader.Read();
+    updater = std::jthread([&pointer, &updated] {
+      pointer.Update(std::make_unique<TrackedValue>(2, nullptr));
+      updated = true;
+    });
+    std::this_thread::sleep_for(50ms);
+    EXPECT_FALSE(updated);
+    EXPECT_FALSE(deleted);
+    EXPECT_EQ(1, value->first);
+  }
+  updater.join();
+  EXPECT_TRUE(updated);
+  EXPECT_TRUE(deleted);
+  EXPECT_EQ(2, reader.Read()->first);
+}
+
+TEST(RcuPointerTest, ReleasedReaderDoesNotBlockUpdate) {
+  RcuPointer<int> pointer(std::make_unique<int>(1));
+  {
+    const auto reader = pointer.RegisterReader();
+    const auto value = reader.Read();
+  }
+  pointer.Update(std::make_unique<int>(2));
+  const auto reader = pointer.RegisterReader();
+  EXPECT_EQ(2, *reader.Read());
+}
+
+TEST(RcuPointerTest, ConcurrentReadsSeeConsistentValues) {
+  constexpr auto reader_count = 4;
+  constexpr auto update_count = 1000;
+
+  RcuPointer<TrackedValue> pointer(std::make_unique<TrackedValue>(0, nullptr));
+  std::atomic<bool> stop = false;
+  std::atomic<size_t> inconsistent = 0;
+  {
+    std::vector<std::jthread> readers;
+    for (size_t i = 0; i < reader_count; ++i) {
+      readers.emplace_back([&pointer, &stop, &inconsistent] {
+        const auto reader = pointer.RegisterReader();
+        int last = 0;
+        while (!stop) {
+          const auto value = reader.Read();
+          // Значения не убывают, а удаленный объект не читается.
+          if (value->first != value->second || value->first < last) {
+            ++inconsistent;
+          }
+          last = value->first;
+        }
+      });
+    }
+    for (int i = 1; i <= update_count; ++i) {
+      pointer.Update(std::make_unique<TrackedValue>(i, nullptr));
+    }
+    stop = true;
+  }
+
+  EXPECT_EQ(0, inconsistent);
+  EXPECT_EQ(update_count, pointer.Get().first);
+}
+
+}  // namespace load_balancer::test
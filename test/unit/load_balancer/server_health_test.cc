@@ -0,0 +1,57 @@
+#include "health/server_health.h"
+
+#include <gtest/gtest.h>
+
+#include <set>
+
+namespace load_balancer::test {
+
+using health::ServerHealth;
+
+TEST(ServerHealthTest, HealthyServerIsKept) {
+  const ServerHealth health(4);
+  for (size_t server = 0; server < 4; ++server) {
+    for (size_t client = 0; client < 100; ++client) {
+      EXPECT_EQ(server, health.Redirect(server, client));
+    }
+  }
+}
+
+TEST(ServerHealthTest, EjectedServerIsReplacedByHealthyOnes) {
+  ServerHealth health(4);
+  EXPECT_TRUE(health.SetHealthy(1, false));
+  EXPECT_FALSE(health.SetHealthy(1, false));
+
+  std::set<size_t> replacements;
+  for (size_t client = 0; client < 100; ++client) {
+    const auto server = health.Redirect(1, client);
+    EXPECT_TRUE(health.IsHealthy(server));
+    EXPECT_EQ(server, health.Redirect(1, client));
+    replacements.insert(server);
+  }
+  EXPECT_EQ(std::set<size_t>({0, 2, 3}), replacements);
+
+  EXPECT_TRUE(health.SetHealthy(1, true));
+  EXPECT_EQ(1, health.Redirect(1, 0));
+}
+
+TEST(ServerHealthTest, BatchIsRedirected) {
+  ServerHealth health(3);
+  health.SetHealthy(0, false);
+  health.SetHealthy(2, false);
+  const std::vector<size_t> client_hashes = {5, 6, 7, 8};
+  std::vector<size_t> server_indexes = {0, 1, 2, 0};
+
+  health.Redirect(client_hashes, server_indexes);
+
+  EXPECT_EQ(std::vector<size_t>({1, 1, 1, 1}), server_indexes);
+}
+
+TEST(ServerHealthTest, SelectionIsKeptWhenAllServersAreEjected) {
+  ServerHealth health(2);
+  health.SetHealthy(0, false);
+  health.SetHealthy(1, false);
+  EXPECT_EQ(1, health.Redirect(1, 42));
+}
+
+}  // namespace load_balancer::test
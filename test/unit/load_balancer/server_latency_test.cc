@@ -0,0 +1,80 @@
+#include "balancing/server_latency.h"
+
+#include <gtest/gtest.h>
+
+namespace load_balancer::test {
+
+using namespace std::chrono_literals;
+
+using balancing::ServerLatency;
+
+TEST(ServerLatencyTest, ReplyMeasuresOldestRequest) {
+  ServerLatency latency(2, 10s);
+  const auto start = ServerLatency::Clock::now();
+  latency.OnSent(0, start);
+  latency.OnSent(0, start + 5ms);
+  EXPECT_EQ(2, latency.GetOutstanding(0));
+  EXPECT_EQ(0, latency.GetOutstanding(1));
+
+  latency.OnReply(0, start + 10ms);
+  EXPECT_EQ(10ms, latency.GetLatency(0));
+  EXPECT_EQ(1, latency.GetOutstanding(0));
+  latency.OnReply(0, start + 11ms);
+  EXPECT_EQ(0, latency.GetOutstanding(0));
+
+  // Ответ без ожидающего запроса не измеряет задержку.
+  latency.OnReply(0, start + 12ms);
+  EXPECT_EQ(0, latency.GetOutstanding(0));
+}
+
+TEST(ServerLatencyTest, PeakIsTakenAtOnceAndDecaysSlowly) {
+  ServerLatency latency(1, 100ms);
+  const auto start = ServerLatency::Clock::now();
+  latency.OnSent(0, start);
+  latency.OnReply(0, start + 2ms);
+  latency.OnSent(0, start + 10ms);
+  latency.OnReply(0, start + 210ms);
+  EXPECT_EQ(200ms, latency.GetLatency(0));
+
+  latency.OnSent(0, start + 220ms);
+  latency.OnReply(0, start + 222ms);
+  EXPECT_GT(latency.GetLatency(0), 100ms);
+  EXPECT_LT(latency.GetLatency(0), 200ms);
+}
+
+TEST(ServerLatencyTest, LostRequestsExpire) {
+  ServerLatency latency(1, 10s);
+  const auto start = ServerLatency::Clock::now();
+  latency.OnSent(0, start);
+  latency.OnSent(0, start + ServerLatency::kReplyTimeout);
+  latency.OnReply(0, start + ServerLatency::kReplyTimeout + 3ms);
+
+  EXPECT_EQ(3ms, latency.GetLatency(0));
+  EXPECT_EQ(0, latency.GetOutstanding(0));
+
+  for (size_t i = 0; i < 2 * ServerLatency::kMaxOutstanding; ++i) {
+    latency.OnSent(0, start);
+  }
+  EXPECT_EQ(ServerLatency::kMaxOutstanding, latency.GetOutstanding(0));
+}
+
+TEST(ServerLatencyTest, CostGrowsWithLatencyAndOutstanding) {
+  ServerLatency latency(3, 10s);
+  const auto start = ServerLatency::Clock::now();
+  for (size_t server = 0; server < 2; ++server) {
+    latency.OnSent(server, start);
+    latency.OnReply(server, start + (server + 1) * 10ms);
+  }
+  const auto now = start + 20ms;
+  EXPECT_LT(latency.GetCost(0, now), latency.GetCost(1, now));
+  latency.OnSent(0, now);
+  latency.OnSent(0, now);
+  EXPECT_GT(latency.GetCost(0, now), latency.GetCost(1, now));
+
+  // Сервер без измерений сначала пробуется, а после отправки без ответа избегается.
+  EXPECT_EQ(0, latency.GetCost(2, now));
+  latency.OnSent(2, now);
+  EXPECT_GT(latency.GetCost(2, now), latency.GetCost(0, now));
+}
+
+}  // namespace load_balancer::test
@@ -0,0 +1,132 @@
+#include "capture/traffic_capture.h"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+#include "capture/pcap_file.h"
+#include "load_balancer.h"
+
+namespace load_balancer::test {
+
+using namespace std::chrono_literals;
+
+using capture::PacketAddress;
+using capture::PcapReader;
+using capture::PcapWriter;
+using capture::TrafficCapture;
+
+TEST(PcapFileTest, WrittenDatagramsAreReadBack) {
+  const auto file_name = testing::TempDir() + "pcap_file_test.pcap";
+  const PacketAddress source = {.address = 0x7F000001, .port = 60000};
+  const PacketAddress destination = {.address = 0x0A000002, .port = 10000};
+  const std::string short_payload = "request";
+  const std::string long_payload(100, 'x');
+  {
+    PcapWriter writer(file_name, 16);
+    writer.Write(1'500'000'123ns, source, destination, short_payload, short_payload.size());
+    writer.Write(2s, destination, source, long_payload, long_payload.size());
+  }
+
+  PcapReader reader(file_name);
+  const auto first = reader.Next();
+  ASSERT_TRUE(first);
+  EXPECT_EQ(1'500'000'123ns, first->timestamp);
+  EXPECT_EQ(source, first->source);
+  EXPECT_EQ(destination, first->destination);
+  EXPECT_EQ(short_payload, std::string(first->payload.begin(), first->payload.end()));
+  EXPECT_EQ(short_payload.size(), first->original_size);
+
+  const auto second = reader.Next();
+  ASSERT_TRUE(second);
+  EXPECT_EQ(destination, second->source);
+  EXPECT_EQ(
+      long_payload.substr(0, 16), std::string(second->payload.begin(), second->payload.end())
+  );
+  EXPECT_EQ(long_payload.size(), second->original_size);
+
+  EXPECT_FALSE(reader.Next());
+  EXPECT_EQ(0, reader.GetSkipped());
+  reader.Rewind();
+  EXPECT_TRUE(reader.Next());
+  std::filesystem::remove(file_name);
+}
+
+TEST(PcapFileTest, NotPcapFileIsRejected) {
+  const auto file_name = testing::TempDir() + "pcap_file_invalid.pcap";
+  {
+    std::ofstream output(file_name);
+    output << "servers=127.0.0.1:60010\nmax_rps=1000\n";
+  }
+  EXPECT_THROW(PcapReader{file_name}, std::runtime_error);
+  std::filesystem::remove(file_name);
+  EXPECT_THROW(PcapReader{file_name}, std::runtime_error);
+}
+
+TEST(TrafficCaptureTest, ConcurrentCapturesAreWritten) {
+  constexpr std::size_t thread_count = 4;
+  constexpr std::size_t capture_count = 1000;
+  const auto file_name = testing::TempDir() + "traffic_capture_test.pcap";
+  TrafficCapture capture(file_name, 256, 64);
+  capture.Start();
+  {
+    std::vector<std::jthread> threads;
+    for (std::size_t i = 0; i < thread_count; ++i) {
+      threads.emplace_back([&capture, i] {
+        const PacketAddress source = {.address = 0x7F000001, .port = static_cast<uint16_t>(i)};
+        for (std::size_t j = 0; j < capture_count; ++j) {
+          const auto payload = std::to_string(j);
+          // Буфер освобождается потоком записи, повтор не блокирует его.
+          while (!capture.Capture(payload, source, {})) {
+            std::this_thread::yield();
+          }
+        }
+      });
+    }
+  }
+  capture.Stop();
+  EXPECT_EQ(thread_count * capture_count, capture.GetWritten());
+
+  PcapReader reader(file_name);
+  std::vector<std::size_t> next(thread_count, 0);
+  std::size_t count = 0;
+  while (const auto packet = reader.Next()) {
+    // Датаграммы каждого потока записываются в порядке захвата.
+    auto &expected = next[packet->source.port];
+    EXPECT_EQ(
+        std::to_string(expected), std::string(packet->payload.begin(), packet->payload.end())
+    );
+    ++expected;
+    ++count;
+  }
+  EXPECT_EQ(thread_count * capture_count, count);
+  std::filesystem::remove(file_name);
+}
+
+TEST(TrafficCaptureTest, FullBufferDropsWithoutBlocking) {
+  const auto file_name = testing::TempDir() + "traffic_capture_full.pcap";
+  TrafficCapture capture(file_name, 3, 64);
+  const std::string payload = "request";
+  // Без потока записи буфер из 4 слотов не освобождается.
+  for (std::size_t i = 0; i < 4; ++i) {
+    EXPECT_TRUE(capture.Capture(payload, PacketAddress{}, PacketAddress{}));
+  }
+  EXPECT_FALSE(capture.Capture(payload, PacketAddress{}, PacketAddress{}));
+  EXPECT_EQ(1, capture.GetDropped());
+
+  capture.Start();
+  capture.Stop();
+  EXPECT_EQ(4, capture.GetWritten());
+  std::filesystem::remove(file_name);
+}
+
+TEST(TrafficCaptureTest, EndPointAddressIsConverted) {
+  const LoadBalancer::EndPointType end_point("127.0.0.1", 60000);
+  const auto address = TrafficCapture::ToPacketAddress(end_point);
+  EXPECT_EQ(0x7F000001, address.address);
+  EXPECT_EQ(60000, address.port);
+}
+
+}  // namespace load_balancer::test
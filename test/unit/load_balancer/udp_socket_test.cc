@@ -0,0 +1,255 @@
+#include "udp_socket.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+
+#include "buffer_pool.h"
+#include "load_balancer.h"
+
+namespace load_balancer::test {
+
+using SocketType = LoadBalancer::SocketType;
+using EndPointType = LoadBalancer::EndPointType;
+using DatagramView = SocketType::DatagramView;
+
+static constexpr std::uint16_t kSenderPort = 60200;
+static constexpr std::uint16_t kReceiverPort = 60201;
+
+/**
+ * \brief Сообщения одинакового размера, последнее сообщение короче.
+ */
+static std::vector<std::string> MakeSegments(const size_t count) {
+  std::vector<std::string> messages;
+  for (size_t i = 0; i < count; ++i) {
+    messages.emplace_back(100, static_cast<char>('a' + i % 26));
+  }
+  messages.back().resize(37);
+  return messages;
+}
+
+/**
+ * \brief Датаграммы, ссылающиеся на сообщения.
+ */
+static std::vector<DatagramView> MakeViews(
+    std::vector<std::string> &messages, const std::vector<EndPointType> &receivers
+) {
+  std::vector<DatagramView> datagrams;
+  for (size_t i = 0; i < messages.size(); ++i) {
+    datagrams.push_back(
+        {.buffer = messages[i], .size = messages[i].size(), .end_point = receivers[i]}
+    );
+  }
+  return datagrams;
+}
+
+/**
+ * \brief Принимать датаграммы, пока не будет получено заданное количество.
+ */
+static std::vector<std::string> ReceiveMessages(const SocketType &socket, const size_t count) {
+  socket_wrapper::BufferPool pool(SocketType::kMaxDatagramSize, count);
+  std::vector<DatagramView> buffers(count);
+  for (auto &buffer : buffers) {
+    buffer.buffer = pool.Acquire();
+  }
+  std::vector<DatagramView> datagrams;
+  std::vector<std::string> messages;
+  while (messages.size() < count) {
+    socket.ReceiveSegmentedBatchFrom(buffers, datagrams);
+    for (const auto &datagram : datagrams) {
+      messages.emplace_back(datagram.buffer.data(), datagram.size);
+    }
+  }
+  return messages;
+}
+
+TEST(UdpSocketTest, SegmentedBatchIsSplitForPlainReceiver) {
+  const SocketType sender(kSenderPort);
+  const SocketType receiver(kReceiverPort);
+  auto sent = MakeSegments(10);
+  const std::vector receivers(sent.size(), EndPointType("127.0.0.1", kReceiverPort));
+
+  sender.SendSegmentedBatchTo(MakeViews(sent, receivers));
+
+  EXPECT_EQ(sent, ReceiveMessages(receiver, sent.size()));
+}
+
+TEST(UdpSocketTest, GroBufferIsSplitIntoDatagrams) {
+  const SocketType sender(kSenderPort);
+  SocketType receiver(kReceiverPort);
+  receiver.SetGro(true);
+  auto sent = MakeSegments(20);
+  const std::vector receivers(sent.size(), EndPointType("127.0.0.1", kReceiverPort));
+
+  sender.SendSegmentedBatchTo(MakeViews(sent, receivers));
+
+  EXPECT_EQ(sent, ReceiveMessages(receiver, sent.size()));
+}
+
+TEST(UdpSocketTest, SegmentedBatchKeepsOrderForMixedReceivers) {
+  const SocketType sender(kSenderPort);
+  const SocketType first_receiver(kReceiverPort);
+  const SocketType second_receiver(kReceiverPort + 1);
+  std::vector<std::string> sent;
+  std::vector<EndPointType> receivers;
+  for (size_t i = 0; i < 6; ++i) {
+    const auto port = i % 3 == 2 ? kReceiverPort + 1 : kReceiverPort;
+    sent.push_back(std::to_string(i * 11));
+    receivers.emplace_back("127.0.0.1", port);
+  }
+
+  sender.SendSegmentedBatchTo(MakeViews(sent, receivers));
+
+  EXPECT_EQ(std::vector<std::string>({"0", "11", "33", "44"}), ReceiveMessages(first_receiver, 4));
+  EXPECT_EQ(std::vector<std::string>({"22", "55"}), ReceiveMessages(second_receiver, 2));
+}
+
+TEST(UdpSocketTest, DatagramIsReceivedIntoCallerBuffer) {
+  const SocketType sender(kSenderPort);
+  const SocketType receiver(kReceiverPort);
+  socket_wrapper::BufferPool pool(64, 1);
+  const auto buffer = pool.Acquire();
+  const std::string message = "pooled datagram";
+
+  sender.SendTo(std::span<const char>(message), EndPointType("127.0.0.1", kReceiverPort));
+  const auto [size, from] = receiver.ReceiveFrom(buffer);
+
+  EXPECT_EQ(message, std::string(buffer.data(), size));
+  EXPECT_EQ(kSenderPort, from.GetPort());
+}
+
+TEST(UdpSocketTest, BatchIsSentAndReceivedThroughCallerBuffers) {
+  const SocketType sender(kSenderPort);
+  const SocketType receiver(kReceiverPort);
+  constexpr size_t kCount = 8;
+  socket_wrapper::BufferPool pool(64, 2 * kCount);
+  std::vector<SocketType::DatagramView> outgoing(kCount);
+  for (size_t i = 0; i < kCount; ++i) {
+    outgoing[i].buffer = pool.Acquire();
+    const auto message = std::to_string(i * 101);
+    std::copy(message.begin(), message.end(), outgoing[i].buffer.begin());
+    outgoing[i].size = message.size();
+    outgoing[i].end_point = EndPointType("127.0.0.1", kReceiverPort);
+  }
+  std::vector<SocketType::DatagramView> incoming(kCount);
+  for (auto &datagram : incoming) {
+    datagram.buffer = pool.Acquire();
+  }
+
+  sender.SendBatchTo(outgoing);
+  std::vector<std::string> messages;
+  while (messages.size() < kCount) {
+    const auto received =
+        receiver.ReceiveBatchFrom(std::span(incoming).first(kCount - messages.size()));
+    for (size_t i = 0; i < received; ++i) {
+      EXPECT_EQ(kSenderPort, incoming[i].end_point.GetPort());
+      messages.emplace_back(incoming[i].buffer.data(), incoming[i].size);
+    }
+  }
+
+  for (size_t i = 0; i < kCount; ++i) {
+    EXPECT_EQ(std::to_string(i * 101), messages[i]);
+  }
+}
+
+TEST(UdpSocketTest, LongDatagramIsTruncatedToCallerBuffer) {
+  const SocketType sender(kSenderPort);
+  const SocketType receiver(kReceiverPort);
+  std::array<char, 4> buffer = {};
+
+  sender.SendTo(std::string("truncated"), EndPointType("127.0.0.1", kReceiverPort));
+  const auto [size, from] = receiver.ReceiveFrom(buffer);
+
+  EXPECT_EQ("trun", std::string(buffer.data(), size));
+}
+
+TEST(UdpSocketTest, NonBlockingBatchReceiveReturnsWhenEmpty) {
+  const SocketType sender(kSenderPort);
+  const SocketType receiver(kReceiverPort, {.non_blocking = true});
+  socket_wrapper::BufferPool pool(64, 2);
+  std::vector<SocketType::DatagramView> incoming(2);
+  for (auto &datagram : incoming) {
+    datagram.buffer = pool.Acquire();
+  }
+
+  EXPECT_EQ(0, receiver.ReceiveBatchFrom(incoming));
+  sender.SendTo(std::string("ready"), EndPointType("127.0.0.1", kReceiverPort));
+  size_t received = 0;
+  while (received == 0) {
+    received = receiver.ReceiveBatchFrom(incoming);
+  }
+  EXPECT_EQ(1, received);
+  EXPECT_EQ("ready", std::string(incoming[0].buffer.data(), incoming[0].size));
+  EXPECT_EQ(0, receiver.ReceiveBatchFrom(incoming));
+}
+
+TEST(UdpSocketTest, TryReceiveReturnsWithoutWaiting) {
+  const SocketType sender(kSenderPort);
+  const SocketType receiver(kReceiverPort);
+  socket_wrapper::BufferPool pool(64, 2);
+  const auto buffer = pool.Acquire();
+  std::vector<SocketType::DatagramView> incoming(1);
+  incoming[0].buffer = pool.Acquire();
+
+  EXPECT_FALSE(receiver.TryReceiveFrom(buffer).has_value());
+  EXPECT_EQ(0, receiver.TryReceiveBatchFrom(incoming));
+  sender.SendTo(std::string("first"), EndPointType("127.0.0.1", kReceiverPort));
+  sender.SendTo(std::string("second"), EndPointType("127.0.0.1", kReceiverPort));
+  std::optional<std::pair<size_t, EndPointType>> datagram;
+  while (!datagram) {
+    datagram = receiver.TryReceiveFrom(buffer);
+  }
+  EXPECT_EQ("first", std::string(buffer.data(), datagram->first));
+  size_t received = 0;
+  while (received == 0) {
+    received = receiver.TryReceiveBatchFrom(incoming);
+  }
+  EXPECT_EQ("second", std::string(incoming[0].buffer.data(), incoming[0].size));
+  EXPECT_FALSE(receiver.TryReceiveFrom(buffer).has_value());
+}
+
+TEST(UdpSocketTest, BufferSizesAreDoubledByKernel) {
+  SocketType socket(kReceiverPort);
+  socket.SetReceiveBufferSize(65536);
+  socket.SetSendBufferSize(32768);
+  EXPECT_EQ(2 * 65536, socket.GetReceiveBufferSize());
+  EXPECT_EQ(2 * 32768, socket.GetSendBufferSize());
+  EXPECT_EQ(0, socket.GetReceiveQueueSize());
+  EXPECT_EQ(0, socket.GetSendQueueSize());
+}
+
+TEST(UdpSocketTest, KernelDropsAreReportedWithDatagrams) {
+  constexpr size_t count = 100;
+  const SocketType sender(kSenderPort);
+  SocketType receiver(kReceiverPort, {.non_blocking = true});
+  // Минимальный буфер приема вмещает лишь несколько датаграмм.
+  receiver.SetReceiveBufferSize(1);
+  receiver.SetRxqOverflow(true);
+  const EndPointType receiver_end_point("127.0.0.1", kReceiverPort);
+  const std::string message(100, 'x');
+  for (size_t i = 0; i < count; ++i) {
+    sender.SendTo(message, receiver_end_point);
+  }
+  EXPECT_EQ(message.size(), receiver.GetReceiveQueueSize());
+
+  socket_wrapper::BufferPool pool(128, 1);
+  const auto buffer = pool.Acquire();
+  size_t received = 0;
+  while (receiver.TryReceiveFrom(buffer)) {
+    ++received;
+  }
+  ASSERT_LT(received, count);
+  // Счетчик передается с датаграммой, поставленной в очередь после отброшенных.
+  EXPECT_EQ(0, receiver.GetKernelDrops());
+  EXPECT_EQ(0, receiver.GetReceiveQueueSize());
+
+  sender.SendTo(message, receiver_end_point);
+  std::vector<SocketType::DatagramView> incoming(1);
+  incoming[0].buffer = buffer;
+  while (receiver.TryReceiveBatchFrom(incoming) == 0) {
+  }
+  EXPECT_EQ(count - received, receiver.GetKernelDrops());
+}
+
+}  // namespace load_balancer::test
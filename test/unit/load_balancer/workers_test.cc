@@ -0,0 +1,71 @@
+#include "workers/worker_scaler.h"
+
+#include <gtest/gtest.h>
+#include <sched.h>
+
+#include <atomic>
+#include <thread>
+
+#include "workers/cpu_affinity.h"
+
+namespace load_balancer::test {
+
+using namespace std::chrono_literals;
+
+using workers::WorkerScaler;
+
+TEST(WorkerScalerTest, ActiveCountFollowsUtilization) {
+  EXPECT_EQ(3, WorkerScaler::NextActiveCount(2, 0.9, 4));
+  EXPECT_EQ(4, WorkerScaler::NextActiveCount(4, 0.9, 4));
+  EXPECT_EQ(1, WorkerScaler::NextActiveCount(2, 0.1, 4));
+  EXPECT_EQ(1, WorkerScaler::NextActiveCount(1, 0.1, 4));
+  EXPECT_EQ(2, WorkerScaler::NextActiveCount(2, 0.5, 4));
+}
+
+TEST(WorkerScalerTest, StopReleasesInactiveWorkers) {
+  WorkerScaler scaler(2, 1, 1s);
+  std::atomic_bool released = false;
+  std::jthread first([&scaler] {
+    scaler.RegisterWorker().WaitUntilActive();
+  });
+  first.join();
+  std::jthread second([&scaler, &released] {
+    scaler.RegisterWorker().WaitUntilActive();
+    released = true;
+  });
+  std::this_thread::sleep_for(100ms);
+  EXPECT_FALSE(released);
+
+  scaler.Stop();
+  second.join();
+  EXPECT_TRUE(released);
+}
+
+TEST(WorkerScalerTest, BusyWorkerActivatesAnother) {
+  WorkerScaler scaler(2, 1, 20ms);
+  std::atomic_bool stop = false;
+  std::jthread busy([&scaler, &stop] {
+    const auto worker = scaler.RegisterWorker();
+    worker.WaitUntilActive();
+    while (!stop) {
+    }
+  });
+  std::jthread idle([&scaler] {
+    scaler.RegisterWorker().WaitUntilActive();
+  });
+  scaler.Start();
+  idle.join();
+  EXPECT_EQ(2, scaler.GetActiveCount());
+  stop = true;
+}
+
+TEST(CpuAffinityTest, PinnedThreadRunsOnCpu) {
+  const auto cpus = workers::GetAllowedCpus();
+  ASSERT_FALSE(cpus.empty());
+  std::jthread([cpu = cpus.back()] {
+    workers::PinCurrentThread(cpu);
+    EXPECT_EQ(cpu, sched_getcpu());
+  }).join();
+}
+
+}  // namespace load_balancer::test
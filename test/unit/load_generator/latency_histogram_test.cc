@@ -0,0 +1,56 @@
+#include "latency_histogram.h"
+
+#include <gtest/gtest.h>
+
+namespace load_balancer::test {
+
+using namespace generator;
+
+TEST(LatencyHistogramTest, SmallValuesAreExact) {
+  LatencyHistogram histogram;
+  for (std::uint64_t value = 1; value <= 50; ++value) {
+    histogram.Record(value);
+  }
+
+  EXPECT_EQ(50, histogram.GetCount());
+  EXPECT_EQ(25, histogram.GetQuantile(0.5));
+  EXPECT_EQ(50, histogram.GetQuantile(0.99));
+  EXPECT_EQ(1, histogram.GetQuantile(0));
+  EXPECT_EQ(50, histogram.GetMax());
+}
+
+TEST(LatencyHistogramTest, LargeValuesHaveBoundedRelativeError) {
+  LatencyHistogram histogram;
+  for (std::uint64_t value = 1000; value <= 1'000'000; value += 1000) {
+    histogram.Record(value);
+  }
+
+  for (const auto &[quantile, expected] :
+       {std::pair{0.5, 500'000.0}, std::pair{0.99, 990'000.0}, std::pair{0.999, 999'000.0}}) {
+    const auto actual = static_cast<double>(histogram.GetQuantile(quantile));
+    EXPECT_GE(actual, expected);
+    EXPECT_LE(actual, expected * (1.0 + 1.0 / LatencyHistogram::kSubBucketCount));
+  }
+  EXPECT_EQ(1'000'000, histogram.GetQuantile(1));
+}
+
+TEST(LatencyHistogramTest, MergeSumsCounts) {
+  LatencyHistogram first;
+  LatencyHistogram second;
+  first.Record(10);
+  second.Record(1'000'000);
+  second.Record(UINT64_MAX);
+
+  first.Merge(second);
+  EXPECT_EQ(3, first.GetCount());
+  EXPECT_EQ(UINT64_MAX, first.GetMax());
+  EXPECT_EQ(10, first.GetQuantile(0.3));
+  EXPECT_EQ(UINT64_MAX, first.GetQuantile(1));
+}
+
+TEST(LatencyHistogramTest, EmptyHistogramReturnsZero) {
+  const LatencyHistogram histogram;
+  EXPECT_EQ(0, histogram.GetQuantile(0.5));
+}
+
+}  // namespace load_balancer::test
@@ -0,0 +1,40 @@
+#include "load_generator.h"
+
+#include <gtest/gtest.h>
+
+#include "latency_sink.h"
+#include "probe.h"
+
+namespace load_balancer::test {
+
+using namespace generator;
+using namespace std::chrono_literals;
+
+TEST(LoadGeneratorTest, SinkMeasuresLatencyOfEveryDatagram) {
+  LatencySink sink(LatencySink::EndPointType("127.0.0.1", 60100));
+  sink.Start();
+  LoadGenerator generator(
+      {.rate = 10000, .payload_size = 100, .thread_count = 2, .source_ports = 4, .duration = 200ms},
+      sink.GetEndPoint()
+  );
+
+  generator.Run();
+  std::this_thread::sleep_for(100ms);
+  sink.Stop();
+
+  // Открытый цикл: количество отправленных определяется только скоростью и длительностью.
+  EXPECT_NEAR(2000, generator.GetSent(), 100);
+  EXPECT_EQ(generator.GetSent(), sink.GetReceived());
+  EXPECT_EQ(sink.GetReceived(), sink.GetHistogram().GetCount());
+  EXPECT_GT(sink.GetHistogram().GetQuantile(0.5), 0);
+  EXPECT_LT(sink.GetHistogram().GetQuantile(0.5), 100'000'000);
+}
+
+TEST(LoadGeneratorTest, InvalidOptionsAreRejected) {
+  const LoadGenerator::EndPointType target("127.0.0.1", 60100);
+  EXPECT_THROW(LoadGenerator({.rate = 0}, target), std::invalid_argument);
+  EXPECT_THROW(LoadGenerator({.payload_size = kProbeSize - 1}, target), std::invalid_argument);
+  EXPECT_THROW(LoadGenerator({.thread_count = 0}, target), std::invalid_argument);
+}
+
+}  // namespace load_balancer::test
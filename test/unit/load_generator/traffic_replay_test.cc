@@ -0,0 +1,99 @@
+#include "traffic_replay.h"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+
+#include "latency_sink.h"
+#include "probe.h"
+
+namespace load_balancer::test {
+
+using namespace generator;
+using namespace std::chrono_literals;
+
+/**
+ * \brief Записать файл pcap с датаграммами генератора от нескольких отправителей, следующими
+ * с заданным интервалом.
+ */
+static void WriteCapture(
+    const std::string &file_name, const std::size_t count, const std::chrono::nanoseconds interval
+) {
+  capture::PcapWriter writer(file_name, 64);
+  std::array<char, 64> payload{};
+  for (std::size_t i = 0; i < count; ++i) {
+    WriteProbe({.thread = 0, .sequence = i, .send_time = 0}, payload);
+    writer.Write(
+        1s + interval * i,
+        {.address = 0x0A000001, .port = static_cast<std::uint16_t>(1000 + i % 3)},
+        {.address = 0x0A000002, .port = 10000},
+        payload,
+        payload.size()
+    );
+  }
+}
+
+TEST(TrafficReplayTest, ReplayKeepsOriginalTiming) {
+  constexpr std::size_t count = 100;
+  const auto file_name = testing::TempDir() + "traffic_replay_test.pcap";
+  WriteCapture(file_name, count, 2ms);
+  LatencySink sink(LatencySink::EndPointType("127.0.0.1", 60100));
+  sink.Start();
+
+  TrafficReplay replay({.source_ports = 4, .replay_file = file_name}, sink.GetEndPoint());
+  const auto start = std::chrono::steady_clock::now();
+  replay.Run();
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  std::this_thread::sleep_for(100ms);
+  sink.Stop();
+
+  EXPECT_GE(elapsed, 2ms * (count - 1));
+  EXPECT_EQ(count, replay.GetSent());
+  EXPECT_EQ(0, replay.GetSkipped());
+  // Время отправки в датаграммах заменено запланированным временем воспроизведения.
+  EXPECT_EQ(count, sink.GetReceived());
+  EXPECT_LT(sink.GetHistogram().GetMax(), 1'000'000'000);
+  std::filesystem::remove(file_name);
+}
+
+TEST(TrafficReplayTest, ScaledAndMaxSpeedReplay) {
+  constexpr std::size_t count = 100;
+  const auto file_name = testing::TempDir() + "traffic_replay_scaled.pcap";
+  WriteCapture(file_name, count, 2ms);
+  LatencySink sink(LatencySink::EndPointType("127.0.0.1", 60100));
+  sink.Start();
+
+  TrafficReplay scaled(
+      {.source_ports = 4, .replay_file = file_name, .replay_speed = 4}, sink.GetEndPoint()
+  );
+  auto start = std::chrono::steady_clock::now();
+  scaled.Run();
+  const auto scaled_elapsed = std::chrono::steady_clock::now() - start;
+  TrafficReplay max_speed(
+      {.source_ports = 4, .replay_file = file_name, .replay_speed = 0}, sink.GetEndPoint()
+  );
+  start = std::chrono::steady_clock::now();
+  max_speed.Run();
+  const auto max_speed_elapsed = std::chrono::steady_clock::now() - start;
+  std::this_thread::sleep_for(100ms);
+  sink.Stop();
+
+  EXPECT_GE(scaled_elapsed, 2ms * (count - 1) / 4);
+  EXPECT_LT(scaled_elapsed, 2ms * (count - 1));
+  EXPECT_LT(max_speed_elapsed, scaled_elapsed);
+  EXPECT_EQ(2 * count, sink.GetReceived());
+  std::filesystem::remove(file_name);
+}
+
+TEST(TrafficReplayTest, InvalidOptionsAreRejected) {
+  const auto file_name = testing::TempDir() + "traffic_replay_invalid.pcap";
+  WriteCapture(file_name, 1, 1ms);
+  const TrafficReplay::EndPointType target("127.0.0.1", 60100);
+  EXPECT_THROW(
+      TrafficReplay({.replay_file = file_name, .replay_speed = -1}, target), std::invalid_argument
+  );
+  std::filesystem::remove(file_name);
+  EXPECT_THROW(TrafficReplay({.replay_file = file_name}, target), std::runtime_error);
+}
+
+}  // namespace load_balancer::test